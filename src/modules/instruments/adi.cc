@@ -33,7 +33,7 @@ XEFIS_REGISTER_MODULE_CLASS ("instruments/adi", ADI)
 
 
 ADI::ADI (xf::ModuleManager* module_manager, QDomElement const& config):
-	Instrument (module_manager, config)
+	Instrument (module_manager, config, 60_Hz)
 {
 	parse_settings (config, {
 		{ "speed-ladder.line-every", _speed_ladder_line_every, false },
@@ -73,6 +73,13 @@ ADIWidget::PaintWorkUnit::pop_params()
 }
 
 
+xf::TextPainter::Cache const*
+ADIWidget::PaintWorkUnit::text_painter_cache() const
+{
+	return &_text_painter_cache;
+}
+
+
 void
 ADIWidget::PaintWorkUnit::resized()
 {
@@ -86,6 +93,8 @@ ADIWidget::PaintWorkUnit::resized()
 	_center_transform.reset();
 	_center_transform.translate (0.5f * _w, 0.5f * _h);
 
+	_digit_drums.clear();
+
 	adi_post_resize();
 	sl_post_resize();
 	al_post_resize();
@@ -1954,14 +1963,30 @@ ADIWidget::PaintWorkUnit::paint_flight_director (xf::Painter& painter)
 	painter.setClipping (false);
 	painter.setTransform (_center_transform);
 
+	// Bars only move, so they're painted from cached sprites:
+	QLineF const pitch_bar (QPointF (-w, 0.f), QPointF (+w, 0.f));
+	QLineF const roll_bar (QPointF (0.f, -w), QPointF (0.f, +w));
+
 	for (auto pen: { get_pen (_autopilot_pen_1.color(), 2.3f),
 					 get_pen (_autopilot_pen_2.color(), 1.65f) })
 	{
 		painter.setPen (pen);
 		if (_params.flight_director_pitch_visible && _params.orientation_pitch_visible)
-			painter.drawLine (QPointF (-w, ypos), QPointF (+w, ypos));
+		{
+			painter.setTransform (_center_transform);
+			painter.translate (0.f, ypos);
+			painter.paint_sprite ("fd-pitch", QRectF (pitch_bar.p1(), pitch_bar.p2()), [&](xf::Painter& painter) {
+				painter.drawLine (pitch_bar);
+			});
+		}
 		if (_params.flight_director_roll_visible && _params.orientation_roll_visible)
-			painter.drawLine (QPointF (xpos, -w), QPointF (xpos, +w));
+		{
+			painter.setTransform (_center_transform);
+			painter.translate (xpos, 0.f);
+			painter.paint_sprite ("fd-roll", QRectF (roll_bar.p1(), roll_bar.p2()), [&](xf::Painter& painter) {
+				painter.drawLine (roll_bar);
+			});
+		}
 	}
 }
 
@@ -2626,22 +2651,72 @@ ADIWidget::PaintWorkUnit::paint_rotating_digit (xf::Painter& painter,
 	float dtr = (value + phase - rounded) / round_target;
 	float pos = 0.f;
 	float epsilon = 0.000001f;
-	float xa = std::fmod ((value + phase) / round_target + 1.f - epsilon, 10.f);
 	float xb = std::fmod ((value + phase) / round_target + 0.f - epsilon, 10.f);
-	float xc = std::fmod ((value + phase) / round_target - 1.f - epsilon, 10.f);
-
-	int a = static_cast<int> (std::abs (xa));
-	int b = static_cast<int> (std::abs (xb));
-	int c = static_cast<int> (std::abs (xc));
-
-	QString sa = zero_mark && a == 0 ? (black_zero ? "-" : (xa >= 0.f ? "G" : "R")) : QString::number (a);
-	QString sb = zero_mark && b == 0 ? (black_zero ? "-" : (xb >= 0.f ? "G" : "R")) : QString::number (b);
-	QString sc = zero_mark && c == 0 ? (black_zero ? "-" : (xc >= 0.f ? "G" : "R")) : QString::number (c);
 
 	if (std::abs (dtr) < delta && (two_zeros || std::abs (value) >= round_target / 2))
 		pos = xf::floored_mod (-dtr * (0.5f / delta), 1.f) - 0.5f;
 
-	paint_rotating_value (painter, box, pos, height_scale, sa, sb, sc);
+	DigitDrum const& drum = get_digit_drum (painter, box, height_scale, zero_mark, black_zero);
+	// Drum cell index of the current value. Next value is one cell up, previous one cell down:
+	int cell = xf::limit<int> (std::floor (xb) + 10, 0, 19) + 1;
+	QRectF source (0.f, (DigitDrum::Cells - 1 - cell + pos) * drum.cell_height, box.width(), box.height());
+	QPointF target = painter.transform().map (box.topLeft());
+
+	painter.save();
+	painter.resetTransform();
+	painter.drawImage (QPoint (std::round (target.x()), std::round (target.y())), drum.image,
+					   QRect (0, std::round (source.top()), std::ceil (source.width()), std::ceil (source.height())));
+	painter.restore();
+}
+
+
+ADIWidget::PaintWorkUnit::DigitDrum const&
+ADIWidget::PaintWorkUnit::get_digit_drum (xf::Painter& painter, QRectF const& box, float height_scale, bool zero_mark, bool black_zero)
+{
+	QFont font = painter.font();
+	DigitDrumKey key { font, static_cast<int> (std::ceil (box.width())), static_cast<int> (std::ceil (box.height())), height_scale, zero_mark, black_zero };
+
+	auto drum_it = _digit_drums.find (key);
+	if (drum_it != _digit_drums.end())
+		return drum_it->second;
+
+	QColor red (255, 0, 0);
+	QColor green (0, 255, 0);
+
+	DigitDrum drum;
+	drum.cell_height = height_scale * QFontMetricsF (font).height();
+	drum.image = QImage (std::ceil (box.width()), std::ceil (box.height() + (DigitDrum::Cells - 1) * drum.cell_height), QImage::Format_ARGB32_Premultiplied);
+	drum.image.fill (Qt::transparent);
+
+	xf::Painter drum_painter (&drum.image, &_text_painter_cache);
+	drum_painter.setRenderHint (QPainter::Antialiasing, true);
+	drum_painter.setRenderHint (QPainter::TextAntialiasing, true);
+	drum_painter.setRenderHint (QPainter::SmoothPixmapTransform, true);
+	drum_painter.setRenderHint (QPainter::NonCosmeticDefaultPen, true);
+	drum_painter.set_font_position_correction ({ 0.0, 0.04 });
+	drum_painter.setFont (font);
+	drum_painter.setPen (painter.pen());
+
+	// Cell n (counting from the bottom) represents value range [j - 10, j - 9),
+	// where j is n - 1 wrapped into [0, 20) the same way std::fmod() wraps values.
+	for (int n = 0; n < DigitDrum::Cells; ++n)
+	{
+		int j = n == 0 ? 9 : n == DigitDrum::Cells - 1 ? 10 : n - 1;
+		int digit = j >= 10 ? j - 10 : 9 - j;
+		QString str = zero_mark && digit == 0 ? (black_zero ? "-" : (j >= 10 ? "G" : "R")) : QString::number (digit);
+		QRectF rect (0.f, (DigitDrum::Cells - 1 - n) * drum.cell_height, box.width(), box.height());
+
+		if (str == "G" || str == "R")
+			paint_dashed_zone (drum_painter, str == "G" ? green : red, rect);
+		else if (str == "-")
+			; // Paint nothing.
+		else
+			drum_painter.fast_draw_text (rect, Qt::AlignVCenter | Qt::AlignLeft, str);
+	}
+
+	drum_painter.end();
+
+	return _digit_drums.insert ({ key, drum }).first->second;
 }
 
 
@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <atomic>
 #include <map>
+#include <tuple>
 
 // Boost:
 #include <boost/optional.hpp>
@@ -230,11 +231,30 @@ class ADIWidget: public xf::InstrumentWidget
 	{
 		friend class ADIWidget;
 
+		/**
+		 * Pre-rendered vertical strip of digits used by paint_rotating_digit().
+		 * Contains cells for all values of a rotating digit in range (-10, 10),
+		 * with one extra wrap-around cell on each end.
+		 */
+		struct DigitDrum
+		{
+			static constexpr int Cells = 22;
+
+			QImage	image;
+			float	cell_height;
+		};
+
+		// Font, box width, box height, height scale, zero mark, black zero:
+		typedef std::tuple<QFont, int, int, float, bool, bool> DigitDrumKey;
+
 	  public:
 		PaintWorkUnit (ADIWidget*);
 
 		~PaintWorkUnit() noexcept { }
 
+		xf::TextPainter::Cache const*
+		text_painter_cache() const override;
+
 	  private:
 		void
 		pop_params() override;
@@ -462,6 +482,13 @@ class ADIWidget: public xf::InstrumentWidget
 							  QRectF const& box, float value, int round_target, float const height_scale, float const delta, float const phase,
 							  bool two_zeros, bool zero_mark, bool black_zero = false);
 
+		/**
+		 * Return digit drum for current painter font and given parameters.
+		 * Renders the drum if it's not in cache. Cache is cleared on resize.
+		 */
+		DigitDrum const&
+		get_digit_drum (xf::Painter& painter, QRectF const& box, float height_scale, bool zero_mark, bool black_zero);
+
 		/**
 		 * Paint horizontal failure flag.
 		 */
@@ -559,6 +586,13 @@ class ADIWidget: public xf::InstrumentWidget
 		QRectF				_al_b_digits_box;
 		QRectF				_al_s_digits_box;
 		float				_al_margin;
+
+		/*
+		 * Other
+		 */
+
+		std::map<DigitDrumKey, DigitDrum>
+							_digit_drums;
 	};
 
   public:
@@ -0,0 +1,175 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+
+// Qt:
+#include <QtGui/QImage>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/benchmark/benchmark.h>
+#include <xefis/benchmark/benchmark_aids.h>
+
+// Local:
+#include "../adi_widget.h"
+
+
+namespace Xefis {
+namespace Benchmarks {
+
+constexpr unsigned int ADIFrames = 200;
+
+
+/**
+ * Typical in-flight parameters with most of the elements visible.
+ */
+static ADIWidget::Parameters
+adi_cruise_params()
+{
+	ADIWidget::Parameters p;
+	p.speed_visible = true;
+	p.speed = 120_kt;
+	p.speed_lookahead_visible = true;
+	p.speed_lookahead = 125_kt;
+	p.speed_minimum_visible = true;
+	p.speed_minimum = 60_kt;
+	p.speed_maximum_visible = true;
+	p.speed_maximum = 180_kt;
+	p.speed_mach_visible = true;
+	p.speed_mach = 0.19;
+	p.speed_bugs["V1"] = 80_kt;
+	p.speed_bugs["VR"] = 85_kt;
+	p.orientation_pitch_visible = true;
+	p.orientation_roll_visible = true;
+	p.orientation_heading_visible = true;
+	p.orientation_heading_numbers_visible = true;
+	p.orientation_heading = 90_deg;
+	p.slip_skid_visible = true;
+	p.flight_path_visible = true;
+	p.critical_aoa_visible = true;
+	p.critical_aoa = 15_deg;
+	p.aoa_alpha = 4_deg;
+	p.altitude_visible = true;
+	p.altitude = 3500_ft;
+	p.altitude_lookahead_visible = true;
+	p.altitude_lookahead = 3600_ft;
+	p.altitude_agl_visible = true;
+	p.altitude_agl = 2500_ft;
+	p.minimums_altitude_visible = true;
+	p.minimums_type = "BARO";
+	p.minimums_amsl = 1200_ft;
+	p.minimums_setting = 1200_ft;
+	p.vertical_speed_visible = true;
+	p.vertical_speed = 500_fpm;
+	p.pressure_visible = true;
+	p.pressure_qnh = 29.92_inHg;
+	p.cmd_speed = 120_kt;
+	p.cmd_altitude = 4000_ft;
+	p.cmd_vertical_speed = 700_fpm;
+	p.flight_director_pitch_visible = true;
+	p.flight_director_roll_visible = true;
+	p.navaid_reference_visible = true;
+	p.navaid_hint = "VOR";
+	p.navaid_identifier = "WAW";
+	p.navaid_distance = 12.3_nmi;
+	p.fma_visible = true;
+	p.fma_speed_hint = "THR REF";
+	p.fma_lateral_hint = "HDG";
+	p.fma_vertical_hint = "V/S";
+	return p;
+}
+
+
+/**
+ * Render frames of the ADI at all standard sizes, changing params for each frame
+ * with the update function.
+ */
+static void
+run_adi_sweep (Benchmark& benchmark, std::function<void (ADIWidget::Parameters&, unsigned int frame)> update)
+{
+	for (QSize const& size: BenchmarkAids::instrument_sizes())
+	{
+		ADIWidget widget (nullptr, nullptr);
+		QImage canvas (size, QImage::Format_ARGB32_Premultiplied);
+		ADIWidget::Parameters params = adi_cruise_params();
+
+		benchmark.measure (BenchmarkAids::size_name (size), ADIFrames, [&](unsigned int frame) {
+			update (params, frame);
+			widget.set_params (params);
+			widget.paint_offscreen (canvas, size);
+		}, [&] {
+			return BenchmarkAids::cache_stats (widget.paint_work_unit()->text_painter_cache());
+		});
+	}
+}
+
+
+static xf::Benchmark adi_attitude ("instruments/adi/attitude", [](Benchmark& benchmark) {
+	run_adi_sweep (benchmark, [](ADIWidget::Parameters& p, unsigned int frame) {
+		double const t = 0.05 * frame;
+		p.orientation_pitch = 15_deg * std::sin (t);
+		p.orientation_roll = 45_deg * std::sin (0.7 * t);
+		p.orientation_heading = 1_deg * (90.0 + 10.0 * std::sin (0.3 * t));
+		p.slip_skid = 0.5f * std::sin (1.3 * t);
+		p.flight_path_alpha = 2_deg * std::sin (t);
+		p.flight_path_beta = 1_deg * std::cos (t);
+		p.flight_director_pitch = 5_deg * std::cos (t);
+		p.flight_director_roll = 20_deg * std::cos (0.7 * t);
+	});
+});
+
+
+static xf::Benchmark adi_ladders ("instruments/adi/ladders", [](Benchmark& benchmark) {
+	run_adi_sweep (benchmark, [](ADIWidget::Parameters& p, unsigned int frame) {
+		p.speed = 1_kt * (80.0 + 0.37 * frame);
+		p.speed_lookahead = p.speed + 3_kt;
+		p.speed_mach = p.speed.quantity<Knot>() / 661.5;
+		p.altitude = 1_ft * (1000.0 + 13.7 * frame);
+		p.altitude_lookahead = p.altitude + 50_ft;
+		p.altitude_agl = p.altitude - 800_ft;
+		p.vertical_speed = 1_fpm * (1000.0 * std::sin (0.05 * frame));
+	});
+});
+
+
+static xf::Benchmark adi_failures ("instruments/adi/failures", [](Benchmark& benchmark) {
+	run_adi_sweep (benchmark, [](ADIWidget::Parameters& p, unsigned int frame) {
+		// Toggle between all-failed and all-working every 10 frames:
+		bool const failed = (frame / 10) % 2 == 0;
+		p.speed_failure = failed;
+		p.orientation_failure = failed;
+		p.flight_path_marker_failure = failed;
+		p.altitude_failure = failed;
+		p.altitude_agl_failure = failed;
+		p.vertical_speed_failure = failed;
+		p.flight_director_failure = failed;
+		p.deviation_vertical_failure = failed;
+		p.deviation_lateral_failure = failed;
+		p.novspd_flag = failed;
+		p.ldgalt_flag = failed;
+		p.pitch_disagree = failed;
+		p.roll_disagree = failed;
+		p.ias_disagree = failed;
+		p.altitude_disagree = failed;
+		p.roll_warning = failed;
+		p.slip_skid_warning = failed;
+	});
+});
+
+} // namespace Benchmarks
+} // namespace Xefis
+
@@ -0,0 +1,101 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+
+// Qt:
+#include <QtGui/QImage>
+#include <QtXml/QDomDocument>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/benchmark/benchmark.h>
+#include <xefis/benchmark/benchmark_aids.h>
+#include <xefis/core/property.h>
+
+// Local:
+#include "../cdu.h"
+
+
+namespace Xefis {
+namespace Benchmarks {
+
+constexpr unsigned int CDUFrames = 200;
+
+constexpr char CDUConfig[] = R"(
+	<module name="instruments/cdu" instance="benchmark">
+		<pages default="main" rows="6">
+			<page id="main" title="BENCHMARK PAGE">
+				<left>
+					<setting title="SPEED" path="/benchmark/cdu/speed" format="%.0f" nil-value="---"/>
+					<setting title="ALTITUDE" path="/benchmark/cdu/altitude" format="%05.0f" nil-value="-----"/>
+					<setting title="VERT SPEED" path="/benchmark/cdu/vertical-speed" format="%+.0f" nil-value="----"/>
+					<goto title="OTHER" page-id="other"/>
+					<fill/>
+				</left>
+				<right>
+					<setting title="HEADING" path="/benchmark/cdu/heading" format="%03.0f" nil-value="---"/>
+					<setting title="QNH" path="/benchmark/cdu/qnh" format="%.2f" nil-value="--.--"/>
+					<setting title="FUEL" path="/benchmark/cdu/fuel" format="%.1f" nil-value="--.-"/>
+					<fill/>
+				</right>
+			</page>
+			<page id="other" title="OTHER PAGE">
+				<left>
+					<goto title="BACK" page-id="main"/>
+					<fill/>
+				</left>
+			</page>
+		</pages>
+	</module>
+)";
+
+
+static xf::Benchmark cdu_values ("instruments/cdu/values", [](Benchmark& benchmark) {
+	QDomDocument doc;
+	doc.setContent (QString (CDUConfig));
+
+	PropertyFloat speed (PropertyPath ("/benchmark/cdu/speed"));
+	PropertyFloat altitude (PropertyPath ("/benchmark/cdu/altitude"));
+	PropertyFloat vertical_speed (PropertyPath ("/benchmark/cdu/vertical-speed"));
+	PropertyFloat heading (PropertyPath ("/benchmark/cdu/heading"));
+	PropertyFloat qnh (PropertyPath ("/benchmark/cdu/qnh"));
+	PropertyFloat fuel (PropertyPath ("/benchmark/cdu/fuel"));
+
+	for (QSize const& size: BenchmarkAids::instrument_sizes())
+	{
+		CDU cdu (nullptr, doc.documentElement());
+		cdu.resize (size);
+		QImage canvas (size, QImage::Format_ARGB32_Premultiplied);
+
+		benchmark.measure (BenchmarkAids::size_name (size), CDUFrames, [&](unsigned int frame) {
+			speed.write (100.0 + 0.5 * frame);
+			altitude.write (3000.0 + 10.0 * frame);
+			vertical_speed.write (500.0 * std::sin (0.05 * frame));
+			heading.write (std::fmod (3.0 * frame, 360.0));
+			qnh.write (29.92);
+			fuel.write (120.0 - 0.1 * frame);
+			cdu.data_updated();
+			cdu.cdu_widget()->paint_offscreen (canvas, size);
+		}, [&] {
+			return BenchmarkAids::cache_stats (cdu.cdu_widget()->paint_work_unit()->text_painter_cache());
+		});
+	}
+});
+
+} // namespace Benchmarks
+} // namespace Xefis
+
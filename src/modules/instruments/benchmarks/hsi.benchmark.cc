@@ -0,0 +1,167 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+#include <memory>
+
+// Qt:
+#include <QtGui/QImage>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/benchmark/benchmark.h>
+#include <xefis/benchmark/benchmark_aids.h>
+#include <xefis/core/navaid_storage.h>
+
+// Local:
+#include "../hsi_widget.h"
+
+
+namespace Xefis {
+namespace Benchmarks {
+
+constexpr unsigned int HSIFrames = 200;
+
+
+/**
+ * Navaid storage loaded from share/nav, shared by all HSI benchmarks.
+ * Return nullptr if navaids couldn't be loaded (eg. benchmark not run from
+ * the top directory).
+ */
+static NavaidStorage*
+hsi_navaid_storage()
+{
+	static Unique<NavaidStorage> storage;
+	static bool tried = false;
+
+	if (!tried)
+	{
+		tried = true;
+		try {
+			auto s = std::make_unique<NavaidStorage>();
+			s->load();
+			storage = std::move (s);
+		}
+		catch (...)
+		{
+			std::cout << "# navaids not available, map benchmarks will paint without navaids" << std::endl;
+		}
+	}
+
+	return storage.get();
+}
+
+
+/**
+ * Parameters for a map display over a dense navaid area (around EDDF).
+ */
+static HSIWidget::Parameters
+hsi_map_params()
+{
+	HSIWidget::Parameters p;
+	p.display_mode = HSIWidget::DisplayMode::Expanded;
+	p.range = 40_nmi;
+	p.heading_visible = true;
+	p.heading_magnetic = 270_deg;
+	p.heading_true = 272_deg;
+	p.ap_visible = true;
+	p.ap_heading_magnetic = 280_deg;
+	p.track_visible = true;
+	p.track_magnetic = 268_deg;
+	p.course_visible = true;
+	p.course_setting_magnetic = 250_deg;
+	p.course_deviation = 1_deg;
+	p.course_to_flag = true;
+	p.ground_speed = 250_kt;
+	p.true_air_speed = 260_kt;
+	p.track_lateral_rotation = 0.5_deg / 1_s;
+	p.wind_information_visible = true;
+	p.wind_from_magnetic_heading = 300_deg;
+	p.wind_tas_speed = 25_kt;
+	p.position_valid = true;
+	p.position = LonLat (8.57_deg, 50.03_deg);
+	p.navaids_visible = true;
+	p.fix_visible = true;
+	p.vor_visible = true;
+	p.dme_visible = true;
+	p.ndb_visible = true;
+	p.loc_visible = true;
+	p.arpt_visible = true;
+	p.arpt_runways_range_threshold = 6_nmi;
+	p.arpt_map_range_threshold = 2_nmi;
+	p.arpt_runway_extension_length = 10_nmi;
+	p.trend_vector_times = { { 30_s, 60_s, 90_s } };
+	p.trend_vector_min_ranges = { { 5_nmi, 10_nmi, 15_nmi } };
+	p.trend_vector_max_range = 30_nmi;
+	return p;
+}
+
+
+/**
+ * Render frames of the HSI at all standard sizes, changing params for each frame
+ * with the update function.
+ */
+static void
+run_hsi_sweep (Benchmark& benchmark, NavaidStorage* navaid_storage, std::function<void (HSIWidget::Parameters&, unsigned int frame)> update)
+{
+	for (QSize const& size: BenchmarkAids::instrument_sizes())
+	{
+		HSIWidget widget (nullptr, nullptr);
+		widget.set_navaid_storage (navaid_storage);
+		QImage canvas (size, QImage::Format_ARGB32_Premultiplied);
+		HSIWidget::Parameters params = hsi_map_params();
+
+		benchmark.measure (BenchmarkAids::size_name (size), HSIFrames, [&](unsigned int frame) {
+			update (params, frame);
+			widget.set_params (params);
+			widget.paint_offscreen (canvas, size);
+		}, [&] {
+			return BenchmarkAids::cache_stats (widget.paint_work_unit()->text_painter_cache());
+		});
+	}
+}
+
+
+static xf::Benchmark hsi_heading ("instruments/hsi/heading", [](Benchmark& benchmark) {
+	run_hsi_sweep (benchmark, nullptr, [](HSIWidget::Parameters& p, unsigned int frame) {
+		p.heading_magnetic = 1_deg * (0.9 * frame);
+		p.heading_true = p.heading_magnetic + 2_deg;
+		p.track_magnetic = p.heading_magnetic - 2_deg;
+	});
+});
+
+
+static xf::Benchmark hsi_dense_map ("instruments/hsi/dense-map", [](Benchmark& benchmark) {
+	run_hsi_sweep (benchmark, hsi_navaid_storage(), [](HSIWidget::Parameters& p, unsigned int frame) {
+		// Fly west at about 250 kt with a slow turn, one frame per second of flight:
+		p.position = LonLat (1_deg * (8.57 - 0.0011 * frame), 1_deg * (50.03 + 0.0002 * frame));
+		p.heading_magnetic = 1_deg * (270.0 + 0.2 * frame);
+		p.heading_true = p.heading_magnetic + 2_deg;
+		p.track_magnetic = p.heading_magnetic - 2_deg;
+	});
+});
+
+
+static xf::Benchmark hsi_range_changes ("instruments/hsi/range-changes", [](Benchmark& benchmark) {
+	run_hsi_sweep (benchmark, hsi_navaid_storage(), [](HSIWidget::Parameters& p, unsigned int frame) {
+		static Length const ranges[] = { 5_nmi, 10_nmi, 20_nmi, 40_nmi, 80_nmi };
+		p.range = ranges[(frame / 20) % countof (ranges)];
+	});
+});
+
+} // namespace Benchmarks
+} // namespace Xefis
+
@@ -28,7 +28,6 @@
 #include <xefis/core/window.h>
 #include <xefis/core/stdexcept.h>
 #include <xefis/utility/qdom.h>
-#include <xefis/utility/text_layout.h>
 
 // Local:
 #include "cdu.h"
@@ -37,9 +36,6 @@
 XEFIS_REGISTER_MODULE_CLASS ("instruments/cdu", CDU)
 
 
-constexpr double CDU::kButtonWidthForHeight;
-
-
 CDU::Strip::Strip (CDU& cdu, QString const& title, Column column):
 	_cdu (cdu),
 	_title (title),
@@ -62,9 +58,10 @@ CDU::Strip::column() const noexcept
 
 
 void
-CDU::Strip::set_rect (QRectF const& rect)
+CDU::Strip::set_rects (CDUWidget::StripRects const& rects)
 {
-	_rect = rect;
+	_rect = rects.rect;
+	_button_rect = rects.button_rect;
 }
 
 
@@ -75,6 +72,13 @@ CDU::Strip::rect() const noexcept
 }
 
 
+QRectF const&
+CDU::Strip::button_rect() const noexcept
+{
+	return _button_rect;
+}
+
+
 CDU&
 CDU::Strip::cdu() const noexcept
 {
@@ -89,234 +93,17 @@ CDU::Strip::fresh() const noexcept
 }
 
 
-void
-CDU::Strip::paint (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column, bool focused)
-{
-	QPen focus_pen = aids._autopilot_pen_2;
-	double fpw = 0.5 * focus_pen.width();
-	double top_bottom_margin = 4.0 * fpw;
-	QRectF inner_rect = rect.adjusted (fpw, fpw, -fpw, -fpw);
-
-	// Compute rects:
-
-	QRectF button_rect;
-	QSizeF button_size (kButtonWidthForHeight * inner_rect.height(), inner_rect.height());
-	switch (column)
-	{
-		case Column::Left:
-			button_rect = QRectF (inner_rect.topLeft(), button_size);
-			break;
-
-		case Column::Right:
-			button_rect = QRectF (inner_rect.topRight() - QPointF (button_size.width(), 0.0), button_size);
-			break;
-	}
-	button_rect.adjust (0.0, top_bottom_margin, 0.0, -top_bottom_margin);
-
-	double dw = button_rect.width() + aids.pen_width (10.0);
-	double kw = rect.width() - dw;
-	QRectF title_rect (QPointF (0.0, 0.0), QSizeF (kw, aids._font_16_digit_height));
-	QRectF value_rect (QPointF (0.0, 0.0), QSizeF (kw, aids._font_20_digit_height));
-	switch (column)
-	{
-		case Column::Left:
-			value_rect.moveTopLeft (QPointF (rect.left() + dw, button_rect.center().y() - 0.5 * value_rect.height()));
-			title_rect.moveBottomLeft (QPointF (value_rect.left() + aids.pen_width (10.0), value_rect.top() - aids.pen_width (5.0)));
-			break;
-
-		case Column::Right:
-			value_rect.moveTopRight (QPointF (rect.right() - dw, button_rect.center().y() - 0.5 * value_rect.height()));
-			title_rect.moveBottomRight (QPointF (value_rect.right() - aids.pen_width (10.0), value_rect.top() - aids.pen_width (5.0)));
-			break;
-	}
-
-	// Draw parts:
-	paint_button (button_rect, aids, painter, column, focused);
-	paint_title (title_rect, aids, painter, column, focused);
-	paint_value (value_rect, aids, painter, column, focused);
-
-	// Focus:
-	if (focused)
-		paint_focus (rect, button_rect.adjusted (-fpw, -fpw, fpw, fpw), aids, painter, column);
-}
-
-
-void
-CDU::Strip::paint_button_helper (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column, ButtonState state)
-{
-	QRectF btn_rect (rect.topLeft(), QSizeF (0.6 * rect.width(), rect.height()));
-	if (column == Column::Right)
-		btn_rect.translate (rect.width() - btn_rect.width(), 0.0);
-
-	double adj_2 = aids.pen_width (1.0);
-	double adj_3 = aids.pen_width (2.25);
-	double swh = std::min (btn_rect.width(), btn_rect.height());
-	QRectF rect_2 = btn_rect.adjusted (adj_2, adj_2, -adj_2, -adj_2);
-	QRectF rect_3 = btn_rect.adjusted (adj_3, adj_3, -adj_3, -adj_3);
-	QPointF point_delta (0.5 * swh, -0.5 * swh);
-	QPointF point_l = btn_rect.bottomLeft() + point_delta;
-	QPointF point_r = btn_rect.topRight() - point_delta;
-	// White line:
-	QPointF pa, pb;
-	switch (column)
-	{
-		case Column::Left:
-			pa = QPointF (btn_rect.right(), btn_rect.center().y());
-			pb = QPointF (btn_rect.right() + 0.35 * rect.width(), pa.y());
-			break;
-
-		case Column::Right:
-			pa = QPointF (btn_rect.left(), btn_rect.center().y());
-			pb = QPointF (btn_rect.left() - 0.35 * rect.width(), pa.y());
-			break;
-	}
-
-	switch (state)
-	{
-		case ButtonState::Normal:
-		case ButtonState::Pressed:
-		{
-			// White line:
-			painter.setPen (aids.get_pen (Qt::white, 1.0));
-			painter.add_shadow (2.0, [&] {
-				painter.drawLine (pa, pb);
-			});
-
-			QColor highlight_color (0xcc, 0xcc, 0xcc);
-			QColor shadow_color (0x55, 0x55, 0x55);
-			QColor face_color (0x88, 0x88, 0x88);
-			if (state == ButtonState::Pressed)
-			{
-				std::swap (highlight_color, shadow_color);
-				shadow_color = shadow_color.darker (150);
-				face_color = face_color.darker (125);
-			}
-
-			// Backgorund/frame:
-			painter.setPen (Qt::NoPen);
-			painter.fillRect (btn_rect, Qt::black);
-			// Highlight:
-			painter.setBrush (highlight_color);
-			painter.drawPolygon (QPolygonF (QVector<QPointF> { rect_2.topLeft(), rect_2.topRight(), point_r, point_l, rect_2.bottomLeft() }));
-			// Shadow:
-			painter.setBrush (shadow_color);
-			painter.drawPolygon (QPolygonF (QVector<QPointF> { rect_2.topRight(), rect_2.bottomRight(), rect_2.bottomLeft(), point_l, point_r }));
-			// Face:
-			painter.fillRect (rect_3, face_color);
-			break;
-		}
-
-		case ButtonState::Disabled:
-		{
-			QColor cyan (0x22, 0xcc, 0xff);
-			painter.setPen (aids.get_pen (cyan, 1.0));
-			painter.setBrush (Qt::NoBrush);
-			painter.add_shadow (2.0, [&] {
-				painter.drawLine (pa, pb);
-				painter.drawRect (rect_2);
-			});
-			break;
-		}
-	}
-}
-
-
-void
-CDU::Strip::paint_title_helper (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column, QString const& title, QColor color)
+xf::PropertyNode::Serial
+CDU::Strip::serial() const noexcept
 {
-	Qt::Alignment title_alignment;
-
-	switch (column)
-	{
-		case Column::Left:
-			title_alignment = Qt::AlignVCenter | Qt::AlignLeft;
-			break;
-
-		case Column::Right:
-			title_alignment = Qt::AlignVCenter | Qt::AlignRight;
-			break;
-	}
-
-	painter.setFont (aids._font_13);
-	painter.setPen (aids.get_pen (color, 1.0));
-	painter.fast_draw_text (rect, title_alignment, title);
+	return 0;
 }
 
 
-void
-CDU::Strip::paint_value_helper (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column, QString const& value, QColor color)
+CDUWidget::Strip
+CDU::Strip::params (bool)
 {
-	Qt::Alignment value_alignment;
-
-	switch (column)
-	{
-		case Column::Left:
-			value_alignment = Qt::AlignVCenter | Qt::AlignLeft;
-			break;
-
-		case Column::Right:
-			value_alignment = Qt::AlignVCenter | Qt::AlignRight;
-			break;
-	}
-
-	painter.setFont (aids._font_20);
-	painter.setPen (aids.get_pen (color, 1.0));
-	painter.fast_draw_text (rect, value_alignment, value);
-}
-
-
-void
-CDU::Strip::paint_focus_helper (QRectF const& rect, QRectF const& button_rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column)
-{
-	QRectF const& r = button_rect;
-	QPolygonF polygon;
-
-	double r_left = 0.0;
-	double rect_right = 0.0;
-	double r_width = 0.0;
-	QPointF r_topLeft;
-	QPointF r_bottomLeft;
-
-	switch (column)
-	{
-		case Column::Left:
-		{
-			r_left = r.left();
-			rect_right = rect.right();
-			r_width = r.width();
-			r_topLeft = r.topLeft();
-			r_bottomLeft = r.bottomLeft();
-			break;
-		}
-
-		case Column::Right:
-		{
-			r_left = r.right();
-			rect_right = rect.left();
-			r_width = -r.width();
-			r_topLeft = r.topRight();
-			r_bottomLeft = r.bottomRight();
-			break;
-		}
-	}
-
-	double rx = r_left + 0.61 * r_width;
-	double ry1 = r.top() + 0.2 * r.height();
-	double ry2 = r.top() + 0.8 * r.height();
-	polygon
-		<< r_topLeft
-		<< QPointF (rx, r.top())
-		<< QPointF (rx, ry1)
-		<< QPointF (rect_right, ry1)
-		<< QPointF (rect_right, ry2)
-		<< QPointF (rx, ry2)
-		<< QPointF (rx, r.bottom())
-		<< r_bottomLeft;
-	polygon << polygon[0];
-
-	painter.setPen (aids._autopilot_pen_2);
-	painter.setBrush (Qt::NoBrush);
-	painter.drawPolyline (polygon);
+	return CDUWidget::Strip();
 }
 
 
@@ -325,13 +112,6 @@ CDU::EmptyStrip::EmptyStrip (CDU& cdu, Column column):
 { }
 
 
-void
-CDU::EmptyStrip::paint_button (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column, bool)
-{
-	paint_button_helper (rect, aids, painter, column, ButtonState::Disabled);
-}
-
-
 CDU::SettingStrip::SettingStrip (CDU& cdu, QDomElement const& setting_element, Column column):
 	Strip (cdu, setting_element.attribute ("title"), column)
 {
@@ -358,11 +138,18 @@ CDU::SettingStrip::fresh() const noexcept
 }
 
 
+xf::PropertyNode::Serial
+CDU::SettingStrip::serial() const noexcept
+{
+	return _property.serial();
+}
+
+
 void
 CDU::SettingStrip::handle_mouse_press (QMouseEvent* event, CDU*)
 {
 	if (!_read_only)
-		if (_button_rect.contains (event->pos()))
+		if (button_rect().contains (event->pos()))
 			_button_state = ButtonState::Pressed;
 }
 
@@ -373,7 +160,7 @@ CDU::SettingStrip::handle_mouse_release (QMouseEvent* event, CDU* cdu)
 	_button_state = ButtonState::Normal;
 
 	if (!_read_only &&
-		_button_rect.contains (event->pos()) &&
+		button_rect().contains (event->pos()) &&
 		_property.configured())
 	{
 		if (_property.is_type<bool>())
@@ -425,104 +212,58 @@ CDU::SettingStrip::handle_mouse_release (QMouseEvent* event, CDU* cdu)
 }
 
 
-void
-CDU::SettingStrip::paint_button (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column, bool)
-{
-	_button_rect = rect;
-	ButtonState button_state = ButtonState::Normal;
-	if (_read_only)
-		button_state = ButtonState::Disabled;
-	else if (_button_rect.contains (cdu().mapFromGlobal (QCursor::pos())))
-		button_state = _button_state;
-	paint_button_helper (rect, aids, painter, column, button_state);
-}
-
-
-void
-CDU::SettingStrip::paint_title (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column, bool)
+CDUWidget::Strip
+CDU::SettingStrip::params (bool focused)
 {
-	paint_title_helper (rect, aids, painter, column, title(), QColor (0xcc, 0xd7, 0xe7));
-}
+	CDUWidget::Strip params;
+	params.focused = focused && !_read_only;
+	params.title = title();
+	params.title_color = QColor (0xcc, 0xd7, 0xe7);
 
+	if (_read_only)
+		params.button_state = ButtonState::Disabled;
+	else if (button_rect().contains (cdu().mapFromGlobal (QCursor::pos())))
+		params.button_state = _button_state;
+	else
+		params.button_state = ButtonState::Normal;
 
-void
-CDU::SettingStrip::paint_value (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column, bool)
-{
 	if (_property.valid())
 	{
 		if (_property.is_type<bool>())
 		{
 			bool p = *static_cast<xf::PropertyBoolean&> (_property);
-			std::string const act_val = p ? _true_value : _false_value;
-			std::string const inact_val = p ? _false_value : _true_value;
-
-			xf::TextLayout tl;
-			tl.set_alignment (Qt::AlignCenter);
-			tl.set_background (Qt::NoBrush);
-
-			switch (column)
-			{
-				case Column::Left:
-					tl.add_fragment (inact_val, aids._font_13, Qt::white);
-					tl.add_fragment ("\u2008⬌\u2008", aids._font_20, Qt::white);
-					tl.add_fragment (act_val, aids._font_20, Qt::green);
-					tl.paint (QPointF (rect.left(), rect.center().y()), Qt::AlignLeft | Qt::AlignVCenter, painter);
-					break;
-
-				case Column::Right:
-					tl.add_fragment (act_val, aids._font_20, Qt::green);
-					tl.add_fragment ("\u2008⬌\u2008", aids._font_20, Qt::white);
-					tl.add_fragment (inact_val, aids._font_13, Qt::white);
-					tl.paint (QPointF (rect.right(), rect.center().y()), Qt::AlignRight | Qt::AlignVCenter, painter);
-					break;
-			}
+			params.value_type = CDUWidget::Strip::Value::Switch;
+			params.value = QString::fromStdString (p ? _true_value : _false_value);
+			params.inactive_value = QString::fromStdString (p ? _false_value : _true_value);
 		}
 		else
 		{
-			QColor str_color = _read_only ? QColor (0x22, 0xcc, 0xff) : Qt::white;
-			QString str_val;
+			params.value_type = CDUWidget::Strip::Value::Text;
+			params.value_color = _read_only ? QColor (0x22, 0xcc, 0xff) : Qt::white;
+
 			try {
-				str_val = QString::fromStdString (_property.stringify (boost::format (_format), _unit, _nil_value));
+				params.value = QString::fromStdString (_property.stringify (boost::format (_format), _unit, _nil_value));
 			}
 			catch (xf::StringifyError const& exception)
 			{
-				str_color = Qt::red;
-				str_val = exception.what();
+				params.value_color = Qt::red;
+				params.value = exception.what();
 			}
 			catch (boost::io::bad_format_string const&)
 			{
-				str_color = Qt::red;
-				str_val = "format: ill formed";
+				params.value_color = Qt::red;
+				params.value = "format: ill formed";
 			}
-
-			paint_value_helper (rect, aids, painter, column, str_val, str_color);
 		}
 	}
 	else if (!_unit.empty())
 	{
-		bool left = column == Column::Left;
 		// At least paint information about units.
-		auto horz_alignment = left ? Qt::AlignLeft : Qt::AlignRight;
-		QPointF position {
-			(column == Column::Left) ? rect.left() : rect.right(),
-			rect.center().y()
-		};
-		std::string text = left ? ("― [" + _unit + "]") : ("[" + _unit + "] ―");
-
-		xf::TextLayout tl;
-		tl.set_alignment (Qt::AlignCenter);
-		tl.set_background (Qt::NoBrush);
-		tl.add_fragment (text, aids._font_13, Qt::gray);
-		tl.paint (position, horz_alignment | Qt::AlignVCenter, painter);
+		params.value_type = CDUWidget::Strip::Value::Unit;
+		params.value = QString::fromStdString (column() == Column::Left ? ("― [" + _unit + "]") : ("[" + _unit + "] ―"));
 	}
-}
 
-
-void
-CDU::SettingStrip::paint_focus (QRectF const& rect, QRectF const& button_rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column)
-{
-	if (!_read_only)
-		paint_focus_helper (rect, button_rect, aids, painter, column);
+	return params;
 }
 
 
@@ -546,7 +287,7 @@ CDU::GotoStrip::target_page_id() const noexcept
 void
 CDU::GotoStrip::handle_mouse_press (QMouseEvent* event, CDU*)
 {
-	if (_button_rect.contains (event->pos()))
+	if (button_rect().contains (event->pos()))
 		_button_state = ButtonState::Pressed;
 }
 
@@ -556,31 +297,22 @@ CDU::GotoStrip::handle_mouse_release (QMouseEvent* event, CDU* cdu)
 {
 	_button_state = ButtonState::Normal;
 
-	if (_button_rect.contains (event->pos()))
+	if (button_rect().contains (event->pos()))
 		cdu->switch_page (_target_page_id);
 }
 
 
-void
-CDU::GotoStrip::paint_button (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column, bool)
-{
-	_button_rect = rect;
-	bool over_button = _button_rect.contains (cdu().mapFromGlobal (QCursor::pos()));
-	paint_button_helper (rect, aids, painter, column, over_button ? _button_state : ButtonState::Normal);
-}
-
-
-void
-CDU::GotoStrip::paint_value (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column, bool)
+CDUWidget::Strip
+CDU::GotoStrip::params (bool focused)
 {
-	paint_value_helper (rect, aids, painter, column, title(), Qt::white);
-}
-
-
-void
-CDU::GotoStrip::paint_focus (QRectF const& rect, QRectF const& button_rect, xf::InstrumentAids& aids, xf::Painter& painter, Column column)
-{
-	paint_focus_helper (rect, button_rect, aids, painter, column);
+	CDUWidget::Strip params;
+	params.focused = focused;
+	bool over_button = button_rect().contains (cdu().mapFromGlobal (QCursor::pos()));
+	params.button_state = over_button ? _button_state : ButtonState::Normal;
+	params.value_type = CDUWidget::Strip::Value::Text;
+	params.value = title();
+	params.value_color = Qt::white;
+	return params;
 }
 
 
@@ -752,6 +484,16 @@ CDU::Page::scan_properties() const noexcept
 }
 
 
+xf::PropertyNode::Serial
+CDU::Page::serial() const noexcept
+{
+	xf::PropertyNode::Serial result = 0;
+	for (auto const& strip: _strips)
+		result += strip->serial();
+	return result;
+}
+
+
 bool
 CDU::Page::handle_mouse_move (QMouseEvent* event)
 {
@@ -796,50 +538,27 @@ CDU::Page::handle_mouse_release (QMouseEvent* event, CDU* cdu)
 
 
 void
-CDU::Page::paint (QRectF const& rect, xf::InstrumentAids& aids, xf::Painter& painter)
+CDU::Page::set_layout (CDUWidget::Layout const& layout)
 {
-	auto paint_column = [&] (Column column, QRectF const& column_rect, Page::Strips const& strips)
-	{
-		std::size_t n = strips.size();
-		QSizeF size (column_rect.width(), column_rect.height() / n);
-
-		for (std::size_t i = 0; i < n; ++i)
-		{
-			auto const& strip = strips[i];
-			QRectF strip_rect (QPointF (column_rect.left(), column_rect.top() + i * size.height()), size);
-			strip->set_rect (strip_rect);
-			strip->paint (strip_rect, aids, painter, column, _focused_strip == strip);
-		}
-	};
+	for (std::size_t i = 0; i < _strips_left.size(); ++i)
+		_strips_left[i]->set_rects (layout.strips_left[i]);
 
-	double title_height = 2.25 * aids._font_20_digit_height;
-	QRectF strips_rect = rect.adjusted (0.0, title_height, 0.0, 0.0);
-	double strip_height = strips_rect.height() / std::max (strips_left().size(), strips_right().size());
-	QRectF black_rect = rect.adjusted (kButtonWidthForHeight * strip_height, 0.0, -kButtonWidthForHeight * strip_height, 0.0);
-	QSizeF half_size (0.5 * strips_rect.width(), strips_rect.height());
-	_bb_margin = black_rect.left();
-
-	// Black rect:
-	painter.setFont (aids._font_20);
-	painter.setPen (aids.get_pen (QColor (0xbb, 0xbb, 0xbb), 1.0));
-	painter.setBrush (Qt::black);
-	painter.drawRect (black_rect);
-
-	// Page title:
-	painter.setPen (aids.get_pen (Qt::white, 1.0));
-	painter.fast_draw_text (QPointF (rect.center().x(), rect.top() + 0.35 * title_height),
-							  Qt::AlignHCenter | Qt::AlignVCenter,
-							  title());
-
-	paint_column (Column::Left, QRectF (strips_rect.topLeft(), half_size), strips_left());
-	paint_column (Column::Right, QRectF (QPointF (strips_rect.left() + 0.5 * strips_rect.width(), strips_rect.top()), half_size), strips_right());
+	for (std::size_t i = 0; i < _strips_right.size(); ++i)
+		_strips_right[i]->set_rects (layout.strips_right[i]);
 }
 
 
-double
-CDU::Page::bb_margin() const noexcept
+void
+CDU::Page::set_params (CDUWidget::Parameters& params)
 {
-	return _bb_margin;
+	params.page_visible = true;
+	params.page_title = title();
+
+	for (Strip* strip: _strips_left)
+		params.strips_left.push_back (strip->params (strip == _focused_strip));
+
+	for (Strip* strip: _strips_right)
+		params.strips_right.push_back (strip->params (strip == _focused_strip));
 }
 
 
@@ -885,6 +604,16 @@ CDU::Config::scan_properties() const noexcept
 }
 
 
+xf::PropertyNode::Serial
+CDU::Config::serial() const noexcept
+{
+	xf::PropertyNode::Serial result = 0;
+	for (auto page: _pages_by_id)
+		result += page.second->serial();
+	return result;
+}
+
+
 QString
 CDU::Config::default_page_id() const noexcept
 {
@@ -982,15 +711,31 @@ CDU::CDU (xf::ModuleManager* module_manager, QDomElement const& config):
 		{ "time.utc", _time_utc, false },
 	});
 
-	update();
+	// Without module manager (eg. in benchmarks) the widget can only be painted offscreen:
+	_cdu_widget = new CDUWidget (this, module_manager ? work_performer() : nullptr);
+
+	QVBoxLayout* layout = new QVBoxLayout (this);
+	layout->setMargin (0);
+	layout->setSpacing (0);
+	layout->addWidget (_cdu_widget);
+
+	update_layout();
+	update_widget();
 }
 
 
 void
 CDU::data_updated()
 {
-	if (_config->scan_properties())
-		update();
+	if (_config->scan_properties() || _time_utc.fresh())
+		update_widget();
+}
+
+
+xf::PropertyNode::Serial
+CDU::input_serial() const
+{
+	return xf::Instrument::input_serial() + _config->serial();
 }
 
 
@@ -998,7 +743,7 @@ void
 CDU::post_message (QString const& message)
 {
 	_messages.push_back (message);
-	update();
+	update_widget();
 }
 
 
@@ -1010,51 +755,7 @@ CDU::resizeEvent (QResizeEvent*)
 		set_scaling (xw->pen_scale(), xw->font_scale());
 
 	InstrumentAids::update_sizes (size(), window()->size());
-}
-
-
-void
-CDU::paintEvent (QPaintEvent*)
-{
-	auto painting_token = get_token (this);
-	clear_background (QColor (0x55, 0x63, 0x71));
-
-	double y_margin = 1.4 * _font_16.pixelSize();
-	double x_margin = 0.3 * y_margin;
-
-	QRectF entry_rect = rect();
-	entry_rect.setTop (5.0 / 7.0 * size().height());
-
-	QRectF strips_rect = rect();
-	strips_rect.setBottom (entry_rect.top());
-
-	entry_rect.adjust (x_margin, 0.0, -x_margin, -x_margin);
-	strips_rect.adjust (x_margin, y_margin, -x_margin, -x_margin);
-
-	// Paint date and time:
-	if (_time_utc.configured())
-	{
-		QString time_str = "NO TIME INFO";
-		QString date_str = "";
-
-		if (_time_utc.valid())
-		{
-			QDateTime datetime = QDateTime::fromTime_t (_time_utc->quantity<Second>());
-			datetime.setTimeZone (QTimeZone (0));
-			time_str = datetime.time().toString ("HH:mm:ss") + " z";
-			date_str = datetime.date().toString ("d MMM yy").toUpper();
-		}
-
-		double dy = 0.475 * (rect().top() + strips_rect.top());
-		double dx = 0.2 * dy;
-		painter().setFont (_font_16);
-		painter().setPen (get_pen (Qt::white, 1.0));
-		painter().fast_draw_text (rect().topLeft() + QPointF (dx, dy), Qt::AlignLeft | Qt::AlignVCenter, time_str);
-		painter().fast_draw_text (rect().topRight() + QPointF (-dx, dy), Qt::AlignRight | Qt::AlignVCenter, date_str);
-	}
-
-	paint_strips_area (strips_rect);
-	paint_entry_area (entry_rect);
+	update_layout();
 }
 
 
@@ -1077,7 +778,7 @@ CDU::keyPressEvent (QKeyEvent* event)
 			_entry_value += event->text();
 	}
 
-	update();
+	update_widget();
 }
 
 
@@ -1095,7 +796,7 @@ CDU::mouseMoveEvent (QMouseEvent* event)
 	if (page)
 	{
 		if (page->handle_mouse_move (event))
-			update();
+			update_widget();
 	}
 }
 
@@ -1105,7 +806,7 @@ CDU::mousePressEvent (QMouseEvent* event)
 {
 	Page* page = current_page();
 	if (page && page->handle_mouse_press (event, this))
-		update();
+		update_widget();
 }
 
 
@@ -1114,105 +815,61 @@ CDU::mouseReleaseEvent (QMouseEvent* event)
 {
 	Page* page = current_page();
 	if (page && page->handle_mouse_release (event, this))
-		update();
+		update_widget();
 }
 
 
 void
-CDU::paint_strips_area (QRectF const& rect)
+CDU::focusInEvent (QFocusEvent*)
+{
+	update_widget();
+}
+
+
+void
+CDU::focusOutEvent (QFocusEvent*)
+{
+	update_widget();
+}
+
+
+void
+CDU::update_layout()
 {
 	Page* page = current_page();
 	if (page)
-		page->paint (rect, *this, painter());
+		page->set_layout (CDUWidget::Layout (rect(), *this, page->strips_left().size(), page->strips_right().size()));
 }
 
 
 void
-CDU::paint_entry_area (QRectF const& rect)
+CDU::update_widget()
 {
-	QColor cyan = QColor (0x00, 0xb0, 0xcf);
-	double ww = 0.16 * _font_20_digit_height;
-	double lh = 1.0 * _font_20_digit_height;
-	double bb = current_page() ? current_page()->bb_margin() : 0.0;
-
-	// Entry box:
-	QRectF entry_rect = rect;
-	entry_rect.setLeft (bb);
-	entry_rect.setRight (this->rect().right() - bb);
-	entry_rect.setTop (rect.top());
-	entry_rect.setHeight (1.8 * _font_20_digit_height);
-	QRectF text_rect = entry_rect.adjusted (ww, 0.0, -ww, 0.0);
-	painter().setFont (_font_20);
-	QColor color (0xbb, 0xbb, 0xbb);
-	if (hasFocus())
-		color = Qt::white;
-	painter().setPen (get_pen (color, 1.0));
-	painter().setBrush (Qt::black);
-	painter().drawRect (entry_rect);
-	painter().setFont (_font_20);
-	painter().setPen (get_pen (Qt::white, 1.0));
-	QFontMetrics metrics (_font_20);
-	if (metrics.width (_entry_value) > text_rect.width())
-	{
-		painter().setClipRect (text_rect);
-		painter().fast_draw_text (QPointF (text_rect.right(), text_rect.center().y()),
-								  Qt::AlignRight | Qt::AlignVCenter, _entry_value);
-	}
-	else
-		painter().fast_draw_text (QPointF (text_rect.left(), text_rect.center().y()),
-								  Qt::AlignLeft | Qt::AlignVCenter, _entry_value);
-	painter().setClipping (false);
-
-	// Message board:
-	QRectF msgbrd_rect = entry_rect;
-	msgbrd_rect.moveTop (entry_rect.bottom() + lh);
-	msgbrd_rect.setBottom (rect.bottom());
-	painter().setPen (Qt::NoPen);
-	painter().setBrush (Qt::black);
-	painter().drawRect (msgbrd_rect);
-
-	// Msg board title:
-	QRectF msgbrd_title = msgbrd_rect;
-	msgbrd_title.setBottom (msgbrd_title.top() + 2.0 * _font_16_digit_height);
-	msgbrd_title.setRight (msgbrd_title.right() - 6.0 * _font_20_digit_height);
-	painter().setFont (_font_16);
-	painter().fillRect (msgbrd_title, cyan);
-	painter().setPen (get_pen (Qt::white, 1.0));
-	painter().fast_draw_text (msgbrd_title, Qt::AlignCenter, "MESSAGE TITLE");
-
-	// Msg board right panel:
-	QRectF msgbrd_rpanel = msgbrd_rect;
-	msgbrd_rpanel.setLeft (msgbrd_title.right() - 1.0);
-	painter().fillRect (msgbrd_rpanel, cyan);
-
-	// Message texts panel:
-	QRectF msgbrd_texts = msgbrd_rect;
-	msgbrd_texts.setTop (msgbrd_title.bottom());
-	msgbrd_texts.setRight (msgbrd_rpanel.left());
-	msgbrd_texts.adjust (ww, 0.0, -ww, -ww);
-	painter().setClipRect (msgbrd_texts);
-	painter().setFont (_font_16);
-	painter().setPen (get_pen (Qt::white, 1.0));
-
-	double msg_height = 1.25 * _font_20_digit_height;
-	QRectF virtual_texts_frame = msgbrd_texts;
-	virtual_texts_frame.setHeight (_messages.size() * msg_height);
-	if (virtual_texts_frame.height() > msgbrd_texts.height())
-		virtual_texts_frame.moveBottom (msgbrd_texts.bottom());
-
-	for (std::size_t i = 0; i < _messages.size(); ++i)
+	CDUWidget::Parameters params;
+
+	if (_time_utc.configured())
 	{
-		QPointF hook = virtual_texts_frame.topLeft() + i * QPointF (0.0, msg_height);
-		if (hook.y() + msg_height < msgbrd_texts.top())
-			continue;
-		painter().fast_draw_text (hook, Qt::AlignTop | Qt::AlignLeft, QString ("%1: %2").arg (i + 1, 2, 10, QChar ('0')).arg (_messages[i]));
+		params.time_visible = true;
+		params.time = "NO TIME INFO";
+
+		if (_time_utc.valid())
+		{
+			QDateTime datetime = QDateTime::fromTime_t (_time_utc->quantity<Second>());
+			datetime.setTimeZone (QTimeZone (0));
+			params.time = datetime.time().toString ("HH:mm:ss") + " z";
+			params.date = datetime.date().toString ("d MMM yy").toUpper();
+		}
 	}
 
-	// Draw msg board outline:
-	painter().setClipping (false);
-	painter().setPen (get_pen (Qt::white, 1.0));
-	painter().setBrush (Qt::NoBrush);
-	painter().drawRect (msgbrd_rect);
+	Page* page = current_page();
+	if (page)
+		page->set_params (params);
+
+	params.entry_value = _entry_value;
+	params.entry_focused = hasFocus();
+	params.messages = _messages;
+
+	_cdu_widget->set_params (params);
 }
 
 
@@ -1230,7 +887,8 @@ CDU::switch_page (QString const& page_id)
 	{
 		_current_page_id = page_id;
 		current_page()->reset();
-		update();
+		update_layout();
+		update_widget();
 	}
 	else
 		post_message ("Page doesn't exist");
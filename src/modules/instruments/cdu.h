@@ -28,26 +28,17 @@
 #include <xefis/core/instrument_aids.h>
 #include <xefis/core/property.h>
 
+// Local:
+#include "cdu_widget.h"
+
 
 class CDU:
 	public xf::Instrument,
 	protected xf::InstrumentAids
 {
   private:
-	static constexpr double kButtonWidthForHeight = 0.9;
-
-	enum class Column
-	{
-		Left,
-		Right,
-	};
-
-	enum class ButtonState
-	{
-		Normal,
-		Pressed,
-		Disabled,
-	};
+	typedef CDUWidget::Column		Column;
+	typedef CDUWidget::ButtonState	ButtonState;
 
 	class Config;
 
@@ -68,10 +59,10 @@ class CDU:
 		column() const noexcept;
 
 		/**
-		 * Assign rect.
+		 * Assign rects of the strip and its button.
 		 */
 		void
-		set_rect (QRectF const&);
+		set_rects (CDUWidget::StripRects const&);
 
 		/**
 		 * Get the assigned rect.
@@ -79,6 +70,12 @@ class CDU:
 		QRectF const&
 		rect() const noexcept;
 
+		/**
+		 * Get the assigned button rect.
+		 */
+		QRectF const&
+		button_rect() const noexcept;
+
 		/**
 		 * Get CDU reference.
 		 */
@@ -91,44 +88,31 @@ class CDU:
 		virtual bool
 		fresh() const noexcept;
 
+		/**
+		 * Return combined serial of followed properties.
+		 */
+		virtual xf::PropertyNode::Serial
+		serial() const noexcept;
+
 		virtual void
 		handle_mouse_press (QMouseEvent*, CDU*);
 
 		virtual void
 		handle_mouse_release (QMouseEvent*, CDU*);
 
-		virtual void
-		paint (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool focused);
-
-		virtual void
-		paint_button (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool focused);
-
-		virtual void
-		paint_title (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool focused);
-
-		virtual void
-		paint_value (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool focused);
-
-		virtual void
-		paint_focus (QRectF const& rect, QRectF const& button_rect, xf::InstrumentAids&, xf::Painter&, Column);
-
-		static void
-		paint_button_helper (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, ButtonState);
-
-		static void
-		paint_title_helper (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, QString const& title, QColor);
-
-		static void
-		paint_value_helper (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, QString const& value, QColor);
-
-		static void
-		paint_focus_helper (QRectF const& rect, QRectF const& button_rect, xf::InstrumentAids&, xf::Painter&, Column);
+		/**
+		 * Return stringified strip for the painter.
+		 * Default implementation returns a strip with disabled button and no value.
+		 */
+		virtual CDUWidget::Strip
+		params (bool focused);
 
 	  private:
 		CDU&	_cdu;
 		QString	_title;
 		Column	_column;
 		QRectF	_rect;
+		QRectF	_button_rect;
 	};
 
 	/**
@@ -152,10 +136,6 @@ class CDU:
 	  public:
 		// Ctor
 		explicit EmptyStrip (CDU&, Column);
-
-		// Strip
-		void
-		paint_button (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool focused) override;
 	};
 
 	/**
@@ -172,28 +152,20 @@ class CDU:
 		fresh() const noexcept override;
 
 		// Strip
-		void
-		handle_mouse_press (QMouseEvent*, CDU*) override;
-
-		// Strip
-		void
-		handle_mouse_release (QMouseEvent*, CDU*) override;
+		xf::PropertyNode::Serial
+		serial() const noexcept override;
 
 		// Strip
 		void
-		paint_button (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool focused) override;
-
-		// Strip
-		void
-		paint_title (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool focused) override;
+		handle_mouse_press (QMouseEvent*, CDU*) override;
 
 		// Strip
 		void
-		paint_value (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool focused) override;
+		handle_mouse_release (QMouseEvent*, CDU*) override;
 
 		// Strip
-		void
-		paint_focus (QRectF const& rect, QRectF const& button_rect, xf::InstrumentAids&, xf::Painter&, Column) override;
+		CDUWidget::Strip
+		params (bool focused) override;
 
 	  private:
 		xf::GenericProperty	_property;
@@ -204,7 +176,6 @@ class CDU:
 		std::string			_false_value;
 		ButtonState			_button_state	= ButtonState::Normal;
 		bool				_read_only		= false;
-		QRectF				_button_rect;
 	};
 
 	/**
@@ -228,21 +199,12 @@ class CDU:
 		handle_mouse_release (QMouseEvent*, CDU*) override;
 
 		// Strip
-		void
-		paint_button (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool focused) override;
-
-		// Strip
-		void
-		paint_value (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool focused) override;
-
-		// Strip
-		void
-		paint_focus (QRectF const& rect, QRectF const& button_rect, xf::InstrumentAids&, xf::Painter&, Column) override;
+		CDUWidget::Strip
+		params (bool focused) override;
 
 	  private:
 		QString			_target_page_id;
 		ButtonState		_button_state = ButtonState::Normal;
-		QRectF			_button_rect;
 	};
 
 	class Page
@@ -291,6 +253,12 @@ class CDU:
 		bool
 		scan_properties() const noexcept;
 
+		/**
+		 * Return combined serial of properties of all strips.
+		 */
+		xf::PropertyNode::Serial
+		serial() const noexcept;
+
 		/**
 		 * Handle mouse move event.
 		 * Return true if widget needs repaint.
@@ -313,16 +281,16 @@ class CDU:
 		handle_mouse_release (QMouseEvent*, CDU*);
 
 		/**
-		 * Paint the page.
+		 * Assign rects computed by the layout to strips.
 		 */
 		void
-		paint (QRectF const& rect, xf::InstrumentAids&, xf::Painter&);
+		set_layout (CDUWidget::Layout const&);
 
 		/**
-		 * Return px num from the left edge to the black box left edge.
+		 * Set page title and strips in painter params.
 		 */
-		double
-		bb_margin() const noexcept;
+		void
+		set_params (CDUWidget::Parameters&);
 
 		/**
 		 * Reset focused button, etc.
@@ -338,7 +306,6 @@ class CDU:
 		Strips			_strips_right;
 		Strip*			_focused_strip	= nullptr;
 		Strip*			_capture_strip	= nullptr;
-		double			_bb_margin		= 0.0;
 	};
 
 	class Config
@@ -356,6 +323,12 @@ class CDU:
 		bool
 		scan_properties() const noexcept;
 
+		/**
+		 * Return combined serial of properties on all pages.
+		 */
+		xf::PropertyNode::Serial
+		serial() const noexcept;
+
 		/**
 		 * Return default page ID.
 		 */
@@ -404,21 +377,27 @@ class CDU:
 	void
 	data_updated() override;
 
+	// Instrument
+	xf::PropertyNode::Serial
+	input_serial() const override;
+
 	/**
 	 * Post message to the message board.
 	 */
 	void
 	post_message (QString const&);
 
+	/**
+	 * Return the widget painting the CDU.
+	 */
+	CDUWidget*
+	cdu_widget() const noexcept;
+
   protected:
 	// QWidget
 	void
 	resizeEvent (QResizeEvent*) override;
 
-	// QWidget
-	void
-	paintEvent (QPaintEvent*) override;
-
 	// QWidget
 	void
 	keyPressEvent (QKeyEvent*) override;
@@ -439,18 +418,26 @@ class CDU:
 	void
 	mouseReleaseEvent (QMouseEvent*) override;
 
+	// QWidget
+	void
+	focusInEvent (QFocusEvent*) override;
+
+	// QWidget
+	void
+	focusOutEvent (QFocusEvent*) override;
+
 	/**
-	 * Paint the black buttons box.
-	 * And buttons of course.
+	 * Compute layout of the current page and assign rects to its strips,
+	 * so that mouse events can be handled.
 	 */
 	void
-	paint_strips_area (QRectF const&);
+	update_layout();
 
 	/**
-	 * Paint entry area.
+	 * Stringify current state and pass it to the CDUWidget.
 	 */
 	void
-	paint_entry_area (QRectF const&);
+	update_widget();
 
 	/**
 	 * Return current page.
@@ -483,6 +470,7 @@ class CDU:
 	xf::PropertyTime		_time_utc;
 	QString					_entry_value;
 	std::vector<QString>	_messages;
+	CDUWidget*				_cdu_widget		= nullptr;
 };
 
 
@@ -496,23 +484,10 @@ CDU::Strip::handle_mouse_release (QMouseEvent*, CDU*)
 { }
 
 
-inline void
-CDU::Strip::paint_button (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool)
-{ }
-
-
-inline void
-CDU::Strip::paint_title (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool)
-{ }
-
-
-inline void
-CDU::Strip::paint_value (QRectF const&, xf::InstrumentAids&, xf::Painter&, Column, bool)
-{ }
-
-
-inline void
-CDU::Strip::paint_focus (QRectF const&, QRectF const&, xf::InstrumentAids&, xf::Painter&, Column)
-{ }
+inline CDUWidget*
+CDU::cdu_widget() const noexcept
+{
+	return _cdu_widget;
+}
 
 #endif
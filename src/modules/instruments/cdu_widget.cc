@@ -0,0 +1,547 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <algorithm>
+
+// Qt:
+#include <QtGui/QFontMetrics>
+#include <QtGui/QPainter>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/window.h>
+#include <xefis/utility/text_layout.h>
+
+// Local:
+#include "cdu_widget.h"
+
+
+constexpr double CDUWidget::kButtonWidthForHeight;
+
+
+CDUWidget::Layout::Layout (QRectF const& rect, xf::InstrumentAids const& aids, std::size_t strips_left_count, std::size_t strips_right_count)
+{
+	double y_margin = 1.4 * aids._font_16.pixelSize();
+	double x_margin = 0.3 * y_margin;
+
+	entry_area = rect;
+	entry_area.setTop (5.0 / 7.0 * rect.height());
+
+	strips_area = rect;
+	strips_area.setBottom (entry_area.top());
+
+	entry_area.adjust (x_margin, 0.0, -x_margin, -x_margin);
+	strips_area.adjust (x_margin, y_margin, -x_margin, -x_margin);
+
+	title_height = 2.25 * aids._font_20_digit_height;
+	QRectF columns_rect = strips_area.adjusted (0.0, title_height, 0.0, 0.0);
+	double strip_height = columns_rect.height() / std::max<std::size_t> (1, std::max (strips_left_count, strips_right_count));
+	black_rect = strips_area.adjusted (kButtonWidthForHeight * strip_height, 0.0, -kButtonWidthForHeight * strip_height, 0.0);
+	QSizeF half_size (0.5 * columns_rect.width(), columns_rect.height());
+
+	double fpw = 0.5 * aids._autopilot_pen_2.width();
+	double top_bottom_margin = 4.0 * fpw;
+
+	auto layout_column = [&] (Column column, QRectF const& column_rect, std::size_t n, std::vector<StripRects>& strips)
+	{
+		QSizeF size (column_rect.width(), column_rect.height() / n);
+		strips.reserve (n);
+
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			StripRects rects;
+			rects.rect = QRectF (QPointF (column_rect.left(), column_rect.top() + i * size.height()), size);
+
+			QRectF inner_rect = rects.rect.adjusted (fpw, fpw, -fpw, -fpw);
+			QSizeF button_size (kButtonWidthForHeight * inner_rect.height(), inner_rect.height());
+			switch (column)
+			{
+				case Column::Left:
+					rects.button_rect = QRectF (inner_rect.topLeft(), button_size);
+					break;
+
+				case Column::Right:
+					rects.button_rect = QRectF (inner_rect.topRight() - QPointF (button_size.width(), 0.0), button_size);
+					break;
+			}
+			rects.button_rect.adjust (0.0, top_bottom_margin, 0.0, -top_bottom_margin);
+
+			strips.push_back (rects);
+		}
+	};
+
+	layout_column (Column::Left, QRectF (columns_rect.topLeft(), half_size), strips_left_count, strips_left);
+	layout_column (Column::Right, QRectF (QPointF (columns_rect.left() + 0.5 * columns_rect.width(), columns_rect.top()), half_size), strips_right_count, strips_right);
+}
+
+
+CDUWidget::PaintWorkUnit::PaintWorkUnit (CDUWidget* widget):
+	InstrumentWidget::PaintWorkUnit (widget),
+	InstrumentAids (0.5f)
+{ }
+
+
+xf::TextPainter::Cache const*
+CDUWidget::PaintWorkUnit::text_painter_cache() const
+{
+	return &_text_painter_cache;
+}
+
+
+void
+CDUWidget::PaintWorkUnit::pop_params()
+{
+	_params = _params_next;
+}
+
+
+void
+CDUWidget::PaintWorkUnit::resized()
+{
+	InstrumentAids::update_sizes (size(), window_size());
+}
+
+
+void
+CDUWidget::PaintWorkUnit::paint (QImage& image)
+{
+	auto painting_token = get_token (&image);
+	clear_background (QColor (0x55, 0x63, 0x71));
+
+	QRectF rect (QPointF (0.0, 0.0), size());
+	Layout layout (rect, *this, _params.strips_left.size(), _params.strips_right.size());
+
+	// Paint date and time:
+	if (_params.time_visible)
+	{
+		double dy = 0.475 * (rect.top() + layout.strips_area.top());
+		double dx = 0.2 * dy;
+		painter().setFont (_font_16);
+		painter().setPen (get_pen (Qt::white, 1.0));
+		painter().fast_draw_text (rect.topLeft() + QPointF (dx, dy), Qt::AlignLeft | Qt::AlignVCenter, _params.time);
+		painter().fast_draw_text (rect.topRight() + QPointF (-dx, dy), Qt::AlignRight | Qt::AlignVCenter, _params.date);
+	}
+
+	if (_params.page_visible)
+		paint_page (layout);
+
+	paint_entry_area (layout);
+}
+
+
+void
+CDUWidget::PaintWorkUnit::paint_page (Layout const& layout)
+{
+	// Black rect:
+	painter().setFont (_font_20);
+	painter().setPen (get_pen (QColor (0xbb, 0xbb, 0xbb), 1.0));
+	painter().setBrush (Qt::black);
+	painter().drawRect (layout.black_rect);
+
+	// Page title:
+	painter().setPen (get_pen (Qt::white, 1.0));
+	painter().fast_draw_text (QPointF (layout.strips_area.center().x(), layout.strips_area.top() + 0.35 * layout.title_height),
+							  Qt::AlignHCenter | Qt::AlignVCenter,
+							  _params.page_title);
+
+	for (std::size_t i = 0; i < layout.strips_left.size(); ++i)
+		paint_strip (layout.strips_left[i], _params.strips_left[i], Column::Left);
+
+	for (std::size_t i = 0; i < layout.strips_right.size(); ++i)
+		paint_strip (layout.strips_right[i], _params.strips_right[i], Column::Right);
+}
+
+
+void
+CDUWidget::PaintWorkUnit::paint_strip (StripRects const& rects, Strip const& strip, Column column)
+{
+	QRectF const& rect = rects.rect;
+	QRectF const& button_rect = rects.button_rect;
+	double fpw = 0.5 * _autopilot_pen_2.width();
+
+	double dw = button_rect.width() + pen_width (10.0);
+	double kw = rect.width() - dw;
+	QRectF title_rect (QPointF (0.0, 0.0), QSizeF (kw, _font_16_digit_height));
+	QRectF value_rect (QPointF (0.0, 0.0), QSizeF (kw, _font_20_digit_height));
+	switch (column)
+	{
+		case Column::Left:
+			value_rect.moveTopLeft (QPointF (rect.left() + dw, button_rect.center().y() - 0.5 * value_rect.height()));
+			title_rect.moveBottomLeft (QPointF (value_rect.left() + pen_width (10.0), value_rect.top() - pen_width (5.0)));
+			break;
+
+		case Column::Right:
+			value_rect.moveTopRight (QPointF (rect.right() - dw, button_rect.center().y() - 0.5 * value_rect.height()));
+			title_rect.moveBottomRight (QPointF (value_rect.right() - pen_width (10.0), value_rect.top() - pen_width (5.0)));
+			break;
+	}
+
+	// Draw parts:
+	paint_button (button_rect, column, strip.button_state);
+	if (!strip.title.isEmpty())
+		paint_title (title_rect, column, strip.title, strip.title_color);
+	paint_value (value_rect, column, strip);
+
+	// Focus:
+	if (strip.focused)
+		paint_focus (rect, button_rect.adjusted (-fpw, -fpw, fpw, fpw), column);
+}
+
+
+void
+CDUWidget::PaintWorkUnit::paint_button (QRectF const& rect, Column column, ButtonState state)
+{
+	QRectF btn_rect (rect.topLeft(), QSizeF (0.6 * rect.width(), rect.height()));
+	if (column == Column::Right)
+		btn_rect.translate (rect.width() - btn_rect.width(), 0.0);
+
+	double adj_2 = pen_width (1.0);
+	double adj_3 = pen_width (2.25);
+	double swh = std::min (btn_rect.width(), btn_rect.height());
+	QRectF rect_2 = btn_rect.adjusted (adj_2, adj_2, -adj_2, -adj_2);
+	QRectF rect_3 = btn_rect.adjusted (adj_3, adj_3, -adj_3, -adj_3);
+	QPointF point_delta (0.5 * swh, -0.5 * swh);
+	QPointF point_l = btn_rect.bottomLeft() + point_delta;
+	QPointF point_r = btn_rect.topRight() - point_delta;
+	// White line:
+	QPointF pa, pb;
+	switch (column)
+	{
+		case Column::Left:
+			pa = QPointF (btn_rect.right(), btn_rect.center().y());
+			pb = QPointF (btn_rect.right() + 0.35 * rect.width(), pa.y());
+			break;
+
+		case Column::Right:
+			pa = QPointF (btn_rect.left(), btn_rect.center().y());
+			pb = QPointF (btn_rect.left() - 0.35 * rect.width(), pa.y());
+			break;
+	}
+
+	switch (state)
+	{
+		case ButtonState::Normal:
+		case ButtonState::Pressed:
+		{
+			// White line:
+			painter().setPen (get_pen (Qt::white, 1.0));
+			painter().add_shadow (2.0, [&] {
+				painter().drawLine (pa, pb);
+			});
+
+			QColor highlight_color (0xcc, 0xcc, 0xcc);
+			QColor shadow_color (0x55, 0x55, 0x55);
+			QColor face_color (0x88, 0x88, 0x88);
+			if (state == ButtonState::Pressed)
+			{
+				std::swap (highlight_color, shadow_color);
+				shadow_color = shadow_color.darker (150);
+				face_color = face_color.darker (125);
+			}
+
+			// Backgorund/frame:
+			painter().setPen (Qt::NoPen);
+			painter().fillRect (btn_rect, Qt::black);
+			// Highlight:
+			painter().setBrush (highlight_color);
+			painter().drawPolygon (QPolygonF (QVector<QPointF> { rect_2.topLeft(), rect_2.topRight(), point_r, point_l, rect_2.bottomLeft() }));
+			// Shadow:
+			painter().setBrush (shadow_color);
+			painter().drawPolygon (QPolygonF (QVector<QPointF> { rect_2.topRight(), rect_2.bottomRight(), rect_2.bottomLeft(), point_l, point_r }));
+			// Face:
+			painter().fillRect (rect_3, face_color);
+			break;
+		}
+
+		case ButtonState::Disabled:
+		{
+			QColor cyan (0x22, 0xcc, 0xff);
+			painter().setPen (get_pen (cyan, 1.0));
+			painter().setBrush (Qt::NoBrush);
+			painter().add_shadow (2.0, [&] {
+				painter().drawLine (pa, pb);
+				painter().drawRect (rect_2);
+			});
+			break;
+		}
+	}
+}
+
+
+void
+CDUWidget::PaintWorkUnit::paint_title (QRectF const& rect, Column column, QString const& title, QColor color)
+{
+	Qt::Alignment title_alignment;
+
+	switch (column)
+	{
+		case Column::Left:
+			title_alignment = Qt::AlignVCenter | Qt::AlignLeft;
+			break;
+
+		case Column::Right:
+			title_alignment = Qt::AlignVCenter | Qt::AlignRight;
+			break;
+	}
+
+	painter().setFont (_font_13);
+	painter().setPen (get_pen (color, 1.0));
+	painter().fast_draw_text (rect, title_alignment, title);
+}
+
+
+void
+CDUWidget::PaintWorkUnit::paint_value (QRectF const& rect, Column column, Strip const& strip)
+{
+	bool left = column == Column::Left;
+	auto horz_alignment = left ? Qt::AlignLeft : Qt::AlignRight;
+	QPointF position (left ? rect.left() : rect.right(), rect.center().y());
+
+	switch (strip.value_type)
+	{
+		case Strip::Value::None:
+			break;
+
+		case Strip::Value::Text:
+			painter().setFont (_font_20);
+			painter().setPen (get_pen (strip.value_color, 1.0));
+			painter().fast_draw_text (rect, horz_alignment | Qt::AlignVCenter, strip.value);
+			break;
+
+		case Strip::Value::Switch:
+		{
+			xf::TextLayout tl;
+			tl.set_alignment (Qt::AlignCenter);
+			tl.set_background (Qt::NoBrush);
+
+			switch (column)
+			{
+				case Column::Left:
+					tl.add_fragment (strip.inactive_value, _font_13, Qt::white);
+					tl.add_fragment ("\u2008⬌\u2008", _font_20, Qt::white);
+					tl.add_fragment (strip.value, _font_20, Qt::green);
+					break;
+
+				case Column::Right:
+					tl.add_fragment (strip.value, _font_20, Qt::green);
+					tl.add_fragment ("\u2008⬌\u2008", _font_20, Qt::white);
+					tl.add_fragment (strip.inactive_value, _font_13, Qt::white);
+					break;
+			}
+
+			tl.paint (position, horz_alignment | Qt::AlignVCenter, painter());
+			break;
+		}
+
+		case Strip::Value::Unit:
+		{
+			xf::TextLayout tl;
+			tl.set_alignment (Qt::AlignCenter);
+			tl.set_background (Qt::NoBrush);
+			tl.add_fragment (strip.value, _font_13, Qt::gray);
+			tl.paint (position, horz_alignment | Qt::AlignVCenter, painter());
+			break;
+		}
+	}
+}
+
+
+void
+CDUWidget::PaintWorkUnit::paint_focus (QRectF const& rect, QRectF const& button_rect, Column column)
+{
+	QRectF const& r = button_rect;
+	QPolygonF polygon;
+
+	double r_left = 0.0;
+	double rect_right = 0.0;
+	double r_width = 0.0;
+	QPointF r_topLeft;
+	QPointF r_bottomLeft;
+
+	switch (column)
+	{
+		case Column::Left:
+		{
+			r_left = r.left();
+			rect_right = rect.right();
+			r_width = r.width();
+			r_topLeft = r.topLeft();
+			r_bottomLeft = r.bottomLeft();
+			break;
+		}
+
+		case Column::Right:
+		{
+			r_left = r.right();
+			rect_right = rect.left();
+			r_width = -r.width();
+			r_topLeft = r.topRight();
+			r_bottomLeft = r.bottomRight();
+			break;
+		}
+	}
+
+	double rx = r_left + 0.61 * r_width;
+	double ry1 = r.top() + 0.2 * r.height();
+	double ry2 = r.top() + 0.8 * r.height();
+	polygon
+		<< r_topLeft
+		<< QPointF (rx, r.top())
+		<< QPointF (rx, ry1)
+		<< QPointF (rect_right, ry1)
+		<< QPointF (rect_right, ry2)
+		<< QPointF (rx, ry2)
+		<< QPointF (rx, r.bottom())
+		<< r_bottomLeft;
+	polygon << polygon[0];
+
+	painter().setPen (_autopilot_pen_2);
+	painter().setBrush (Qt::NoBrush);
+	painter().drawPolyline (polygon);
+}
+
+
+void
+CDUWidget::PaintWorkUnit::paint_entry_area (Layout const& layout)
+{
+	QRectF const& rect = layout.entry_area;
+	QColor cyan = QColor (0x00, 0xb0, 0xcf);
+	double ww = 0.16 * _font_20_digit_height;
+	double lh = 1.0 * _font_20_digit_height;
+	double bb = _params.page_visible ? layout.black_rect.left() : 0.0;
+
+	// Entry box:
+	QRectF entry_rect = rect;
+	entry_rect.setLeft (bb);
+	entry_rect.setRight (size().width() - bb);
+	entry_rect.setTop (rect.top());
+	entry_rect.setHeight (1.8 * _font_20_digit_height);
+	QRectF text_rect = entry_rect.adjusted (ww, 0.0, -ww, 0.0);
+	painter().setFont (_font_20);
+	QColor color (0xbb, 0xbb, 0xbb);
+	if (_params.entry_focused)
+		color = Qt::white;
+	painter().setPen (get_pen (color, 1.0));
+	painter().setBrush (Qt::black);
+	painter().drawRect (entry_rect);
+	painter().setFont (_font_20);
+	painter().setPen (get_pen (Qt::white, 1.0));
+	QFontMetrics metrics (_font_20);
+	if (metrics.width (_params.entry_value) > text_rect.width())
+	{
+		painter().setClipRect (text_rect);
+		painter().fast_draw_text (QPointF (text_rect.right(), text_rect.center().y()),
+								  Qt::AlignRight | Qt::AlignVCenter, _params.entry_value);
+	}
+	else
+		painter().fast_draw_text (QPointF (text_rect.left(), text_rect.center().y()),
+								  Qt::AlignLeft | Qt::AlignVCenter, _params.entry_value);
+	painter().setClipping (false);
+
+	// Message board:
+	QRectF msgbrd_rect = entry_rect;
+	msgbrd_rect.moveTop (entry_rect.bottom() + lh);
+	msgbrd_rect.setBottom (rect.bottom());
+	painter().setPen (Qt::NoPen);
+	painter().setBrush (Qt::black);
+	painter().drawRect (msgbrd_rect);
+
+	// Msg board title:
+	QRectF msgbrd_title = msgbrd_rect;
+	msgbrd_title.setBottom (msgbrd_title.top() + 2.0 * _font_16_digit_height);
+	msgbrd_title.setRight (msgbrd_title.right() - 6.0 * _font_20_digit_height);
+	painter().setFont (_font_16);
+	painter().fillRect (msgbrd_title, cyan);
+	painter().setPen (get_pen (Qt::white, 1.0));
+	painter().fast_draw_text (msgbrd_title, Qt::AlignCenter, "MESSAGE TITLE");
+
+	// Msg board right panel:
+	QRectF msgbrd_rpanel = msgbrd_rect;
+	msgbrd_rpanel.setLeft (msgbrd_title.right() - 1.0);
+	painter().fillRect (msgbrd_rpanel, cyan);
+
+	// Message texts panel:
+	QRectF msgbrd_texts = msgbrd_rect;
+	msgbrd_texts.setTop (msgbrd_title.bottom());
+	msgbrd_texts.setRight (msgbrd_rpanel.left());
+	msgbrd_texts.adjust (ww, 0.0, -ww, -ww);
+	painter().setClipRect (msgbrd_texts);
+	painter().setFont (_font_16);
+	painter().setPen (get_pen (Qt::white, 1.0));
+
+	double msg_height = 1.25 * _font_20_digit_height;
+	QRectF virtual_texts_frame = msgbrd_texts;
+	virtual_texts_frame.setHeight (_params.messages.size() * msg_height);
+	if (virtual_texts_frame.height() > msgbrd_texts.height())
+		virtual_texts_frame.moveBottom (msgbrd_texts.bottom());
+
+	for (std::size_t i = 0; i < _params.messages.size(); ++i)
+	{
+		QPointF hook = virtual_texts_frame.topLeft() + i * QPointF (0.0, msg_height);
+		if (hook.y() + msg_height < msgbrd_texts.top())
+			continue;
+		painter().fast_draw_text (hook, Qt::AlignTop | Qt::AlignLeft, QString ("%1: %2").arg (i + 1, 2, 10, QChar ('0')).arg (_params.messages[i]));
+	}
+
+	// Draw msg board outline:
+	painter().setClipping (false);
+	painter().setPen (get_pen (Qt::white, 1.0));
+	painter().setBrush (Qt::NoBrush);
+	painter().drawRect (msgbrd_rect);
+}
+
+
+CDUWidget::CDUWidget (QWidget* parent, xf::WorkPerformer* work_performer):
+	InstrumentWidget (parent, work_performer),
+	_local_paint_work_unit (this)
+{
+	// Mouse is handled by the CDU module:
+	setAttribute (Qt::WA_TransparentForMouseEvents);
+	set_painter (&_local_paint_work_unit);
+}
+
+
+CDUWidget::~CDUWidget()
+{
+	wait_for_painter();
+}
+
+
+void
+CDUWidget::set_params (Parameters const& new_params)
+{
+	_params = new_params;
+	request_repaint();
+}
+
+
+void
+CDUWidget::resizeEvent (QResizeEvent* event)
+{
+	InstrumentWidget::resizeEvent (event);
+
+	auto xw = dynamic_cast<xf::Window*> (window());
+	if (xw)
+		_local_paint_work_unit.set_scaling (xw->pen_scale(), xw->font_scale());
+}
+
+
+void
+CDUWidget::push_params()
+{
+	_local_paint_work_unit._params_next = _params;
+}
+
@@ -0,0 +1,206 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+#ifndef XEFIS__MODULES__INSTRUMENTS__CDU_WIDGET_H__INCLUDED
+#define XEFIS__MODULES__INSTRUMENTS__CDU_WIDGET_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <vector>
+
+// Qt:
+#include <QtGui/QColor>
+#include <QtWidgets/QWidget>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/instrument_widget.h>
+#include <xefis/core/instrument_aids.h>
+#include <xefis/core/work_performer.h>
+#include <xefis/utility/painter.h>
+
+
+class CDUWidget: public xf::InstrumentWidget
+{
+  public:
+	static constexpr double kButtonWidthForHeight = 0.9;
+
+	enum class Column
+	{
+		Left,
+		Right,
+	};
+
+	enum class ButtonState
+	{
+		Normal,
+		Pressed,
+		Disabled,
+	};
+
+	/**
+	 * Already stringified strip.
+	 */
+	class Strip
+	{
+	  public:
+		enum class Value
+		{
+			None,		// Nothing is painted.
+			Text,		// Value text.
+			Switch,		// Active and inactive values of a boolean setting.
+			Unit,		// Information about unit of a nil setting, given as value.
+		};
+
+	  public:
+		ButtonState	button_state	= ButtonState::Disabled;
+		bool		focused			= false;
+		QString		title;
+		QColor		title_color;
+		Value		value_type		= Value::None;
+		QString		value;
+		QString		inactive_value;	// Switch only
+		QColor		value_color;
+	};
+
+	class Parameters
+	{
+	  public:
+		bool					time_visible	= false;
+		QString					time;
+		QString					date;
+		bool					page_visible	= false;
+		QString					page_title;
+		std::vector<Strip>		strips_left;
+		std::vector<Strip>		strips_right;
+		QString					entry_value;
+		bool					entry_focused	= false;
+		std::vector<QString>	messages;
+	};
+
+	/**
+	 * Rects of a strip and its button.
+	 */
+	class StripRects
+	{
+	  public:
+		QRectF	rect;
+		QRectF	button_rect;
+	};
+
+	/**
+	 * Geometry of the CDU. Computed the same way by the painter and by the CDU module,
+	 * which uses it to handle mouse events.
+	 */
+	class Layout
+	{
+	  public:
+		// Ctor
+		Layout (QRectF const& rect, xf::InstrumentAids const&, std::size_t strips_left_count, std::size_t strips_right_count);
+
+	  public:
+		QRectF					strips_area;
+		QRectF					entry_area;
+		QRectF					black_rect;
+		double					title_height;
+		std::vector<StripRects>	strips_left;
+		std::vector<StripRects>	strips_right;
+	};
+
+  private:
+	class PaintWorkUnit:
+		public xf::InstrumentWidget::PaintWorkUnit,
+		protected xf::InstrumentAids
+	{
+		friend class CDUWidget;
+
+	  public:
+		PaintWorkUnit (CDUWidget*);
+
+		~PaintWorkUnit() noexcept { }
+
+		xf::TextPainter::Cache const*
+		text_painter_cache() const override;
+
+	  private:
+		void
+		pop_params() override;
+
+		void
+		resized() override;
+
+		void
+		paint (QImage&) override;
+
+		/**
+		 * Paint the page: black box, page title and strips.
+		 */
+		void
+		paint_page (Layout const&);
+
+		void
+		paint_strip (StripRects const&, Strip const&, Column);
+
+		void
+		paint_button (QRectF const&, Column, ButtonState);
+
+		void
+		paint_title (QRectF const&, Column, QString const& title, QColor);
+
+		void
+		paint_value (QRectF const&, Column, Strip const&);
+
+		void
+		paint_focus (QRectF const& rect, QRectF const& button_rect, Column);
+
+		/**
+		 * Paint entry area and message board.
+		 */
+		void
+		paint_entry_area (Layout const&);
+
+	  private:
+		Parameters	_params;
+		Parameters	_params_next;
+	};
+
+  public:
+	// Ctor
+	CDUWidget (QWidget* parent, xf::WorkPerformer*);
+
+	// Dtor
+	~CDUWidget();
+
+	/**
+	 * Set new params for the widget.
+	 */
+	void
+	set_params (Parameters const&);
+
+  protected:
+	// API of QWidget
+	void
+	resizeEvent (QResizeEvent*) override;
+
+	// API of InstrumentWidget
+	void
+	push_params() override;
+
+  private:
+	PaintWorkUnit	_local_paint_work_unit;
+	Parameters		_params;
+};
+
+#endif
+
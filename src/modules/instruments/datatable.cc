@@ -77,8 +77,7 @@ Datatable::LabelValue::stringify() const
 
 
 Datatable::Datatable (xf::ModuleManager* module_manager, QDomElement const& config):
-	xf::Instrument (module_manager, config),
-	InstrumentAids (0.5f)
+	xf::Instrument (module_manager, config, 10_Hz)
 {
 	QString label_color_str;
 	QString value_color_str;
@@ -101,76 +100,70 @@ Datatable::Datatable (xf::ModuleManager* module_manager, QDomElement const& conf
 			for (QDomElement f: e)
 				if (f == "row")
 					_list.emplace_back (f, _default_label_color, _default_value_color);
+
+	_datatable_widget = new DatatableWidget (this, work_performer());
+
+	QVBoxLayout* layout = new QVBoxLayout (this);
+	layout->setMargin (0);
+	layout->setSpacing (0);
+	layout->addWidget (_datatable_widget);
 }
 
 
 void
 Datatable::data_updated()
 {
-	if (std::any_of (_list.begin(), _list.end(), std::mem_fn (&LabelValue::fresh)))
-		update();
+	if (!_inited || std::any_of (_list.begin(), _list.end(), std::mem_fn (&LabelValue::fresh)))
+	{
+		_inited = true;
+		update_widget();
+	}
 }
 
 
-void
-Datatable::resizeEvent (QResizeEvent*)
+xf::PropertyNode::Serial
+Datatable::input_serial() const
 {
-	auto xw = dynamic_cast<xf::Window*> (window());
-	if (xw)
-		set_scaling (xw->pen_scale(), xw->font_scale());
-
-	InstrumentAids::update_sizes (size(), window()->size());
+	xf::PropertyNode::Serial result = xf::Instrument::input_serial();
+	for (LabelValue const& lv: _list)
+		result += lv.serial();
+	return result;
 }
 
 
 void
-Datatable::paintEvent (QPaintEvent*)
+Datatable::update_widget()
 {
-	auto painting_token = get_token (this);
-	clear_background();
+	DatatableWidget::Parameters params;
+	params.label_font_size = _label_font_size;
+	params.value_font_size = _value_font_size;
+	params.alignment = _alignment;
+	params.rows.reserve (_list.size());
 
-	QFont label_font = _font_10;
-	QFont value_font = _font_10;
-	label_font.setPixelSize (_label_font_size * _master_font_scale);
-	value_font.setPixelSize (_value_font_size * _master_font_scale);
-
-	double line_height = std::max (QFontMetricsF (label_font).height(), QFontMetricsF (value_font).height());
-	double empty_height = height() - line_height * _list.size();
-
-	if (_alignment & Qt::AlignVCenter)
-		painter().translate (QPointF (0.0, 0.5 * empty_height));
-	else if (_alignment & Qt::AlignBottom)
-		painter().translate (QPointF (0.0, empty_height));
-
-	for (std::size_t i = 0; i < _list.size(); ++i)
+	for (LabelValue const& lv: _list)
 	{
-		LabelValue const& lv = _list[i];
-
-		QPointF left (0.0, (i + 1) * line_height);
-		QPointF right (rect().width(), left.y());
-
-		// Label:
-		painter().setFont (label_font);
-		painter().setPen (get_pen (lv.label_color, 1.0));
-		painter().fast_draw_text (left, Qt::AlignLeft | Qt::AlignBottom, lv.label);
-		// Value:
-		painter().setFont (value_font);
-		painter().setPen (get_pen (lv.value_color, 1.0));
-		QString lv_s;
+		DatatableWidget::Row row;
+		row.label = lv.label;
+		row.label_color = lv.label_color;
+		row.value_color = lv.value_color;
+
 		try {
-			lv_s = lv.stringify();
+			row.value = lv.stringify();
 		}
 		catch (xf::StringifyError const& exception)
 		{
-			painter().setPen (get_pen (Qt::red, 1.0));
-			lv_s = exception.what();
+			row.value_color = Qt::red;
+			row.value = exception.what();
 		}
 		catch (boost::io::bad_format_string const&)
 		{
-			painter().setPen (get_pen (Qt::red, 1.0));
-			lv_s = "format: ill formed";
+			row.value_color = Qt::red;
+			row.value = "format: ill formed";
 		}
-		painter().fast_draw_text (right, Qt::AlignRight | Qt::AlignBottom, lv_s);
+
+		params.rows.push_back (row);
 	}
+
+	_datatable_widget->set_params (params);
 }
 
@@ -24,13 +24,13 @@
 // Xefis:
 #include <xefis/config/all.h>
 #include <xefis/core/instrument.h>
-#include <xefis/core/instrument_aids.h>
 #include <xefis/core/property.h>
 
+// Local:
+#include "datatable_widget.h"
 
-class Datatable:
-	public xf::Instrument,
-	protected xf::InstrumentAids
+
+class Datatable: public xf::Instrument
 {
 	class LabelValue
 	{
@@ -44,6 +44,12 @@ class Datatable:
 		bool
 		fresh() const;
 
+		/**
+		 * Return serial of the value property.
+		 */
+		xf::PropertyNode::Serial
+		serial() const;
+
 		/**
 		 * Return value to be painted.
 		 */
@@ -67,20 +73,25 @@ class Datatable:
 	void
 	data_updated() override;
 
-  protected:
-	void
-	resizeEvent (QResizeEvent*) override;
+	xf::PropertyNode::Serial
+	input_serial() const override;
 
+  private:
+	/**
+	 * Stringify all values and pass them to the widget.
+	 */
 	void
-	paintEvent (QPaintEvent*) override;
+	update_widget();
 
   private:
+	DatatableWidget*		_datatable_widget		= nullptr;
 	double					_label_font_size		= 16.0;
 	double					_value_font_size		= 18.0;
 	QColor					_default_label_color	= { 0xff, 0xff, 0xff };
 	QColor					_default_value_color	= { 0xff, 0xff, 0xff };
 	Qt::Alignment			_alignment				= Qt::AlignTop;
 	std::vector<LabelValue>	_list;
+	bool					_inited					= false;
 };
 
 
@@ -90,4 +101,11 @@ Datatable::LabelValue::fresh() const
 	return value.fresh();
 }
 
+
+inline xf::PropertyNode::Serial
+Datatable::LabelValue::serial() const
+{
+	return value.serial();
+}
+
 #endif
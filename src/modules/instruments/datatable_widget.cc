@@ -0,0 +1,126 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <algorithm>
+
+// Qt:
+#include <QtGui/QPainter>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/window.h>
+
+// Local:
+#include "datatable_widget.h"
+
+
+DatatableWidget::PaintWorkUnit::PaintWorkUnit (DatatableWidget* widget):
+	InstrumentWidget::PaintWorkUnit (widget),
+	InstrumentAids (0.5f)
+{ }
+
+
+void
+DatatableWidget::PaintWorkUnit::pop_params()
+{
+	_params = _params_next;
+}
+
+
+void
+DatatableWidget::PaintWorkUnit::resized()
+{
+	InstrumentAids::update_sizes (size(), window_size());
+}
+
+
+void
+DatatableWidget::PaintWorkUnit::paint (QImage& image)
+{
+	auto painting_token = get_token (&image);
+	clear_background();
+
+	QFont label_font = _font_10;
+	QFont value_font = _font_10;
+	label_font.setPixelSize (_params.label_font_size * _master_font_scale);
+	value_font.setPixelSize (_params.value_font_size * _master_font_scale);
+
+	double line_height = std::max (QFontMetricsF (label_font).height(), QFontMetricsF (value_font).height());
+	double empty_height = size().height() - line_height * _params.rows.size();
+
+	if (_params.alignment & Qt::AlignVCenter)
+		painter().translate (QPointF (0.0, 0.5 * empty_height));
+	else if (_params.alignment & Qt::AlignBottom)
+		painter().translate (QPointF (0.0, empty_height));
+
+	for (std::size_t i = 0; i < _params.rows.size(); ++i)
+	{
+		Row const& row = _params.rows[i];
+
+		QPointF left (0.0, (i + 1) * line_height);
+		QPointF right (size().width(), left.y());
+
+		// Label:
+		painter().setFont (label_font);
+		painter().setPen (get_pen (row.label_color, 1.0));
+		painter().fast_draw_text (left, Qt::AlignLeft | Qt::AlignBottom, row.label);
+		// Value:
+		painter().setFont (value_font);
+		painter().setPen (get_pen (row.value_color, 1.0));
+		painter().fast_draw_text (right, Qt::AlignRight | Qt::AlignBottom, row.value);
+	}
+}
+
+
+DatatableWidget::DatatableWidget (QWidget* parent, xf::WorkPerformer* work_performer):
+	InstrumentWidget (parent, work_performer),
+	_local_paint_work_unit (this)
+{
+	set_painter (&_local_paint_work_unit);
+}
+
+
+DatatableWidget::~DatatableWidget()
+{
+	wait_for_painter();
+}
+
+
+void
+DatatableWidget::set_params (Parameters const& new_params)
+{
+	_params = new_params;
+	request_repaint();
+}
+
+
+void
+DatatableWidget::resizeEvent (QResizeEvent* event)
+{
+	InstrumentWidget::resizeEvent (event);
+
+	auto xw = dynamic_cast<xf::Window*> (window());
+	if (xw)
+		_local_paint_work_unit.set_scaling (xw->pen_scale(), xw->font_scale());
+}
+
+
+void
+DatatableWidget::push_params()
+{
+	_local_paint_work_unit._params_next = _params;
+}
+
@@ -0,0 +1,113 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+#ifndef XEFIS__MODULES__INSTRUMENTS__DATATABLE_WIDGET_H__INCLUDED
+#define XEFIS__MODULES__INSTRUMENTS__DATATABLE_WIDGET_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <vector>
+
+// Qt:
+#include <QtGui/QColor>
+#include <QtWidgets/QWidget>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/instrument_widget.h>
+#include <xefis/core/instrument_aids.h>
+#include <xefis/core/work_performer.h>
+#include <xefis/utility/painter.h>
+
+
+class DatatableWidget: public xf::InstrumentWidget
+{
+  public:
+	/**
+	 * Already stringified row of the table.
+	 */
+	class Row
+	{
+	  public:
+		QString	label;
+		QColor	label_color;
+		QString	value;
+		QColor	value_color;
+	};
+
+	class Parameters
+	{
+	  public:
+		double				label_font_size		= 16.0;
+		double				value_font_size		= 18.0;
+		Qt::Alignment		alignment			= Qt::AlignTop;
+		std::vector<Row>	rows;
+	};
+
+  private:
+	class PaintWorkUnit:
+		public xf::InstrumentWidget::PaintWorkUnit,
+		protected xf::InstrumentAids
+	{
+		friend class DatatableWidget;
+
+	  public:
+		PaintWorkUnit (DatatableWidget*);
+
+		~PaintWorkUnit() noexcept { }
+
+	  private:
+		void
+		pop_params() override;
+
+		void
+		resized() override;
+
+		void
+		paint (QImage&) override;
+
+	  private:
+		Parameters	_params;
+		Parameters	_params_next;
+	};
+
+  public:
+	// Ctor
+	DatatableWidget (QWidget* parent, xf::WorkPerformer*);
+
+	// Dtor
+	~DatatableWidget();
+
+	/**
+	 * Set new params for the widget.
+	 */
+	void
+	set_params (Parameters const&);
+
+  protected:
+	// API of QWidget
+	void
+	resizeEvent (QResizeEvent*) override;
+
+	// API of InstrumentWidget
+	void
+	push_params() override;
+
+  private:
+	PaintWorkUnit	_local_paint_work_unit;
+	Parameters		_params;
+};
+
+#endif
+
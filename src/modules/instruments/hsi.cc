@@ -119,6 +119,14 @@ HSI::HSI (xf::ModuleManager* module_manager, QDomElement const& config):
 }
 
 
+xf::PropertyNode::Serial
+HSI::input_serial() const
+{
+	// Navaids loaded in background are another input, that should cause repaint:
+	return xf::Instrument::input_serial() + (navaid_storage()->loaded() ? 1 : 0);
+}
+
+
 void
 HSI::read()
 {
@@ -191,6 +199,15 @@ HSI::read()
 		params.position = LonLat (*_position_longitude, *_position_latitude);
 	else
 		params.position.reset();
+
+	if (params.position)
+	{
+		// True track for prefetching navaids ahead of the aircraft:
+		Optional<Angle> true_track;
+		if (_orientation_heading_true.valid() && _orientation_heading_magnetic.valid())
+			true_track = *_orientation_heading_true + params.track_magnetic - *_orientation_heading_magnetic;
+		navaid_storage()->update_position (*params.position, true_track);
+	}
 	params.navaids_visible = _orientation_heading_true.valid();
 	params.fix_visible = _features_fix.read (false);
 	params.vor_visible = _features_vor.read (false);
@@ -51,6 +51,9 @@ class HSI: public xf::Instrument
 	void
 	data_updated() override;
 
+	xf::PropertyNode::Serial
+	input_serial() const override;
+
   private:
 	Unique<HSIWidget>		_hsi_widget;
 	std::array<LonLat, 3>	_positions;
@@ -13,6 +13,8 @@
 
 // Standard:
 #include <cstddef>
+#include <algorithm>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <cmath>
@@ -76,6 +78,13 @@ HSIWidget::PaintWorkUnit::pop_params()
 }
 
 
+xf::TextPainter::Cache const*
+HSIWidget::PaintWorkUnit::text_painter_cache() const
+{
+	return &_text_painter_cache;
+}
+
+
 void
 HSIWidget::PaintWorkUnit::resized()
 {
@@ -241,6 +250,9 @@ HSIWidget::PaintWorkUnit::resized()
 	}
 
 	_margin = 0.15 * _q;
+
+	// Pens and sizes might have changed:
+	_map_layer.valid = false;
 }
 
 
@@ -360,6 +372,7 @@ HSIWidget::PaintWorkUnit::paint (QImage& image)
 	paint_home_direction (painter());
 	paint_range (painter());
 	paint_hints (painter());
+	paint_map_loading (painter());
 	paint_trend_vector (painter());
 	paint_tcas();
 	paint_course (painter());
@@ -379,7 +392,7 @@ HSIWidget::PaintWorkUnit::paint_aircraft (xf::Painter& painter)
 
 	// Aircraft triangle - shadow and triangle:
 	painter.setPen (get_pen (Qt::white, 1.f));
-	painter.add_shadow ([&] {
+	painter.add_shadow_sprite ("aircraft", _aircraft_shape.boundingRect(), [&](xf::Painter& painter) {
 		painter.drawPolyline (_aircraft_shape);
 	});
 
@@ -552,6 +565,24 @@ HSIWidget::PaintWorkUnit::paint_hints (xf::Painter& painter)
 }
 
 
+void
+HSIWidget::PaintWorkUnit::paint_map_loading (xf::Painter& painter)
+{
+	// Keyed on loaded(), which is what HSI::input_serial() tracks, so that the banner
+	// is removed by the repaint caused by navaids becoming available:
+	if (!_params.navaids_visible || !_navaid_storage || !_navaid_storage->loading() || _navaid_storage->loaded())
+		return;
+
+	painter.setTransform (_aircraft_center_transform);
+	painter.setClipping (false);
+
+	xf::TextLayout layout;
+	layout.set_background (Qt::black, { _margin, 0.0 });
+	layout.add_fragment ("MAP LOADING", _font_13, _warning_color_2);
+	layout.paint (QPointF (0.0, -0.5 * _r), Qt::AlignVCenter | Qt::AlignHCenter, painter);
+}
+
+
 void
 HSIWidget::PaintWorkUnit::paint_track (xf::Painter& painter, bool paint_heading_triangle)
 {
@@ -1428,7 +1459,36 @@ HSIWidget::PaintWorkUnit::paint_navaids (xf::Painter& painter)
 	painter.setFont (_font_10);
 
 	retrieve_navaids();
-	paint_locs();
+
+	MapLayerKey map_layer_key { _params.range, _r, _params.display_mode, _params.loc_visible, _params.arpt_visible, _params.highlighted_loc,
+								_params.arpt_runways_range_threshold, _params.arpt_map_range_threshold, _params.arpt_runway_extension_length };
+
+	// Layer has a margin for drift of 0.1 of the range:
+	bool const map_layer_drifted = _map_layer.valid && _map_layer.position.haversine_earth (*_params.position) >= 0.1f * _params.range;
+
+	if (!_map_layer.valid || _map_layer.key != map_layer_key || map_layer_drifted)
+	{
+		_map_layer.key = map_layer_key;
+		render_map_layer();
+	}
+
+	// Maps north-up layer coordinates to coordinates relative to _aircraft_center_transform:
+	QPointF const layer_xy = get_navaid_xy (_map_layer.position);
+	QTransform const layer_transform = _features_transform * QTransform::fromTranslate (layer_xy.x(), layer_xy.y());
+
+	// Map-fixed features:
+	painter.setTransform (layer_transform * _aircraft_center_transform);
+	painter.drawImage (QPointF (-0.5 * _map_layer.image.width(), -0.5 * _map_layer.image.height()), _map_layer.image);
+
+	// LOC identifiers, highlighted one last, so it's on top:
+	painter.setTransform (_aircraft_center_transform);
+	for (bool highlighted: { false, true })
+	{
+		painter.setPen (highlighted ? _hi_loc_pen : _lo_loc_pen);
+		for (auto const& label: _map_layer.loc_labels)
+			if (label.highlighted == highlighted)
+				painter.fast_draw_text (layer_transform.map (label.position) - label.offset, label.text);
+	}
 
 	// Return feature position on screen relative to _aircraft_center_transform.
 	auto position_feature = [&](LonLat const& position, bool* limit_to_range = nullptr) -> QPointF
@@ -1451,10 +1511,24 @@ HSIWidget::PaintWorkUnit::paint_navaids (xf::Painter& painter)
 		return mapped_pos;
 	};
 
-	auto paint_navaid = [&](Navaid const& navaid)
+	// Navaid symbols are painted from cached sprites, since they're all the same:
+	QRectF const ndb_rect (-0.1f, -0.1f, 0.2f, 0.2f);
+	QRectF const vor_center_rect (-0.07f, -0.07f, 0.14f, 0.14f);
+	QRectF const symbol_rect (-0.5f, -0.5f, 1.f, 1.f);
+	double const arpt_v = 1.1;
+	QRectF const arpt_rect (QPointF (-0.5 * arpt_v, -0.5 * arpt_v), QSizeF (1.0 * arpt_v, 1.0 * arpt_v));
+	float const fix_h = 0.75f;
+	QPolygonF const fix_shape = QPolygonF()
+		<< QPointF (0.f, -0.66f * fix_h)
+		<< QPointF (+0.5f * fix_h, +0.33f * fix_h)
+		<< QPointF (-0.5f * fix_h, +0.33f * fix_h)
+		<< QPointF (0.f, -0.66f * fix_h);
+
+	// Paint upright symbol and label of a navaid. Position is taken from the map layer.
+	auto paint_navaid = [&](Navaid const& navaid, QPointF const& layer_position)
 	{
 		QTransform feature_centered_transform = _aircraft_center_transform;
-		QPointF translation = position_feature (navaid.position());
+		QPointF translation = layer_transform.map (layer_position);
 		feature_centered_transform.translate (translation.x(), translation.y());
 
 		QTransform feature_scaled_transform = feature_centered_transform;
@@ -1467,7 +1541,9 @@ HSIWidget::PaintWorkUnit::paint_navaids (xf::Painter& painter)
 				painter.setTransform (feature_scaled_transform);
 				painter.setPen (_ndb_pen);
 				painter.setBrush (_ndb_pen.color());
-				painter.drawEllipse (QRectF (-0.1f, -0.1f, 0.2f, 0.2f));
+				painter.paint_sprite ("ndb", ndb_rect, [&](xf::Painter& painter) {
+					painter.drawEllipse (ndb_rect);
+				});
 				painter.setTransform (feature_centered_transform);
 				painter.fast_draw_text (QPointF (0.15 * _q, 0.10 * _q), Qt::AlignLeft | Qt::AlignTop, navaid.identifier());
 				break;
@@ -1479,17 +1555,25 @@ HSIWidget::PaintWorkUnit::paint_navaids (xf::Painter& painter)
 				painter.setBrush (_navigation_color);
 				if (navaid.vor_type() == Navaid::VOROnly)
 				{
-					painter.drawEllipse (QRectF (-0.07f, -0.07f, 0.14f, 0.14f));
-					painter.drawPolyline (_vor_shape);
+					painter.paint_sprite ("vor", symbol_rect, [&](xf::Painter& painter) {
+						painter.drawEllipse (vor_center_rect);
+						painter.drawPolyline (_vor_shape);
+					});
 				}
 				else if (navaid.vor_type() == Navaid::VOR_DME)
 				{
-					painter.drawEllipse (QRectF (-0.07f, -0.07f, 0.14f, 0.14f));
-					painter.drawPolyline (_vor_shape);
-					painter.drawPolyline (_dme_for_vor_shape);
+					painter.paint_sprite ("vor-dme", symbol_rect, [&](xf::Painter& painter) {
+						painter.drawEllipse (vor_center_rect);
+						painter.drawPolyline (_vor_shape);
+						painter.drawPolyline (_dme_for_vor_shape);
+					});
 				}
 				else if (navaid.vor_type() == Navaid::VORTAC)
-					painter.drawPolyline (_vortac_shape);
+				{
+					painter.paint_sprite ("vortac", symbol_rect, [&](xf::Painter& painter) {
+						painter.drawPolyline (_vortac_shape);
+					});
+				}
 				painter.setTransform (feature_centered_transform);
 				painter.fast_draw_text (QPointF (0.35f * _q, 0.55f * _q), navaid.identifier());
 				break;
@@ -1497,19 +1581,18 @@ HSIWidget::PaintWorkUnit::paint_navaids (xf::Painter& painter)
 			case Navaid::DME:
 				painter.setTransform (feature_scaled_transform);
 				painter.setPen (_dme_pen);
-				painter.drawRect (QRectF (-0.5f, -0.5f, 1.f, 1.f));
+				painter.paint_sprite ("dme", symbol_rect, [&](xf::Painter& painter) {
+					painter.drawRect (symbol_rect);
+				});
 				break;
 
 			case Navaid::FIX:
 			{
-				float const h = 0.75f;
-				QPointF a (0.f, -0.66f * h);
-				QPointF b (+0.5f * h, +0.33f * h);
-				QPointF c (-0.5f * h, +0.33f * h);
-				QPointF points[] = { a, b, c, a };
 				painter.setTransform (feature_scaled_transform);
 				painter.setPen (_fix_pen);
-				painter.drawPolyline (points, sizeof (points) / sizeof (*points));
+				painter.paint_sprite ("fix", fix_shape.boundingRect(), [&](xf::Painter& painter) {
+					painter.drawPolyline (fix_shape);
+				});
 				painter.setTransform (feature_centered_transform);
 				painter.translate (0.5f, 0.5f);
 				painter.fast_draw_text (QPointF (0.25f * _q, 0.45f * _q), navaid.identifier());
@@ -1518,58 +1601,19 @@ HSIWidget::PaintWorkUnit::paint_navaids (xf::Painter& painter)
 
 			case Navaid::ARPT:
 			{
+				// Runways are painted on the map layer, only circles for airports here:
 				if (_params.range > _params.arpt_runways_range_threshold)
 				{
-					// Draw circles for airports:
-					double v = 1.1;
 					painter.setTransform (feature_scaled_transform);
 					painter.setPen (_arpt_pen);
 					painter.setBrush (Qt::NoBrush);
-					painter.drawEllipse (QRectF (QPointF (-0.5 * v, -0.5 * v), QSizeF (1.0 * v, 1.0 * v)));
+					painter.paint_sprite ("arpt", arpt_rect, [&](xf::Painter& painter) {
+						painter.drawEllipse (arpt_rect);
+					});
 					// Label:
 					painter.setTransform (feature_centered_transform);
 					painter.fast_draw_text (QPointF (0.46 * scale, 0.46 * scale), Qt::AlignTop | Qt::AlignLeft, navaid.identifier());
 				}
-				else if (_params.range > _params.arpt_map_range_threshold)
-				{
-					// Draw airport runways:
-					for (xf::Navaid::Runway const& runway: navaid.runways())
-					{
-						// Make the drawn runway somewhat more wide:
-						double half_width = 1.5 * to_px (runway.width());
-						QTransform tr_l; tr_l.translate (-half_width, 0.0);
-						QTransform tr_r; tr_r.translate (+half_width, 0.0);
-						// Find runway's true bearing from pos_1 to pos_2 and runway
-						// length in pixels:
-						Angle true_bearing = runway.pos_1().initial_bearing (runway.pos_2());
-						double length_px = to_px (runway.pos_1().haversine_earth (runway.pos_2()));
-						double extended_length_px = to_px (_params.arpt_runway_extension_length);
-						// Create transform so that the first end of the runway
-						// is at (0, 0) and runway extends to the top.
-						QPointF point_1 = get_navaid_xy (runway.pos_1());
-						QTransform transform = _aircraft_center_transform;
-						transform.translate (point_1.x(), point_1.y());
-						transform = _features_transform * transform;
-						transform.rotate (true_bearing.quantity<Degree>());
-
-						painter.setTransform (transform);
-						// The runway:
-						painter.setPen (get_pen (Qt::white, 1.0));
-						painter.drawLine (tr_l.map (QPointF (0.0, 0.0)), tr_l.map (QPointF (0.0, -length_px)));
-						painter.drawLine (tr_r.map (QPointF (0.0, 0.0)), tr_r.map (QPointF (0.0, -length_px)));
-						// Extended runway:
-						double m_px = xf::limit<double> (to_px (1_m), 0.02, 0.04);
-						QPen dashed_pen = get_pen (Qt::white, 1.0, Qt::DashLine);
-						dashed_pen.setDashPattern (QVector<qreal>() << 300 * m_px << 200 * m_px);
-						painter.setPen (dashed_pen);
-						painter.drawLine (QPointF (0.0, 0.0), QPointF (0.0, extended_length_px));
-						painter.drawLine (QPointF (0.0, -length_px), QPointF (0.0, -length_px - extended_length_px));
-					}
-				}
-				else
-				{
-					// TODO airport map
-				}
 				break;
 			}
 
@@ -1578,25 +1622,26 @@ HSIWidget::PaintWorkUnit::paint_navaids (xf::Painter& painter)
 		}
 	};
 
+	auto paint_navaids_group = [&](NavaidStorage::NavaidRefs const& navaids, std::vector<QPointF> const& layer_positions)
+	{
+		for (std::size_t i = 0; i < navaids.size() && i < layer_positions.size(); ++i)
+			paint_navaid (*navaids[i], layer_positions[i]);
+	};
+
 	if (_params.fix_visible)
-		for (auto& navaid: _fix_navs)
-			paint_navaid (navaid);
+		paint_navaids_group (_fix_navs, _map_layer.fix_xy);
 
 	if (_params.ndb_visible)
-		for (auto& navaid: _ndb_navs)
-			paint_navaid (navaid);
+		paint_navaids_group (_ndb_navs, _map_layer.ndb_xy);
 
 	if (_params.dme_visible)
-		for (auto& navaid: _dme_navs)
-			paint_navaid (navaid);
+		paint_navaids_group (_dme_navs, _map_layer.dme_xy);
 
 	if (_params.vor_visible)
-		for (auto& navaid: _vor_navs)
-			paint_navaid (navaid);
+		paint_navaids_group (_vor_navs, _map_layer.vor_xy);
 
 	if (_params.arpt_visible)
-		for (auto& navaid: _arpt_navs)
-			paint_navaid (navaid);
+		paint_navaids_group (_arpt_navs, _map_layer.arpt_xy);
 
 	if (_params.home)
 	{
@@ -1654,35 +1699,73 @@ HSIWidget::PaintWorkUnit::paint_navaids (xf::Painter& painter)
 
 
 void
-HSIWidget::PaintWorkUnit::paint_locs()
+HSIWidget::PaintWorkUnit::render_map_layer()
+{
+	LonLat const reference = *_params.position;
+	// Layer is re-rendered when aircraft moves by 0.1 of the range,
+	// so it needs such margin:
+	float const drift_margin = 0.1f * _r + 2.f;
+
+	// Cover whole visible map, but not more than outer clip (a square with half-side of _r):
+	QPointF const center = _aircraft_center_transform.map (QPointF (0.f, 0.f));
+	float visible_radius = 0.f;
+	for (QPointF corner: { QPointF (0.f, 0.f), QPointF (size().width(), 0.f), QPointF (0.f, size().height()), QPointF (size().width(), size().height()) })
+	{
+		QPointF d = corner - center;
+		visible_radius = std::max<float> (visible_radius, std::sqrt (d.x() * d.x() + d.y() * d.y()));
+	}
+	visible_radius = std::min (visible_radius, std::sqrt (2.f) * _r);
+
+	int const side = 2 * static_cast<int> (std::ceil (visible_radius + drift_margin));
+
+	_map_layer.valid = true;
+	_map_layer.position = reference;
+	_map_layer.image = QImage (side, side, QImage::Format_ARGB32_Premultiplied);
+	_map_layer.image.fill (Qt::transparent);
+
+	auto compute_positions = [&](NavaidStorage::NavaidRefs const& navaids, std::vector<QPointF>& positions)
+	{
+		positions.clear();
+		positions.reserve (navaids.size());
+		for (Navaid const* navaid: navaids)
+			positions.push_back (get_north_up_xy (navaid->position(), reference));
+	};
+
+	compute_positions (_fix_navs, _map_layer.fix_xy);
+	compute_positions (_ndb_navs, _map_layer.ndb_xy);
+	compute_positions (_dme_navs, _map_layer.dme_xy);
+	compute_positions (_vor_navs, _map_layer.vor_xy);
+	compute_positions (_arpt_navs, _map_layer.arpt_xy);
+
+	xf::Painter layer_painter (&_map_layer.image, &_text_painter_cache);
+	layer_painter.setRenderHint (QPainter::Antialiasing, true);
+	layer_painter.setRenderHint (QPainter::NonCosmeticDefaultPen, true);
+	layer_painter.setFont (_font_10);
+
+	paint_locs (layer_painter);
+	paint_runways (layer_painter);
+}
+
+
+void
+HSIWidget::PaintWorkUnit::paint_locs (xf::Painter& layer_painter)
 {
+	_map_layer.loc_labels.clear();
+
 	if (!_params.loc_visible)
 		return;
 
-	QFontMetricsF font_metrics (painter().font());
+	QFontMetricsF font_metrics (layer_painter.font());
 	QTransform rot_1; rot_1.rotate (-2.f);
 	QTransform rot_2; rot_2.rotate (+2.f);
 	QPointF zero (0.f, 0.f);
+	QTransform layer_center_transform = QTransform::fromTranslate (0.5 * _map_layer.image.width(), 0.5 * _map_layer.image.height());
 
-	// Group painting lines and texts as separate tasks. For this,
-	// cache texts that need to be drawn later along with their positions.
-	std::vector<std::pair<QPointF, QString>> texts_to_paint;
-	texts_to_paint.reserve (128);
-
-	auto paint_texts_to_paint = [&]() -> void
-	{
-		painter().resetTransform();
-		for (auto const& text_and_xy: texts_to_paint)
-			painter().fast_draw_text (text_and_xy.first, text_and_xy.second);
-		texts_to_paint.clear();
-	};
-
-	auto paint_loc = [&] (Navaid const& navaid) -> void
+	auto paint_loc = [&] (Navaid const& navaid, bool highlighted) -> void
 	{
-		QPointF navaid_pos = get_navaid_xy (navaid.position());
-		QTransform transform = _aircraft_center_transform;
+		QPointF navaid_pos = get_north_up_xy (navaid.position(), _map_layer.position);
+		QTransform transform;
 		transform.translate (navaid_pos.x(), navaid_pos.y());
-		transform = _features_transform * transform;
 		transform.rotate (navaid.true_bearing().quantity<Degree>());
 
 		float const line_1 = to_px (navaid.range());
@@ -1692,40 +1775,85 @@ HSIWidget::PaintWorkUnit::paint_locs()
 		QPointF pt_1 (rot_1.map (QPointF (0.f, line_2)));
 		QPointF pt_2 (rot_2.map (QPointF (0.f, line_2)));
 
-		painter().setTransform (transform);
+		layer_painter.setTransform (transform * layer_center_transform);
 		if (_params.range < 16_nmi)
-			painter().drawLine (zero, pt_0);
-		painter().drawLine (zero, pt_1);
-		painter().drawLine (zero, pt_2);
-		painter().drawLine (pt_0, pt_1);
-		painter().drawLine (pt_0, pt_2);
+			layer_painter.drawLine (zero, pt_0);
+		layer_painter.drawLine (zero, pt_1);
+		layer_painter.drawLine (zero, pt_2);
+		layer_painter.drawLine (pt_0, pt_1);
+		layer_painter.drawLine (pt_0, pt_2);
 
 		QPointF text_offset (0.5f * font_metrics.width (navaid.identifier()), -0.35f * font_metrics.height());
-		texts_to_paint.emplace_back (transform.map (pt_0 + QPointF (0.f, 0.6f * _q)) - text_offset, navaid.identifier());
+		_map_layer.loc_labels.push_back ({ transform.map (pt_0 + QPointF (0.f, 0.6f * _q)), text_offset, navaid.identifier(), highlighted });
 	};
 
 	// Paint localizers:
-	painter().setBrush (Qt::NoBrush);
-	painter().setPen (_lo_loc_pen);
+	layer_painter.setBrush (Qt::NoBrush);
+	layer_painter.setPen (_lo_loc_pen);
 	Navaid const* hi_loc = nullptr;
-	for (auto& navaid: _loc_navs)
+	for (Navaid const* navaid: _loc_navs)
 	{
 		// Paint highlighted LOC at the end, so it's on top:
-		if (navaid.identifier() == _params.highlighted_loc)
-			hi_loc = &navaid;
+		if (navaid->identifier() == _params.highlighted_loc)
+			hi_loc = navaid;
 		else
-			paint_loc (navaid);
+			paint_loc (*navaid, false);
 	}
 
-	// Paint identifiers:
-	paint_texts_to_paint();
-
-	// Highlighted localizer with text:
+	// Highlighted localizer:
 	if (hi_loc)
 	{
-		painter().setPen (_hi_loc_pen);
-		paint_loc (*hi_loc);
-		paint_texts_to_paint();
+		layer_painter.setPen (_hi_loc_pen);
+		paint_loc (*hi_loc, true);
+	}
+}
+
+
+void
+HSIWidget::PaintWorkUnit::paint_runways (xf::Painter& layer_painter)
+{
+	if (!_params.arpt_visible)
+		return;
+
+	if (_params.range > _params.arpt_runways_range_threshold || _params.range <= _params.arpt_map_range_threshold)
+		return;
+
+	QTransform layer_center_transform = QTransform::fromTranslate (0.5 * _map_layer.image.width(), 0.5 * _map_layer.image.height());
+	double extended_length_px = to_px (_params.arpt_runway_extension_length);
+	double m_px = xf::limit<double> (to_px (1_m), 0.02, 0.04);
+	QPen runway_pen = get_pen (Qt::white, 1.0);
+	QPen dashed_pen = get_pen (Qt::white, 1.0, Qt::DashLine);
+	dashed_pen.setDashPattern (QVector<qreal>() << 300 * m_px << 200 * m_px);
+
+	for (Navaid const* navaid: _arpt_navs)
+	{
+		for (xf::Navaid::Runway const& runway: navaid->runways())
+		{
+			// Make the drawn runway somewhat more wide:
+			double half_width = 1.5 * to_px (runway.width());
+			QTransform tr_l; tr_l.translate (-half_width, 0.0);
+			QTransform tr_r; tr_r.translate (+half_width, 0.0);
+			// Find runway's true bearing from pos_1 to pos_2 and runway
+			// length in pixels:
+			Angle true_bearing = runway.pos_1().initial_bearing (runway.pos_2());
+			double length_px = to_px (runway.pos_1().haversine_earth (runway.pos_2()));
+			// Create transform so that the first end of the runway
+			// is at (0, 0) and runway extends to the top.
+			QPointF point_1 = get_north_up_xy (runway.pos_1(), _map_layer.position);
+			QTransform transform;
+			transform.translate (point_1.x(), point_1.y());
+			transform.rotate (true_bearing.quantity<Degree>());
+
+			layer_painter.setTransform (transform * layer_center_transform);
+			// The runway:
+			layer_painter.setPen (runway_pen);
+			layer_painter.drawLine (tr_l.map (QPointF (0.0, 0.0)), tr_l.map (QPointF (0.0, -length_px)));
+			layer_painter.drawLine (tr_r.map (QPointF (0.0, 0.0)), tr_r.map (QPointF (0.0, -length_px)));
+			// Extended runway:
+			layer_painter.setPen (dashed_pen);
+			layer_painter.drawLine (QPointF (0.0, 0.0), QPointF (0.0, extended_length_px));
+			layer_painter.drawLine (QPointF (0.0, -length_px), QPointF (0.0, -length_px - extended_length_px));
+		}
 	}
 }
 
@@ -1782,56 +1910,113 @@ HSIWidget::PaintWorkUnit::paint_tcas()
 void
 HSIWidget::PaintWorkUnit::retrieve_navaids()
 {
-	if (!_navaid_storage || !_params.position)
-		return;
-
-	if (_navs_retrieved && _navs_retrieve_position.haversine_earth (*_params.position) < 0.1f * _params.range && _params.range == _navs_retrieve_range)
+	if (!_navaid_storage || !_navaid_storage->loaded() || !_params.position)
 		return;
 
-	_fix_navs.clear();
-	_vor_navs.clear();
-	_dme_navs.clear();
-	_ndb_navs.clear();
-	_loc_navs.clear();
-	_arpt_navs.clear();
+	Length const retrieve_radius = std::max (_params.range + 20_nmi, 2.f * _params.range);
+	NavaidStorage::TypeFilter const drawn_types { Navaid::LOC, Navaid::NDB, Navaid::VOR, Navaid::DME, Navaid::FIX, Navaid::ARPT };
 
-	for (Navaid const& navaid: _navaid_storage->get_navs (*_params.position, std::max (_params.range + 20_nmi, 2.f * _params.range)))
+	if (!_navs_retrieved || _params.range != _navs_retrieve_range)
 	{
-		switch (navaid.type())
+		// Release previously pinned tiles after the query, so that tiles still in range aren't reloaded:
+		NavaidStorage::TilePins previous_pins;
+		previous_pins.swap (_navaid_pins);
+
+		for (Navaid::Type type: { Navaid::LOC, Navaid::NDB, Navaid::VOR, Navaid::DME, Navaid::FIX, Navaid::ARPT })
+			navaids_group (type).first->clear();
+
+		for (Navaid const* navaid: _navaid_storage->get_nav_refs (*_params.position, retrieve_radius, _navaid_pins, drawn_types))
 		{
-			case Navaid::LOC:
-				_loc_navs.push_back (navaid);
-				break;
+			NavaidStorage::NavaidRefs* navaids = navaids_group (navaid->type()).first;
+			if (navaids)
+				navaids->push_back (navaid);
+		}
 
-			case Navaid::NDB:
-				_ndb_navs.push_back (navaid);
-				break;
+		_navs_retrieved = true;
+		_navs_retrieve_position = *_params.position;
+		_navs_retrieve_range = _params.range;
+		_map_layer.valid = false;
+	}
+	else if (_navs_retrieve_position.haversine_earth (*_params.position) >= 0.01f * _params.range)
+	{
+		// Only search the area between the old and new circles, so that cost of each update is small:
+		apply_navaids_delta (_navaid_storage->get_nav_delta (_navs_retrieve_position, retrieve_radius, *_params.position, retrieve_radius, _navaid_pins, drawn_types));
+		_navs_retrieve_position = *_params.position;
+	}
+}
 
-			case Navaid::VOR:
-				_vor_navs.push_back (navaid);
-				break;
 
-			case Navaid::DME:
-				_dme_navs.push_back (navaid);
-				break;
+void
+HSIWidget::PaintWorkUnit::apply_navaids_delta (NavaidStorage::NavaidDelta const& delta)
+{
+	std::unordered_set<Navaid const*> const left (delta.left.begin(), delta.left.end());
 
-			case Navaid::FIX:
-				_fix_navs.push_back (navaid);
-				break;
+	// Features painted into the map layer image (see paint_locs() and paint_runways()):
+	bool const locs_in_layer = _params.loc_visible;
+	bool const runways_in_layer = _params.arpt_visible && _params.range <= _params.arpt_runways_range_threshold && _params.range > _params.arpt_map_range_threshold;
 
-			case Navaid::ARPT:
-				_arpt_navs.push_back (navaid);
-				break;
+	auto affects_layer_image = [&](Navaid const* navaid) -> bool {
+		return (locs_in_layer && navaid->type() == Navaid::LOC) || (runways_in_layer && navaid->type() == Navaid::ARPT);
+	};
 
-			default:
-				// Other types not drawn.
-				break;
+	if (!left.empty())
+	{
+		for (Navaid::Type type: { Navaid::LOC, Navaid::NDB, Navaid::VOR, Navaid::DME, Navaid::FIX, Navaid::ARPT })
+		{
+			auto group = navaids_group (type);
+			NavaidStorage::NavaidRefs& navaids = *group.first;
+			// Layer positions are parallel to navaids, keep them in sync:
+			std::vector<QPointF>* layer_xy = _map_layer.valid ? group.second : nullptr;
+			std::size_t kept = 0;
+
+			for (std::size_t i = 0; i < navaids.size(); ++i)
+			{
+				if (left.count (navaids[i]) == 0)
+				{
+					if (layer_xy)
+						(*layer_xy)[kept] = (*layer_xy)[i];
+					navaids[kept++] = navaids[i];
+				}
+			}
+
+			navaids.resize (kept);
+			if (layer_xy)
+				layer_xy->resize (kept);
 		}
 	}
 
-	_navs_retrieved = true;
-	_navs_retrieve_position = *_params.position;
-	_navs_retrieve_range = _params.range;
+	for (Navaid const* navaid: delta.entered)
+	{
+		auto group = navaids_group (navaid->type());
+		if (!group.first)
+			continue;
+
+		group.first->push_back (navaid);
+		if (_map_layer.valid && group.second)
+			group.second->push_back (get_north_up_xy (navaid->position(), _map_layer.position));
+	}
+
+	if (std::any_of (delta.entered.begin(), delta.entered.end(), affects_layer_image) ||
+		std::any_of (delta.left.begin(), delta.left.end(), affects_layer_image))
+	{
+		_map_layer.valid = false;
+	}
+}
+
+
+std::pair<NavaidStorage::NavaidRefs*, std::vector<QPointF>*>
+HSIWidget::PaintWorkUnit::navaids_group (Navaid::Type type)
+{
+	switch (type)
+	{
+		case Navaid::LOC:	return { &_loc_navs, nullptr };
+		case Navaid::NDB:	return { &_ndb_navs, &_map_layer.ndb_xy };
+		case Navaid::VOR:	return { &_vor_navs, &_map_layer.vor_xy };
+		case Navaid::DME:	return { &_dme_navs, &_map_layer.dme_xy };
+		case Navaid::FIX:	return { &_fix_navs, &_map_layer.fix_xy };
+		case Navaid::ARPT:	return { &_arpt_navs, &_map_layer.arpt_xy };
+		default:			return { nullptr, nullptr };
+	}
 }
 
 
@@ -1840,8 +2025,15 @@ HSIWidget::PaintWorkUnit::get_navaid_xy (LonLat const& position)
 {
 	if (!_params.position)
 		return QPointF();
-	QPointF navaid_pos = kEarthMeanRadius.quantity<NauticalMile>() * position.rotated (*_params.position).project_flat();
-	return _features_transform.map (QPointF (to_px (1_nmi * navaid_pos.x()), to_px (1_nmi * navaid_pos.y())));
+	return _features_transform.map (get_north_up_xy (position, *_params.position));
+}
+
+
+inline QPointF
+HSIWidget::PaintWorkUnit::get_north_up_xy (LonLat const& position, LonLat const& reference)
+{
+	QPointF navaid_pos = kEarthMeanRadius.quantity<NauticalMile>() * position.rotated (reference).project_flat();
+	return QPointF (to_px (1_nmi * navaid_pos.x()), to_px (1_nmi * navaid_pos.y()));
 }
 
 
@@ -16,10 +16,14 @@
 
 // Standard:
 #include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 // Qt:
 #include <QtCore/QDateTime>
 #include <QtGui/QColor>
+#include <QtGui/QImage>
 #include <QtWidgets/QWidget>
 
 // Xefis:
@@ -184,11 +188,52 @@ class HSIWidget: public xf::InstrumentWidget
 	{
 		friend class HSIWidget;
 
+		/**
+		 * Settings the map layer depends on: range, radius in pixels, display mode,
+		 * LOCs visible, airports visible, highlighted LOC, airport thresholds and
+		 * runway extension length.
+		 */
+		typedef std::tuple<Length, float, DisplayMode, bool, bool, QString, Length, Length, Length> MapLayerKey;
+
+		/**
+		 * Localizer identifier to be painted upright over the map layer.
+		 */
+		struct MapLayerLabel
+		{
+			QPointF	position;
+			QPointF	offset;
+			QString	text;
+			bool	highlighted;
+		};
+
+		/**
+		 * True-north-up map layer rendered around a reference position.
+		 * Contains map-fixed features (localizers, runways) as an image, and positions
+		 * of point features (symbols that stay upright) relative to the reference
+		 * position, so that per-frame work is only a rotate/translate of both.
+		 */
+		struct MapLayer
+		{
+			bool						valid	= false;
+			MapLayerKey					key;
+			LonLat						position;
+			QImage						image;
+			std::vector<QPointF>		fix_xy;
+			std::vector<QPointF>		ndb_xy;
+			std::vector<QPointF>		dme_xy;
+			std::vector<QPointF>		vor_xy;
+			std::vector<QPointF>		arpt_xy;
+			std::vector<MapLayerLabel>	loc_labels;
+		};
+
 	  public:
 		PaintWorkUnit (HSIWidget*);
 
 		~PaintWorkUnit() noexcept { }
 
+		xf::TextPainter::Cache const*
+		text_painter_cache() const override;
+
 		void
 		set_navaid_storage (NavaidStorage*);
 
@@ -211,6 +256,9 @@ class HSIWidget: public xf::InstrumentWidget
 		void
 		paint_hints (xf::Painter&);
 
+		void
+		paint_map_loading (xf::Painter&);
+
 		void
 		paint_ap_settings (xf::Painter&);
 
@@ -250,8 +298,23 @@ class HSIWidget: public xf::InstrumentWidget
 		void
 		paint_navaids (xf::Painter&);
 
+		/**
+		 * Render the map layer around current aircraft position.
+		 */
 		void
-		paint_locs();
+		render_map_layer();
+
+		/**
+		 * Paint localizers on the map layer image.
+		 */
+		void
+		paint_locs (xf::Painter&);
+
+		/**
+		 * Paint runways on the map layer image.
+		 */
+		void
+		paint_runways (xf::Painter&);
 
 		void
 		paint_tcas();
@@ -263,6 +326,21 @@ class HSIWidget: public xf::InstrumentWidget
 		void
 		retrieve_navaids();
 
+		/**
+		 * Update _*_navs variables (and point positions of the map layer)
+		 * with navaids that entered or left the retrieved area.
+		 */
+		void
+		apply_navaids_delta (NavaidStorage::NavaidDelta const&);
+
+		/**
+		 * Return _*_navs variable for given navaid type and map layer positions
+		 * of its navaids (nullptr if type isn't painted as a point feature).
+		 * Return nullptrs for types not painted at all.
+		 */
+		std::pair<NavaidStorage::NavaidRefs*, std::vector<QPointF>*>
+		navaids_group (Navaid::Type);
+
 		/**
 		 * Compute position where navaid should be drawn on map
 		 * relative to the aircraft (assumes usage with aircraft-centered transform).
@@ -270,6 +348,12 @@ class HSIWidget: public xf::InstrumentWidget
 		QPointF
 		get_navaid_xy (LonLat const& position);
 
+		/**
+		 * Compute true-north-up position in pixels of a feature relative to the reference position.
+		 */
+		QPointF
+		get_north_up_xy (LonLat const& position, LonLat const& reference);
+
 		/**
 		 * Trend vector range.
 		 */
@@ -333,12 +417,15 @@ class HSIWidget: public xf::InstrumentWidget
 		bool					_navs_retrieved				= false;
 		LonLat					_navs_retrieve_position		= { 0_deg, 0_deg };
 		Length					_navs_retrieve_range		= 0_nmi;
-		NavaidStorage::Navaids	_fix_navs;
-		NavaidStorage::Navaids	_vor_navs;
-		NavaidStorage::Navaids	_dme_navs;
-		NavaidStorage::Navaids	_ndb_navs;
-		NavaidStorage::Navaids	_loc_navs;
-		NavaidStorage::Navaids	_arpt_navs;
+		// Keeps tiles of retrieved navaids alive in region-streaming mode:
+		NavaidStorage::TilePins		_navaid_pins;
+		NavaidStorage::NavaidRefs	_fix_navs;
+		NavaidStorage::NavaidRefs	_vor_navs;
+		NavaidStorage::NavaidRefs	_dme_navs;
+		NavaidStorage::NavaidRefs	_ndb_navs;
+		NavaidStorage::NavaidRefs	_loc_navs;
+		NavaidStorage::NavaidRefs	_arpt_navs;
+		MapLayer				_map_layer;
 		Parameters				_params;
 		Parameters				_params_next;
 		LocalParameters			_locals;
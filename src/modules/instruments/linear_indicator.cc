@@ -34,7 +34,7 @@ XEFIS_REGISTER_MODULE_CLASS ("instruments/linear-indicator", LinearIndicator)
 LinearIndicator::LinearIndicator (xf::ModuleManager* module_manager, QDomElement const& config):
 	xf::Instrument (module_manager, config)
 {
-	_widget = new LinearIndicatorWidget (this);
+	_widget = new LinearIndicatorWidget (this, work_performer());
 
 	QVBoxLayout* layout = new QVBoxLayout (this);
 	layout->setMargin (0);
@@ -66,11 +66,12 @@ LinearIndicator::data_updated()
 {
 	if (_initialize || _value.fresh())
 	{
-		_widget->set_mirrored_style (_style_mirrored);
-		_widget->set_range (xf::Range<double> { _value_minimum, _value_maximum });
-		_widget->set_precision (_value_precision);
-		_widget->set_modulo (_value_modulo);
-		_widget->set_digits (_value_digits);
+		LinearIndicatorWidget::Parameters params;
+		params.mirrored = _style_mirrored;
+		params.range = xf::Range<double> { _value_minimum, _value_maximum };
+		params.precision = _value_precision;
+		params.modulo = _value_modulo;
+		params.digits = _value_digits;
 
 		Optional<double> value;
 		if (_value.valid())
@@ -84,11 +85,12 @@ LinearIndicator::data_updated()
 			}
 		}
 
-		_widget->set_value (value);
-		_widget->set_minimum_critical_value (_value_minimum_critical);
-		_widget->set_minimum_warning_value (_value_minimum_warning);
-		_widget->set_maximum_warning_value (_value_maximum_warning);
-		_widget->set_maximum_critical_value (_value_maximum_critical);
+		params.value = value;
+		params.minimum_critical_value = _value_minimum_critical;
+		params.minimum_warning_value = _value_minimum_warning;
+		params.maximum_warning_value = _value_maximum_warning;
+		params.maximum_critical_value = _value_maximum_critical;
+		_widget->set_params (params);
 
 		_initialize = false;
 	}
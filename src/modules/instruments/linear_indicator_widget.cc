@@ -27,39 +27,40 @@
 #include "linear_indicator_widget.h"
 
 
-LinearIndicatorWidget::LinearIndicatorWidget (QWidget* parent):
-	InstrumentWidget (parent),
+LinearIndicatorWidget::PaintWorkUnit::PaintWorkUnit (LinearIndicatorWidget* widget):
+	InstrumentWidget::PaintWorkUnit (widget),
 	InstrumentAids (0.8f)
 { }
 
 
 void
-LinearIndicatorWidget::resizeEvent (QResizeEvent* event)
+LinearIndicatorWidget::PaintWorkUnit::pop_params()
 {
-	InstrumentWidget::resizeEvent (event);
+	_params = _params_next;
+}
 
-	auto xw = dynamic_cast<xf::Window*> (window());
-	if (xw)
-		InstrumentAids::set_scaling (1.2f * xw->pen_scale(), 0.95f * xw->font_scale());
 
-	InstrumentAids::update_sizes (size(), window()->size());
+void
+LinearIndicatorWidget::PaintWorkUnit::resized()
+{
+	InstrumentAids::update_sizes (size(), window_size());
 }
 
 
 void
-LinearIndicatorWidget::paintEvent (QPaintEvent*)
+LinearIndicatorWidget::PaintWorkUnit::paint (QImage& image)
 {
-	auto painting_token = get_token (this);
+	auto painting_token = get_token (&image);
 
-	float const w = width();
-	float const h = height();
+	float const w = size().width();
+	float const h = size().height();
 
 	QPen pen_white = get_pen (Qt::white, 1.f);
 	QPen pen_silver = get_pen (QColor (0xbb, 0xbd, 0xbf), 1.f);
 
 	clear_background();
 
-	if (_mirrored)
+	if (_params.mirrored)
 	{
 		painter().translate (w, 0.f);
 		painter().scale (-1.f, 1.f);
@@ -77,10 +78,10 @@ LinearIndicatorWidget::paintEvent (QPaintEvent*)
 	painter().setPen (pen_silver);
 	painter().drawLine (p0, p1);
 
-	if (_value)
+	if (_params.value)
 	{
-		auto value = xf::limit<double> (*_value, _range.min(), _range.max());
-		bool inbound = _range.includes (*_value);
+		auto value = xf::limit<double> (*_params.value, _params.range.min(), _params.range.max());
+		bool inbound = _params.range.includes (*_params.value);
 
 		if (inbound)
 			painter().setBrush (Qt::white);
@@ -92,7 +93,7 @@ LinearIndicatorWidget::paintEvent (QPaintEvent*)
 			<< QPointF (0.f, 0.f)
 			<< QPointF (1.9f * q, -0.5f * q)
 			<< QPointF (1.9f * q, +0.5f * q);
-		polygon.translate (p1.x(), xf::renormalize (value, _range.min(), _range.max(), p1.y(), p0.y()));
+		polygon.translate (p1.x(), xf::renormalize (value, _params.range.min(), _params.range.max(), p1.y(), p0.y()));
 		painter().add_shadow ([&] {
 			painter().drawPolygon (polygon);
 		});
@@ -106,8 +107,8 @@ LinearIndicatorWidget::paintEvent (QPaintEvent*)
 	float hcorr = 0.025f * metrics.height();
 
 	QString text;
-	if (_value)
-		text = stringify_value (*_value);
+	if (_params.value)
+		text = stringify_value (*_params.value);
 	text = pad_string (text);
 
 	painter().setFont (font);
@@ -117,7 +118,7 @@ LinearIndicatorWidget::paintEvent (QPaintEvent*)
 	painter().setBrush (Qt::NoBrush);
 	painter().drawRect (text_rect);
 	QPointF position;
-	if (_mirrored)
+	if (_params.mirrored)
 	{
 		position = QPointF (text_rect.left() + 0.25f * char_width, text_rect.center().y());
 		position = painter().transform().map (position);
@@ -130,20 +131,59 @@ LinearIndicatorWidget::paintEvent (QPaintEvent*)
 
 
 QString
-LinearIndicatorWidget::stringify_value (double value) const
+LinearIndicatorWidget::PaintWorkUnit::stringify_value (double value) const
 {
 	double numeric_value = value;
-	if (_precision < 0)
-		numeric_value /= std::pow (10.0, -_precision);
-	if (_modulo > 0)
-		numeric_value = static_cast<int> (numeric_value) / _modulo * _modulo;
-	return QString ("%1").arg (numeric_value, 0, 'f', std::max (0, _precision));
+	if (_params.precision < 0)
+		numeric_value /= std::pow (10.0, -_params.precision);
+	if (_params.modulo > 0)
+		numeric_value = static_cast<int> (numeric_value) / _params.modulo * _params.modulo;
+	return QString ("%1").arg (numeric_value, 0, 'f', std::max (0, _params.precision));
 }
 
 
 QString
-LinearIndicatorWidget::pad_string (QString const& input) const
+LinearIndicatorWidget::PaintWorkUnit::pad_string (QString const& input) const
+{
+	return QString ("%1").arg (input, _params.digits);
+}
+
+
+LinearIndicatorWidget::LinearIndicatorWidget (QWidget* parent, xf::WorkPerformer* work_performer):
+	InstrumentWidget (parent, work_performer),
+	_local_paint_work_unit (this)
+{
+	set_painter (&_local_paint_work_unit);
+}
+
+
+LinearIndicatorWidget::~LinearIndicatorWidget()
+{
+	wait_for_painter();
+}
+
+
+void
+LinearIndicatorWidget::set_params (Parameters const& new_params)
 {
-	return QString ("%1").arg (input, _digits);
+	_params = new_params;
+	request_repaint();
 }
 
+
+void
+LinearIndicatorWidget::resizeEvent (QResizeEvent* event)
+{
+	InstrumentWidget::resizeEvent (event);
+
+	auto xw = dynamic_cast<xf::Window*> (window());
+	if (xw)
+		_local_paint_work_unit.set_scaling (1.2f * xw->pen_scale(), 0.95f * xw->font_scale());
+}
+
+
+void
+LinearIndicatorWidget::push_params()
+{
+	_local_paint_work_unit._params_next = _params;
+}
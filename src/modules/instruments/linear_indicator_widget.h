@@ -25,194 +25,98 @@
 #include <xefis/config/all.h>
 #include <xefis/core/instrument_widget.h>
 #include <xefis/core/instrument_aids.h>
+#include <xefis/core/work_performer.h>
 #include <xefis/utility/painter.h>
 #include <xefis/utility/range.h>
 
 
-class LinearIndicatorWidget:
-	public xf::InstrumentWidget,
-	protected xf::InstrumentAids
+class LinearIndicatorWidget: public xf::InstrumentWidget
 {
   public:
-	// Ctor
-	LinearIndicatorWidget (QWidget* parent);
-
-	/**
-	 * Set mirrored style.
-	 */
-	void
-	set_mirrored_style (bool);
+	class Parameters
+	{
+	  public:
+		bool				mirrored				= false;
+		xf::Range<double>	range					= { 0.0, 1.0 };
+		int					precision				= 0;
+		int					modulo					= 0;
+		unsigned int		digits					= 3;
+		Optional<double>	value;
+		Optional<double>	minimum_critical_value;
+		Optional<double>	minimum_warning_value;
+		Optional<double>	maximum_warning_value;
+		Optional<double>	maximum_critical_value;
+		Optional<double>	normal_value;
+		Optional<double>	target_value;
+	};
 
-	/**
-	 * Set new range to be used with LinearIndicatorWidget.
-	 */
-	void
-	set_range (xf::Range<double>);
+  private:
+	class PaintWorkUnit:
+		public xf::InstrumentWidget::PaintWorkUnit,
+		protected xf::InstrumentAids
+	{
+		friend class LinearIndicatorWidget;
+
+	  public:
+		PaintWorkUnit (LinearIndicatorWidget*);
+
+		~PaintWorkUnit() noexcept { }
+
+	  private:
+		void
+		pop_params() override;
+
+		void
+		resized() override;
+
+		void
+		paint (QImage&) override;
+
+		/**
+		 * Convert value to string using precision and modulo parameters.
+		 * Negative precision means value will be divided by 10^n.
+		 * Positive modulo means value will be converted to int,
+		 * divided by n and then multipled by n again.
+		 */
+		QString
+		stringify_value (double value) const;
+
+		/**
+		 * Pad string to the configured number of digits.
+		 */
+		QString
+		pad_string (QString const& input) const;
+
+	  private:
+		Parameters	_params;
+		Parameters	_params_next;
+	};
 
-	/**
-	 * Set precision (digits after decimal point).
-	 * Negative values are accepted (value will be divided by 10^n).
-	 */
-	void
-	set_precision (int precision);
+  public:
+	// Ctor
+	LinearIndicatorWidget (QWidget* parent, xf::WorkPerformer*);
 
-	/**
-	 * Set modulo value. If > 0, value will be converted to int,
-	 * divided by n and the multipled by n again.
-	 */
-	void
-	set_modulo (unsigned int modulo);
+	// Dtor
+	~LinearIndicatorWidget();
 
 	/**
-	 * Set number of digits displayed.
+	 * Set new params for the widget.
 	 */
 	void
-	set_digits (unsigned int digits);
-
-	void
-	set_value (Optional<double>);
-
-	void
-	set_minimum_critical_value (Optional<double>);
-
-	void
-	set_minimum_warning_value (Optional<double>);
-
-	void
-	set_maximum_warning_value (Optional<double>);
-
-	void
-	set_maximum_critical_value (Optional<double>);
-
-	void
-	set_normal_value (Optional<double>);
-
-	void
-	set_target_value (Optional<double>);
+	set_params (Parameters const&);
 
   protected:
+	// API of QWidget
 	void
 	resizeEvent (QResizeEvent*) override;
 
+	// API of InstrumentWidget
 	void
-	paintEvent (QPaintEvent*) override;
-
-	QString
-	stringify_value (double value) const;
-
-	QString
-	pad_string (QString const& input) const;
+	push_params() override;
 
   private:
-	bool				_mirrored			= false;
-	xf::Range<double>	_range				= { 0.0, 1.0 };
-	int					_precision			= 0;
-	int					_modulo				= 0;
-	unsigned int		_digits				= 3;
-	Optional<double>	_value;
-	Optional<double>	_minimum_critical_value;
-	Optional<double>	_minimum_warning_value;
-	Optional<double>	_maximum_warning_value;
-	Optional<double>	_maximum_critical_value;
-	Optional<double>	_normal_value;
-	Optional<double>	_target_value;
+	PaintWorkUnit	_local_paint_work_unit;
+	Parameters		_params;
 };
 
-
-inline void
-LinearIndicatorWidget::set_mirrored_style (bool mirrored)
-{
-	_mirrored = mirrored;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_range (xf::Range<double> range)
-{
-	_range = range;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_precision (int precision)
-{
-	_precision = precision;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_modulo (unsigned int modulo)
-{
-	_modulo = modulo;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_digits (unsigned int digits)
-{
-	_digits = digits;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_value (Optional<double> value)
-{
-	_value = value;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_minimum_critical_value (Optional<double> value)
-{
-	_minimum_critical_value = value;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_minimum_warning_value (Optional<double> value)
-{
-	_minimum_warning_value = value;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_maximum_warning_value (Optional<double> value)
-{
-	_maximum_warning_value = value;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_maximum_critical_value (Optional<double> value)
-{
-	_maximum_critical_value = value;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_normal_value (Optional<double> value)
-{
-	_normal_value = value;
-	update();
-}
-
-
-inline void
-LinearIndicatorWidget::set_target_value (Optional<double> value)
-{
-	_target_value = value;
-	update();
-}
-
 #endif
-
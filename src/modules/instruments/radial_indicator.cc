@@ -34,7 +34,7 @@ XEFIS_REGISTER_MODULE_CLASS ("instruments/radial-indicator", RadialIndicator)
 RadialIndicator::RadialIndicator (xf::ModuleManager* module_manager, QDomElement const& config):
 	xf::Instrument (module_manager, config)
 {
-	_widget = new RadialIndicatorWidget (this);
+	_widget = new RadialIndicatorWidget (this, work_performer());
 
 	QVBoxLayout* layout = new QVBoxLayout (this);
 	layout->setMargin (0);
@@ -65,16 +65,17 @@ RadialIndicator::data_updated()
 {
 	if (_initialize || _value.fresh() || _value_target.fresh() || _value_reference.fresh() || _value_automatic.fresh())
 	{
-		_widget->set_range (xf::Range<double> { _value_minimum, _value_maximum });
-		_widget->set_precision (_value_precision);
-		_widget->set_modulo (_value_modulo);
-
-		_widget->set_value (get_optional_value (_value));
-		_widget->set_warning_value (_value_maximum_warning);
-		_widget->set_critical_value (_value_maximum_critical);
-		_widget->set_target_value (get_optional_value (_value_target));
-		_widget->set_reference_value (get_optional_value (_value_reference));
-		_widget->set_automatic_value (get_optional_value (_value_automatic));
+		RadialIndicatorWidget::Parameters params;
+		params.range = xf::Range<double> { _value_minimum, _value_maximum };
+		params.precision = _value_precision;
+		params.modulo = _value_modulo;
+		params.value = get_optional_value (_value);
+		params.warning_value = _value_maximum_warning;
+		params.critical_value = _value_maximum_critical;
+		params.target_value = get_optional_value (_value_target);
+		params.reference_value = get_optional_value (_value_reference);
+		params.automatic_value = get_optional_value (_value_automatic);
+		_widget->set_params (params);
 
 		_initialize = false;
 	}
@@ -27,32 +27,33 @@
 #include "radial_indicator_widget.h"
 
 
-RadialIndicatorWidget::RadialIndicatorWidget (QWidget* parent):
-	InstrumentWidget (parent),
+RadialIndicatorWidget::PaintWorkUnit::PaintWorkUnit (RadialIndicatorWidget* widget):
+	InstrumentWidget::PaintWorkUnit (widget),
 	InstrumentAids (0.9f)
 { }
 
 
 void
-RadialIndicatorWidget::resizeEvent (QResizeEvent* event)
+RadialIndicatorWidget::PaintWorkUnit::pop_params()
 {
-	InstrumentWidget::resizeEvent (event);
+	_params = _params_next;
+}
 
-	auto xw = dynamic_cast<xf::Window*> (window());
-	if (xw)
-		InstrumentAids::set_scaling (1.2f * xw->pen_scale(), 0.95f * xw->font_scale());
 
-	InstrumentAids::update_sizes (size(), window()->size());
+void
+RadialIndicatorWidget::PaintWorkUnit::resized()
+{
+	InstrumentAids::update_sizes (size(), window_size());
 }
 
 
 void
-RadialIndicatorWidget::paintEvent (QPaintEvent*)
+RadialIndicatorWidget::PaintWorkUnit::paint (QImage& image)
 {
-	auto painting_token = get_token (this);
+	auto painting_token = get_token (&image);
 
-	float const w = width();
-	float const h = height();
+	float const w = size().width();
+	float const h = size().height();
 
 	clear_background();
 
@@ -67,23 +68,23 @@ RadialIndicatorWidget::paintEvent (QPaintEvent*)
 
 
 QString
-RadialIndicatorWidget::stringify_value (double value) const
+RadialIndicatorWidget::PaintWorkUnit::stringify_value (double value) const
 {
 	double numeric_value = value;
-	if (_precision < 0)
-		numeric_value /= std::pow (10.0, -_precision);
-	if (_modulo > 0)
-		numeric_value = static_cast<int> (numeric_value) / _modulo * _modulo;
-	return QString ("%1").arg (numeric_value, 0, 'f', std::max (0, _precision));
+	if (_params.precision < 0)
+		numeric_value /= std::pow (10.0, -_params.precision);
+	if (_params.modulo > 0)
+		numeric_value = static_cast<int> (numeric_value) / _params.modulo * _params.modulo;
+	return QString ("%1").arg (numeric_value, 0, 'f', std::max (0, _params.precision));
 }
 
 
 void
-RadialIndicatorWidget::paint_text (float q, float)
+RadialIndicatorWidget::PaintWorkUnit::paint_text (float q, float)
 {
 	QString text;
-	if (_value)
-		text = stringify_value (*_value);
+	if (_params.value)
+		text = stringify_value (*_params.value);
 
 	QFont font (_font_20);
 	QFontMetricsF metrics (font);
@@ -104,7 +105,7 @@ RadialIndicatorWidget::paint_text (float q, float)
 	painter().save();
 
 	painter().setFont (font);
-	if (_value)
+	if (_params.value)
 	{
 		painter().setPen (pen);
 		painter().drawRect (rect);
@@ -116,13 +117,13 @@ RadialIndicatorWidget::paint_text (float q, float)
 		painter().drawRect (rect);
 	}
 
-	if (_reference_value)
+	if (_params.reference_value)
 	{
 		painter().setFont (small_font);
 		painter().setPen (get_pen (Qt::green, 1.0f));
 		painter().fast_draw_text (QPointF (text_rect.right() - zero_width + small_zero_width, text_rect.top()),
 								  Qt::AlignBottom | Qt::AlignRight,
-								  stringify_value (*_reference_value));
+								  stringify_value (*_params.reference_value));
 	}
 
 	painter().restore();
@@ -130,7 +131,7 @@ RadialIndicatorWidget::paint_text (float q, float)
 
 
 void
-RadialIndicatorWidget::paint_indicator (float, float r)
+RadialIndicatorWidget::PaintWorkUnit::paint_indicator (float, float r)
 {
 	QColor silver (0xbb, 0xbd, 0xbf);
 	QColor gray (0x7a, 0x7a, 0x7a);
@@ -166,33 +167,33 @@ RadialIndicatorWidget::paint_indicator (float, float r)
 	QRectF rect (-r, -r, 2.f * r, 2.f * r);
 
 	float value_span_angle = 210.f;
-	float value = _value ? limit (*_value, _range) : 0.f;
-	float warning = _warning_value ? limit (*_warning_value, _range) : 0.f;
-	float critical = _critical_value ? limit (*_critical_value, _range) : 0.f;
-	float reference = _reference_value ? limit (*_reference_value, _range) : 0.f;
-	float target = _target_value ? limit (*_target_value, _range) : 0.f;
-	float automatic = _automatic_value ? limit (*_automatic_value, _range) : 0.f;
-
-	if (!_warning_value)
-		warning = _range.max();
-	if (!_critical_value)
-		critical = _range.max();
+	float value = _params.value ? limit (*_params.value, _params.range) : 0.f;
+	float warning = _params.warning_value ? limit (*_params.warning_value, _params.range) : 0.f;
+	float critical = _params.critical_value ? limit (*_params.critical_value, _params.range) : 0.f;
+	float reference = _params.reference_value ? limit (*_params.reference_value, _params.range) : 0.f;
+	float target = _params.target_value ? limit (*_params.target_value, _params.range) : 0.f;
+	float automatic = _params.automatic_value ? limit (*_params.automatic_value, _params.range) : 0.f;
+
+	if (!_params.warning_value)
+		warning = _params.range.max();
+	if (!_params.critical_value)
+		critical = _params.range.max();
 	// Fill colors:
-	if (_warning_value && value >= warning)
+	if (_params.warning_value && value >= warning)
 		brush.setColor (orange.darker (100));
-	if (_critical_value && value >= critical)
+	if (_params.critical_value && value >= critical)
 		brush.setColor (red);
 
-	double value_angle = value_span_angle * (value - _range.min()) / _range.extent();
-	double warning_angle = value_span_angle * (warning - _range.min()) / _range.extent();
-	double critical_angle = value_span_angle * (critical - _range.min()) / _range.extent();
-	double reference_angle = value_span_angle * (reference - _range.min()) / _range.extent();
-	double target_angle = value_span_angle * (target - _range.min()) / _range.extent();
-	double automatic_angle = value_span_angle * (automatic - _range.min()) / _range.extent();
+	double value_angle = value_span_angle * (value - _params.range.min()) / _params.range.extent();
+	double warning_angle = value_span_angle * (warning - _params.range.min()) / _params.range.extent();
+	double critical_angle = value_span_angle * (critical - _params.range.min()) / _params.range.extent();
+	double reference_angle = value_span_angle * (reference - _params.range.min()) / _params.range.extent();
+	double target_angle = value_span_angle * (target - _params.range.min()) / _params.range.extent();
+	double automatic_angle = value_span_angle * (automatic - _params.range.min()) / _params.range.extent();
 
 	painter().save();
 
-	if (_value)
+	if (_params.value)
 	{
 		painter().save();
 		painter().setPen (Qt::NoPen);
@@ -222,9 +223,9 @@ RadialIndicatorWidget::paint_indicator (float, float r)
 	float gap_degs = 4;
 
 	points.emplace_back (0.f, silver_pen, 0.f);
-	if (_warning_value)
+	if (_params.warning_value)
 		points.emplace_back (warning_angle, warning_pen, 0.1f * r);
-	if (_critical_value)
+	if (_params.critical_value)
 		points.emplace_back (critical_angle, critical_pen, 0.2f * r);
 	points.emplace_back (value_span_angle, critical_pen, 0.f);
 
@@ -245,7 +246,7 @@ RadialIndicatorWidget::paint_indicator (float, float r)
 	}
 
 	// Normal value bug:
-	if (_reference_value)
+	if (_params.reference_value)
 	{
 		painter().setPen (green_pen);
 		painter().rotate (reference_angle);
@@ -257,7 +258,7 @@ RadialIndicatorWidget::paint_indicator (float, float r)
 	painter().restore();
 
 	// Needle:
-	if (_value)
+	if (_params.value)
 	{
 		painter().rotate (value_angle);
 		painter().set_shadow_color (Qt::black);
@@ -276,12 +277,12 @@ RadialIndicatorWidget::paint_indicator (float, float r)
 
 		painter().save();
 		painter().setPen (automatic_pen);
-		if (_automatic_value)
+		if (_params.automatic_value)
 			draw_outside_arc (automatic_angle, 0.10 * r, 0.95 * r, 1.10 * r, false);
 
 		painter().restore();
 		painter().setPen (pointer_pen);
-		if (_target_value)
+		if (_params.target_value)
 			draw_outside_arc (target_angle, 0.15 * r, 1.01 * r, 1.15 * r, true);
 		else
 			painter().draw_outlined_line (QPointF (0.0, 0.0), QPointF (0.99f * r, 0.0));
@@ -290,3 +291,43 @@ RadialIndicatorWidget::paint_indicator (float, float r)
 	painter().restore();
 }
 
+
+RadialIndicatorWidget::RadialIndicatorWidget (QWidget* parent, xf::WorkPerformer* work_performer):
+	InstrumentWidget (parent, work_performer),
+	_local_paint_work_unit (this)
+{
+	set_painter (&_local_paint_work_unit);
+}
+
+
+RadialIndicatorWidget::~RadialIndicatorWidget()
+{
+	wait_for_painter();
+}
+
+
+void
+RadialIndicatorWidget::set_params (Parameters const& new_params)
+{
+	_params = new_params;
+	request_repaint();
+}
+
+
+void
+RadialIndicatorWidget::resizeEvent (QResizeEvent* event)
+{
+	InstrumentWidget::resizeEvent (event);
+
+	auto xw = dynamic_cast<xf::Window*> (window());
+	if (xw)
+		_local_paint_work_unit.set_scaling (1.2f * xw->pen_scale(), 0.95f * xw->font_scale());
+}
+
+
+void
+RadialIndicatorWidget::push_params()
+{
+	_local_paint_work_unit._params_next = _params;
+}
+
@@ -25,155 +25,95 @@
 #include <xefis/config/all.h>
 #include <xefis/core/instrument_widget.h>
 #include <xefis/core/instrument_aids.h>
+#include <xefis/core/work_performer.h>
 #include <xefis/utility/painter.h>
 #include <xefis/utility/range.h>
 
 
-class RadialIndicatorWidget:
-	public xf::InstrumentWidget,
-	protected xf::InstrumentAids
+class RadialIndicatorWidget: public xf::InstrumentWidget
 {
   public:
-	// Ctor
-	RadialIndicatorWidget (QWidget* parent);
+	class Parameters
+	{
+	  public:
+		xf::Range<double>	range				= { 0.f, 1.f };
+		int					precision			= 0;
+		int					modulo				= 0;
+		Optional<double>	value;
+		Optional<double>	warning_value;
+		Optional<double>	critical_value;
+		Optional<double>	reference_value;
+		Optional<double>	target_value;
+		Optional<double>	automatic_value;
+	};
 
-	/**
-	 * Set new range to be used with RadialIndicatorWidget.
-	 */
-	void
-	set_range (xf::Range<double>);
+  private:
+	class PaintWorkUnit:
+		public xf::InstrumentWidget::PaintWorkUnit,
+		protected xf::InstrumentAids
+	{
+		friend class RadialIndicatorWidget;
 
-	/**
-	 * Set precision (digits after decimal point).
-	 * Negative values are accepted (value will be divided by 10^n).
-	 */
-	void
-	set_precision (int precision);
+	  public:
+		PaintWorkUnit (RadialIndicatorWidget*);
 
-	/**
-	 * Set modulo value. If > 0, value will be converted to int,
-	 * divided by n and the multipled by n again.
-	 */
-	void
-	set_modulo (unsigned int modulo);
+		~PaintWorkUnit() noexcept { }
 
-	void
-	set_value (Optional<double>);
+	  private:
+		void
+		pop_params() override;
 
-	void
-	set_warning_value (Optional<double>);
+		void
+		resized() override;
 
-	void
-	set_critical_value (Optional<double>);
+		void
+		paint (QImage&) override;
 
-	void
-	set_reference_value (Optional<double>);
+		/**
+		 * Convert value to string using precision and modulo parameters.
+		 * Negative precision means value will be divided by 10^n.
+		 * Positive modulo means value will be converted to int,
+		 * divided by n and then multipled by n again.
+		 */
+		QString
+		stringify_value (double value) const;
 
-	void
-	set_target_value (Optional<double>);
+		void
+		paint_text (float q, float r);
 
-	void
-	set_automatic_value (Optional<double>);
+		void
+		paint_indicator (float q, float r);
 
-  protected:
-	void
-	resizeEvent (QResizeEvent*) override;
+	  private:
+		Parameters	_params;
+		Parameters	_params_next;
+	};
 
-	void
-	paintEvent (QPaintEvent*) override;
+  public:
+	// Ctor
+	RadialIndicatorWidget (QWidget* parent, xf::WorkPerformer*);
 
-	QString
-	stringify_value (double value) const;
+	// Dtor
+	~RadialIndicatorWidget();
 
+	/**
+	 * Set new params for the widget.
+	 */
 	void
-	paint_text (float q, float r);
+	set_params (Parameters const&);
+
+  protected:
+	// API of QWidget
+	void
+	resizeEvent (QResizeEvent*) override;
 
+	// API of InstrumentWidget
 	void
-	paint_indicator (float q, float r);
+	push_params() override;
 
   private:
-	xf::Range<double>		_range				= { 0.f, 1.f };
-	int						_precision			= 0;
-	int						_modulo				= 0;
-	Optional<double>		_value;
-	Optional<double>		_warning_value;
-	Optional<double>		_critical_value;
-	Optional<double>		_reference_value;
-	Optional<double>		_target_value;
-	Optional<double>		_automatic_value;
+	PaintWorkUnit	_local_paint_work_unit;
+	Parameters		_params;
 };
 
-
-inline void
-RadialIndicatorWidget::set_range (xf::Range<double> range)
-{
-	_range = range;
-	update();
-}
-
-
-inline void
-RadialIndicatorWidget::set_precision (int precision)
-{
-	_precision = precision;
-	update();
-}
-
-
-inline void
-RadialIndicatorWidget::set_modulo (unsigned int modulo)
-{
-	_modulo = modulo;
-	update();
-}
-
-
-inline void
-RadialIndicatorWidget::set_value (Optional<double> value)
-{
-	_value = value;
-	update();
-}
-
-
-inline void
-RadialIndicatorWidget::set_warning_value (Optional<double> warning_value)
-{
-	_warning_value = warning_value;
-	update();
-}
-
-
-inline void
-RadialIndicatorWidget::set_critical_value (Optional<double> critical_value)
-{
-	_critical_value = critical_value;
-	update();
-}
-
-
-inline void
-RadialIndicatorWidget::set_reference_value (Optional<double> reference_value)
-{
-	_reference_value = reference_value;
-	update();
-}
-
-
-inline void
-RadialIndicatorWidget::set_target_value (Optional<double> target_value)
-{
-	_target_value = target_value;
-	update();
-}
-
-
-inline void
-RadialIndicatorWidget::set_automatic_value (Optional<double> automatic_value)
-{
-	_automatic_value = automatic_value;
-	update();
-}
-
 #endif
-
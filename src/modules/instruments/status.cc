@@ -62,6 +62,13 @@ Status::MessageDefinition::Observation::fresh() const
 }
 
 
+xf::PropertyNode::Serial
+Status::MessageDefinition::Observation::serial() const
+{
+	return _observed_property.serial();
+}
+
+
 bool
 Status::MessageDefinition::Observation::test() const
 {
@@ -131,6 +138,16 @@ Status::MessageDefinition::test()
 }
 
 
+xf::PropertyNode::Serial
+Status::MessageDefinition::serial() const
+{
+	xf::PropertyNode::Serial result = 0;
+	for (Observation const& o: _observations)
+		result += o.serial();
+	return result;
+}
+
+
 QColor
 Status::MessageDefinition::color() const noexcept
 {
@@ -170,7 +187,7 @@ Status::Status (xf::ModuleManager* module_manager, QDomElement const& config):
 				if (message_el == "message")
 					_messages.push_back (MessageDefinition (message_el));
 
-	_status_widget = new StatusWidget (this);
+	_status_widget = new StatusWidget (this, work_performer());
 
 	QVBoxLayout* layout = new QVBoxLayout (this);
 	layout->setMargin (0);
@@ -194,6 +211,16 @@ Status::Status (xf::ModuleManager* module_manager, QDomElement const& config):
 }
 
 
+xf::PropertyNode::Serial
+Status::input_serial() const
+{
+	xf::PropertyNode::Serial result = xf::Instrument::input_serial();
+	for (auto const& m: _messages)
+		result += m.serial();
+	return result;
+}
+
+
 void
 Status::data_updated()
 {
@@ -78,6 +78,12 @@ class Status: public xf::Instrument
 			bool
 			fresh() const;
 
+			/**
+			 * Return serial of the observed property.
+			 */
+			xf::PropertyNode::Serial
+			serial() const;
+
 			/**
 			 * Return true, if conditions for showing message apply.
 			 */
@@ -107,6 +113,12 @@ class Status: public xf::Instrument
 		StateChange
 		test();
 
+		/**
+		 * Return combined serial of all observed properties.
+		 */
+		xf::PropertyNode::Serial
+		serial() const;
+
 		/**
 		 * Message to show on Status.
 		 */
@@ -160,6 +172,9 @@ class Status: public xf::Instrument
 	void
 	data_updated() override;
 
+	xf::PropertyNode::Serial
+	input_serial() const override;
+
   private:
 	StatusWidget*					_status_widget			= nullptr;
 	xf::PropertyInteger				_input_cursor_value;
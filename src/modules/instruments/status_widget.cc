@@ -35,18 +35,129 @@ StatusWidget::Message::mark_as_outdated()
 }
 
 
-StatusWidget::StatusWidget (QWidget* parent):
-	InstrumentWidget (parent),
+StatusWidget::PaintWorkUnit::PaintWorkUnit (StatusWidget* status_widget):
+	InstrumentWidget::PaintWorkUnit (status_widget),
 	InstrumentAids (1.0f)
+{ }
+
+
+void
+StatusWidget::PaintWorkUnit::pop_params()
+{
+	_params = _params_next;
+}
+
+
+void
+StatusWidget::PaintWorkUnit::resized()
+{
+	InstrumentAids::update_sizes (size(), window_size());
+
+	float margin = pen_width (2.f);
+	_font = _font_16;
+	QFontMetricsF metrics (_font);
+	_line_height = 0.85 * metrics.height();
+	// Compute space needed for more-up/more-down arrows and actual
+	// messages viewport.
+	_arrow_height = 0.5f * _line_height;
+	_viewport = QRectF (margin, _arrow_height, size().width() - 2.f * margin, size().height() - 2.f * _arrow_height);
+	if (_viewport.height() <= 0)
+		_max_shown_messages = 0;
+	else
+		_max_shown_messages = static_cast<unsigned int> (_viewport.height() / _line_height);
+	// Fix viewport size to be integral number of shown messages:
+	_viewport.setHeight (_line_height * _max_shown_messages);
+}
+
+
+void
+StatusWidget::PaintWorkUnit::paint (QImage& image)
+{
+	auto painting_token = get_token (&image);
+	clear_background();
+
+	solve_scroll();
+
+	Messages const& shown_messages = _params.shown_messages;
+
+	// Messages:
+	painter().setBrush (Qt::NoBrush);
+	painter().setFont (_font);
+	int n = std::min<int> (static_cast<int> (shown_messages.size()) - _scroll, _max_shown_messages);
+	for (int i = 0; i < n; ++i)
+	{
+		Message const& message = shown_messages[i + _scroll];
+		if (message.outdated)
+			painter().setPen (QPen (QColor (0x70, 0x70, 0x70)));
+		else
+			painter().setPen (QPen (message.color));
+		painter().fast_draw_text (QPointF (_viewport.left(), _viewport.top() + _line_height * (i + 0.5)), Qt::AlignVCenter | Qt::AlignLeft, message.message);
+	}
+
+	// Cursor:
+	if (_params.cursor_visible)
+	{
+		float margin = pen_width (1.f);
+		QRectF cursor (_viewport.left(), _viewport.top() + _line_height * (_params.cursor - _scroll), _viewport.width(), _line_height);
+		cursor.adjust (-margin, 0.0, margin, 0.0);
+		painter().setPen (get_pen (Qt::white, 1.2f));
+		painter().drawRect (cursor);
+	}
+
+	// For up/down arrows:
+	painter().setPen (get_pen (Qt::white, 1.f));
+	painter().setBrush (Qt::white);
+
+	// Both arrows are blinking:
+	if (_params.blink_status)
+	{
+		// Up arrow:
+		if (_scroll > 0)
+		{
+			QPolygonF arrow = QPolygonF()
+				<< QPointF (0.f, -_arrow_height)
+				<< QPointF (-_arrow_height, 0.f)
+				<< QPointF (+_arrow_height, 0.f);
+
+			painter().drawPolygon (arrow.translated (_viewport.center().x(), _viewport.top()));
+		}
+
+		// Down arrow:
+		if (_scroll + _max_shown_messages < static_cast<int> (shown_messages.size()))
+		{
+			QPolygonF arrow = QPolygonF()
+				<< QPointF (-_arrow_height, 0.f)
+				<< QPointF (+_arrow_height, 0.f)
+				<< QPointF (0.f, _arrow_height);
+
+			painter().drawPolygon (arrow.translated (_viewport.center().x(), _viewport.bottom()));
+		}
+	}
+}
+
+
+void
+StatusWidget::PaintWorkUnit::solve_scroll()
+{
+	if (_params.cursor >= _scroll + _max_shown_messages)
+		_scroll = _params.cursor - _max_shown_messages + 1;
+	else if (_params.cursor < _scroll)
+		_scroll = _params.cursor;
+}
+
+
+StatusWidget::StatusWidget (QWidget* parent, xf::WorkPerformer* work_performer):
+	InstrumentWidget (parent, work_performer),
+	_local_paint_work_unit (this)
 {
-	recompute();
+	set_painter (&_local_paint_work_unit);
 
 	_blinking_timer = std::make_unique<QTimer>();
 	_blinking_timer->setInterval (200);
 	_blinking_timer->setSingleShot (false);
 	QObject::connect (_blinking_timer.get(), &QTimer::timeout, [&] {
 		_blink_status = !_blink_status;
-		update();
+		request_repaint();
 	});
 	_blinking_timer->start();
 
@@ -55,19 +166,25 @@ StatusWidget::StatusWidget (QWidget* parent):
 	_cursor_hide_timer->setSingleShot (true);
 	QObject::connect (_cursor_hide_timer.get(), &QTimer::timeout, [&] {
 		_cursor_visible = false;
-		update();
+		request_repaint();
 	});
 }
 
 
+StatusWidget::~StatusWidget()
+{
+	wait_for_painter();
+}
+
+
 uint64_t
 StatusWidget::add_message (QString const& message, QColor color)
 {
 	Message m { _id_generator++, message, false, color };
 	_shown_messages.push_back (m);
 
-	solve_scroll_and_cursor();
-	update();
+	solve_cursor();
+	request_repaint();
 
 	return m.id;
 }
@@ -81,7 +198,7 @@ StatusWidget::remove_message (uint64_t message_id)
 	if (msg)
 	{
 		msg->mark_as_outdated();
-		update();
+		request_repaint();
 	}
 	// Later remove the message:
 	QTimer* timer = new QTimer (this);
@@ -103,10 +220,10 @@ StatusWidget::cursor_up()
 	else if (_cursor > 0)
 	{
 		_cursor -= 1;
-		solve_scroll_and_cursor();
+		solve_cursor();
 	}
 
-	update();
+	request_repaint();
 	_cursor_hide_timer->start();
 }
 
@@ -119,10 +236,10 @@ StatusWidget::cursor_down()
 	else if (_cursor < static_cast<int> (_shown_messages.size()) - 1)
 	{
 		_cursor += 1;
-		solve_scroll_and_cursor();
+		solve_cursor();
 	}
 
-	update();
+	request_repaint();
 	_cursor_hide_timer->start();
 }
 
@@ -141,8 +258,8 @@ StatusWidget::cursor_del()
 
 	_cursor_hide_timer->start();
 
-	solve_scroll_and_cursor();
-	update();
+	solve_cursor();
+	request_repaint();
 }
 
 
@@ -152,8 +269,8 @@ StatusWidget::recall()
 	_shown_messages.insert (_shown_messages.end(), _hidden_messages.begin(), _hidden_messages.end());
 	_hidden_messages.clear();
 
-	solve_scroll_and_cursor();
-	update();
+	solve_cursor();
+	request_repaint();
 }
 
 
@@ -163,8 +280,8 @@ StatusWidget::clear()
 	_hidden_messages.insert (_hidden_messages.end(), _shown_messages.begin(), _shown_messages.end());
 	_shown_messages.clear();
 
-	solve_scroll_and_cursor();
-	update();
+	solve_cursor();
+	request_repaint();
 }
 
 
@@ -175,102 +292,24 @@ StatusWidget::resizeEvent (QResizeEvent* event)
 
 	auto xw = dynamic_cast<xf::Window*> (window());
 	if (xw)
-		InstrumentAids::set_scaling (1.2f * xw->pen_scale(), 0.95f * xw->font_scale());
-
-	InstrumentAids::update_sizes (size(), window()->size());
-
-	recompute();
+		_local_paint_work_unit.set_scaling (1.2f * xw->pen_scale(), 0.95f * xw->font_scale());
 }
 
 
 void
-StatusWidget::paintEvent (QPaintEvent*)
+StatusWidget::push_params()
 {
-	auto painting_token = get_token (this);
-	clear_background();
-
-	// Messages:
-	painter().setBrush (Qt::NoBrush);
-	painter().setFont (_font);
-	int n = std::min<int> (static_cast<int> (_shown_messages.size()) - _scroll, _max_shown_messages);
-	for (int i = 0; i < n; ++i)
-	{
-		Message const& message = _shown_messages[i + _scroll];
-		if (message.outdated)
-			painter().setPen (QPen (QColor (0x70, 0x70, 0x70)));
-		else
-			painter().setPen (QPen (message.color));
-		painter().fast_draw_text (QPointF (_viewport.left(), _viewport.top() + _line_height * (i + 0.5)), Qt::AlignVCenter | Qt::AlignLeft, message.message);
-	}
-
-	// Cursor:
-	if (_cursor_visible)
-	{
-		float margin = pen_width (1.f);
-		QRectF cursor (_viewport.left(), _viewport.top() + _line_height * (_cursor - _scroll), _viewport.width(), _line_height);
-		cursor.adjust (-margin, 0.0, margin, 0.0);
-		painter().setPen (get_pen (Qt::white, 1.2f));
-		painter().drawRect (cursor);
-	}
-
-	// For up/down arrows:
-	painter().setPen (get_pen (Qt::white, 1.f));
-	painter().setBrush (Qt::white);
-
-	// Both arrows are blinking:
-	if (_blink_status)
-	{
-		// Up arrow:
-		if (_scroll > 0)
-		{
-			QPolygonF arrow = QPolygonF()
-				<< QPointF (0.f, -_arrow_height)
-				<< QPointF (-_arrow_height, 0.f)
-				<< QPointF (+_arrow_height, 0.f);
-
-			painter().drawPolygon (arrow.translated (_viewport.center().x(), _viewport.top()));
-		}
-
-		// Down arrow:
-		if (_scroll + _max_shown_messages < static_cast<int> (_shown_messages.size()))
-		{
-			QPolygonF arrow = QPolygonF()
-				<< QPointF (-_arrow_height, 0.f)
-				<< QPointF (+_arrow_height, 0.f)
-				<< QPointF (0.f, _arrow_height);
-
-			painter().drawPolygon (arrow.translated (_viewport.center().x(), _viewport.bottom()));
-		}
-	}
+	Parameters& params = _local_paint_work_unit._params_next;
+	params.shown_messages = _shown_messages;
+	params.cursor = _cursor;
+	params.cursor_visible = _cursor_visible;
+	params.blink_status = _blink_status;
 }
 
 
 void
-StatusWidget::recompute()
+StatusWidget::solve_cursor()
 {
-	float margin = pen_width (2.f);
-	_font = _font_16;
-	QFontMetricsF metrics (_font);
-	_line_height = 0.85 * metrics.height();
-	// Compute space needed for more-up/more-down arrows and actual
-	// messages viewport.
-	_arrow_height = 0.5f * _line_height;
-	_viewport = QRectF (margin, _arrow_height, width() - 2.f * margin, height() - 2.f * _arrow_height);
-	if (_viewport.height() <= 0)
-		_max_shown_messages = 0;
-	else
-		_max_shown_messages = static_cast<unsigned int> (_viewport.height() / _line_height);
-	// Fix viewport size to be integral number of shown messages:
-	_viewport.setHeight (_line_height * _max_shown_messages);
-
-	solve_scroll_and_cursor();
-}
-
-
-void
-StatusWidget::solve_scroll_and_cursor()
-{
-	// Solve _cursor:
 	if (_shown_messages.empty())
 	{
 		_cursor_visible = false;
@@ -278,12 +317,6 @@ StatusWidget::solve_scroll_and_cursor()
 	}
 	else if (_cursor >= static_cast<int> (_shown_messages.size()))
 		_cursor = _shown_messages.size() - 1;
-
-	// Solve _scroll:
-	if (_cursor >= _scroll + _max_shown_messages)
-		_scroll = _cursor - _max_shown_messages + 1;
-	else if (_cursor < _scroll)
-		_scroll = _cursor;
 }
 
 
@@ -296,8 +329,8 @@ StatusWidget::do_remove_message (uint64_t message_id)
 	if (msg)
 	{
 		vector->erase (*iterator);
-		solve_scroll_and_cursor();
-		update();
+		solve_cursor();
+		request_repaint();
 	}
 }
 
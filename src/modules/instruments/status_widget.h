@@ -26,12 +26,11 @@
 #include <xefis/config/all.h>
 #include <xefis/core/instrument_widget.h>
 #include <xefis/core/instrument_aids.h>
+#include <xefis/core/work_performer.h>
 #include <xefis/utility/painter.h>
 
 
-class StatusWidget:
-	public xf::InstrumentWidget,
-	protected xf::InstrumentAids
+class StatusWidget: public xf::InstrumentWidget
 {
 	static constexpr Time MessageHideTimeout = 5_s;
 
@@ -56,9 +55,62 @@ class StatusWidget:
   private:
 	typedef std::vector<Message> Messages;
 
+	/**
+	 * Snapshot of the widget state used by the painting thread.
+	 */
+	class Parameters
+	{
+	  public:
+		Messages	shown_messages;
+		int			cursor			= 0;
+		bool		cursor_visible	= false;
+		bool		blink_status	= false;
+	};
+
+	class PaintWorkUnit:
+		public xf::InstrumentWidget::PaintWorkUnit,
+		protected xf::InstrumentAids
+	{
+		friend class StatusWidget;
+
+	  public:
+		PaintWorkUnit (StatusWidget*);
+
+		~PaintWorkUnit() noexcept { }
+
+	  private:
+		void
+		pop_params() override;
+
+		void
+		resized() override;
+
+		void
+		paint (QImage&) override;
+
+		/**
+		 * Compute scroll value needed to display message under cursor.
+		 */
+		void
+		solve_scroll();
+
+	  private:
+		Parameters	_params;
+		Parameters	_params_next;
+		double		_line_height		= 0.0;
+		double		_arrow_height		= 0.0;
+		int			_scroll				= 0;
+		int			_max_shown_messages	= 0;
+		QFont		_font;
+		QRectF		_viewport;
+	};
+
   public:
 	// Ctor
-	StatusWidget (QWidget* parent);
+	StatusWidget (QWidget* parent, xf::WorkPerformer*);
+
+	// Dtor
+	~StatusWidget();
 
 	/**
 	 * Add new message to show.
@@ -105,24 +157,20 @@ class StatusWidget:
 	clear();
 
   protected:
+	// API of QWidget
 	void
 	resizeEvent (QResizeEvent*) override;
 
+	// API of InstrumentWidget
 	void
-	paintEvent (QPaintEvent*) override;
+	push_params() override;
 
   private:
 	/**
-	 * Calculate sizes, viewports, etc.
-	 */
-	void
-	recompute();
-
-	/**
-	 * Compute scroll value needed to display messages.
+	 * Make sure cursor points to an existing message.
 	 */
 	void
-	solve_scroll_and_cursor();
+	solve_cursor();
 
 	/**
 	 * Removes message identified by ID.
@@ -140,16 +188,11 @@ class StatusWidget:
 	find_message (uint64_t id, Messages** vector_ptr = nullptr, Messages::iterator** iterator_ptr = nullptr);
 
   private:
-	double						_line_height		= 0.0;
-	double						_arrow_height		= 0.0;
-	int							_scroll				= 0;
+	PaintWorkUnit				_local_paint_work_unit;
 	int							_cursor				= 0;
-	int							_max_shown_messages	= 0;
 	uint64_t					_id_generator		= 0;
 	bool						_blink_status		= false;
 	bool						_cursor_visible		= false;
-	QFont						_font;
-	QRectF						_viewport;
 	Messages					_shown_messages;
 	Messages					_hidden_messages;
 	Unique<QTimer>				_blinking_timer;
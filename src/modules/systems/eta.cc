@@ -37,6 +37,8 @@ ETA::ETA (xf::ModuleManager* module_manager, QDomElement const& config):
 		{ "output.eta", _output_eta, true },
 	});
 
+	_smoother.set_engine (xf::SmootherBase::Engine::MultiResolution);
+
 	_eta_computer.set_minimum_dt (1_s);
 	_eta_computer.set_callback (std::bind (&ETA::compute, this));
 	_eta_computer.add_depending_smoothers ({
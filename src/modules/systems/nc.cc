@@ -22,7 +22,6 @@
 // Xefis:
 #include <xefis/config/all.h>
 #include <xefis/config/exception.h>
-#include <xefis/support/navigation/magnetic_variation.h>
 #include <xefis/utility/qdom.h>
 #include <xefis/utility/time_helper.h>
 
@@ -41,8 +40,10 @@ NavigationComputer::NavigationComputer (xf::ModuleManager* module_manager, QDomE
 {
 	_track_lateral_true_smoother.set_winding ({ 0.0, 360.0 });
 	_orientation_heading_magnetic_smoother.set_winding ({ 0.0, 360.0 });
-	_orientation_pitch_smoother.set_winding ({ -180.0, 180.0 });
-	_orientation_roll_smoother.set_winding ({ -180.0, 180.0 });
+	_orientation_pitch_channel = _orientation_pitch_roll_smoothers.add_channel ({ -180.0, 180.0 });
+	_orientation_roll_channel = _orientation_pitch_roll_smoothers.add_channel ({ -180.0, 180.0 });
+	_track_lateral_rotation_smoother.set_engine (xf::SmootherBase::Engine::MultiResolution);
+	_track_ground_speed_smoother.set_engine (xf::SmootherBase::Engine::Recursive);
 
 	// Initialize _positions* with invalid vals, to get them non-empty:
 	for (Positions* positions: { &_positions, &_positions_accurate_2_times, &_positions_accurate_9_times })
@@ -101,8 +102,7 @@ NavigationComputer::NavigationComputer (xf::ModuleManager* module_manager, QDomE
 	_headings_computer.set_callback (std::bind (&NavigationComputer::compute_headings, this));
 	_headings_computer.add_depending_smoothers ({
 		&_orientation_heading_magnetic_smoother,
-		&_orientation_pitch_smoother,
-		&_orientation_roll_smoother,
+		&_orientation_pitch_roll_smoothers,
 	});
 	_headings_computer.observe ({
 		&_orientation_input_heading_magnetic,
@@ -214,17 +214,12 @@ NavigationComputer::compute_magnetic_variation()
 {
 	if (_position_longitude.valid() && _position_latitude.valid())
 	{
-		xf::MagneticVariation mv;
-		mv.set_position (LonLat (*_position_longitude, *_position_latitude));
-		if (_position_altitude_amsl.valid())
-			mv.set_altitude_amsl (*_position_altitude_amsl);
-		else
-			mv.set_altitude_amsl (0_ft);
 		QDate today = QDateTime::fromTime_t (xf::TimeHelper::now().quantity<Second>()).date();
-		mv.set_date (today.year(), today.month(), today.day());
-		mv.update();
-		_magnetic_declination.write (mv.magnetic_declination());
-		_magnetic_inclination.write (mv.magnetic_inclination());
+		_magnetic_variation_cache.set_date (today.year(), today.month(), today.day());
+		auto field = _magnetic_variation_cache.field (LonLat (*_position_longitude, *_position_latitude),
+													  _position_altitude_amsl.read (0_ft));
+		_magnetic_declination.write (field.declination);
+		_magnetic_inclination.write (field.inclination);
 	}
 	else
 	{
@@ -255,23 +250,28 @@ NavigationComputer::compute_headings()
 		_orientation_heading_magnetic_smoother.invalidate();
 	}
 
-	// Smoothed pitch:
+	// Smoothed pitch and roll:
 	if (_orientation_input_pitch.valid())
-		_orientation_pitch.write (1_deg * _orientation_pitch_smoother.process ((*_orientation_input_pitch).quantity<Degree>(), update_dt));
+		_orientation_pitch_roll_smoothers.set_sample (_orientation_pitch_channel, (*_orientation_input_pitch).quantity<Degree>());
+	else
+		_orientation_pitch_roll_smoothers.invalidate (_orientation_pitch_channel);
+
+	if (_orientation_input_roll.valid())
+		_orientation_pitch_roll_smoothers.set_sample (_orientation_roll_channel, (*_orientation_input_roll).quantity<Degree>());
+	else
+		_orientation_pitch_roll_smoothers.invalidate (_orientation_roll_channel);
+
+	_orientation_pitch_roll_smoothers.process (update_dt);
+
+	if (_orientation_input_pitch.valid())
+		_orientation_pitch.write (1_deg * _orientation_pitch_roll_smoothers.value (_orientation_pitch_channel));
 	else
-	{
 		_orientation_pitch.set_nil();
-		_orientation_pitch_smoother.invalidate();
-	}
 
-	// Smoothed roll:
 	if (_orientation_input_roll.valid())
-		_orientation_roll.write (1_deg * _orientation_roll_smoother.process ((*_orientation_input_roll).quantity<Degree>(), update_dt));
+		_orientation_roll.write (1_deg * _orientation_pitch_roll_smoothers.value (_orientation_roll_channel));
 	else
-	{
 		_orientation_roll.set_nil();
-		_orientation_roll_smoother.invalidate();
-	}
 }
 
 
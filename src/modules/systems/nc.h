@@ -28,7 +28,9 @@
 #include <xefis/core/module.h>
 #include <xefis/core/property.h>
 #include <xefis/core/property_observer.h>
+#include <xefis/support/navigation/magnetic_variation_cache.h>
 #include <xefis/utility/smoother.h>
+#include <xefis/utility/smoother_bank.h>
 
 
 class NavigationComputer: public xf::Module
@@ -73,10 +75,12 @@ class NavigationComputer: public xf::Module
 	Positions				_positions;
 	Positions				_positions_accurate_2_times;
 	Positions				_positions_accurate_9_times;
+	xf::MagneticVariationCache	_magnetic_variation_cache;
 	// Note: PropertyObservers depend on Smoothers, so first Smoothers must be defined,
 	// then PropertyObservers, to ensure correct order of destruction.
-	xf::Smoother<double>	_orientation_pitch_smoother				= Time (25_ms);
-	xf::Smoother<double>	_orientation_roll_smoother				= Time (25_ms);
+	xf::SmootherBank		_orientation_pitch_roll_smoothers		= Time (25_ms);
+	xf::SmootherBank::Channel	_orientation_pitch_channel;
+	xf::SmootherBank::Channel	_orientation_roll_channel;
 	xf::Smoother<double>	_orientation_heading_magnetic_smoother	= Time (200_ms);
 	xf::Smoother<double>	_track_vertical_smoother				= Time (500_ms);
 	xf::Smoother<double>	_track_lateral_true_smoother			= Time (500_ms);
@@ -41,7 +41,9 @@ PerformanceComputer::PerformanceComputer (xf::ModuleManager* module_manager, QDo
 	Module (module_manager, config)
 {
 	_airframe = module_manager->application()->airframe();
-	_wind_direction_smoother.set_winding ({ 0.0, 360.0 });
+	_wind_smoothers.set_engine (xf::SmootherBase::Engine::Recursive);
+	_wind_direction_channel = _wind_smoothers.add_channel ({ 0.0, 360.0 });
+	_wind_speed_channel = _wind_smoothers.add_channel();
 
 	parse_settings (config, {
 		{ "total-energy-variometer.minimum-ias", _total_energy_variometer_min_ias, true },
@@ -96,10 +98,7 @@ PerformanceComputer::PerformanceComputer (xf::ModuleManager* module_manager, QDo
 	});
 
 	_wind_computer.set_callback (std::bind (&PerformanceComputer::compute_wind, this));
-	_wind_computer.add_depending_smoothers ({
-		&_wind_direction_smoother,
-		&_wind_speed_smoother,
-	});
+	_wind_computer.add_depending_smoother (_wind_smoothers);
 	_wind_computer.observe ({
 		&_speed_tas,
 		&_speed_gs,
@@ -202,17 +201,20 @@ PerformanceComputer::compute_wind()
 		wt.set_air_vector (*_speed_tas, *_orientation_heading_true);
 		wt.set_ground_vector (*_speed_gs, *_track_lateral_true);
 		wt.compute_wind_vector();
-		_wind_from_true.write (xf::floored_mod (1_deg * _wind_direction_smoother.process (wt.wind_from().quantity<Degree>(), update_dt), 360_deg));
+		_wind_smoothers.set_sample (_wind_direction_channel, wt.wind_from().quantity<Degree>());
+		_wind_smoothers.set_sample (_wind_speed_channel, wt.wind_speed().quantity<Knot>());
+		_wind_smoothers.process (update_dt);
+
+		_wind_from_true.write (xf::floored_mod (1_deg * _wind_smoothers.value (_wind_direction_channel), 360_deg));
 		_wind_from_magnetic.write (xf::true_to_magnetic (*_wind_from_true, *_magnetic_declination));
-		_wind_tas.write (1_kt * _wind_speed_smoother.process (wt.wind_speed().quantity<Knot>(), update_dt));
+		_wind_tas.write (1_kt * _wind_smoothers.value (_wind_speed_channel));
 	}
 	else
 	{
 		_wind_from_true.set_nil();
 		_wind_from_magnetic.set_nil();
 		_wind_tas.set_nil();
-		_wind_direction_smoother.invalidate();
-		_wind_speed_smoother.invalidate();
+		_wind_smoothers.invalidate();
 	}
 }
 
@@ -363,33 +365,11 @@ PerformanceComputer::compute_speeds_vbg()
 		xf::FlapsAngle flaps_angle (*_input_flaps_angle);
 		xf::SpoilersAngle spoilers_angle (*_input_spoilers_angle);
 
-		xf::Range<Angle> aoa_range = _airframe->get_defined_aoa_range();
+		auto polar = _airframe->get_polar (flaps_angle, spoilers_angle);
+		auto tas = cl_to_tas_now (polar.max_lift_to_drag_cl);
 
-		Optional<Angle> v_bg_aoa;
-		double v_bg_ratio = std::numeric_limits<double>::max();
-
-		for (Angle aoa = aoa_range.min(); aoa < aoa_range.max(); aoa += 0.25_deg)
-		{
-			double cl = _airframe->get_cl (aoa, flaps_angle, spoilers_angle);
-			double cd = _airframe->get_cd (aoa, flaps_angle, spoilers_angle);
-			double new_ratio = cl / cd;
-
-			if (new_ratio < v_bg_ratio)
-			{
-				v_bg_ratio = new_ratio;
-				v_bg_aoa = aoa;
-			}
-		}
-
-		if (v_bg_aoa)
-		{
-			auto tas = aoa_to_tas_now (*v_bg_aoa);
-
-			if (tas)
-				_v_bg = tas_to_ias (*tas);
-			else
-				_v_bg.set_nil();
-		}
+		if (tas)
+			_v_bg = tas_to_ias (*tas);
 		else
 			_v_bg.set_nil();
 	}
@@ -406,14 +386,15 @@ PerformanceComputer::get_stall_ias (Angle const& max_bank_angle) const
 	// Formula:
 	//   V_s = sqrt((load_factor * weight) / (0.5 * air_density * wings_area * C_L_max)).
 
-	if (_airframe)
+	if (_airframe &&
+		_input_flaps_angle.valid() &&
+		_input_spoilers_angle.valid())
 	{
-		xf::FlapsAngle flaps_angle (_input_flaps_angle.read (0_deg));
-		xf::SpoilersAngle spoilers_angle (_input_spoilers_angle.read (0_deg));
-		Angle max_safe_aoa = _airframe->get_max_safe_aoa (flaps_angle, spoilers_angle);
+		xf::FlapsAngle flaps_angle (*_input_flaps_angle);
+		xf::SpoilersAngle spoilers_angle (*_input_spoilers_angle);
 		Acceleration load = 1_g / cos (max_bank_angle);
 
-		auto tas = aoa_to_tas_now (max_safe_aoa, load);
+		auto tas = cl_to_tas_now (_airframe->get_polar (flaps_angle, spoilers_angle).max_safe_cl, load);
 
 		if (tas)
 			return tas_to_ias (*tas);
@@ -443,7 +424,7 @@ PerformanceComputer::compute_critical_aoa()
 		xf::FlapsAngle flaps_angle (_input_flaps_angle.read (0_deg));
 		xf::SpoilersAngle spoilers_angle (_input_spoilers_angle.read (0_deg));
 
-		_critical_aoa = _airframe->get_critical_aoa (flaps_angle, spoilers_angle);
+		_critical_aoa = _airframe->get_polar (flaps_angle, spoilers_angle).critical_aoa;
 
 		if (_stall.configured())
 		{
@@ -555,19 +536,14 @@ PerformanceComputer::compute_estimations()
 
 
 inline Optional<Speed>
-PerformanceComputer::aoa_to_tas_now (Angle const& aoa, Optional<Acceleration> const& load) const
+PerformanceComputer::cl_to_tas_now (xf::LiftCoefficient cl, Optional<Acceleration> const& load) const
 {
 	if (_airframe &&
 		_input_load.valid() &&
 		_input_aircraft_mass.valid() &&
-		_input_air_density_static.valid() &&
-		_input_flaps_angle.valid() &&
-		_input_spoilers_angle.valid())
+		_input_air_density_static.valid())
 	{
 		Area wings_area = _airframe->wings_area();
-		xf::FlapsAngle flaps_angle (*_input_flaps_angle);
-		xf::SpoilersAngle spoilers_angle (*_input_spoilers_angle);
-		xf::LiftCoefficient cl = _airframe->get_cl (aoa, flaps_angle, spoilers_angle);
 		Acceleration xload = load ? *load : *_input_load;
 		Force lift = xload * *_input_aircraft_mass;
 		// Result is TAS:
@@ -27,6 +27,7 @@
 #include <xefis/core/property.h>
 #include <xefis/core/property_observer.h>
 #include <xefis/utility/smoother.h>
+#include <xefis/utility/smoother_bank.h>
 
 
 class PerformanceComputer: public xf::Module
@@ -73,14 +74,13 @@ class PerformanceComputer: public xf::Module
 	compute_estimations();
 
 	/**
-	 * Convert AOA to IAS for current environment and configuration.
-	 * Automatically includes flaps/spoilers angle, so parameter @aoa
-	 * should only be wings AOA.
+	 * Convert C_L to TAS for current environment.
+	 * C_L should already include corrections for flaps and spoilers.
 	 *
 	 * May return empty result if it's not possible to compute TAS.
 	 */
 	Optional<Speed>
-	aoa_to_tas_now (Angle const& aoa, Optional<Acceleration> const& load = {}) const;
+	cl_to_tas_now (xf::LiftCoefficient cl, Optional<Acceleration> const& load = {}) const;
 
   private:
 	Speed						_total_energy_variometer_min_ias	= 0_kt;
@@ -88,8 +88,9 @@ class PerformanceComputer: public xf::Module
 	xf::Airframe*				_airframe;
 	// Note: PropertyObservers depend on Smoothers, so first Smoothers must be defined,
 	// then PropertyObservers, to ensure correct order of destruction.
-	xf::Smoother<double>		_wind_direction_smoother			= 5_s;
-	xf::Smoother<double>		_wind_speed_smoother				= 5_s;
+	xf::SmootherBank			_wind_smoothers						= 5_s;
+	xf::SmootherBank::Channel	_wind_direction_channel;
+	xf::SmootherBank::Channel	_wind_speed_channel;
 	xf::Smoother<double>		_total_energy_variometer_smoother	= 1_s;
 	xf::Smoother<double>		_cl_smoother						= 1_s;
 	// Input:
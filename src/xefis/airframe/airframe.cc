@@ -13,6 +13,9 @@
 
 // Standard:
 #include <cstddef>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 // Xefis:
 #include <xefis/config/all.h>
@@ -87,6 +90,79 @@ Airframe::get_cd (Angle const& aoa, FlapsAngle const& flaps_angle, SpoilersAngle
 }
 
 
+void
+Airframe::get_cl_cd (Angle const* aoas, std::size_t count, FlapsAngle const& flaps_angle, SpoilersAngle const& spoilers_angle,
+					 LiftCoefficient* cls, DragCoefficient* cds) const
+{
+	Angle correction = flaps().get_aoa_correction (flaps_angle.value()) + spoilers().get_aoa_correction (spoilers_angle.value());
+
+	std::vector<Angle> total_aoas (count);
+
+	for (std::size_t i = 0; i < count; ++i)
+		total_aoas[i] = aoas[i] + correction;
+
+	lift().get_cl (total_aoas.data(), cls, count);
+	drag().get_cd (total_aoas.data(), cds, count);
+}
+
+
+Airframe::Polar
+Airframe::get_polar (FlapsAngle const& flaps_angle, SpoilersAngle const& spoilers_angle) const
+{
+	PolarKey key { std::lround (flaps_angle.value() / kPolarCacheQuantum), std::lround (spoilers_angle.value() / kPolarCacheQuantum) };
+
+	{
+		Mutex::Lock lock (_polar_cache_mutex);
+		auto found = _polar_cache.find (key);
+
+		if (found != _polar_cache.end())
+			return found->second;
+	}
+
+	// Compute for quantized settings, so that results depend only on the key:
+	FlapsAngle quantized_flaps_angle (static_cast<double> (key.first) * kPolarCacheQuantum);
+	SpoilersAngle quantized_spoilers_angle (static_cast<double> (key.second) * kPolarCacheQuantum);
+	Polar polar;
+
+	polar.critical_aoa = get_critical_aoa (quantized_flaps_angle, quantized_spoilers_angle);
+	polar.max_safe_aoa = get_max_safe_aoa (quantized_flaps_angle, quantized_spoilers_angle);
+	polar.max_safe_cl = get_cl (polar.max_safe_aoa, quantized_flaps_angle, quantized_spoilers_angle);
+
+	// Sweep the defined AOA range to find maximum C_L/C_D:
+	std::vector<Angle> aoas;
+	for (Angle aoa = _defined_aoa_range.min(); aoa < _defined_aoa_range.max(); aoa += kLiftToDragSweepStep)
+		aoas.push_back (aoa);
+
+	std::vector<LiftCoefficient> cls (aoas.size());
+	std::vector<DragCoefficient> cds (aoas.size());
+	get_cl_cd (aoas.data(), aoas.size(), quantized_flaps_angle, quantized_spoilers_angle, cls.data(), cds.data());
+
+	polar.max_lift_to_drag = -std::numeric_limits<double>::infinity();
+	polar.max_lift_to_drag_aoa = polar.max_safe_aoa;
+	polar.max_lift_to_drag_cl = polar.max_safe_cl;
+
+	for (std::size_t i = 0; i < aoas.size(); ++i)
+	{
+		double ratio = cls[i] / cds[i];
+
+		if (ratio > polar.max_lift_to_drag)
+		{
+			polar.max_lift_to_drag = ratio;
+			polar.max_lift_to_drag_aoa = aoas[i];
+			polar.max_lift_to_drag_cl = cls[i];
+		}
+	}
+
+	// Computed outside of the lock; if other thread computed the same key meanwhile, both results are equal:
+	Mutex::Lock lock (_polar_cache_mutex);
+
+	if (_polar_cache.size() >= kPolarCacheSize)
+		_polar_cache.clear();
+
+	return _polar_cache.emplace (key, polar).first->second;
+}
+
+
 Optional<Angle>
 Airframe::get_aoa_in_normal_regime (LiftCoefficient const& cl, FlapsAngle const& flaps_angle, SpoilersAngle const& spoilers_angle) const
 {
@@ -16,6 +16,8 @@
 
 // Standard:
 #include <cstddef>
+#include <map>
+#include <utility>
 
 // Xefis:
 #include <xefis/config/all.h>
@@ -25,6 +27,7 @@
 #include <xefis/airframe/lift.h>
 #include <xefis/airframe/drag.h>
 #include <xefis/airframe/types.h>
+#include <xefis/utility/mutex.h>
 
 
 namespace Xefis {
@@ -37,6 +40,36 @@ class Application;
  */
 class Airframe
 {
+  public:
+	/**
+	 * Aerodynamic data that depends only on flaps and spoilers settings.
+	 */
+	class Polar
+	{
+	  public:
+		// Critical AOA, see get_critical_aoa():
+		Angle			critical_aoa;
+		// Maximum safe AOA, see get_max_safe_aoa():
+		Angle			max_safe_aoa;
+		// C_L at maximum safe AOA (determines stall speeds):
+		LiftCoefficient	max_safe_cl;
+		// Maximum C_L/C_D ratio (determines best glide speed):
+		double			max_lift_to_drag;
+		// AOA and C_L at maximum C_L/C_D ratio:
+		Angle			max_lift_to_drag_aoa;
+		LiftCoefficient	max_lift_to_drag_cl;
+	};
+
+  private:
+	// Flaps and spoilers angles are quantized to this step for get_polar() cache:
+	static constexpr Angle			kPolarCacheQuantum			= 0.1_deg;
+	// Maximum number of cached polars, cache is cleared when exceeded:
+	static constexpr std::size_t	kPolarCacheSize				= 256;
+	// AOA step of the sweep that finds maximum C_L/C_D:
+	static constexpr Angle			kLiftToDragSweepStep		= 0.25_deg;
+
+	typedef std::pair<long, long> PolarKey;
+
   public:
 	// Ctor
 	Airframe (Application* application, QDomElement const& config);
@@ -98,6 +131,27 @@ class Airframe
 	DragCoefficient
 	get_cd (Angle const& aoa, FlapsAngle const&, SpoilersAngle const&) const;
 
+	/**
+	 * Compute C_L and C_D for @count angles of attack, including corrections for flaps and spoilers.
+	 * Corrections are computed once for all AOAs, so this is much faster than calling get_cl()
+	 * and get_cd() for each AOA.
+	 *
+	 * \param aoas
+	 *        Angles of attack as detected by AOA sensor.
+	 */
+	void
+	get_cl_cd (Angle const* aoas, std::size_t count, FlapsAngle const&, SpoilersAngle const&, LiftCoefficient* cls, DragCoefficient* cds) const;
+
+	/**
+	 * Return aerodynamic data for given flaps and spoilers settings.
+	 * Settings are quantized to 0.1° and results are memoized, so that subsequent calls
+	 * for the same configuration are just a lookup.
+	 *
+	 * \threadsafe
+	 */
+	Polar
+	get_polar (FlapsAngle const&, SpoilersAngle const&) const;
+
 	/**
 	 * Return AOA for given C_L, corrected for flaps and spoilers.
 	 *
@@ -136,6 +190,8 @@ class Airframe
 	Length				_wings_chord;
 	Range<double>		_load_factor_limits;
 	Angle				_safe_aoa_correction;
+	Mutex				_polar_cache_mutex;
+	mutable std::map<PolarKey, Polar>	_polar_cache;
 };
 
 
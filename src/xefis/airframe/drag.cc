@@ -58,5 +58,12 @@ Drag::get_cd (Angle const& aoa) const
 	return _aoa_to_cd->extrapolated_value (aoa);
 }
 
+
+void
+Drag::get_cd (Angle const* aoas, DragCoefficient* cds, std::size_t count) const
+{
+	_aoa_to_cd->extrapolated_values (aoas, cds, count);
+}
+
 } // namespace Xefis
 
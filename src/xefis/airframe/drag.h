@@ -48,6 +48,13 @@ class Drag
 	DragCoefficient
 	get_cd (Angle const& aoa) const;
 
+	/**
+	 * Compute C_D for @count angles of attack.
+	 * Faster than calling get_cd() for each AOA.
+	 */
+	void
+	get_cd (Angle const* aoas, DragCoefficient* cds, std::size_t count) const;
+
   private:
 	Unique<Datatable2D<Angle, DragCoefficient>>	_aoa_to_cd;
 };
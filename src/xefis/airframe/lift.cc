@@ -67,6 +67,13 @@ Lift::get_cl (Angle const& aoa) const
 }
 
 
+void
+Lift::get_cl (Angle const* aoas, LiftCoefficient* cls, std::size_t count) const
+{
+	_aoa_to_cl->extrapolated_values (aoas, cls, count);
+}
+
+
 LiftCoefficient
 Lift::max_cl() const noexcept
 {
@@ -48,6 +48,13 @@ class Lift
 	LiftCoefficient
 	get_cl (Angle const& aoa) const;
 
+	/**
+	 * Compute C_L for @count angles of attack.
+	 * Faster than calling get_cl() for each AOA.
+	 */
+	void
+	get_cl (Angle const* aoas, LiftCoefficient* cls, std::size_t count) const;
+
 	/**
 	 * Return maximum possible lift.
 	 */
@@ -0,0 +1,75 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Qt:
+#include <QtWidgets/QApplication>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/benchmark/benchmark.h>
+#include <xefis/core/property_storage.h>
+#include <xefis/core/services.h>
+
+
+std::atomic<uint64_t> xf::Benchmark::allocations_counter { 0 };
+
+
+void*
+operator new (std::size_t size)
+{
+	xf::Benchmark::allocations_counter.fetch_add (1, std::memory_order_relaxed);
+
+	if (void* ptr = std::malloc (size ? size : 1))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+
+void
+operator delete (void* ptr) noexcept
+{
+	std::free (ptr);
+}
+
+
+void
+operator delete (void* ptr, std::size_t) noexcept
+{
+	std::free (ptr);
+}
+
+
+int
+main (int argc, char** argv, char**)
+{
+	// Render without any display, unless told otherwise:
+	setenv ("QT_QPA_PLATFORM", "offscreen", 0);
+
+	QApplication app (argc, argv);
+	xf::Services::initialize();
+	xf::PropertyStorage::initialize();
+
+	// Optional argument: run only benchmarks with names containing it.
+	xf::Benchmark::run_all (argc > 1 ? argv[1] : "");
+
+	xf::Services::deinitialize();
+	return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,188 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+#ifndef XEFIS__BENCHMARK__BENCHMARK_H__INCLUDED
+#define XEFIS__BENCHMARK__BENCHMARK_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Lib:
+#include <boost/format.hpp>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/utility/time_helper.h>
+
+
+namespace Xefis {
+
+/**
+ * Statically registered benchmark.
+ * Unlike RuntimeTest, benchmarks are not run during static initialization,
+ * but from main() of the benchmark program by run_all(), after QApplication
+ * has been created.
+ *
+ * Each measurement prints one line in a stable, column-aligned format:
+ *   <benchmark> <variant> <iterations> <ms/iteration> <allocs/iteration> [key=value…]
+ */
+class Benchmark
+{
+  public:
+	typedef std::function<void (Benchmark&)>	BenchmarkFunction;
+	typedef std::function<void (unsigned int)>	IterationFunction;
+	typedef std::function<std::string()>		ExtraFunction;
+
+  public:
+	// Ctor
+	Benchmark (std::string const& name, BenchmarkFunction);
+
+	/**
+	 * Return benchmark name.
+	 */
+	std::string const&
+	name() const noexcept;
+
+	/**
+	 * Call the iteration function given number of times and print results.
+	 * \param	variant
+	 * 			Short name of the measured case, eg. resolution.
+	 * \param	extra
+	 * 			If set, it's called after the measurement and its result
+	 * 			is appended to the output line.
+	 */
+	void
+	measure (std::string const& variant, unsigned int iterations, IterationFunction, ExtraFunction extra = nullptr);
+
+	/**
+	 * Run all registered benchmarks, sorted by name.
+	 * Only those with names containing filter are run.
+	 */
+	static void
+	run_all (std::string const& filter = "");
+
+	/**
+	 * Return number of heap allocations done so far by the program.
+	 * Counted only if the program replaces global operator new
+	 * and increments allocations_counter.
+	 */
+	static uint64_t
+	allocations() noexcept;
+
+  public:
+	static std::atomic<uint64_t>	allocations_counter;
+
+  private:
+	static std::vector<Benchmark*>&
+	benchmarks();
+
+  private:
+	std::string			_name;
+	BenchmarkFunction	_function;
+};
+
+
+inline
+Benchmark::Benchmark (std::string const& name, BenchmarkFunction function):
+	_name (name),
+	_function (function)
+{
+	benchmarks().push_back (this);
+}
+
+
+inline std::string const&
+Benchmark::name() const noexcept
+{
+	return _name;
+}
+
+
+inline void
+Benchmark::measure (std::string const& variant, unsigned int iterations, IterationFunction function, ExtraFunction extra)
+{
+	iterations = std::max (iterations, 1u);
+
+	uint64_t allocations_before = allocations();
+	Time t = TimeHelper::measure ([&] {
+		for (unsigned int i = 0; i < iterations; ++i)
+			function (i);
+	});
+	uint64_t allocations_made = allocations() - allocations_before;
+
+	std::cout << boost::format ("%-32s %-16s %8u %12.4f %12.1f")
+		% _name
+		% variant
+		% iterations
+		% (t.quantity<Millisecond>() / iterations)
+		% (static_cast<double> (allocations_made) / iterations);
+
+	if (extra)
+		std::cout << " " << extra();
+
+	std::cout << std::endl;
+}
+
+
+inline void
+Benchmark::run_all (std::string const& filter)
+{
+	std::vector<Benchmark*> sorted = benchmarks();
+	std::stable_sort (sorted.begin(), sorted.end(), [](Benchmark const* a, Benchmark const* b) {
+		return a->name() < b->name();
+	});
+
+	std::cout << boost::format ("%-32s %-16s %8s %12s %12s %s") % "# benchmark" % "variant" % "iters" % "ms/iter" % "allocs/iter" % "extra" << std::endl;
+
+	for (Benchmark* b: sorted)
+	{
+		if (b->name().find (filter) == std::string::npos)
+			continue;
+
+		try {
+			b->_function (*b);
+		}
+		catch (std::exception const& e)
+		{
+			std::cout << boost::format ("%-32s FAILED: %s") % b->name() % e.what() << std::endl;
+		}
+	}
+}
+
+
+inline uint64_t
+Benchmark::allocations() noexcept
+{
+	return allocations_counter.load (std::memory_order_relaxed);
+}
+
+
+inline std::vector<Benchmark*>&
+Benchmark::benchmarks()
+{
+	static std::vector<Benchmark*> list;
+	return list;
+}
+
+} // namespace Xefis
+
+#endif
+
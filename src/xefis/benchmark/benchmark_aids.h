@@ -0,0 +1,70 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+#ifndef XEFIS__BENCHMARK__BENCHMARK_AIDS_H__INCLUDED
+#define XEFIS__BENCHMARK__BENCHMARK_AIDS_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Qt:
+#include <QtCore/QSize>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/utility/text_painter.h>
+
+
+namespace Xefis {
+namespace BenchmarkAids {
+
+/**
+ * Resolutions at which instruments are benchmarked.
+ */
+inline std::vector<QSize> const&
+instrument_sizes()
+{
+	static std::vector<QSize> const sizes = { { 400, 300 }, { 800, 600 }, { 1600, 1200 } };
+	return sizes;
+}
+
+
+/**
+ * Return size as "WxH" string, to be used as benchmark variant name.
+ */
+inline std::string
+size_name (QSize const& size)
+{
+	return std::to_string (size.width()) + "x" + std::to_string (size.height());
+}
+
+
+/**
+ * Return text painter cache statistics as key=value pairs.
+ */
+inline std::string
+cache_stats (TextPainter::Cache const* cache)
+{
+	if (!cache)
+		return "glyphs=- runs=-";
+	return "glyphs=" + std::to_string (cache->glyphs_count()) + " runs=" + std::to_string (cache->runs_count());
+}
+
+} // namespace BenchmarkAids
+} // namespace Xefis
+
+#endif
+
@@ -95,7 +95,15 @@ Application::Application (int& argc, char** argv):
 	_config_reader->process_settings();
 
 	if (_config_reader->load_navaids())
-		_navaid_storage->load();
+	{
+		if (_config_reader->navaids_streaming_radius())
+			_navaid_storage->set_streaming_radius (*_config_reader->navaids_streaming_radius());
+
+		if (_config_reader->load_navaids_in_background())
+			_navaid_storage->load_in_background (_work_performer.get());
+		else
+			_navaid_storage->load (_work_performer.get());
+	}
 
 	_config_reader->process_modules();
 	_config_reader->process_windows();
@@ -239,11 +247,6 @@ Application::print_copyrights (std::ostream& out)
 		<< endl
 		<< License::lib_half << endl
 		<< endl;
-	out << "The 'kdtree++' library is distributed under the following license" << endl
-		<< "=================================================================" << endl
-		<< endl
-		<< License::lib_kdtreeplusplus << endl
-		<< endl;
 }
 
 
@@ -0,0 +1,153 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// Qt:
+#include <QtCore/QDir>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/benchmark/benchmark.h>
+#include <xefis/core/navaid.h>
+#include <xefis/core/navaid_database.h>
+#include <xefis/core/navaid_storage.h>
+#include <xefis/core/navaids_builder.h>
+
+
+namespace Xefis {
+namespace Benchmarks {
+
+/**
+ * Measure allocations done when navaids are loaded from share/nav and from
+ * a compiled database made of them. Must be run from the top directory.
+ */
+static xf::Benchmark navaids_loading ("core/navaids/loading", [](Benchmark& benchmark) {
+	NavaidStorage storage;
+
+	benchmark.measure ("sources", 1, [&](unsigned int) {
+		storage.load_sources();
+	});
+
+	// Half of the Earth circumference from the pole covers everything:
+	NavaidStorage::Navaids const navaids = storage.get_navs (LonLat (0_deg, 90_deg), M_PI * kEarthMeanRadius);
+	if (navaids.empty())
+	{
+		std::cout << "# navaids not available, run from the top directory" << std::endl;
+		return;
+	}
+
+	benchmark.measure ("copy", navaids.size(), [&](unsigned int i) {
+		NavaidStorage::Navaids::value_type copy (navaids[i]);
+		static_cast<void> (copy);
+	});
+
+	// Creating navaids from parsed strings, as text data file parsers do.
+	// "records-before" sets strings and runways on each navaid (a block and a table per navaid),
+	// "records-after" uses NavaidsBuilder (one block and one table for all navaids).
+	struct ParsedRunway
+	{
+		QString	identifier_1;
+		LonLat	pos_1;
+		QString	identifier_2;
+		LonLat	pos_2;
+		Length	width;
+	};
+
+	struct ParsedNavaid
+	{
+		QString						identifier;
+		QString						name;
+		QString						icao;
+		QString						runway_id;
+		std::vector<ParsedRunway>	runways;
+		Navaid						navaid;
+	};
+
+	std::vector<ParsedNavaid> parsed;
+	parsed.reserve (navaids.size());
+	for (Navaid const& navaid: navaids)
+	{
+		Navaid without_strings (navaid);
+		without_strings.set_strings (nullptr, 0, 0, 0, 0);
+		without_strings.set_runways (nullptr, 0, 0);
+		parsed.push_back ({ navaid.identifier(), navaid.name(), navaid.icao(), navaid.runway_id(), { }, without_strings });
+		for (Navaid::Runway const& runway: navaid.runways())
+			parsed.back().runways.push_back ({ runway.identifier_1(), runway.pos_1(), runway.identifier_2(), runway.pos_2(), runway.width() });
+	}
+
+	{
+		std::vector<Navaid> created;
+		created.reserve (parsed.size());
+
+		benchmark.measure ("records-before", parsed.size(), [&](unsigned int i) {
+			Navaid navaid (parsed[i].navaid);
+			navaid.set_identifier (parsed[i].identifier);
+			navaid.set_name (parsed[i].name);
+			navaid.set_icao (parsed[i].icao);
+			navaid.set_runway_id (parsed[i].runway_id);
+
+			if (!parsed[i].runways.empty())
+			{
+				Navaid::Runways runways;
+				for (ParsedRunway const& rwy: parsed[i].runways)
+				{
+					Navaid::Runway runway (rwy.identifier_1, rwy.pos_1, rwy.identifier_2, rwy.pos_2);
+					runway.set_width (rwy.width);
+					runways.push_back (runway);
+				}
+				navaid.set_runways (runways);
+			}
+
+			created.push_back (navaid);
+		});
+	}
+
+	{
+		NavaidsBuilder builder;
+		std::vector<Navaid> created;
+
+		benchmark.measure ("records-after", parsed.size(), [&](unsigned int i) {
+			builder.add (parsed[i].navaid, parsed[i].identifier, parsed[i].name, parsed[i].icao, parsed[i].runway_id);
+
+			for (ParsedRunway const& rwy: parsed[i].runways)
+				builder.add_runway (rwy.identifier_1, rwy.pos_1, rwy.identifier_2, rwy.pos_2, rwy.width);
+
+			if (i + 1 == parsed.size())
+				created = builder.finish();
+		});
+	}
+
+	QString const compiled_file = QDir::temp().filePath ("xefis-benchmark.navdb");
+	storage.compile (compiled_file);
+
+	{
+		NavaidDatabase database (compiled_file);
+
+		benchmark.measure ("database", database.navaids_count(), [&](unsigned int i) {
+			Navaid navaid = database.navaid (i);
+			static_cast<void> (navaid);
+		});
+	}
+
+	std::remove (compiled_file.toUtf8().constData());
+});
+
+} // namespace Benchmarks
+} // namespace Xefis
+
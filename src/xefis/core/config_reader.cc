@@ -294,6 +294,17 @@ ConfigReader::PropertiesParser::registered_names() const
 }
 
 
+PropertyNode::Serial
+ConfigReader::PropertiesParser::serial() const
+{
+	// Serials only grow, so their sum changes whenever any of them changes:
+	PropertyNode::Serial result = 0;
+	for (auto const& p: _list)
+		result += p.property->serial();
+	return result;
+}
+
+
 ConfigReader::ConfigReader (Application* application, ModuleManager* module_manager):
 	_application (application),
 	_module_manager (module_manager)
@@ -488,6 +499,8 @@ ConfigReader::process_settings_element (QDomElement const& settings_element)
 	SettingsParser sp ({
 		{ "update-frequency", _update_frequency, false },
 		{ "navaids.enable", _navaids_enable, false },
+		{ "navaids.background", _navaids_background, false },
+		{ "navaids.streaming-radius", _navaids_streaming_radius, false },
 		{ "scale.pen", _scale_pen, false },
 		{ "scale.font", _scale_font, false },
 		{ "scale.master", _scale_master, false },
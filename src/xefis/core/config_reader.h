@@ -249,6 +249,13 @@ class ConfigReader
 		std::vector<QString>
 		registered_names() const;
 
+		/**
+		 * Return combined serial value of all registered properties.
+		 * It changes whenever any of the properties gets updated.
+		 */
+		PropertyNode::Serial
+		serial() const;
+
 	  private:
 		PropertiesList	_list;
 	};
@@ -306,6 +313,20 @@ class ConfigReader
 	bool
 	load_navaids() const noexcept;
 
+	/**
+	 * Return true if navaids should be loaded in background,
+	 * without delaying creation of windows.
+	 */
+	bool
+	load_navaids_in_background() const noexcept;
+
+	/**
+	 * Return radius of region-streaming mode for navaids,
+	 * or nothing if all navaids should be loaded.
+	 */
+	Optional<Length>
+	navaids_streaming_radius() const noexcept;
+
 	/**
 	 * Return scaling factor for pens/lines.
 	 */
@@ -378,6 +399,8 @@ class ConfigReader
 	bool					_has_windows		= false;
 	Frequency				_update_frequency	= 100_Hz;
 	bool					_navaids_enable		= true;
+	bool					_navaids_background	= true;
+	Optional<Length>		_navaids_streaming_radius;
 	float					_scale_pen			= 1.f;
 	float					_scale_font			= 1.f;
 	float					_scale_master		= 1.f;
@@ -434,6 +457,20 @@ ConfigReader::load_navaids() const noexcept
 }
 
 
+inline bool
+ConfigReader::load_navaids_in_background() const noexcept
+{
+	return _navaids_background;
+}
+
+
+inline Optional<Length>
+ConfigReader::navaids_streaming_radius() const noexcept
+{
+	return _navaids_streaming_radius;
+}
+
+
 inline float
 ConfigReader::pen_scale() const noexcept
 {
@@ -16,6 +16,7 @@
 
 // Standard:
 #include <cstddef>
+#include <algorithm>
 
 // Qt:
 #include <QtWidgets/QWidget>
@@ -24,6 +25,7 @@
 // Xefis:
 #include <xefis/config/all.h>
 #include <xefis/core/module.h>
+#include <xefis/core/property_node.h>
 #include <xefis/core/services.h>
 
 
@@ -36,20 +38,62 @@ class Instrument:
 	public QWidget
 {
   public:
-	// Ctor
-	Instrument (ModuleManager*, QDomElement const& config);
+	/**
+	 * Create instrument.
+	 * \param	default_max_fps
+	 * 			Maximum rate of data_updated() calls, used unless the module element
+	 * 			has the "max-fps" attribute.
+	 */
+	Instrument (ModuleManager*, QDomElement const& config, Frequency default_max_fps = 30_Hz);
+
+	/**
+	 * Maximum rate at which ModuleManager calls data_updated().
+	 */
+	Frequency
+	max_fps() const noexcept;
+
+	/**
+	 * Return combined serial of all inputs of the instrument.
+	 * ModuleManager skips data_updated() calls when it doesn't change.
+	 * Default implementation returns properties_serial(). Instruments
+	 * that read properties not registered with parse_properties() must
+	 * add their serials.
+	 */
+	virtual PropertyNode::Serial
+	input_serial() const;
+
+  private:
+	Frequency	_max_fps;
 };
 
 
 inline
-Instrument::Instrument (ModuleManager* module_manager, QDomElement const& config):
+Instrument::Instrument (ModuleManager* module_manager, QDomElement const& config, Frequency default_max_fps):
 	Module (module_manager, config),
-	QWidget (nullptr)
+	QWidget (nullptr),
+	_max_fps (default_max_fps)
 {
+	if (config.hasAttribute ("max-fps"))
+		_max_fps = 1_Hz * std::max (config.attribute ("max-fps").toDouble(), 1.0);
+
 	setFont (xf::Services::instrument_font());
 	setCursor (QCursor (Qt::CrossCursor));
 }
 
+
+inline Frequency
+Instrument::max_fps() const noexcept
+{
+	return _max_fps;
+}
+
+
+inline PropertyNode::Serial
+Instrument::input_serial() const
+{
+	return properties_serial();
+}
+
 } // namespace Xefis
 
 #endif
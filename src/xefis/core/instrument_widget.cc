@@ -47,6 +47,28 @@ InstrumentWidget::PaintWorkUnit::resized()
 }
 
 
+TextPainter::Cache const*
+InstrumentWidget::PaintWorkUnit::text_painter_cache() const
+{
+	return nullptr;
+}
+
+
+void
+InstrumentWidget::PaintWorkUnit::paint_synchronously (QImage& canvas, QSize const& window_size)
+{
+	if (_size != canvas.size() || _window_size != window_size)
+	{
+		_size = canvas.size();
+		_window_size = window_size;
+		resized();
+	}
+
+	pop_params();
+	paint (canvas);
+}
+
+
 void
 InstrumentWidget::PaintWorkUnit::execute()
 {
@@ -149,6 +171,21 @@ InstrumentWidget::push_params()
 }
 
 
+void
+InstrumentWidget::paint_offscreen (QImage& canvas, QSize const& window_size)
+{
+	if (!_paint_work_unit)
+		return;
+
+	// Make sure painting thread isn't using the work unit:
+	Semaphore::Lock paint_lock (_paint_sem);
+	_paint_mutex.synchronize ([&] {
+		push_params();
+	});
+	_paint_work_unit->paint_synchronously (canvas, window_size);
+}
+
+
 void
 InstrumentWidget::resizeEvent (QResizeEvent* event)
 {
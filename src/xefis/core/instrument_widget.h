@@ -26,6 +26,7 @@
 #include <xefis/core/work_performer.h>
 #include <xefis/utility/mutex.h>
 #include <xefis/utility/semaphore.h>
+#include <xefis/utility/text_painter.h>
 
 
 namespace Xefis {
@@ -64,6 +65,20 @@ class InstrumentWidget: public QWidget
 		virtual void
 		paint (QImage& canvas) = 0;
 
+		/**
+		 * Return text painter cache used by the painter, if any.
+		 * Used for statistics. Default implementation returns nullptr.
+		 */
+		virtual TextPainter::Cache const*
+		text_painter_cache() const;
+
+		/**
+		 * Resize if needed, pop params and paint on the calling thread.
+		 * Widget size is taken from the canvas size.
+		 */
+		void
+		paint_synchronously (QImage& canvas, QSize const& window_size);
+
 	  protected:
 		// WorkPerformer::Unit API
 		void
@@ -149,6 +164,20 @@ class InstrumentWidget: public QWidget
 	virtual void
 	push_params();
 
+	/**
+	 * Push current params and paint them on the calling thread into
+	 * the canvas, without involving WorkPerformer or showing the widget.
+	 * Used for offscreen rendering, eg. in benchmarks.
+	 */
+	void
+	paint_offscreen (QImage& canvas, QSize const& window_size);
+
+	/**
+	 * Return the work unit set with set_painter().
+	 */
+	PaintWorkUnit*
+	paint_work_unit() const noexcept;
+
   protected:
 	// QWidget API
 	void
@@ -205,6 +234,13 @@ InstrumentWidget::set_painter (PaintWorkUnit* painter)
 	_paint_work_unit = painter;
 }
 
+
+inline InstrumentWidget::PaintWorkUnit*
+InstrumentWidget::paint_work_unit() const noexcept
+{
+	return _paint_work_unit;
+}
+
 } // namespace Xefis
 
 #endif
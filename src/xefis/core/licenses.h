@@ -27,7 +27,6 @@ namespace License {
 extern const char* main;
 extern const char* font_crystal;
 extern const char* lib_half;
-extern const char* lib_kdtreeplusplus;
 
 } // namespace License
 } // namespace Xefis
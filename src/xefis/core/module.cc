@@ -129,6 +129,13 @@ Module::has_setting (QString const& name)
 }
 
 
+PropertyNode::Serial
+Module::properties_serial() const
+{
+	return _properties_parser->serial();
+}
+
+
 Time
 Module::update_time() const
 {
@@ -198,6 +198,13 @@ class Module: private Noncopyable
 	bool
 	has_setting (QString const& name);
 
+	/**
+	 * Return combined serial of all properties registered with parse_properties().
+	 * Changes whenever any of these properties is updated.
+	 */
+	PropertyNode::Serial
+	properties_serial() const;
+
 	/**
 	 * Access NavaidStorage.
 	 */
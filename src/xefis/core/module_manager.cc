@@ -13,6 +13,7 @@
 
 // Standard:
 #include <cstddef>
+#include <cmath>
 #include <typeinfo>
 
 // Xefis:
@@ -21,6 +22,7 @@
 #include <xefis/core/application.h>
 #include <xefis/core/accounting.h>
 #include <xefis/core/stdexcept.h>
+#include <xefis/utility/numeric.h>
 #include <xefis/utility/time_helper.h>
 
 // Local:
@@ -76,7 +78,14 @@ ModuleManager::load_module (QString const& name, QString const& instance, QDomEl
 
 	Instrument* instrument = dynamic_cast<Instrument*> (module);
 	if (instrument)
-		_instrument_modules.insert (instrument);
+	{
+		// Spread phases of consecutive instruments using golden ratio
+		// fractions of their periods:
+		InstrumentPacing pacing;
+		pacing.period = 1.0 / instrument->max_fps();
+		pacing.phase = pacing.period * floored_mod (0.618034 * _loaded_instruments++, 1.0);
+		_instrument_modules[instrument] = pacing;
+	}
 	else
 		_non_instrument_modules.insert (module);
 
@@ -95,7 +104,9 @@ ModuleManager::unload_module (Module* module)
 		if (umod.get() == module)
 		{
 			// Remove the module:
-			_instrument_modules.erase (module);
+			Instrument* instrument = dynamic_cast<Instrument*> (module);
+			if (instrument)
+				_instrument_modules.erase (instrument);
 			_non_instrument_modules.erase (module);
 
 			Module::Pointer ptr = _module_to_pointer_map[module];
@@ -123,13 +134,9 @@ ModuleManager::data_updated (Time time)
 		module_data_updated (mod);
 
 	// Let instruments display data already computed by all other modules.
-	// Also limit FPS of the instrument modules.
-	if (time - _instrument_update_time > 1_s / 30.0)
-	{
-		for (Module* mod: _instrument_modules)
-			module_data_updated (mod);
-		_instrument_update_time = time;
-	}
+	// Each instrument is paced according to its max FPS setting.
+	for (auto& im: _instrument_modules)
+		instrument_data_updated (im.first, im.second, time);
 }
 
 
@@ -231,6 +238,26 @@ ModuleManager::module_data_updated (Module* module) const
 }
 
 
+void
+ModuleManager::instrument_data_updated (Instrument* instrument, InstrumentPacing& pacing, Time now)
+{
+	int64_t slot = std::floor ((now - pacing.phase) / pacing.period);
+
+	if (slot == pacing.last_slot)
+		return;
+
+	// Slot is consumed even if nothing changed, to keep the phase:
+	pacing.last_slot = slot;
+
+	PropertyNode::Serial serial = instrument->input_serial();
+	if (pacing.last_serial && *pacing.last_serial == serial)
+		return;
+
+	pacing.last_serial = serial;
+	module_data_updated (instrument);
+}
+
+
 void
 ModuleManager::do_module_reload_request (Module::Pointer const& module_ptr)
 {
@@ -16,6 +16,9 @@
 
 // Standard:
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
 #include <set>
 
 // Qt:
@@ -25,11 +28,13 @@
 // Xefis:
 #include <xefis/config/all.h>
 #include <xefis/core/module.h>
+#include <xefis/core/property_node.h>
 
 
 namespace Xefis {
 
 class Module;
+class Instrument;
 class Application;
 
 class ModuleManager: public QObject
@@ -47,8 +52,23 @@ class ModuleManager: public QObject
 		Module::Pointer _module_ptr;
 	};
 
-	typedef std::set<Module*>					Modules;
-	typedef std::set<Unique<Module>>			OwnedModules;
+	/**
+	 * Frame pacing state of an instrument module.
+	 */
+	class InstrumentPacing
+	{
+	  public:
+		Time							period;
+		// Offset of the instrument's update slots, so that instruments
+		// don't all get updated in the same cycle:
+		Time							phase;
+		int64_t							last_slot	= std::numeric_limits<int64_t>::min();
+		Optional<PropertyNode::Serial>	last_serial;
+	};
+
+	typedef std::set<Module*>						Modules;
+	typedef std::set<Unique<Module>>				OwnedModules;
+	typedef std::map<Instrument*, InstrumentPacing>	InstrumentModules;
 
   public:
 	typedef std::map<Module*, Module::Pointer>	ModuleToPointerMap;
@@ -143,6 +163,13 @@ class ModuleManager: public QObject
 	void
 	module_data_updated (Module*) const;
 
+	/**
+	 * Call data_updated() on instrument if its next update slot has come
+	 * and any of its inputs has changed since last update.
+	 */
+	void
+	instrument_data_updated (Instrument*, InstrumentPacing&, Time now);
+
 	/**
 	 * Module reload.
 	 */
@@ -160,11 +187,11 @@ class ModuleManager: public QObject
 	Logger				_logger;
 	Application*		_application = nullptr;
 	OwnedModules		_modules;
-	Modules				_instrument_modules;
+	InstrumentModules	_instrument_modules;
 	Modules				_non_instrument_modules;
 	Time				_update_time;
 	Time				_update_dt;
-	Time				_instrument_update_time;
+	unsigned int		_loaded_instruments	= 0;
 	ModuleToPointerMap	_module_to_pointer_map;
 	PointerToModuleMap	_pointer_to_module_map;
 };
@@ -13,6 +13,11 @@
 
 // Standard:
 #include <cstddef>
+#include <cstring>
+#include <initializer_list>
+
+// Qt:
+#include <QtCore/QByteArray>
 
 // Xefis:
 #include <xefis/config/all.h>
@@ -20,3 +25,74 @@
 // Local:
 #include "navaid.h"
 
+
+namespace Xefis {
+
+/**
+ * Copy null-terminated @strings one after another into a new block
+ * and write their offsets in the block to @offsets.
+ */
+static Shared<char const>
+make_strings (std::initializer_list<char const*> strings, uint32_t* offsets)
+{
+	std::size_t size = 0;
+	for (char const* string: strings)
+		size += std::strlen (string) + 1;
+
+	Shared<char> block (new char[size], std::default_delete<char[]>());
+	std::size_t offset = 0;
+	for (char const* string: strings)
+	{
+		std::size_t const string_size = std::strlen (string) + 1;
+		std::memcpy (block.get() + offset, string, string_size);
+		*offsets++ = offset;
+		offset += string_size;
+	}
+
+	return block;
+}
+
+
+Navaid::Runway::Runway (QString const& identifier_1, LonLat const& pos_1, QString const& identifier_2, LonLat const& pos_2):
+	_pos_1 (pos_1),
+	_pos_2 (pos_2)
+{
+	uint32_t offsets[2];
+	_strings = make_strings ({ identifier_1.toUtf8().constData(), identifier_2.toUtf8().constData() }, offsets);
+	_identifier_1 = offsets[0];
+	_identifier_2 = offsets[1];
+}
+
+
+Navaid::Navaid (Type type, LonLat const& position, QString const& identifier, QString const& name, Length range):
+	_position (position),
+	_range (range),
+	_type (type)
+{
+	uint32_t offsets[3];
+	_strings = make_strings ({ identifier.toUtf8().constData(), name.toUtf8().constData(), "" }, offsets);
+	_identifier = offsets[0];
+	_name = offsets[1];
+	_icao = offsets[2];
+	_runway_id = offsets[2];
+}
+
+
+void
+Navaid::set_string (uint32_t Navaid::* field, QString const& value)
+{
+	uint32_t Navaid::* const fields[] = { &Navaid::_identifier, &Navaid::_name, &Navaid::_icao, &Navaid::_runway_id };
+	QByteArray const utf8 = value.toUtf8();
+	char const* strings[4];
+	for (std::size_t i = 0; i < 4; ++i)
+		strings[i] = fields[i] == field ? utf8.constData() : c_str (_strings, this->*fields[i]);
+
+	uint32_t offsets[4];
+	// Old block is released after strings are copied:
+	_strings = make_strings ({ strings[0], strings[1], strings[2], strings[3] }, offsets);
+	for (std::size_t i = 0; i < 4; ++i)
+		this->*fields[i] = offsets[i];
+}
+
+} // namespace Xefis
+
@@ -16,6 +16,8 @@
 
 // Standard:
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 // Qt:
 #include <QtCore/QString>
@@ -26,6 +28,19 @@
 
 namespace Xefis {
 
+/**
+ * Strings are null-terminated UTF-8 strings in a shared immutable block, addressed by offsets.
+ * Navaids created from the compiled database use the memory-mapped string pool of the database
+ * as the block, so no strings are copied and the block is released (unmapped) together with the
+ * last navaid using it. Navaids parsed from text data files share one block per file, built by
+ * NavaidsBuilder. Other navaids get a small block of their own when strings are set, and each
+ * setter replaces the block. Copies share the block, so copying a Navaid doesn't allocate.
+ * String accessors decode UTF-8 on each call; code that compares many identifiers should use
+ * utf8_identifier() instead.
+ *
+ * Runways of an airport are an immutable range of a runways table, which is shared between
+ * copies of the Navaid and, for navaids built by NavaidsBuilder, between all airports of a file.
+ */
 class Navaid
 {
   public:
@@ -33,13 +48,16 @@ class Navaid
 	{
 	  public:
 		// Ctor
-		Runway (QString const& identifier_1, LonLat const& pos_1, QString const& identifier_2, LonLat const& pos_2) noexcept;
+		Runway (QString const& identifier_1, LonLat const& pos_1, QString const& identifier_2, LonLat const& pos_2);
+
+		// Ctor, identifiers are offsets in the @strings block
+		Runway (Shared<char const> const& strings, uint32_t identifier_1, LonLat const& pos_1, uint32_t identifier_2, LonLat const& pos_2) noexcept;
 
 		/**
 		 * Runway ID of the first end.
 		 */
-		QString const&
-		identifier_1() const noexcept;
+		QString
+		identifier_1() const;
 
 		/**
 		 * Location of the first end.
@@ -50,8 +68,8 @@ class Navaid
 		/**
 		 * Runway ID of the second end.
 		 */
-		QString const&
-		identifier_2() const noexcept;
+		QString
+		identifier_2() const;
 
 		/**
 		 * Location of the second end.
@@ -72,11 +90,12 @@ class Navaid
 		set_width (Length width) noexcept;
 
 	  private:
-		QString	_identifier_1;
-		LonLat	_pos_1;
-		QString	_identifier_2;
-		LonLat	_pos_2;
-		Length	_width;
+		LonLat				_pos_1;
+		LonLat				_pos_2;
+		Length				_width;
+		Shared<char const>	_strings;
+		uint32_t			_identifier_1;
+		uint32_t			_identifier_2;
 	};
 
 	enum Type
@@ -99,6 +118,35 @@ class Navaid
 
 	typedef std::vector<Runway> Runways;
 
+	/**
+	 * Range of runways of an airport in a shared runways table.
+	 */
+	class RunwaysRange
+	{
+	  public:
+		// Ctor
+		RunwaysRange (Runway const* begin, Runway const* end) noexcept;
+
+		Runway const*
+		begin() const noexcept;
+
+		Runway const*
+		end() const noexcept;
+
+		std::size_t
+		size() const noexcept;
+
+		bool
+		empty() const noexcept;
+
+		Runway const&
+		operator[] (std::size_t index) const noexcept;
+
+	  private:
+		Runway const*	_begin;
+		Runway const*	_end;
+	};
+
   public:
 	// Ctor
 	Navaid (Type);
@@ -118,17 +166,24 @@ class Navaid
 	void
 	set_position (LonLat const& position) noexcept;
 
-	QString const&
-	identifier() const noexcept;
+	QString
+	identifier() const;
+
+	/**
+	 * Return identifier as null-terminated UTF-8 string.
+	 * Cheap, doesn't allocate.
+	 */
+	char const*
+	utf8_identifier() const noexcept;
 
 	void
-	set_identifier (QString const& identifier) noexcept;
+	set_identifier (QString const& identifier);
 
-	QString const&
-	name() const noexcept;
+	QString
+	name() const;
 
 	void
-	set_name (QString const& name) noexcept;
+	set_name (QString const& name);
 
 	Length
 	range() const noexcept;
@@ -163,22 +218,22 @@ class Navaid
 	void
 	set_icao (QString const& icao);
 
-	QString const&
-	icao() const noexcept;
+	QString
+	icao() const;
 
 	void
 	set_runway_id (QString const& runway_id);
 
-	QString const&
-	runway_id() const noexcept;
+	QString
+	runway_id() const;
 
 	/**
 	 * Return appropriate identifier for displaying on HSI.
 	 * This will be the identifier for VORs, DMEs, etc.
 	 * and ICAO code for localisers.
 	 */
-	QString const&
-	identifier_for_hsi() const noexcept;
+	QString
+	identifier_for_hsi() const;
 
 	/**
 	 * Return VOR subtype, if this navaid is VOR.
@@ -193,45 +248,79 @@ class Navaid
 	/**
 	 * Return list of runways.
 	 */
-	Runways const&
+	RunwaysRange
 	runways() const noexcept;
 
 	/**
-	 * Set runways list.
+	 * Set runways list. Runways are copied to a new table.
 	 */
 	void
 	set_runways (Runways const& runways);
 
+	/**
+	 * Use @count runways of the shared @table, starting at @begin.
+	 */
+	void
+	set_runways (Shared<Runways const> const& table, uint32_t begin, uint32_t count) noexcept;
+
+	/**
+	 * Set identifier, name, ICAO code and runway ID at once, given as offsets in the @strings
+	 * block of null-terminated UTF-8 strings. The block is shared, not copied.
+	 */
+	void
+	set_strings (Shared<char const> const& strings, uint32_t identifier, uint32_t name, uint32_t icao, uint32_t runway_id) noexcept;
+
+  private:
+	/**
+	 * Return string at @offset in the @strings block,
+	 * or empty string if there's no block.
+	 */
+	static char const*
+	c_str (Shared<char const> const& strings, uint32_t offset) noexcept;
+
+	/**
+	 * Set one of the string fields. Strings are moved to a new block,
+	 * since blocks are shared and immutable.
+	 */
+	void
+	set_string (uint32_t Navaid::* field, QString const& value);
+
   private:
-	Type		_type;
-	LonLat		_position			= { 0_deg, 0_deg };
-	QString		_identifier;
-	QString		_name;
-	Length		_range				= 0_nmi;
-	Frequency	_frequency			= 0_Hz;
-	Angle		_slaved_variation	= 0_deg; // VOR only
-	Length		_elevation			= 0_ft;
-	Angle		_true_bearing		= 0_deg; // LOC* only
-	QString		_icao;
-	QString		_runway_id;
-	VorType		_vor_type			= VOROnly;
-	Runways		_runways; // ARPT only
+	LonLat					_position			= { 0_deg, 0_deg };
+	Length					_range				= 0_nmi;
+	Frequency				_frequency			= 0_Hz;
+	Angle					_slaved_variation	= 0_deg; // VOR only
+	Length					_elevation			= 0_ft;
+	Angle					_true_bearing		= 0_deg; // LOC* only
+	// Runways table and the range of runways of this airport in it (ARPT only):
+	Shared<Runways const>	_runways;
+	uint32_t				_runways_begin		= 0;
+	uint32_t				_runways_count		= 0;
+	// Block of strings, nullptr if all are empty:
+	Shared<char const>		_strings;
+	uint32_t				_identifier			= 0;
+	uint32_t				_name				= 0;
+	uint32_t				_icao				= 0;
+	uint32_t				_runway_id			= 0;
+	uint8_t					_type;
+	uint8_t					_vor_type			= VOROnly;
 };
 
 
 inline
-Navaid::Runway::Runway (QString const& identifier_1, LonLat const& pos_1, QString const& identifier_2, LonLat const& pos_2) noexcept:
-	_identifier_1 (identifier_1),
+Navaid::Runway::Runway (Shared<char const> const& strings, uint32_t identifier_1, LonLat const& pos_1, uint32_t identifier_2, LonLat const& pos_2) noexcept:
 	_pos_1 (pos_1),
-	_identifier_2 (identifier_2),
-	_pos_2 (pos_2)
+	_pos_2 (pos_2),
+	_strings (strings),
+	_identifier_1 (identifier_1),
+	_identifier_2 (identifier_2)
 { }
 
 
-inline QString const&
-Navaid::Runway::identifier_1() const noexcept
+inline QString
+Navaid::Runway::identifier_1() const
 {
-	return _identifier_1;
+	return QString::fromUtf8 (c_str (_strings, _identifier_1));
 }
 
 
@@ -242,10 +331,10 @@ Navaid::Runway::pos_1() const noexcept
 }
 
 
-inline QString const&
-Navaid::Runway::identifier_2() const noexcept
+inline QString
+Navaid::Runway::identifier_2() const
 {
-	return _identifier_2;
+	return QString::fromUtf8 (c_str (_strings, _identifier_2));
 }
 
 
@@ -271,18 +360,50 @@ Navaid::Runway::set_width (Length width) noexcept
 
 
 inline
-Navaid::Navaid (Type type):
-	_type (type)
+Navaid::RunwaysRange::RunwaysRange (Runway const* begin, Runway const* end) noexcept:
+	_begin (begin),
+	_end (end)
 { }
 
 
+inline Navaid::Runway const*
+Navaid::RunwaysRange::begin() const noexcept
+{
+	return _begin;
+}
+
+
+inline Navaid::Runway const*
+Navaid::RunwaysRange::end() const noexcept
+{
+	return _end;
+}
+
+
+inline std::size_t
+Navaid::RunwaysRange::size() const noexcept
+{
+	return _end - _begin;
+}
+
+
+inline bool
+Navaid::RunwaysRange::empty() const noexcept
+{
+	return _begin == _end;
+}
+
+
+inline Navaid::Runway const&
+Navaid::RunwaysRange::operator[] (std::size_t index) const noexcept
+{
+	return _begin[index];
+}
+
+
 inline
-Navaid::Navaid (Type type, LonLat const& position, QString const& identifier, QString const& name, Length range):
-	_type (type),
-	_position (position),
-	_identifier (identifier),
-	_name (name),
-	_range (range)
+Navaid::Navaid (Type type):
+	_type (type)
 { }
 
 
@@ -297,7 +418,7 @@ Navaid::operator< (Navaid const& other) const
 inline Navaid::Type
 Navaid::type() const noexcept
 {
-	return _type;
+	return static_cast<Type> (_type);
 }
 
 
@@ -315,31 +436,38 @@ Navaid::set_position (LonLat const& position) noexcept
 }
 
 
-inline QString const&
-Navaid::identifier() const noexcept
+inline QString
+Navaid::identifier() const
 {
-	return _identifier;
+	return QString::fromUtf8 (utf8_identifier());
+}
+
+
+inline char const*
+Navaid::utf8_identifier() const noexcept
+{
+	return c_str (_strings, _identifier);
 }
 
 
 inline void
-Navaid::set_identifier (QString const& identifier) noexcept
+Navaid::set_identifier (QString const& identifier)
 {
-	_identifier = identifier;
+	set_string (&Navaid::_identifier, identifier);
 }
 
 
-inline QString const&
-Navaid::name() const noexcept
+inline QString
+Navaid::name() const
 {
-	return _name;
+	return QString::fromUtf8 (c_str (_strings, _name));
 }
 
 
 inline void
-Navaid::set_name (QString const& name) noexcept
+Navaid::set_name (QString const& name)
 {
-	_name = name;
+	set_string (&Navaid::_name, name);
 }
 
 
@@ -416,33 +544,33 @@ Navaid::true_bearing() const noexcept
 inline void
 Navaid::set_icao (QString const& icao)
 {
-	_icao = icao;
+	set_string (&Navaid::_icao, icao);
 }
 
 
-inline QString const&
-Navaid::icao() const noexcept
+inline QString
+Navaid::icao() const
 {
-	return _icao;
+	return QString::fromUtf8 (c_str (_strings, _icao));
 }
 
 
 inline void
 Navaid::set_runway_id (QString const& runway_id)
 {
-	_runway_id = runway_id;
+	set_string (&Navaid::_runway_id, runway_id);
 }
 
 
-inline QString const&
-Navaid::runway_id() const noexcept
+inline QString
+Navaid::runway_id() const
 {
-	return _runway_id;
+	return QString::fromUtf8 (c_str (_strings, _runway_id));
 }
 
 
-inline QString const&
-Navaid::identifier_for_hsi() const noexcept
+inline QString
+Navaid::identifier_for_hsi() const
 {
 	if (_type == LOC)
 		return icao();
@@ -450,10 +578,21 @@ Navaid::identifier_for_hsi() const noexcept
 }
 
 
+inline void
+Navaid::set_strings (Shared<char const> const& strings, uint32_t identifier, uint32_t name, uint32_t icao, uint32_t runway_id) noexcept
+{
+	_strings = strings;
+	_identifier = identifier;
+	_name = name;
+	_icao = icao;
+	_runway_id = runway_id;
+}
+
+
 inline Navaid::VorType
 Navaid::vor_type() const noexcept
 {
-	return _vor_type;
+	return static_cast<VorType> (_vor_type);
 }
 
 
@@ -464,17 +603,40 @@ Navaid::set_vor_type (VorType vor_type) noexcept
 }
 
 
-inline Navaid::Runways const&
+inline Navaid::RunwaysRange
 Navaid::runways() const noexcept
 {
-	return _runways;
+	if (!_runways)
+		return RunwaysRange (nullptr, nullptr);
+
+	Runway const* begin = _runways->data() + _runways_begin;
+	return RunwaysRange (begin, begin + _runways_count);
 }
 
 
 inline void
 Navaid::set_runways (Runways const& runways)
 {
-	_runways = runways;
+	if (runways.empty())
+		set_runways (nullptr, 0, 0);
+	else
+		set_runways (std::make_shared<Runways const> (runways), 0, runways.size());
+}
+
+
+inline void
+Navaid::set_runways (Shared<Runways const> const& table, uint32_t begin, uint32_t count) noexcept
+{
+	_runways = table;
+	_runways_begin = begin;
+	_runways_count = count;
+}
+
+
+inline char const*
+Navaid::c_str (Shared<char const> const& strings, uint32_t offset) noexcept
+{
+	return strings ? strings.get() + offset : "";
 }
 
 } // namespace Xefis
@@ -0,0 +1,411 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include <numeric>
+
+// System:
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+
+// Qt:
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/stdexcept.h>
+
+// Local:
+#include "navaid_database.h"
+
+
+namespace Xefis {
+
+static constexpr char kNavaidDatabaseMagic[8] = { 'X', 'F', 'N', 'A', 'V', 'D', 'B', '\0' };
+
+
+inline QString
+NavaidDatabase::string (uint32_t offset) const
+{
+	if (offset >= _header->strings_size)
+		return QString();
+	return QString::fromUtf8 (_strings + offset);
+}
+
+
+inline uint32_t
+NavaidDatabase::checked_string_offset (uint32_t offset) const noexcept
+{
+	// String pool ends with a null-terminator, which is an empty string:
+	if (offset >= _header->strings_size)
+		return _header->strings_size - 1;
+	return offset;
+}
+
+
+template<class T>
+	inline T const*
+	NavaidDatabase::checked_pointer (uint64_t offset, uint64_t count) const
+	{
+		if (offset % alignof (T) != 0 || offset > _size || count > (_size - offset) / sizeof (T))
+			throw IOError ("section out of file bounds");
+		return reinterpret_cast<T const*> (_data + offset);
+	}
+
+
+NavaidDatabase::NavaidDatabase (QString const& path):
+	_path (path)
+{
+	// Mapping, if any, is released with the _mapping member:
+	auto fail = [&](QString const& message) {
+		if (_fd >= 0)
+			::close (_fd);
+		throw IOError ("navigation database " + _path + ": " + message);
+	};
+
+	_fd = ::open (path.toStdString().c_str(), O_RDONLY);
+	if (_fd < 0)
+		fail (QString ("could not open file: ") + strerror (errno));
+
+	struct stat st;
+	if (::fstat (_fd, &st) != 0)
+		fail (QString ("could not stat file: ") + strerror (errno));
+
+	_size = st.st_size;
+	if (_size < sizeof (Header))
+		fail ("file too short");
+
+	void* mapping = ::mmap (nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+	if (mapping == MAP_FAILED)
+		fail (QString ("could not map file: ") + strerror (errno));
+
+	std::size_t const size = _size;
+	_mapping = Shared<uint8_t const> (static_cast<uint8_t const*> (mapping), [size](uint8_t const* data) {
+		::munmap (const_cast<uint8_t*> (data), size);
+	});
+	_data = _mapping.get();
+	_header = reinterpret_cast<Header const*> (_data);
+
+	if (std::memcmp (_header->magic, kNavaidDatabaseMagic, sizeof (kNavaidDatabaseMagic)) != 0)
+		fail ("not a navigation database");
+	if (_header->version != kVersion)
+		fail (QString ("unsupported version %1").arg (_header->version));
+	if (_header->byte_order_mark != kByteOrderMark || _header->navaid_record_size != sizeof (NavaidRecord) || _header->runway_record_size != sizeof (RunwayRecord))
+		fail ("file compiled for different architecture");
+	if (_header->sources_count > kMaxSources)
+		fail ("invalid header");
+
+	try {
+		_navaids = checked_pointer<NavaidRecord> (_header->navaids_offset, _header->navaids_count);
+		_runways = checked_pointer<RunwayRecord> (_header->runways_offset, _header->runways_count);
+		_strings = checked_pointer<char> (_header->strings_offset, _header->strings_size);
+		_by_identifier = checked_pointer<uint32_t> (_header->by_identifier_offset, _header->navaids_count);
+		_by_frequency = checked_pointer<uint32_t> (_header->by_frequency_offset, _header->navaids_count);
+		_tiles = checked_pointer<TileRecord> (_header->tiles_offset, _header->tiles_count);
+		_tile_grid = GeoTileGrid (1_deg * _header->tile_size_deg);
+	}
+	catch (Exception const& e)
+	{
+		fail (e.what());
+	}
+
+	// String pool must end with a null-terminator, so that any valid offset gives a terminated string:
+	if (_header->strings_size == 0 || _strings[_header->strings_size - 1] != '\0')
+		fail ("invalid string pool");
+
+	_shared_strings = Shared<char const> (_mapping, _strings);
+
+	for (std::size_t i = 0; i < _header->navaids_count; ++i)
+	{
+		if (_by_identifier[i] >= _header->navaids_count || _by_frequency[i] >= _header->navaids_count)
+			fail ("invalid index");
+
+		NavaidRecord const& record = _navaids[i];
+		if (record.runways_begin > _header->runways_count || record.runways_count > _header->runways_count - record.runways_begin)
+			fail ("invalid runways range");
+	}
+
+	// Tiles must cover the navaids array contiguously, in tile order:
+	if (_header->tiles_count != _tile_grid.tiles_count())
+		fail ("invalid tile directory");
+
+	uint64_t next_navaid = 0;
+	for (std::size_t t = 0; t < _header->tiles_count; ++t)
+	{
+		if (_tiles[t].navaids_begin != next_navaid)
+			fail ("invalid tile directory");
+		next_navaid += _tiles[t].navaids_count;
+	}
+
+	if (next_navaid != _header->navaids_count)
+		fail ("invalid tile directory");
+}
+
+
+NavaidDatabase::~NavaidDatabase()
+{
+	::close (_fd);
+}
+
+
+bool
+NavaidDatabase::is_fresh (std::vector<QString> const& source_paths) const
+{
+	if (source_paths.size() != _header->sources_count)
+		return false;
+
+	for (std::size_t i = 0; i < source_paths.size(); ++i)
+	{
+		// Missing files have stamp { -1, -1 } and are compared like the rest:
+		if (!(source_stamp (source_paths[i]) == _header->sources[i]))
+			return false;
+	}
+
+	return true;
+}
+
+
+QString
+NavaidDatabase::identifier (std::size_t index) const
+{
+	return string (_navaids[index].identifier);
+}
+
+
+char const*
+NavaidDatabase::utf8_identifier (std::size_t index) const noexcept
+{
+	uint32_t const offset = _navaids[index].identifier;
+	if (offset >= _header->strings_size)
+		return "";
+	return _strings + offset;
+}
+
+
+Navaid
+NavaidDatabase::navaid (std::size_t index) const
+{
+	NavaidRecord const& record = _navaids[index];
+
+	Navaid navaid (static_cast<Navaid::Type> (record.type));
+	navaid.set_position (LonLat (1_deg * record.lon_deg, 1_deg * record.lat_deg));
+	navaid.set_range (1_nmi * record.range_nmi);
+	// Refer to strings in the mapped file, without copying them:
+	navaid.set_strings (_shared_strings, checked_string_offset (record.identifier), checked_string_offset (record.name),
+						checked_string_offset (record.icao), checked_string_offset (record.runway_id));
+	navaid.set_frequency (1_Hz * record.frequency_hz);
+	navaid.set_slaved_variation (1_deg * record.slaved_variation_deg);
+	navaid.set_elevation (1_ft * record.elevation_ft);
+	navaid.set_true_bearing (1_deg * record.true_bearing_deg);
+	navaid.set_vor_type (static_cast<Navaid::VorType> (record.vor_type));
+
+	if (record.runways_count > 0)
+	{
+		Navaid::Runways runways;
+		runways.reserve (record.runways_count);
+
+		for (uint32_t r = record.runways_begin; r < record.runways_begin + record.runways_count; ++r)
+		{
+			RunwayRecord const& rwy = _runways[r];
+			Navaid::Runway runway (_shared_strings,
+								   checked_string_offset (rwy.identifier[0]), LonLat (1_deg * rwy.lon_deg[0], 1_deg * rwy.lat_deg[0]),
+								   checked_string_offset (rwy.identifier[1]), LonLat (1_deg * rwy.lon_deg[1], 1_deg * rwy.lat_deg[1]));
+			runway.set_width (1_m * rwy.width_m);
+			runways.push_back (runway);
+		}
+
+		navaid.set_runways (std::make_shared<Navaid::Runways const> (std::move (runways)), 0, record.runways_count);
+	}
+
+	return navaid;
+}
+
+
+NavaidDatabase::SourceStamp
+NavaidDatabase::source_stamp (QString const& path)
+{
+	SourceStamp stamp;
+	QFileInfo file_info (path);
+
+	if (file_info.exists())
+	{
+		stamp.size = file_info.size();
+		stamp.mtime_ms = file_info.lastModified().toMSecsSinceEpoch();
+	}
+
+	return stamp;
+}
+
+
+void
+NavaidDatabase::write (QString const& path, std::vector<QString> const& source_paths, GeoTileGrid const& tile_grid, std::vector<Navaid const*> const& navaids)
+{
+	if (source_paths.size() > kMaxSources)
+		throw InvalidCall ("too many source files for navigation database");
+
+	std::vector<TileRecord> tile_records (tile_grid.tiles_count(), TileRecord {});
+	GeoTileGrid::TileID previous_tile = 0;
+
+	for (std::size_t i = 0; i < navaids.size(); ++i)
+	{
+		GeoTileGrid::TileID tile = tile_grid.tile_of (navaids[i]->position());
+		if (tile < previous_tile)
+			throw InvalidCall ("navaids must be sorted by tile");
+		if (tile_records[tile].navaids_count++ == 0)
+			tile_records[tile].navaids_begin = i;
+		previous_tile = tile;
+	}
+
+	// Empty tiles start where the next non-empty tile starts:
+	uint32_t next_navaid = navaids.size();
+	for (std::size_t t = tile_records.size(); t-- > 0; )
+	{
+		if (tile_records[t].navaids_count == 0)
+			tile_records[t].navaids_begin = next_navaid;
+		next_navaid = tile_records[t].navaids_begin;
+	}
+
+	std::vector<char> strings;
+	std::map<QString, uint32_t> string_offsets;
+
+	auto intern = [&](QString const& string) -> uint32_t
+	{
+		auto found = string_offsets.find (string);
+		if (found != string_offsets.end())
+			return found->second;
+
+		QByteArray utf8 = string.toUtf8();
+		uint32_t offset = strings.size();
+		strings.insert (strings.end(), utf8.begin(), utf8.end());
+		strings.push_back ('\0');
+		string_offsets[string] = offset;
+		return offset;
+	};
+
+	// Offset 0 is the empty string:
+	intern ("");
+
+	std::vector<NavaidRecord> navaid_records;
+	std::vector<RunwayRecord> runway_records;
+	navaid_records.reserve (navaids.size());
+
+	for (Navaid const* navaid: navaids)
+	{
+		NavaidRecord record {};
+		record.lon_deg = navaid->position().lon().quantity<Degree>();
+		record.lat_deg = navaid->position().lat().quantity<Degree>();
+		record.range_nmi = navaid->range().quantity<NauticalMile>();
+		record.frequency_hz = navaid->frequency().quantity<Hertz>();
+		record.slaved_variation_deg = navaid->slaved_variation().quantity<Degree>();
+		record.elevation_ft = navaid->elevation().quantity<Foot>();
+		record.true_bearing_deg = navaid->true_bearing().quantity<Degree>();
+		record.identifier = intern (navaid->identifier());
+		record.name = intern (navaid->name());
+		record.icao = intern (navaid->icao());
+		record.runway_id = intern (navaid->runway_id());
+		record.runways_begin = runway_records.size();
+		record.runways_count = navaid->runways().size();
+		record.type = navaid->type();
+		record.vor_type = navaid->vor_type();
+
+		for (Navaid::Runway const& runway: navaid->runways())
+		{
+			RunwayRecord rwy {};
+			rwy.lon_deg[0] = runway.pos_1().lon().quantity<Degree>();
+			rwy.lat_deg[0] = runway.pos_1().lat().quantity<Degree>();
+			rwy.lon_deg[1] = runway.pos_2().lon().quantity<Degree>();
+			rwy.lat_deg[1] = runway.pos_2().lat().quantity<Degree>();
+			rwy.width_m = runway.width().quantity<Meter>();
+			rwy.identifier[0] = intern (runway.identifier_1());
+			rwy.identifier[1] = intern (runway.identifier_2());
+			runway_records.push_back (rwy);
+		}
+
+		navaid_records.push_back (record);
+	}
+
+	std::vector<uint32_t> by_identifier (navaids.size());
+	std::iota (by_identifier.begin(), by_identifier.end(), 0);
+	std::stable_sort (by_identifier.begin(), by_identifier.end(), [&](uint32_t a, uint32_t b) {
+		if (navaids[a]->type() != navaids[b]->type())
+			return navaids[a]->type() < navaids[b]->type();
+		return std::strcmp (navaids[a]->utf8_identifier(), navaids[b]->utf8_identifier()) < 0;
+	});
+
+	std::vector<uint32_t> by_frequency (navaids.size());
+	std::iota (by_frequency.begin(), by_frequency.end(), 0);
+	std::stable_sort (by_frequency.begin(), by_frequency.end(), [&](uint32_t a, uint32_t b) {
+		if (navaids[a]->type() != navaids[b]->type())
+			return navaids[a]->type() < navaids[b]->type();
+		return navaids[a]->frequency() < navaids[b]->frequency();
+	});
+
+	// Layout sections, each aligned to 8 bytes:
+	auto align = [](uint64_t offset) -> uint64_t { return (offset + 7) & ~static_cast<uint64_t> (7); };
+
+	Header header {};
+	std::memcpy (header.magic, kNavaidDatabaseMagic, sizeof (kNavaidDatabaseMagic));
+	header.version = kVersion;
+	header.byte_order_mark = kByteOrderMark;
+	header.navaid_record_size = sizeof (NavaidRecord);
+	header.runway_record_size = sizeof (RunwayRecord);
+	header.sources_count = source_paths.size();
+	for (std::size_t i = 0; i < source_paths.size(); ++i)
+		header.sources[i] = source_stamp (source_paths[i]);
+	header.navaids_offset = align (sizeof (Header));
+	header.navaids_count = navaid_records.size();
+	header.runways_offset = align (header.navaids_offset + sizeof (NavaidRecord) * navaid_records.size());
+	header.runways_count = runway_records.size();
+	header.by_identifier_offset = align (header.runways_offset + sizeof (RunwayRecord) * runway_records.size());
+	header.by_frequency_offset = align (header.by_identifier_offset + sizeof (uint32_t) * by_identifier.size());
+	header.tile_size_deg = tile_grid.tile_size().quantity<Degree>();
+	header.tiles_offset = align (header.by_frequency_offset + sizeof (uint32_t) * by_frequency.size());
+	header.tiles_count = tile_records.size();
+	header.strings_offset = align (header.tiles_offset + sizeof (TileRecord) * tile_records.size());
+	header.strings_size = strings.size();
+
+	QByteArray data (header.strings_offset + header.strings_size, '\0');
+	auto put = [&](uint64_t offset, void const* source, std::size_t bytes) {
+		if (bytes > 0)
+			std::memcpy (data.data() + offset, source, bytes);
+	};
+
+	put (0, &header, sizeof (header));
+	put (header.navaids_offset, navaid_records.data(), sizeof (NavaidRecord) * navaid_records.size());
+	put (header.runways_offset, runway_records.data(), sizeof (RunwayRecord) * runway_records.size());
+	put (header.by_identifier_offset, by_identifier.data(), sizeof (uint32_t) * by_identifier.size());
+	put (header.by_frequency_offset, by_frequency.data(), sizeof (uint32_t) * by_frequency.size());
+	put (header.tiles_offset, tile_records.data(), sizeof (TileRecord) * tile_records.size());
+	put (header.strings_offset, strings.data(), strings.size());
+
+	// QSaveFile replaces the target atomically, so a running instance never sees partially written file:
+	QSaveFile file (path);
+	if (!file.open (QSaveFile::WriteOnly))
+		throw IOError ("could not open " + path + " for writing: " + file.errorString());
+	if (file.write (data) != data.size() || !file.commit())
+		throw IOError ("could not write " + path + ": " + file.errorString());
+}
+
+} // namespace Xefis
+
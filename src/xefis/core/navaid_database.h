@@ -0,0 +1,322 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+#ifndef XEFIS__CORE__NAVAID_DATABASE_H__INCLUDED
+#define XEFIS__CORE__NAVAID_DATABASE_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Qt:
+#include <QtCore/QString>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/utility/geo_tile_grid.h>
+#include <xefis/utility/noncopyable.h>
+
+// Local:
+#include "navaid.h"
+
+
+namespace Xefis {
+
+/**
+ * Precompiled, memory-mapped navigation database.
+ *
+ * The file is created offline from text nav/fix/apt data files (see the navdb-compiler tool)
+ * and contains packed navaid and runway records, a string pool, and indexes of navaids sorted by
+ * (type, identifier) and (type, frequency).
+ *
+ * Navaid records are grouped by GeoTileGrid tiles, and the tile directory gives the range of records
+ * of each tile, so that a single tile can be loaded by touching only its own pages. Within a tile
+ * records are in SphericalIndex order, so that per-tile indexes don't have to be rebuilt on load.
+ *
+ * Navaids created with navaid() refer to strings in the mapped string pool instead of copying
+ * them. They keep the mapping alive, so it's unmapped when both the database and all such navaids
+ * (and their copies) are destroyed.
+ *
+ * The file is stored in native byte order; files with different byte order, version
+ * or record sizes are rejected. Header stores size and modification time of each source file,
+ * so that stale files can be detected with is_fresh().
+ */
+class NavaidDatabase: private Noncopyable
+{
+  public:
+	static constexpr uint32_t	kVersion		= 3;
+	static constexpr uint32_t	kByteOrderMark	= 0x01020304;
+	static constexpr std::size_t kMaxSources	= 4;
+
+	/**
+	 * Identifies a version of a source text file.
+	 */
+	struct SourceStamp
+	{
+		int64_t		size		= -1;
+		int64_t		mtime_ms	= -1;
+
+		bool
+		operator== (SourceStamp const& other) const noexcept;
+	};
+
+	struct Header
+	{
+		char		magic[8];
+		uint32_t	version;
+		uint32_t	byte_order_mark;
+		uint32_t	navaid_record_size;
+		uint32_t	runway_record_size;
+		uint32_t	sources_count;
+		uint32_t	reserved;
+		SourceStamp	sources[kMaxSources];
+		uint64_t	navaids_offset;
+		uint64_t	navaids_count;
+		uint64_t	runways_offset;
+		uint64_t	runways_count;
+		uint64_t	strings_offset;
+		uint64_t	strings_size;
+		// Both indexes contain navaids_count uint32_t indexes to the navaids array:
+		uint64_t	by_identifier_offset;
+		uint64_t	by_frequency_offset;
+		// Tile directory, one TileRecord for each tile of the grid:
+		double		tile_size_deg;
+		uint64_t	tiles_offset;
+		uint64_t	tiles_count;
+	};
+
+	struct TileRecord
+	{
+		// Range in the navaids array:
+		uint32_t	navaids_begin;
+		uint32_t	navaids_count;
+	};
+
+	struct NavaidRecord
+	{
+		double		lon_deg;
+		double		lat_deg;
+		double		range_nmi;
+		double		frequency_hz;
+		double		slaved_variation_deg;
+		double		elevation_ft;
+		double		true_bearing_deg;
+		// Offsets in the string pool:
+		uint32_t	identifier;
+		uint32_t	name;
+		uint32_t	icao;
+		uint32_t	runway_id;
+		// Range in the runways array:
+		uint32_t	runways_begin;
+		uint32_t	runways_count;
+		uint8_t		type;
+		uint8_t		vor_type;
+		uint8_t		reserved[6];
+	};
+
+	struct RunwayRecord
+	{
+		double		lon_deg[2];
+		double		lat_deg[2];
+		double		width_m;
+		// Offsets in the string pool:
+		uint32_t	identifier[2];
+	};
+
+  public:
+	/**
+	 * Map the file to memory.
+	 * Throw IOError if file can't be mapped or has invalid format.
+	 */
+	explicit
+	NavaidDatabase (QString const& path);
+
+	// Dtor
+	~NavaidDatabase();
+
+	/**
+	 * Return true if database was compiled from given source files
+	 * in their current versions.
+	 */
+	bool
+	is_fresh (std::vector<QString> const& source_paths) const;
+
+	/**
+	 * Number of navaids.
+	 */
+	std::size_t
+	navaids_count() const noexcept;
+
+	/**
+	 * Return navaid record.
+	 */
+	NavaidRecord const&
+	navaid_record (std::size_t index) const noexcept;
+
+	/**
+	 * Return identifier of the navaid at given index.
+	 */
+	QString
+	identifier (std::size_t index) const;
+
+	/**
+	 * Return identifier of the navaid at given index as null-terminated UTF-8 string.
+	 * Unlike identifier() it doesn't allocate.
+	 */
+	char const*
+	utf8_identifier (std::size_t index) const noexcept;
+
+	/**
+	 * Create Navaid object from the record at given index.
+	 */
+	Navaid
+	navaid (std::size_t index) const;
+
+	/**
+	 * Grid used to group navaids into tiles.
+	 */
+	GeoTileGrid const&
+	tile_grid() const noexcept;
+
+	/**
+	 * Return range of navaid records of given tile. Navaids within
+	 * the range are in SphericalIndex order.
+	 */
+	TileRecord const&
+	tile_record (GeoTileGrid::TileID tile) const noexcept;
+
+	/**
+	 * Return array of navaids_count() navaid indexes
+	 * sorted by (type, identifier).
+	 */
+	uint32_t const*
+	by_identifier() const noexcept;
+
+	/**
+	 * Return array of navaids_count() navaid indexes
+	 * sorted by (type, frequency).
+	 */
+	uint32_t const*
+	by_frequency() const noexcept;
+
+	/**
+	 * Return source file stamp for the file at @path.
+	 */
+	static SourceStamp
+	source_stamp (QString const& path);
+
+	/**
+	 * Write database file.
+	 * Navaids must be sorted by tile of the @tile_grid, and should be in SphericalIndex
+	 * order within each tile. Throw InvalidCall if they're not sorted by tile,
+	 * IOError on failure.
+	 */
+	static void
+	write (QString const& path, std::vector<QString> const& source_paths, GeoTileGrid const& tile_grid, std::vector<Navaid const*> const& navaids);
+
+  private:
+	/**
+	 * Return string from the string pool.
+	 */
+	QString
+	string (uint32_t offset) const;
+
+	/**
+	 * Return @offset if it's a valid offset in the string pool,
+	 * offset of an empty string otherwise.
+	 */
+	uint32_t
+	checked_string_offset (uint32_t offset) const noexcept;
+
+	/**
+	 * Return pointer to data at given offset.
+	 * Throw IOError if the range doesn't fit in the file.
+	 */
+	template<class T>
+		T const*
+		checked_pointer (uint64_t offset, uint64_t count) const;
+
+  private:
+	QString				_path;
+	int					_fd			= -1;
+	// Unmaps the file when released:
+	Shared<uint8_t const>	_mapping;
+	uint8_t const*		_data		= nullptr;
+	std::size_t			_size		= 0;
+	Header const*		_header		= nullptr;
+	NavaidRecord const*	_navaids	= nullptr;
+	RunwayRecord const*	_runways	= nullptr;
+	char const*			_strings	= nullptr;
+	// Shares ownership of _mapping, given to navaids:
+	Shared<char const>	_shared_strings;
+	uint32_t const*		_by_identifier	= nullptr;
+	uint32_t const*		_by_frequency	= nullptr;
+	TileRecord const*	_tiles		= nullptr;
+	GeoTileGrid			_tile_grid;
+};
+
+
+inline bool
+NavaidDatabase::SourceStamp::operator== (SourceStamp const& other) const noexcept
+{
+	return size == other.size && mtime_ms == other.mtime_ms;
+}
+
+
+inline std::size_t
+NavaidDatabase::navaids_count() const noexcept
+{
+	return _header->navaids_count;
+}
+
+
+inline NavaidDatabase::NavaidRecord const&
+NavaidDatabase::navaid_record (std::size_t index) const noexcept
+{
+	return _navaids[index];
+}
+
+
+inline GeoTileGrid const&
+NavaidDatabase::tile_grid() const noexcept
+{
+	return _tile_grid;
+}
+
+
+inline NavaidDatabase::TileRecord const&
+NavaidDatabase::tile_record (GeoTileGrid::TileID tile) const noexcept
+{
+	return _tiles[tile];
+}
+
+
+inline uint32_t const*
+NavaidDatabase::by_identifier() const noexcept
+{
+	return _by_identifier;
+}
+
+
+inline uint32_t const*
+NavaidDatabase::by_frequency() const noexcept
+{
+	return _by_frequency;
+}
+
+} // namespace Xefis
+
+#endif
+
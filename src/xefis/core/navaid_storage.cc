@@ -13,6 +13,14 @@
 
 // Standard:
 #include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <set>
 
 // Qt:
 #include <QtCore/QFile>
@@ -20,11 +28,14 @@
 
 // Xefis:
 #include <xefis/config/all.h>
+#include <xefis/core/stdexcept.h>
 #include <xefis/utility/numeric.h>
 #include <xefis/utility/qzdevice.h>
 
 // Local:
 #include "navaid_storage.h"
+#include "navaid_database.h"
+#include "navaids_builder.h"
 
 
 namespace Xefis {
@@ -99,8 +110,360 @@ GzDataFileIterator::operator*()
 }
 
 
+/**
+ * Return point reached from @start after travelling @distance (great-circle angle)
+ * with initial @bearing.
+ */
+static LonLat
+great_circle_destination (LonLat const& start, Angle bearing, Angle distance)
+{
+	double const lon_1 = start.lon().quantity<Radian>();
+	double const lat_1 = start.lat().quantity<Radian>();
+	double const b = bearing.quantity<Radian>();
+	double const d = distance.quantity<Radian>();
+	double const lat_2 = std::asin (std::sin (lat_1) * std::cos (d) + std::cos (lat_1) * std::sin (d) * std::cos (b));
+	double const lon_2 = lon_1 + std::atan2 (std::sin (b) * std::sin (d) * std::cos (lat_1), std::cos (d) - std::sin (lat_1) * std::sin (lat_2));
+
+	return LonLat (1_rad * floored_mod (lon_2 + M_PI, 2.0 * M_PI) - 180_deg, 1_rad * lat_2);
+}
+
+
+NavaidStorage::FrequencyIterator&
+NavaidStorage::FrequencyIterator::operator++()
+{
+	++_channels[_current].nearest;
+	find_nearest_channel();
+	return *this;
+}
+
+
+void
+NavaidStorage::FrequencyIterator::add_channel (NavaidRefs const& navaids, SphericalIndex const& index, LonLat const& position)
+{
+	_channels.push_back ({ &navaids, index.nearest (position) });
+}
+
+
+void
+NavaidStorage::FrequencyIterator::find_nearest_channel() noexcept
+{
+	// Usually there are only one or two channels, linear search is fine:
+	_current = _channels.size();
+	for (std::size_t c = 0; c < _channels.size(); ++c)
+		if (_channels[c].nearest && (_current == _channels.size() || _channels[c].nearest.squared_chord() < _channels[_current].nearest.squared_chord()))
+			_current = c;
+}
+
+
+NavaidStorage::PrefixSearch::PrefixSearch (NavaidStorage const& storage, TypeFilter filter):
+	_storage (&storage),
+	_filter (filter)
+{
+	if (!_storage->loaded())
+		return;
+
+	_storage_loaded = true;
+
+	if (NavaidDatabase const* database = _storage->_database.get())
+	{
+		// Database index is sorted by (type, identifier):
+		auto type_of = [database](uint32_t i) {
+			return static_cast<Navaid::Type> (database->navaid_record (i).type);
+		};
+		uint32_t const* by_identifier = database->by_identifier();
+		uint32_t const* by_identifier_end = by_identifier + database->navaids_count();
+
+		for (int t = Navaid::OTHER; t <= Navaid::ARPT; ++t)
+		{
+			auto const type = static_cast<Navaid::Type> (t);
+			if (!_filter.accepts (type))
+				continue;
+
+			auto begin = std::lower_bound (by_identifier, by_identifier_end, type, [&](uint32_t i, Navaid::Type type) {
+				return type_of (i) < type;
+			});
+			auto end = std::upper_bound (begin, by_identifier_end, type, [&](Navaid::Type type, uint32_t i) {
+				return type < type_of (i);
+			});
+			if (begin != end)
+				_ranges.push_back ({ type, nullptr, static_cast<std::size_t> (begin - by_identifier), static_cast<std::size_t> (end - by_identifier) });
+		}
+	}
+	else
+	{
+		for (auto const& g: _storage->_navaids_by_type)
+			if (_filter.accepts (g.first) && !g.second.by_identifier.empty())
+				_ranges.push_back ({ g.first, g.second.by_identifier.data(), 0, g.second.by_identifier.size() });
+	}
+}
+
+
+void
+NavaidStorage::PrefixSearch::set_prefix (QString const& prefix)
+{
+	if (!_storage_loaded || !prefix.startsWith (_prefix))
+		*this = PrefixSearch (*_storage, _filter);
+
+	_prefix = prefix;
+
+	QByteArray const utf8_prefix = prefix.toUtf8();
+	for (Range& range: _ranges)
+		narrow (range, utf8_prefix);
+
+	_ranges.erase (std::remove_if (_ranges.begin(), _ranges.end(), [](Range const& range) { return range.begin == range.end; }), _ranges.end());
+}
+
+
+std::size_t
+NavaidStorage::PrefixSearch::matches_count() const noexcept
+{
+	std::size_t count = 0;
+	for (Range const& range: _ranges)
+		count += range.end - range.begin;
+	return count;
+}
+
+
+NavaidStorage::Navaids
+NavaidStorage::PrefixSearch::nearest (LonLat const& position, std::size_t limit) const
+{
+	struct Match
+	{
+		float			squared_chord;
+		Range const*	range;
+		std::size_t		index_position;
+
+		bool
+		operator< (Match const& other) const noexcept
+		{
+			return squared_chord < other.squared_chord;
+		}
+	};
+
+	// Short prefixes match a large part of the world, search tiles around the position instead:
+	if (matches_count() > kMaxScannedMatches)
+		return nearest_in_tiles (position, limit);
+
+	SphericalIndex::Vector const center = SphericalIndex::to_vector (position);
+	double const center_lat_deg = position.lat().quantity<Degree>();
+	// Max-heap of the nearest matches found so far:
+	std::vector<Match> matches;
+	matches.reserve (limit);
+	// Great-circle distance is never less than the latitude difference, so once
+	// there are enough matches, farther candidates can be skipped without any
+	// trigonometry:
+	double max_lat_difference_deg = std::numeric_limits<double>::infinity();
+
+	if (limit > 0)
+	{
+		for (Range const& range: _ranges)
+		{
+			for (std::size_t i = range.begin; i < range.end; ++i)
+			{
+				LonLat const candidate = this->position (range, i);
+				if (std::abs (candidate.lat().quantity<Degree>() - center_lat_deg) > max_lat_difference_deg)
+					continue;
+
+				SphericalIndex::Vector const v = SphericalIndex::to_vector (candidate);
+				float const dx = v[0] - center[0];
+				float const dy = v[1] - center[1];
+				float const dz = v[2] - center[2];
+				Match const match { dx * dx + dy * dy + dz * dz, &range, i };
+
+				if (matches.size() < limit)
+					matches.push_back (match);
+				else if (match < matches.front())
+				{
+					std::pop_heap (matches.begin(), matches.end());
+					matches.back() = match;
+				}
+				else
+					continue;
+
+				std::push_heap (matches.begin(), matches.end());
+
+				if (matches.size() == limit)
+				{
+					double const max_chord = std::min (2.0, std::sqrt (static_cast<double> (matches.front().squared_chord)));
+					// Small margin for rounding errors:
+					max_lat_difference_deg = (1_rad * (2.0 * std::asin (max_chord / 2.0))).quantity<Degree>() + 1e-4;
+				}
+			}
+		}
+	}
+
+	std::sort_heap (matches.begin(), matches.end());
+
+	Navaids result;
+	result.reserve (matches.size());
+	for (Match const& match: matches)
+		result.push_back (navaid (*match.range, match.index_position));
+
+	return result;
+}
+
+
+NavaidStorage::Navaids
+NavaidStorage::PrefixSearch::nearest_in_tiles (LonLat const& position, std::size_t limit) const
+{
+	typedef std::pair<float, Navaid const*> Match;
+
+	QByteArray const utf8_prefix = _prefix.toUtf8();
+	char const* prefix = utf8_prefix.constData();
+	std::size_t const prefix_size = utf8_prefix.size();
+	SphericalIndex::Vector const center = SphericalIndex::to_vector (position);
+	GeoTileGrid const& tile_grid = _storage->_tile_grid;
+	std::vector<bool> searched (tile_grid.tiles_count(), false);
+	// Keeps navaids of searched tiles until they're copied:
+	TilePins pins;
+	std::vector<Match> matches;
+
+	if (limit > 0)
+	{
+		// Search caps of doubling radius, until the cap contains enough matches.
+		// All tiles touching the cap are searched, so matches within it are final:
+		for (Angle radius = tile_grid.tile_size(); ; radius = std::min<Angle> (2.0 * radius, 180_deg))
+		{
+			for (GeoTileGrid::TileID tile_id: tile_grid.tiles_within (position, radius))
+			{
+				if (searched[tile_id])
+					continue;
+
+				searched[tile_id] = true;
+
+				Shared<Tile const> tile = _storage->tile (tile_id);
+				if (!tile)
+					continue;
+
+				for (Navaid const& navaid: tile->navaids)
+				{
+					if (_filter.accepts (navaid.type()) && std::strncmp (navaid.utf8_identifier(), prefix, prefix_size) == 0)
+					{
+						SphericalIndex::Vector const v = SphericalIndex::to_vector (navaid.position());
+						float const dx = v[0] - center[0];
+						float const dy = v[1] - center[1];
+						float const dz = v[2] - center[2];
+						matches.emplace_back (dx * dx + dy * dy + dz * dz, &navaid);
+					}
+				}
+
+				pins.push_back (tile);
+			}
+
+			std::size_t const found = std::min (limit, matches.size());
+			std::partial_sort (matches.begin(), matches.begin() + found, matches.end(), [](Match const& a, Match const& b) {
+				return a.first < b.first;
+			});
+
+			if (radius >= 180_deg)
+				break;
+
+			if (found == limit)
+			{
+				double const chord = 2.0 * std::sin (0.5 * radius.quantity<Radian>());
+				if (matches[limit - 1].first <= chord * chord)
+					break;
+			}
+		}
+	}
+
+	Navaids result;
+	result.reserve (std::min (limit, matches.size()));
+	for (std::size_t i = 0; i < std::min (limit, matches.size()); ++i)
+		result.push_back (*matches[i].second);
+
+	return result;
+}
+
+
+void
+NavaidStorage::PrefixSearch::narrow (Range& range, QByteArray const& utf8_prefix) const
+{
+	char const* prefix = utf8_prefix.constData();
+	std::size_t const prefix_size = utf8_prefix.size();
+
+	std::size_t begin = range.begin;
+	std::size_t count = range.end - range.begin;
+
+	// Find first identifier not less than the prefix:
+	while (count > 0)
+	{
+		std::size_t const step = count / 2;
+		if (std::strcmp (utf8_identifier (range, begin + step), prefix) < 0)
+		{
+			begin += step + 1;
+			count -= step + 1;
+		}
+		else
+			count = step;
+	}
+
+	// Identifiers starting with the prefix follow it contiguously:
+	std::size_t end = begin;
+	count = range.end - begin;
+
+	while (count > 0)
+	{
+		std::size_t const step = count / 2;
+		if (std::strncmp (utf8_identifier (range, end + step), prefix, prefix_size) == 0)
+		{
+			end += step + 1;
+			count -= step + 1;
+		}
+		else
+			count = step;
+	}
+
+	range.begin = begin;
+	range.end = end;
+}
+
+
+char const*
+NavaidStorage::PrefixSearch::utf8_identifier (Range const& range, std::size_t i) const
+{
+	if (range.navaids)
+		return range.navaids[i]->utf8_identifier();
+
+	NavaidDatabase const& database = *_storage->_database;
+	return database.utf8_identifier (database.by_identifier()[i]);
+}
+
+
+LonLat
+NavaidStorage::PrefixSearch::position (Range const& range, std::size_t i) const
+{
+	if (range.navaids)
+		return range.navaids[i]->position();
+
+	NavaidDatabase const& database = *_storage->_database;
+	NavaidDatabase::NavaidRecord const& record = database.navaid_record (database.by_identifier()[i]);
+	return LonLat (1_deg * record.lon_deg, 1_deg * record.lat_deg);
+}
+
+
+Navaid
+NavaidStorage::PrefixSearch::navaid (Range const& range, std::size_t i) const
+{
+	if (range.navaids)
+		return *range.navaids[i];
+
+	NavaidDatabase const& database = *_storage->_database;
+	return database.navaid (database.by_identifier()[i]);
+}
+
+
 NavaidStorage::NavaidStorage():
-	_navaids_tree (access_position)
+	NavaidStorage ("share/nav")
+{ }
+
+
+NavaidStorage::NavaidStorage (QString const& directory):
+	_nav_dat_file (directory + "/nav.dat.gz"),
+	_fix_dat_file (directory + "/fix.dat.gz"),
+	_apt_dat_file (directory + "/apt.dat.gz"),
+	_awy_dat_file (directory + "/awy.dat.gz"),
+	_compiled_file (directory + "/navaids.navdb")
 {
 	_logger.set_prefix ("<navaid storage>");
 	_logger << "Creating NavaidStorage" << std::endl;
@@ -109,25 +472,164 @@ NavaidStorage::NavaidStorage():
 
 NavaidStorage::~NavaidStorage()
 {
+	if (_loader_thread.joinable())
+		_loader_thread.join();
+
+	if (_stream_thread.joinable())
+	{
+		_stream_quit.store (true);
+		_stream_semaphore.post();
+		_stream_thread.join();
+	}
+
 	_logger << "Destroying NavaidStorage" << std::endl;
 }
 
 
 void
-NavaidStorage::load()
+NavaidStorage::set_streaming_radius (Length radius)
+{
+	if (loading() || loaded())
+		throw InvalidCall ("NavaidStorage::set_streaming_radius() must be called before load()");
+
+	_streaming_radius = radius;
+}
+
+
+void
+NavaidStorage::update_position (LonLat const& position, Optional<Angle> track)
+{
+	if (!streaming())
+		return;
+
+	Mutex::Lock lock (_stream_position_mutex);
+	_stream_position = position;
+	_stream_track = track;
+	_stream_semaphore.post();
+}
+
+
+void
+NavaidStorage::load (WorkPerformer* work_performer)
+{
+	_loading.store (true);
+
+	try {
+		if (!load_compiled())
+		{
+			if (_streaming_radius)
+				_logger << "Region-streaming requires compiled navaids database, loading all navaids" << std::endl;
+
+			load_sources (work_performer);
+		}
+	}
+	catch (...)
+	{
+		_loading.store (false);
+		throw;
+	}
+
+	_loading.store (false);
+
+	// Airways aren't part of the compiled database. Parse them after navaids
+	// are published, so that navaid queries don't wait for them:
+	load_airways();
+	_airways_loaded.store (true);
+}
+
+
+void
+NavaidStorage::load_in_background (WorkPerformer* work_performer)
+{
+	if (_loader_thread.joinable())
+		return;
+
+	// Set here, so that loading() is true right after this call returns:
+	_loading.store (true);
+
+	_loader_thread = std::thread ([this, work_performer] {
+		try {
+			load (work_performer);
+		}
+		catch (Exception const& e)
+		{
+			_logger << "Failed to load navaids: " << e << std::endl;
+		}
+		catch (std::exception const& e)
+		{
+			_logger << "Failed to load navaids: " << e.what() << std::endl;
+		}
+	});
+}
+
+
+void
+NavaidStorage::load_sources (WorkPerformer* work_performer)
 {
-	parse_nav_dat();
-	parse_fix_dat();
-	parse_apt_dat();
+	Navaids nav_navaids;
+	Navaids fix_navaids;
+	Navaids apt_navaids;
+
+	std::vector<std::function<void()>> parsers = {
+		[&] { nav_navaids = parse_nav_dat(); },
+		[&] { fix_navaids = parse_fix_dat(); },
+		[&] { apt_navaids = parse_apt_dat(); },
+	};
+
+	if (work_performer)
+	{
+		std::vector<Unique<WorkPerformer::Unit>> units;
+		for (auto& parser: parsers)
+			units.emplace_back (WorkPerformer::make_unit (parser));
+		for (auto& unit: units)
+			work_performer->add (unit.get());
+		for (auto& unit: units)
+			unit->wait();
+	}
+	else
+	{
+		for (auto& parser: parsers)
+			parser();
+	}
 
-	_navaids_tree.optimize();
+	Navaids all_navaids;
+	all_navaids.reserve (nav_navaids.size() + fix_navaids.size() + apt_navaids.size());
+	for (Navaids* navaids: { &nav_navaids, &fix_navaids, &apt_navaids })
+	{
+		std::move (navaids->begin(), navaids->end(), std::back_inserter (all_navaids));
+		navaids->clear();
+	}
 
-	for (Navaid const& navaid: _navaids_tree)
+	build_tiles (std::move (all_navaids));
+	build_indexes();
+
+	// Publish:
+	_loaded.store (true);
+}
+
+
+void
+NavaidStorage::compile (QString const& path) const
+{
+	if (streaming())
+		throw InvalidCall ("can't compile navaids database in region-streaming mode");
+
+	// Navaids are written tile by tile, in index order, so that indexes don't have to be rebuilt when loaded.
+	// Tiles of the compiled database are loaded on demand, hold them until written:
+	Tiles tiles;
+	std::vector<Navaid const*> navaids;
+	for (GeoTileGrid::TileID t = 0; t < _tiles.size(); ++t)
 	{
-		auto g = _navaids_by_type.insert (std::make_pair (navaid.type(), Group())).first;
-		g->second.by_identifier[navaid.identifier()] = &navaid;
-		g->second.by_frequency.insert (std::make_pair (navaid.frequency(), &navaid));
+		if (Shared<Tile const> tile = this->tile (t))
+		{
+			for (Navaid const& navaid: tile->navaids)
+				navaids.push_back (&navaid);
+			tiles.push_back (tile);
+		}
 	}
+
+	NavaidDatabase::write (path, source_files(), _tile_grid, navaids);
+	_logger << "Compiled " << navaids.size() << " navaids into " << path.toStdString() << std::endl;
 }
 
 
@@ -135,63 +637,616 @@ NavaidStorage::Navaids
 NavaidStorage::get_navs (LonLat const& position, Length radius) const
 {
 	Navaids set;
+	// Navaids are copied before tiles are unpinned:
+	TilePins pins;
+
+	for (Navaid const* navaid: get_nav_refs (position, radius, pins))
+		set.push_back (*navaid);
+
+	return set;
+}
+
+
+NavaidStorage::NavaidRefs
+NavaidStorage::get_nav_refs (LonLat const& position, Length radius, TilePins& pins, TypeFilter filter) const
+{
+	NavaidRefs set;
+
+	if (!loaded())
+		return set;
+
+	Angle const angle = SphericalIndex::earth_angle (radius);
 
-	auto inserter_and_predicate = [&] (Navaid const& navaid) -> bool
+	for (GeoTileGrid::TileID tile_id: _tile_grid.tiles_within (position, angle))
 	{
-		if (position.haversine_earth (navaid.position()) <= radius)
-		{
-			set.push_back (navaid);
-			return false;
-		}
-		return true;
+		Shared<Tile const> tile = this->tile (tile_id);
+		if (!tile)
+			continue;
+
+		tile->index.for_each_within (position, angle, [&](std::size_t i) {
+			Navaid const& navaid = tile->navaids[i];
+			if (filter.accepts (navaid.type()))
+				set.push_back (&navaid);
+		});
+
+		if (_database)
+			pins.push_back (tile);
+	}
+
+	return set;
+}
+
+
+NavaidStorage::NavaidDelta
+NavaidStorage::get_nav_delta (LonLat const& old_position, Length old_radius, LonLat const& new_position, Length new_radius,
+							  TilePins& pins, TypeFilter filter) const
+{
+	NavaidDelta delta;
+
+	if (!loaded())
+		return delta;
+
+	Angle const old_angle = SphericalIndex::earth_angle (old_radius);
+	Angle const new_angle = SphericalIndex::earth_angle (new_radius);
+
+	// In streaming mode storage might have freed and reloaded tiles pinned by the caller,
+	// so use pinned ones, navaids in reloaded ones wouldn't match previous results:
+	std::map<GeoTileGrid::TileID, Shared<Tile const>> pinned;
+	for (auto const& tile: pins)
+		pinned[tile->id] = tile;
+
+	auto get_tile = [&](GeoTileGrid::TileID tile_id) -> Shared<Tile const> {
+		auto found = pinned.find (tile_id);
+		return found != pinned.end() ? found->second : tile (tile_id);
 	};
 
-	Navaid navaid_at_position (Navaid::OTHER, position, "", "", 0_nmi);
-	_navaids_tree.find_nearest_if (navaid_at_position, std::numeric_limits<Length::Value>::max(), inserter_and_predicate);
+	auto collect = [&](Tile const& tile, LonLat const& center, Angle radius, LonLat const& excluded_center, Angle excluded_radius, NavaidRefs& result) {
+		tile.index.for_each_within_difference (center, radius, excluded_center, excluded_radius, [&](std::size_t i) {
+			Navaid const& navaid = tile.navaids[i];
+			if (filter.accepts (navaid.type()))
+				result.push_back (&navaid);
+		});
+	};
 
-	return set;
+	TilePins new_pins;
+
+	for (GeoTileGrid::TileID tile_id: _tile_grid.tiles_within (new_position, new_angle))
+	{
+		Shared<Tile const> tile = get_tile (tile_id);
+		if (!tile)
+			continue;
+
+		collect (*tile, new_position, new_angle, old_position, old_angle, delta.entered);
+
+		if (_database)
+			new_pins.push_back (tile);
+	}
+
+	for (GeoTileGrid::TileID tile_id: _tile_grid.tiles_within (old_position, old_angle))
+	{
+		Shared<Tile const> tile = get_tile (tile_id);
+		if (!tile)
+			continue;
+
+		collect (*tile, old_position, old_angle, new_position, new_angle, delta.left);
+	}
+
+	delta.left_pins = std::move (pins);
+	pins = std::move (new_pins);
+
+	return delta;
 }
 
 
 Navaid const*
 NavaidStorage::find_by_id (Navaid::Type type, QString const& identifier) const
 {
+	if (!loaded())
+		return nullptr;
+
+	// Indexes are sorted by UTF-8 identifiers:
+	QByteArray const utf8_identifier = identifier.toUtf8();
+
+	if (_database)
+	{
+		Mutex::Lock lock (_found_navaids_mutex);
+
+		auto key = std::make_pair (type, identifier);
+		auto found = _found_navaids.find (key);
+		if (found != _found_navaids.end())
+			return found->second.get();
+
+		uint32_t const* by_identifier = _database->by_identifier();
+		uint32_t const* by_identifier_end = by_identifier + _database->navaids_count();
+		auto index = std::lower_bound (by_identifier, by_identifier_end, type, [&](uint32_t i, Navaid::Type type) {
+			auto record_type = static_cast<Navaid::Type> (_database->navaid_record (i).type);
+			return record_type < type || (record_type == type && std::strcmp (_database->utf8_identifier (i), utf8_identifier.constData()) < 0);
+		});
+		if (index != by_identifier_end && _database->navaid_record (*index).type == type && std::strcmp (_database->utf8_identifier (*index), utf8_identifier.constData()) == 0)
+			return (_found_navaids[key] = std::make_unique<Navaid> (_database->navaid (*index))).get();
+
+		return nullptr;
+	}
+
 	auto g = _navaids_by_type.find (type);
 	if (g != _navaids_by_type.end())
 	{
-		auto navaid = g->second.by_identifier.find (identifier);
-		if (navaid != g->second.by_identifier.end())
-			return navaid->second;
+		auto const& by_identifier = g->second.by_identifier;
+		auto navaid = std::lower_bound (by_identifier.begin(), by_identifier.end(), utf8_identifier.constData(), [](Navaid const* navaid, char const* identifier) {
+			return std::strcmp (navaid->utf8_identifier(), identifier) < 0;
+		});
+		if (navaid != by_identifier.end() && std::strcmp ((*navaid)->utf8_identifier(), utf8_identifier.constData()) == 0)
+			return *navaid;
 	}
 	return nullptr;
 }
 
 
+NavaidStorage::PrefixSearch
+NavaidStorage::prefix_search (TypeFilter filter) const
+{
+	return PrefixSearch (*this, filter);
+}
+
+
 NavaidStorage::Navaids
 NavaidStorage::find_by_frequency (LonLat const& position, Navaid::Type type, Frequency frequency) const
 {
 	Navaids result;
 
-	auto g = _navaids_by_type.find (type);
-	if (g != _navaids_by_type.end())
+	for (auto navaid = nearest_by_frequency (position, type, frequency); navaid; ++navaid)
+		result.push_back (*navaid);
+
+	return result;
+}
+
+
+NavaidStorage::FrequencyIterator
+NavaidStorage::nearest_by_frequency (LonLat const& position, Navaid::Type type, Frequency frequency) const
+{
+	FrequencyIterator iterator;
+
+	if (loaded())
 	{
-		auto r0 = g->second.by_frequency.lower_bound (frequency - 5_kHz);
-		auto r1 = g->second.by_frequency.lower_bound (frequency + 5_kHz);
-		for (auto r = r0; r != r1; ++r)
-			result.push_back (*r->second);
+		auto c0 = _frequency_channels.lower_bound ({ type, frequency - 5_kHz });
+		auto c1 = _frequency_channels.lower_bound ({ type, frequency + 5_kHz });
+		for (auto c = c0; c != c1; ++c)
+			iterator.add_channel (c->second.navaids, c->second.index, position);
 	}
 
-	std::sort (result.begin(), result.end(), [&](Navaid const& a, Navaid const& b) -> bool {
-		return position.haversine (a.position()) < position.haversine (b.position());
-	});
+	iterator.find_nearest_channel();
+	return iterator;
+}
 
-	return result;
+
+Optional<NavaidStorage::Route>
+NavaidStorage::find_route (QString const& from, QString const& to, Optional<AirwayLevel> level) const
+{
+	if (!_airways_loaded.load())
+		return { };
+
+	std::vector<AirwayGraph::NodeID> sources = airway_nodes (from);
+	std::vector<AirwayGraph::NodeID> targets = airway_nodes (to);
+
+	if (sources.empty() || targets.empty())
+		return { };
+
+	uint8_t const classes = level ? static_cast<uint8_t> (*level) : 0xff;
+	Optional<AirwayGraph::Route> graph_route = _airway_graph.shortest_route (sources, targets, classes);
+
+	if (!graph_route)
+		return { };
+
+	Route route;
+	route.from = _airway_node_identifiers[graph_route->nodes.front()];
+	route.from_position = _airway_graph.position (graph_route->nodes.front());
+	route.distance = graph_route->distance;
+	route.legs.reserve (graph_route->edges.size());
+
+	for (AirwayGraph::Edge const* edge: graph_route->edges)
+	{
+		RouteLeg leg;
+		leg.airway = _airway_names[edge->airway];
+		leg.to = _airway_node_identifiers[edge->target];
+		leg.to_position = _airway_graph.position (edge->target);
+		leg.initial_true_bearing = 1_deg * edge->bearing;
+		leg.distance = static_cast<double> (edge->distance) * kEarthMeanRadius;
+		route.legs.push_back (leg);
+	}
+
+	return route;
+}
+
+
+bool
+NavaidStorage::load_compiled()
+{
+	Unique<NavaidDatabase> database;
+
+	try {
+		database = std::make_unique<NavaidDatabase> (_compiled_file);
+	}
+	catch (IOError const& e)
+	{
+		_logger << "Not using compiled navaids database: " << e.message() << std::endl;
+		return false;
+	}
+
+	if (!database->is_fresh (source_files()))
+	{
+		_logger << "Compiled navaids database is stale, use navdb-compiler to update it" << std::endl;
+		return false;
+	}
+
+	_tile_grid = database->tile_grid();
+	_tiles.assign (_tile_grid.tiles_count(), nullptr);
+
+	if (_streaming_radius)
+		_logger << "Using compiled navaids database in region-streaming mode, radius " << _streaming_radius->quantity<NauticalMile>() << " nmi" << std::endl;
+	else
+		_logger << "Using compiled navaids database" << std::endl;
+
+	// Navaids with frequencies are few, keep them resident for frequency queries.
+	// Reserve, so that pointers to _frequency_navaids remain valid:
+	std::size_t const count = database->navaids_count();
+	std::size_t frequency_navaids_count = 0;
+	for (std::size_t i = 0; i < count; ++i)
+		if (database->navaid_record (i).frequency_hz > 0.0)
+			++frequency_navaids_count;
+
+	_frequency_navaids.reserve (frequency_navaids_count);
+	NavaidRefs frequency_navaids;
+	frequency_navaids.reserve (frequency_navaids_count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (database->navaid_record (i).frequency_hz > 0.0)
+		{
+			_frequency_navaids.push_back (database->navaid (i));
+			frequency_navaids.push_back (&_frequency_navaids.back());
+		}
+	}
+	build_frequency_channels (frequency_navaids);
+
+	// Tiles will be loaded from the mapped file on demand, and in region-streaming
+	// mode also prefetched and freed by the streaming thread:
+	_database = std::move (database);
+	if (_streaming_radius)
+		_stream_thread = std::thread (&NavaidStorage::stream_tiles, this);
+
+	// Publish:
+	_loaded.store (true);
+	return true;
+}
+
+
+std::vector<QString>
+NavaidStorage::source_files() const
+{
+	return { _nav_dat_file, _fix_dat_file, _apt_dat_file };
+}
+
+
+void
+NavaidStorage::build_tiles (Navaids&& navaids)
+{
+	std::vector<Navaids> tiles_navaids (_tile_grid.tiles_count());
+	for (Navaid& navaid: navaids)
+		tiles_navaids[_tile_grid.tile_of (navaid.position())].push_back (std::move (navaid));
+	navaids.clear();
+
+	_tiles.assign (_tile_grid.tiles_count(), nullptr);
+
+	for (GeoTileGrid::TileID t = 0; t < _tiles.size(); ++t)
+	{
+		Navaids& tile_navaids = tiles_navaids[t];
+		if (tile_navaids.empty())
+			continue;
+
+		std::vector<LonLat> positions;
+		positions.reserve (tile_navaids.size());
+		for (Navaid const& navaid: tile_navaids)
+			positions.push_back (navaid.position());
+
+		auto tile = std::make_shared<Tile>();
+		tile->id = t;
+		tile->navaids.reserve (tile_navaids.size());
+		for (std::size_t i: tile->index.build (positions))
+			tile->navaids.push_back (std::move (tile_navaids[i]));
+
+		tile_navaids.clear();
+		_tiles[t] = tile;
+	}
+}
+
+
+void
+NavaidStorage::build_indexes()
+{
+	NavaidRefs all_navaids;
+
+	for (auto const& tile: _tiles)
+	{
+		if (!tile)
+			continue;
+
+		for (Navaid const& navaid: tile->navaids)
+		{
+			_navaids_by_type[navaid.type()].by_identifier.push_back (&navaid);
+			all_navaids.push_back (&navaid);
+		}
+	}
+
+	for (auto& g: _navaids_by_type)
+	{
+		// Same order as of the compiled database index:
+		std::stable_sort (g.second.by_identifier.begin(), g.second.by_identifier.end(), [](Navaid const* a, Navaid const* b) {
+			return std::strcmp (a->utf8_identifier(), b->utf8_identifier()) < 0;
+		});
+	}
+
+	build_frequency_channels (all_navaids);
+}
+
+
+void
+NavaidStorage::build_frequency_channels (NavaidRefs const& navaids)
+{
+	std::map<std::pair<Navaid::Type, Frequency>, NavaidRefs> channels_navaids;
+
+	for (Navaid const* navaid: navaids)
+		if (navaid->frequency() > 0_Hz)
+			channels_navaids[{ navaid->type(), navaid->frequency() }].push_back (navaid);
+
+	for (auto& c: channels_navaids)
+	{
+		std::vector<LonLat> positions;
+		positions.reserve (c.second.size());
+		for (Navaid const* navaid: c.second)
+			positions.push_back (navaid->position());
+
+		FrequencyChannel& channel = _frequency_channels[c.first];
+		channel.navaids.reserve (c.second.size());
+		for (std::size_t i: channel.index.build (positions))
+			channel.navaids.push_back (c.second[i]);
+	}
+}
+
+
+Shared<NavaidStorage::Tile const>
+NavaidStorage::tile (GeoTileGrid::TileID tile_id) const
+{
+	// When loaded from text files, _tiles isn't modified after loading:
+	if (!_database)
+		return _tiles[tile_id];
+
+	{
+		Mutex::Lock lock (_tiles_mutex);
+		if (_tiles[tile_id])
+			return _tiles[tile_id];
+	}
+
+	if (_database->tile_record (tile_id).navaids_count == 0)
+		return nullptr;
+
+	// Load without holding the lock, so that other threads can use resident tiles meanwhile:
+	Shared<Tile const> loaded_tile = load_tile (*_database, tile_id);
+
+	Mutex::Lock lock (_tiles_mutex);
+	if (!_tiles[tile_id])
+		_tiles[tile_id] = loaded_tile;
+	return _tiles[tile_id];
+}
+
+
+Shared<NavaidStorage::Tile const>
+NavaidStorage::load_tile (NavaidDatabase const& database, GeoTileGrid::TileID tile_id)
+{
+	NavaidDatabase::TileRecord const& record = database.tile_record (tile_id);
+
+	auto tile = std::make_shared<Tile>();
+	tile->id = tile_id;
+	std::vector<LonLat> positions;
+	tile->navaids.reserve (record.navaids_count);
+	positions.reserve (record.navaids_count);
+
+	for (std::size_t i = record.navaids_begin; i < record.navaids_begin + record.navaids_count; ++i)
+	{
+		tile->navaids.push_back (database.navaid (i));
+		positions.push_back (tile->navaids.back().position());
+	}
+
+	// Records are stored in SphericalIndex order within the tile, so the index doesn't need to be rebuilt:
+	tile->index.adopt (positions);
+
+	return tile;
+}
+
+
+void
+NavaidStorage::stream_tiles()
+{
+	Optional<LonLat> last_position;
+	Optional<Angle> last_track;
+	// Don't recompute resident set too often:
+	Angle const min_movement = 0.25 * _tile_grid.tile_size();
+	Angle const min_turn = 15_deg;
+
+	while (true)
+	{
+		_stream_semaphore.wait();
+		// Coalesce queued position updates:
+		while (_stream_semaphore.try_wait())
+			continue;
+
+		if (_stream_quit.load())
+			break;
+
+		LonLat position;
+		Optional<Angle> track;
+		{
+			Mutex::Lock lock (_stream_position_mutex);
+			position = *_stream_position;
+			track = _stream_track;
+		}
+
+		bool const moved = !last_position || 1_rad * last_position->haversine (position) > min_movement;
+		bool const turned = !track != !last_track ||
+							(track && abs (floored_mod (*track - *last_track + 180_deg, 360_deg) - 180_deg) > min_turn);
+
+		if (moved || turned)
+		{
+			update_resident_tiles (position, track);
+			last_position = position;
+			last_track = track;
+		}
+	}
+}
+
+
+void
+NavaidStorage::update_resident_tiles (LonLat const& position, Optional<Angle> track)
+{
+	Angle const radius = SphericalIndex::earth_angle (*_streaming_radius);
+
+	std::vector<LonLat> centers = { position };
+	// Prefetch tiles one radius ahead on the track:
+	if (track)
+		centers.push_back (great_circle_destination (position, *track, radius));
+
+	std::vector<GeoTileGrid::TileID> wanted;
+	std::set<GeoTileGrid::TileID> kept;
+
+	for (LonLat const& center: centers)
+	{
+		for (GeoTileGrid::TileID t: _tile_grid.tiles_within (center, radius))
+			wanted.push_back (t);
+		// Keep some margin, so that tiles aren't freed and reloaded when flying near the boundary:
+		for (GeoTileGrid::TileID t: _tile_grid.tiles_within (center, 1.5 * radius))
+			kept.insert (t);
+	}
+
+	// Loads missing tiles:
+	for (GeoTileGrid::TileID t: wanted)
+		tile (t);
+
+	// Tiles are destroyed after the lock is released:
+	Tiles freed;
+	Mutex::Lock lock (_tiles_mutex);
+
+	for (GeoTileGrid::TileID t = 0; t < _tiles.size(); ++t)
+		if (_tiles[t] && kept.count (t) == 0)
+			freed.push_back (std::move (_tiles[t]));
 }
 
 
 void
-NavaidStorage::parse_nav_dat()
+NavaidStorage::load_airways()
+{
+	_logger << "Loading airways" << std::endl;
+
+	// Waypoints are identified by identifier and position, since identifiers aren't unique.
+	// Positions are compared with 1e-5° resolution:
+	typedef std::pair<QString, std::pair<int32_t, int32_t>> NodeKey;
+
+	std::map<NodeKey, AirwayGraph::NodeID> node_ids;
+	std::map<QString, AirwayGraph::AirwayID> airway_ids;
+	std::vector<LonLat> positions;
+	std::vector<AirwayGraph::Segment> segments;
+
+	auto node_id = [&](QString const& identifier, double lon_deg, double lat_deg) -> AirwayGraph::NodeID {
+		NodeKey key (identifier, { std::lround (lon_deg * 1e5), std::lround (lat_deg * 1e5) });
+		auto found = node_ids.find (key);
+		if (found != node_ids.end())
+			return found->second;
+
+		AirwayGraph::NodeID const id = positions.size();
+		positions.emplace_back (1_deg * lon_deg, 1_deg * lat_deg);
+		_airway_node_identifiers.push_back (identifier);
+		node_ids[key] = id;
+		return id;
+	};
+
+	for (GzDataFileIterator line (_awy_dat_file); line; ++line)
+	{
+		auto& line_ts = *line;
+
+		QString identifier_a;
+		double lat_a;
+		double lon_a;
+		QString identifier_b;
+		double lat_b;
+		double lon_b;
+		int level;
+		int base_fl;
+		int top_fl;
+		QString airway;
+
+		line_ts >> identifier_a;
+
+		if (identifier_a == "99") // EOF sentinel
+			break;
+
+		line_ts >> lat_a >> lon_a >> identifier_b >> lat_b >> lon_b >> level >> base_fl >> top_fl >> airway;
+
+		AirwayGraph::Segment segment;
+		segment.a = node_id (identifier_a, lon_a, lat_a);
+		segment.b = node_id (identifier_b, lon_b, lat_b);
+
+		auto found_airway = airway_ids.find (airway);
+		if (found_airway != airway_ids.end())
+			segment.airway = found_airway->second;
+		else
+		{
+			segment.airway = _airway_names.size();
+			_airway_names.push_back (airway);
+			airway_ids[airway] = segment.airway;
+		}
+
+		switch (level)
+		{
+			case static_cast<int> (AirwayLevel::Low):
+			case static_cast<int> (AirwayLevel::High):
+				segment.classes = level;
+				break;
+
+			default:
+				segment.classes = static_cast<uint8_t> (AirwayLevel::Low) | static_cast<uint8_t> (AirwayLevel::High);
+		}
+
+		segments.push_back (segment);
+	}
+
+	_airway_graph = AirwayGraph (std::move (positions), segments);
+
+	_airway_nodes_by_identifier.resize (_airway_node_identifiers.size());
+	std::iota (_airway_nodes_by_identifier.begin(), _airway_nodes_by_identifier.end(), 0);
+	std::sort (_airway_nodes_by_identifier.begin(), _airway_nodes_by_identifier.end(), [&](AirwayGraph::NodeID a, AirwayGraph::NodeID b) {
+		return _airway_node_identifiers[a] < _airway_node_identifiers[b];
+	});
+
+	_logger << "Loading airways: done, " << segments.size() << " segments" << std::endl;
+}
+
+
+std::vector<AirwayGraph::NodeID>
+NavaidStorage::airway_nodes (QString const& identifier) const
 {
+	auto begin = std::lower_bound (_airway_nodes_by_identifier.begin(), _airway_nodes_by_identifier.end(), identifier, [&](AirwayGraph::NodeID node, QString const& identifier) {
+		return _airway_node_identifiers[node] < identifier;
+	});
+	auto end = std::upper_bound (begin, _airway_nodes_by_identifier.end(), identifier, [&](QString const& identifier, AirwayGraph::NodeID node) {
+		return identifier < _airway_node_identifiers[node];
+	});
+
+	return std::vector<AirwayGraph::NodeID> (begin, end);
+}
+
+
+NavaidStorage::Navaids
+NavaidStorage::parse_nav_dat() const
+{
+	NavaidsBuilder builder;
+
 	_logger << "Loading navaids" << std::endl;
 
 	for (GzDataFileIterator line (_nav_dat_file); line; ++line)
@@ -226,9 +1281,11 @@ NavaidStorage::parse_nav_dat()
 				line_ts >> unused_int >> unused_int >> khz >> range >> unused_float >> identifier;
 				// Rest of the line is the name:
 				name = line_ts.readLine();
-				Navaid navaid (Navaid::NDB, pos, identifier, name, 1_nmi * range);
+				Navaid navaid (Navaid::NDB);
+				navaid.set_position (pos);
+				navaid.set_range (1_nmi * range);
 				navaid.set_frequency (khz * 10_kHz);
-				_navaids_tree.insert (navaid);
+				builder.add (navaid, identifier, name);
 				break;
 			}
 
@@ -240,7 +1297,9 @@ NavaidStorage::parse_nav_dat()
 				name = line_ts.readLine();
 				khz *= 10.f;
 
-				Navaid navaid (Navaid::VOR, pos, identifier, name, 1_nmi * range);
+				Navaid navaid (Navaid::VOR);
+				navaid.set_position (pos);
+				navaid.set_range (1_nmi * range);
 				navaid.set_frequency (khz * 10_kHz);
 				navaid.set_slaved_variation (1_deg * slaved_variation_deg);
 				navaid.set_elevation (1_ft * elevation_ft);
@@ -250,7 +1309,7 @@ NavaidStorage::parse_nav_dat()
 					navaid.set_vor_type (Navaid::VORTAC);
 				else
 					navaid.set_vor_type (Navaid::VOROnly);
-				_navaids_tree.insert (navaid);
+				builder.add (navaid, identifier, name);
 				break;
 			}
 
@@ -265,13 +1324,13 @@ NavaidStorage::parse_nav_dat()
 				name = line_ts.readLine();
 				khz *= 10.f;
 
-				Navaid navaid (Navaid::LOC, pos, identifier, name, 1_nmi * range);
+				Navaid navaid (Navaid::LOC);
+				navaid.set_position (pos);
+				navaid.set_range (1_nmi * range);
 				navaid.set_frequency (khz * 10_kHz);
 				navaid.set_true_bearing (1_deg * true_bearing_deg);
 				navaid.set_elevation (1_ft * elevation_ft);
-				navaid.set_icao (icao);
-				navaid.set_runway_id (runway_id);
-				_navaids_tree.insert (navaid);
+				builder.add (navaid, identifier, name, icao, runway_id);
 				break;
 			}
 
@@ -293,12 +1352,16 @@ NavaidStorage::parse_nav_dat()
 	}
 
 	_logger << "Loading navaids: done" << std::endl;
+
+	return builder.finish();
 }
 
 
-void
-NavaidStorage::parse_fix_dat()
+NavaidStorage::Navaids
+NavaidStorage::parse_fix_dat() const
 {
+	NavaidsBuilder builder;
+
 	_logger << "Loading fixes" << std::endl;
 
 	for (GzDataFileIterator line (_fix_dat_file); line; ++line)
@@ -317,31 +1380,48 @@ NavaidStorage::parse_fix_dat()
 
 		pos = LonLat (1_deg * pos_lon, 1_deg * pos_lat);
 
-		_navaids_tree.insert (Navaid (Navaid::FIX, pos, identifier, identifier, 0_nmi));
+		Navaid navaid (Navaid::FIX);
+		navaid.set_position (pos);
+		builder.add (navaid, identifier, identifier);
 	}
 
 	_logger << "Loading fixes: done" << std::endl;
+
+	return builder.finish();
 }
 
 
-void
-NavaidStorage::parse_apt_dat()
+NavaidStorage::Navaids
+NavaidStorage::parse_apt_dat() const
 {
+	struct ParsedRunway
+	{
+		QString	identifier_1;
+		LonLat	pos_1;
+		QString	identifier_2;
+		LonLat	pos_2;
+		Length	width;
+	};
+
+	NavaidsBuilder builder;
+
 	_logger << "Loading airports" << std::endl;
 
 	Unique<Navaid> cur_land_airport;
-	Navaid::Runways runways;
+	QString cur_identifier;
+	QString cur_name;
+	std::vector<ParsedRunway> runways;
 	std::size_t loaded_airports = 0;
 
 	auto push_navaid = [&] {
 		if (cur_land_airport && !runways.empty())
 		{
 			// Compute position:
-			LonLat min_position = runways[0].pos_1();
+			LonLat min_position = runways[0].pos_1;
 			LonLat max_position = min_position;
-			for (auto rwy: runways)
+			for (auto const& rwy: runways)
 			{
-				for (auto point: { rwy.pos_1(), rwy.pos_2() })
+				for (auto point: { rwy.pos_1, rwy.pos_2 })
 				{
 					min_position.lon() = std::min (min_position.lon(), point.lon());
 					min_position.lat() = std::min (min_position.lat(), point.lat());
@@ -352,9 +1432,11 @@ NavaidStorage::parse_apt_dat()
 			LonLat mean_position (mean (min_position.lon(), max_position.lon()),
 								  mean (min_position.lat(), max_position.lat()));
 			cur_land_airport->set_position (mean_position);
-			cur_land_airport->set_runways (runways);
 
-			_navaids_tree.insert (*cur_land_airport);
+			builder.add (*cur_land_airport, cur_identifier, cur_name);
+			for (auto const& rwy: runways)
+				builder.add_runway (rwy.identifier_1, rwy.pos_1, rwy.identifier_2, rwy.pos_2, rwy.width);
+
 			cur_land_airport.reset();
 			runways.clear();
 
@@ -381,15 +1463,11 @@ NavaidStorage::parse_apt_dat()
 				int elevation_ft;
 				int twr;
 				int deprecated;
-				QString identifier;
-				QString name;
 
-				line_ts >> elevation_ft >> twr >> deprecated >> identifier;
-				name = line_ts.readAll();
+				line_ts >> elevation_ft >> twr >> deprecated >> cur_identifier;
+				cur_name = line_ts.readAll();
 
 				cur_land_airport = std::make_unique<Navaid> (Navaid::ARPT);
-				cur_land_airport->set_identifier (identifier);
-				cur_land_airport->set_name (name);
 				cur_land_airport->set_elevation (1_ft * elevation_ft);
 				break;
 			}
@@ -421,12 +1499,11 @@ NavaidStorage::parse_apt_dat()
 						line_ts >> identifier[i] >> lat_deg[i] >> lon_deg[i] >> displaced_threshold_m[i] >> blast_pad_length_m[i]
 								>> runway_markings[i] >> approach_lighting[i] >> touchdown_zone_lighting[i] >> runway_end_identifier_lights[i];
 
-					Navaid::Runway runway (identifier[0],
-										   LonLat (1_deg * lon_deg[0], 1_deg * lat_deg[0]),
-										   identifier[1],
-										   LonLat (1_deg * lon_deg[1], 1_deg * lat_deg[1]));
-					runway.set_width (1_m * width_m);
-					runways.push_back (runway);
+					runways.push_back ({ identifier[0],
+										 LonLat (1_deg * lon_deg[0], 1_deg * lat_deg[0]),
+										 identifier[1],
+										 LonLat (1_deg * lon_deg[1], 1_deg * lat_deg[1]),
+										 1_m * width_m });
 				}
 			}
 		}
@@ -435,6 +1512,8 @@ NavaidStorage::parse_apt_dat()
 	push_navaid();
 
 	_logger << "Loading airports: done" << std::endl;
+
+	return builder.finish();
 }
 
 } // namespace Xefis
@@ -16,13 +16,26 @@
 
 // Standard:
 #include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <atomic>
 #include <set>
 #include <map>
+#include <thread>
+#include <vector>
+
+// Qt:
+#include <QtCore/QByteArray>
 
 // Xefis:
 #include <xefis/config/all.h>
+#include <xefis/core/work_performer.h>
+#include <xefis/utility/airway_graph.h>
+#include <xefis/utility/geo_tile_grid.h>
 #include <xefis/utility/logger.h>
-#include <kdtree++/kdtree.hpp>
+#include <xefis/utility/mutex.h>
+#include <xefis/utility/semaphore.h>
+#include <xefis/utility/spherical_index.h>
 
 // Local:
 #include "navaid.h"
@@ -30,12 +43,26 @@
 
 namespace Xefis {
 
+class NavaidDatabase;
+
+
+/**
+ * Navaids are grouped into GeoTileGrid tiles, each with its own SphericalIndex.
+ *
+ * When navaids are parsed from text files, all tiles are in memory. With the compiled
+ * database tiles are read on demand from the memory-mapped file and kept afterwards.
+ * In region-streaming mode (see set_streaming_radius()) only tiles near the aircraft
+ * are kept in memory.
+ *
+ * Airways are loaded into an AirwayGraph, whose nodes are waypoints (fixes and navaids)
+ * identified by their identifiers and positions.
+ */
 class NavaidStorage
 {
 	struct Group
 	{
-		std::map<QString, Navaid const*>		by_identifier;
-		std::multimap<Frequency, Navaid const*>	by_frequency;
+		// Sorted by identifier:
+		std::vector<Navaid const*>	by_identifier;
 	};
 
 	typedef std::map<Navaid::Type, Group> NavaidsByType;
@@ -68,25 +95,343 @@ class NavaidStorage
 
   public:
 	typedef std::vector<Navaid> Navaids;
+	typedef std::vector<Navaid const*> NavaidRefs;
 
-  private:
-	static Angle::Value
-	access_position (Navaid const& navaid, std::size_t const dimension);
+	/**
+	 * Navaids of a single tile.
+	 */
+	struct Tile
+	{
+		GeoTileGrid::TileID	id;
+		// In index order:
+		Navaids				navaids;
+		SphericalIndex		index;
+	};
+
+	/**
+	 * Holds tiles referenced by query results, so that they're not
+	 * freed in region-streaming mode while the results are in use.
+	 */
+	typedef std::vector<Shared<Tile const>> TilePins;
+
+	/**
+	 * Change of a query result after moving the query circle.
+	 */
+	struct NavaidDelta
+	{
+		// Navaids within the new circle, that weren't within the old one:
+		NavaidRefs	entered;
+		// Navaids within the old circle, that aren't within the new one:
+		NavaidRefs	left;
+		// Keeps tiles of left navaids alive as long as the delta exists:
+		TilePins	left_pins;
+	};
+
+	/**
+	 * Airway levels. Values are AirwayGraph classes.
+	 */
+	enum class AirwayLevel: uint8_t
+	{
+		Low		= 1,
+		High	= 2,
+	};
+
+	/**
+	 * Leg of an airway route.
+	 */
+	struct RouteLeg
+	{
+		// Airway name, or names separated with '-' if airways share the segment:
+		QString	airway;
+		// Waypoint at the end of the leg:
+		QString	to;
+		LonLat	to_position;
+		Angle	initial_true_bearing;
+		Length	distance;
+	};
+
+	/**
+	 * Route along airways.
+	 */
+	struct Route
+	{
+		QString					from;
+		LonLat					from_position;
+		std::vector<RouteLeg>	legs;
+		Length					distance;
+	};
+
+	/**
+	 * Set of navaid types accepted by a query.
+	 * Default-constructed filter accepts all types.
+	 */
+	class TypeFilter
+	{
+	  public:
+		// Ctor
+		TypeFilter() noexcept;
+
+		// Ctor
+		TypeFilter (std::initializer_list<Navaid::Type> types) noexcept;
+
+		/**
+		 * Return true if navaids of given type should be returned.
+		 */
+		bool
+		accepts (Navaid::Type) const noexcept;
+
+	  private:
+		uint32_t	_mask;
+	};
+
+	/**
+	 * Iterates over navaids found with nearest_by_frequency(), nearest first.
+	 * Navaids are found lazily, so taking only first few of them is cheap.
+	 * Valid as long as the storage exists.
+	 */
+	class FrequencyIterator
+	{
+		friend class NavaidStorage;
+
+		struct Channel
+		{
+			// In channel's index order:
+			NavaidRefs const*				navaids;
+			SphericalIndex::NearestIterator	nearest;
+		};
+
+	  public:
+		/**
+		 * Return true if iterator points to a navaid (is not at the end).
+		 */
+		explicit
+		operator bool() const noexcept;
+
+		Navaid const&
+		operator*() const noexcept;
+
+		Navaid const*
+		operator->() const noexcept;
+
+		/**
+		 * Go to the next nearest navaid.
+		 */
+		FrequencyIterator&
+		operator++();
+
+	  private:
+		// Ctor
+		FrequencyIterator() = default;
 
-	typedef KDTree::KDTree<2, Navaid, std::function<Angle::Value (Navaid const&, std::size_t)>> NavaidsTree;
+		/**
+		 * Add navaids of a channel to the iteration.
+		 */
+		void
+		add_channel (NavaidRefs const& navaids, SphericalIndex const& index, LonLat const& position);
+
+		/**
+		 * Set _current to the channel with the nearest pending navaid.
+		 */
+		void
+		find_nearest_channel() noexcept;
+
+	  private:
+		std::vector<Channel>	_channels;
+		// Channel containing the current navaid, equal to _channels.size() at the end:
+		std::size_t				_current = 0;
+	};
+
+	/**
+	 * Incremental search of navaids by identifier prefix, see prefix_search().
+	 * Keeps ranges of per-type identifier indexes matching the current prefix,
+	 * so that when the prefix is extended (a character is typed), only these
+	 * ranges are searched. Valid as long as the storage exists.
+	 *
+	 * If created before the storage was loaded, it matches nothing until
+	 * the next set_prefix() after loading, which rebuilds the ranges.
+	 */
+	class PrefixSearch
+	{
+		friend class NavaidStorage;
+
+		/**
+		 * Range of identifier index matching the prefix. With the compiled database it's a range
+		 * of the database index, otherwise of Group::by_identifier of the type.
+		 */
+		struct Range
+		{
+			Navaid::Type		type;
+			// Group::by_identifier, nullptr with the compiled database:
+			Navaid const* const*	navaids;
+			std::size_t			begin;
+			std::size_t			end;
+		};
+
+	  public:
+		/**
+		 * Return current prefix.
+		 */
+		QString const&
+		prefix() const noexcept;
+
+		/**
+		 * Change the prefix. If it extends the current one,
+		 * search is narrowed down instead of being restarted,
+		 * unless the ranges were built before the storage was loaded.
+		 */
+		void
+		set_prefix (QString const& prefix);
+
+		/**
+		 * Number of navaids matching current prefix.
+		 */
+		std::size_t
+		matches_count() const noexcept;
+
+		/**
+		 * Return up to @limit navaids matching current prefix,
+		 * sorted by proximity to the @position (first is the nearest).
+		 */
+		Navaids
+		nearest (LonLat const& position, std::size_t limit) const;
+
+	  private:
+		// Above this number of matches nearest() searches tiles around the position
+		// instead of scanning all matches:
+		static constexpr std::size_t kMaxScannedMatches = 4096;
+
+	  private:
+		// Ctor
+		PrefixSearch (NavaidStorage const&, TypeFilter);
+
+		/**
+		 * Implementation of nearest() for prefixes matching many navaids:
+		 * search tiles in growing caps around @position, nearest first.
+		 */
+		Navaids
+		nearest_in_tiles (LonLat const& position, std::size_t limit) const;
+
+		/**
+		 * Narrow down @range to identifiers starting with @utf8_prefix.
+		 */
+		void
+		narrow (Range& range, QByteArray const& utf8_prefix) const;
+
+		/**
+		 * Return UTF-8 identifier of a navaid at position @i of the index.
+		 */
+		char const*
+		utf8_identifier (Range const&, std::size_t i) const;
+
+		/**
+		 * Return position of a navaid at position @i of the index.
+		 */
+		LonLat
+		position (Range const&, std::size_t i) const;
+
+		/**
+		 * Return navaid at position @i of the index.
+		 */
+		Navaid
+		navaid (Range const&, std::size_t i) const;
+
+	  private:
+		NavaidStorage const*	_storage;
+		TypeFilter				_filter;
+		QString					_prefix;
+		std::vector<Range>		_ranges;
+		// True if _ranges were built from a loaded storage:
+		bool					_storage_loaded	= false;
+	};
 
   public:
 	// Ctor
 	NavaidStorage();
 
+	/**
+	 * Use navigation data files (nav.dat.gz, fix.dat.gz, apt.dat.gz, awy.dat.gz and
+	 * the compiled navaids.navdb) from @directory instead of share/nav.
+	 */
+	explicit
+	NavaidStorage (QString const& directory);
+
 	// Dtor
 	~NavaidStorage();
 
 	/**
-	 * Load navaids and fixes.
+	 * Enable region-streaming mode: keep in memory only tiles within @radius
+	 * from the position given with update_position(), and prefetch tiles along
+	 * the track in a background thread. Must be called before load().
+	 * Requires up to date compiled database; otherwise all navaids are loaded.
+	 */
+	void
+	set_streaming_radius (Length radius);
+
+	/**
+	 * Return true if navaids are loaded in region-streaming mode.
+	 * \threadsafe
+	 */
+	bool
+	streaming() const noexcept;
+
+	/**
+	 * Set current aircraft position and true track used to select resident tiles
+	 * in region-streaming mode. Tiles are loaded and freed in a background thread.
+	 * Does nothing in normal mode.
+	 * \threadsafe
+	 */
+	void
+	update_position (LonLat const& position, Optional<Angle> track = {});
+
+	/**
+	 * Load navaids and fixes. Use the compiled database if it's up to date
+	 * with the text data files, parse the text files otherwise.
+	 * If @work_performer is given, text files are parsed concurrently on it.
+	 */
+	void
+	load (WorkPerformer* work_performer = nullptr);
+
+	/**
+	 * Like load(), but run in a separate thread and return immediately.
+	 * Queries return empty results until loaded() becomes true.
 	 */
 	void
-	load();
+	load_in_background (WorkPerformer* work_performer = nullptr);
+
+	/**
+	 * Load navaids and fixes from the text data files.
+	 * If @work_performer is given, files are parsed concurrently on it.
+	 */
+	void
+	load_sources (WorkPerformer* work_performer = nullptr);
+
+	/**
+	 * Return true if loading of navaids has been started, but navaids are not yet published.
+	 * Airways may still be loading when this returns false, see find_route().
+	 * \threadsafe
+	 */
+	bool
+	loading() const noexcept;
+
+	/**
+	 * Return true if navaids are loaded and can be queried.
+	 * \threadsafe
+	 */
+	bool
+	loaded() const noexcept;
+
+	/**
+	 * Write loaded navaids to a compiled database file.
+	 * Throw IOError on failure.
+	 */
+	void
+	compile (QString const& path) const;
+
+	/**
+	 * Path to the compiled database used by load().
+	 */
+	QString
+	compiled_file() const;
 
 	/**
 	 * Return set of navaids withing the given @radius
@@ -95,13 +440,45 @@ class NavaidStorage
 	Navaids
 	get_navs (LonLat const& position, Length radius) const;
 
+	/**
+	 * Like get_navs(), but don't copy navaids, return pointers to navaids
+	 * owned by the storage instead. Only navaids of types accepted by @filter
+	 * are collected. Returned pointers are valid only as long as tiles added
+	 * to @pins are held, since in region-streaming mode other tiles may be freed.
+	 * Tiles that aren't resident are loaded synchronously.
+	 */
+	NavaidRefs
+	get_nav_refs (LonLat const& position, Length radius, TilePins& pins, TypeFilter filter = TypeFilter()) const;
+
+	/**
+	 * Return navaids that entered and left the result of get_nav_refs() when the query
+	 * circle moves from @old_position/@old_radius to @new_position/@new_radius.
+	 * Only the difference between circles is searched, so the cost is proportional to
+	 * the movement rather than to the circle area.
+	 *
+	 * @pins must be the pins of the previous result (of get_nav_refs() or get_nav_delta());
+	 * navaids are then taken from the pinned tiles, so that pointers match the ones
+	 * returned previously. @pins is replaced with pins for the new result.
+	 */
+	NavaidDelta
+	get_nav_delta (LonLat const& old_position, Length old_radius, LonLat const& new_position, Length new_radius,
+				   TilePins& pins, TypeFilter filter = TypeFilter()) const;
+
 	/**
 	 * Find navaid of given type by its @identifier.
-	 * Return nullptr if not found.
+	 * Return nullptr if not found. With the compiled database
+	 * found navaids are kept until the storage is destroyed.
 	 */
 	Navaid const*
 	find_by_id (Navaid::Type, QString const& identifier) const;
 
+	/**
+	 * Return incremental identifier prefix search over navaids of types
+	 * accepted by @filter. Initial prefix is empty (matches everything).
+	 */
+	PrefixSearch
+	prefix_search (TypeFilter filter = TypeFilter()) const;
+
 	/**
 	 * Return set of navaids, sorted by proximity to the @position
 	 * (first is the nearest).
@@ -109,30 +486,242 @@ class NavaidStorage
 	Navaids
 	find_by_frequency (LonLat const& position, Navaid::Type, Frequency frequency) const;
 
+	/**
+	 * Return iterator over navaids of given type tuned to @frequency (±5 kHz),
+	 * nearest to @position first. Unlike find_by_frequency() it doesn't copy
+	 * or sort anything, so taking the nearest few navaids is cheap.
+	 */
+	FrequencyIterator
+	nearest_by_frequency (LonLat const& position, Navaid::Type, Frequency frequency) const;
+
+	/**
+	 * Find the shortest route along airways between waypoints identified by @from and @to.
+	 * If identifiers aren't unique, the pair of waypoints giving the shortest route is used.
+	 * If @level is given, only airways of that level are used.
+	 * Return empty Optional if there's no such route or airways aren't loaded yet
+	 * (they're parsed after navaids are loaded).
+	 */
+	Optional<Route>
+	find_route (QString const& from, QString const& to, Optional<AirwayLevel> level = {}) const;
+
+  private:
+	/**
+	 * Navaids of a single type tuned to the same frequency
+	 * with spatial index over them.
+	 */
+	struct FrequencyChannel
+	{
+		// In index order:
+		NavaidRefs		navaids;
+		SphericalIndex	index;
+	};
+
+	typedef std::vector<Shared<Tile const>> Tiles;
+	typedef std::map<std::pair<Navaid::Type, QString>, Unique<Navaid>> FoundNavaids;
+	typedef std::map<std::pair<Navaid::Type, Frequency>, FrequencyChannel> FrequencyChannels;
+
   private:
+	/**
+	 * Try to load navaids from the compiled database.
+	 * Return false if it doesn't exist, is invalid or is stale.
+	 */
+	bool
+	load_compiled();
+
+	/**
+	 * Return paths of text data files.
+	 */
+	std::vector<QString>
+	source_files() const;
+
+	/**
+	 * Group navaids into tiles and build per-tile spatial indexes.
+	 */
+	void
+	build_tiles (Navaids&& navaids);
+
+	/**
+	 * Build per-type identifier indexes and frequency channels from all tiles.
+	 */
+	void
+	build_indexes();
+
+	/**
+	 * Group navaids that have a frequency into frequency channels
+	 * and build spatial index of each channel.
+	 */
 	void
-	parse_nav_dat();
+	build_frequency_channels (NavaidRefs const& navaids);
 
+	/**
+	 * Return given tile or nullptr if it's empty.
+	 * With the compiled database load the tile if it's not resident.
+	 */
+	Shared<Tile const>
+	tile (GeoTileGrid::TileID) const;
+
+	/**
+	 * Create tile from the compiled database.
+	 */
+	static Shared<Tile const>
+	load_tile (NavaidDatabase const&, GeoTileGrid::TileID);
+
+	/**
+	 * Region-streaming thread: load tiles around the position given
+	 * with update_position() and free the ones that are far away.
+	 */
 	void
-	parse_fix_dat();
+	stream_tiles();
 
+	/**
+	 * Load tiles around @position and ahead on the @track, free
+	 * tiles that are outside of the hysteresis zone.
+	 */
 	void
-	parse_apt_dat();
+	update_resident_tiles (LonLat const& position, Optional<Angle> track);
+
+	/**
+	 * Parse airways file and build the airway graph.
+	 */
+	void
+	load_airways();
+
+	/**
+	 * Return airway graph nodes having given identifier.
+	 */
+	std::vector<AirwayGraph::NodeID>
+	airway_nodes (QString const& identifier) const;
+
+	Navaids
+	parse_nav_dat() const;
+
+	Navaids
+	parse_fix_dat() const;
+
+	Navaids
+	parse_apt_dat() const;
 
   private:
-	Logger			_logger;
-	NavaidsTree		_navaids_tree;
-	const char*		_nav_dat_file	= "share/nav/nav.dat.gz";
-	const char*		_fix_dat_file	= "share/nav/fix.dat.gz";
-	const char*		_apt_dat_file	= "share/nav/apt.dat.gz";
-	NavaidsByType	_navaids_by_type;
+	Logger				_logger;
+	QString				_nav_dat_file;
+	QString				_fix_dat_file;
+	QString				_apt_dat_file;
+	QString				_awy_dat_file;
+	QString				_compiled_file;
+	GeoTileGrid			_tile_grid;
+	// Indexed by tile ID, nullptr for empty tiles (or not resident ones with the compiled database):
+	Tiles mutable		_tiles;
+	Mutex				_tiles_mutex;
+	// Not used with the compiled database:
+	NavaidsByType		_navaids_by_type;
+	// Used in both modes:
+	FrequencyChannels	_frequency_channels;
+	// Owns navaids referenced by _frequency_channels with the compiled database, since tiles may be not loaded or freed:
+	Navaids				_frequency_navaids;
+	// Airways:
+	AirwayGraph			_airway_graph;
+	// Indexed by AirwayGraph::NodeID:
+	std::vector<QString>	_airway_node_identifiers;
+	// Node IDs sorted by identifier:
+	std::vector<AirwayGraph::NodeID>	_airway_nodes_by_identifier;
+	// Indexed by AirwayGraph::AirwayID:
+	std::vector<QString>	_airway_names;
+	// Compiled database and region-streaming mode:
+	Optional<Length>	_streaming_radius;
+	Unique<NavaidDatabase>	_database;
+	FoundNavaids mutable	_found_navaids;
+	Mutex				_found_navaids_mutex;
+	Mutex				_stream_position_mutex;
+	Optional<LonLat>	_stream_position;
+	Optional<Angle>		_stream_track;
+	Semaphore			_stream_semaphore;
+	std::atomic<bool>	_stream_quit	{ false };
+	std::thread			_stream_thread;
+	// Set after all above structures but airways are built; they're not modified afterwards
+	// (except _tiles with the compiled database):
+	std::atomic<bool>	_loaded			{ false };
+	std::atomic<bool>	_airways_loaded	{ false };
+	std::atomic<bool>	_loading		{ false };
+	std::thread			_loader_thread;
 };
 
 
-inline Angle::Value
-NavaidStorage::access_position (Navaid const& navaid, std::size_t const dimension)
+inline
+NavaidStorage::TypeFilter::TypeFilter() noexcept:
+	_mask (~static_cast<uint32_t> (0))
+{ }
+
+
+inline
+NavaidStorage::TypeFilter::TypeFilter (std::initializer_list<Navaid::Type> types) noexcept:
+	_mask (0)
+{
+	for (Navaid::Type type: types)
+		_mask |= static_cast<uint32_t> (1) << type;
+}
+
+
+inline bool
+NavaidStorage::TypeFilter::accepts (Navaid::Type type) const noexcept
+{
+	return _mask & (static_cast<uint32_t> (1) << type);
+}
+
+
+inline
+NavaidStorage::FrequencyIterator::operator bool() const noexcept
+{
+	return _current < _channels.size();
+}
+
+
+inline Navaid const&
+NavaidStorage::FrequencyIterator::operator*() const noexcept
+{
+	Channel const& channel = _channels[_current];
+	return *(*channel.navaids)[*channel.nearest];
+}
+
+
+inline Navaid const*
+NavaidStorage::FrequencyIterator::operator->() const noexcept
+{
+	return &**this;
+}
+
+
+inline QString const&
+NavaidStorage::PrefixSearch::prefix() const noexcept
+{
+	return _prefix;
+}
+
+
+inline bool
+NavaidStorage::streaming() const noexcept
+{
+	return loaded() && _database && _streaming_radius;
+}
+
+
+inline bool
+NavaidStorage::loading() const noexcept
+{
+	return _loading.load();
+}
+
+
+inline bool
+NavaidStorage::loaded() const noexcept
+{
+	return _loaded.load();
+}
+
+
+inline QString
+NavaidStorage::compiled_file() const
 {
-	return dimension == 0 ? navaid.position().lat().quantity<Degree>() : navaid.position().lon().quantity<Degree>();
+	return _compiled_file;
 }
 
 } // namespace Xefis
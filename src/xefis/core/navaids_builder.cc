@@ -0,0 +1,170 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+// Standard:
+#include <cstddef>
+#include <cstring>
+
+// Qt:
+#include <QtCore/QByteArray>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/stdexcept.h>
+
+// Local:
+#include "navaids_builder.h"
+
+
+namespace Xefis {
+
+std::size_t
+NavaidsBuilder::StringHash::operator() (uint32_t offset) const noexcept
+{
+	// FNV-1a:
+	std::size_t hash = 2166136261u;
+	for (char const* c = strings->data() + offset; *c; ++c)
+		hash = (hash ^ static_cast<unsigned char> (*c)) * 16777619u;
+	return hash;
+}
+
+
+bool
+NavaidsBuilder::StringEqual::operator() (uint32_t a, uint32_t b) const noexcept
+{
+	return std::strcmp (strings->data() + a, strings->data() + b) == 0;
+}
+
+
+NavaidsBuilder::NavaidsBuilder():
+	_strings (1, '\0'),
+	_string_offsets (0, StringHash { &_strings }, StringEqual { &_strings })
+{ }
+
+
+void
+NavaidsBuilder::add (Navaid const& navaid, QString const& identifier, QString const& name, QString const& icao, QString const& runway_id)
+{
+	_navaids.push_back (navaid);
+	_navaid_strings.push_back ({
+		intern (identifier),
+		intern (name),
+		intern (icao),
+		intern (runway_id),
+		static_cast<uint32_t> (_runways.size()),
+		0,
+	});
+}
+
+
+void
+NavaidsBuilder::add_runway (QString const& identifier_1, LonLat const& pos_1, QString const& identifier_2, LonLat const& pos_2, Length width)
+{
+	if (_navaid_strings.empty())
+		throw InvalidCall ("NavaidsBuilder::add_runway(): no navaid to add runway to");
+
+	_runways.push_back ({ intern (identifier_1), pos_1, intern (identifier_2), pos_2, width });
+	_navaid_strings.back().runways_count += 1;
+}
+
+
+std::vector<Navaid>
+NavaidsBuilder::finish()
+{
+	// The pool becomes the block of strings, without copying:
+	auto pool = std::make_shared<std::vector<char>> (std::move (_strings));
+	Shared<char const> strings (pool, pool->data());
+
+	Shared<Navaid::Runways const> runways_table;
+
+	if (!_runways.empty())
+	{
+		auto runways = std::make_shared<Navaid::Runways>();
+		runways->reserve (_runways.size());
+
+		for (RunwayData const& data: _runways)
+		{
+			runways->emplace_back (strings, data.identifier_1, data.pos_1, data.identifier_2, data.pos_2);
+			runways->back().set_width (data.width);
+		}
+
+		runways_table = runways;
+	}
+
+	for (std::size_t i = 0; i < _navaids.size(); ++i)
+	{
+		NavaidStrings const& navaid_strings = _navaid_strings[i];
+		Navaid& navaid = _navaids[i];
+
+		navaid.set_strings (strings, navaid_strings.identifier, navaid_strings.name, navaid_strings.icao, navaid_strings.runway_id);
+
+		if (navaid_strings.runways_count > 0)
+			navaid.set_runways (runways_table, navaid_strings.runways_begin, navaid_strings.runways_count);
+		else
+			navaid.set_runways (nullptr, 0, 0);
+	}
+
+	std::vector<Navaid> result;
+	result.swap (_navaids);
+
+	_strings.assign (1, '\0');
+	_string_offsets.clear();
+	_navaid_strings.clear();
+	_runways.clear();
+
+	return result;
+}
+
+
+uint32_t
+NavaidsBuilder::intern (QString const& string)
+{
+	if (string.isEmpty())
+		return 0;
+
+	std::size_t const offset = _strings.size();
+	bool ascii = true;
+
+	// Data files are mostly ASCII, which is copied without creating a temporary QByteArray:
+	for (QChar c: string)
+	{
+		if (c.unicode() >= 0x80)
+		{
+			ascii = false;
+			break;
+		}
+	}
+
+	if (ascii)
+	{
+		for (QChar c: string)
+			_strings.push_back (static_cast<char> (c.unicode()));
+	}
+	else
+	{
+		QByteArray const utf8 = string.toUtf8();
+		_strings.insert (_strings.end(), utf8.constData(), utf8.constData() + utf8.size());
+	}
+
+	_strings.push_back ('\0');
+
+	auto inserted = _string_offsets.insert (offset);
+	// Drop the copy if the string is already in the pool:
+	if (!inserted.second)
+		_strings.resize (offset);
+
+	return *inserted.first;
+}
+
+} // namespace Xefis
+
@@ -0,0 +1,146 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+#ifndef XEFIS__CORE__NAVAIDS_BUILDER_H__INCLUDED
+#define XEFIS__CORE__NAVAIDS_BUILDER_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+// Qt:
+#include <QtCore/QString>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/utility/noncopyable.h>
+
+// Local:
+#include "navaid.h"
+
+
+namespace Xefis {
+
+/**
+ * Creates navaids that share one block of strings and one runways table,
+ * eg. all navaids parsed from a data file.
+ *
+ * Strings of added navaids are interned in a pool (equal strings are stored once),
+ * runways are appended to a common table. finish() turns the pool into a single block
+ * and gives it and the runways table to all navaids, so that parsing a file doesn't
+ * allocate anything per navaid. The block and the table are released together with
+ * the last navaid (or its copy) using them.
+ */
+class NavaidsBuilder: private Noncopyable
+{
+	/**
+	 * Strings and runways of an added navaid.
+	 */
+	struct NavaidStrings
+	{
+		uint32_t	identifier;
+		uint32_t	name;
+		uint32_t	icao;
+		uint32_t	runway_id;
+		uint32_t	runways_begin;
+		uint32_t	runways_count;
+	};
+
+	struct RunwayData
+	{
+		uint32_t	identifier_1;
+		LonLat		pos_1;
+		uint32_t	identifier_2;
+		LonLat		pos_2;
+		Length		width;
+	};
+
+	/**
+	 * Hash and comparison of strings given by their offsets in the pool.
+	 */
+	struct StringHash
+	{
+		std::vector<char> const*	strings;
+
+		std::size_t
+		operator() (uint32_t offset) const noexcept;
+	};
+
+	struct StringEqual
+	{
+		std::vector<char> const*	strings;
+
+		bool
+		operator() (uint32_t a, uint32_t b) const noexcept;
+	};
+
+	typedef std::unordered_set<uint32_t, StringHash, StringEqual> StringOffsets;
+
+  public:
+	// Ctor
+	NavaidsBuilder();
+
+	/**
+	 * Add navaid with given strings. Strings and runways set on @navaid itself are replaced.
+	 */
+	void
+	add (Navaid const& navaid, QString const& identifier, QString const& name, QString const& icao = QString(), QString const& runway_id = QString());
+
+	/**
+	 * Add runway to the last added navaid.
+	 */
+	void
+	add_runway (QString const& identifier_1, LonLat const& pos_1, QString const& identifier_2, LonLat const& pos_2, Length width);
+
+	/**
+	 * Number of added navaids.
+	 */
+	std::size_t
+	size() const noexcept;
+
+	/**
+	 * Return all added navaids, sharing the strings block and the runways table.
+	 * Builder is empty afterwards.
+	 */
+	std::vector<Navaid>
+	finish();
+
+  private:
+	/**
+	 * Add string to the pool and return its offset.
+	 */
+	uint32_t
+	intern (QString const&);
+
+  private:
+	// Null-terminated UTF-8 strings, starting with an empty string at offset 0:
+	std::vector<char>			_strings;
+	StringOffsets				_string_offsets;
+	std::vector<Navaid>			_navaids;
+	std::vector<NavaidStrings>	_navaid_strings;
+	std::vector<RunwayData>		_runways;
+};
+
+
+inline std::size_t
+NavaidsBuilder::size() const noexcept
+{
+	return _navaids.size();
+}
+
+} // namespace Xefis
+
+#endif
+
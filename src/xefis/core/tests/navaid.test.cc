@@ -0,0 +1,129 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <cstring>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/navaid.h>
+#include <xefis/core/navaids_builder.h>
+#include <xefis/test/test.h>
+
+
+namespace Xefis {
+namespace Test {
+
+static xf::RuntimeTest t1 ("Navaid strings", []{
+	using namespace xf::TestAsserts;
+
+	Navaid empty (Navaid::FIX);
+	verify ("strings of a new navaid are empty", empty.identifier().isEmpty() && empty.name().isEmpty() && std::strlen (empty.utf8_identifier()) == 0);
+
+	Navaid navaid (Navaid::LOC, LonLat (21_deg, 52_deg), "IWA", "Warszawa ILS", 18_nmi);
+	navaid.set_icao ("EPWA");
+	navaid.set_runway_id ("33");
+	verify ("setting a string keeps other strings",
+			navaid.identifier() == "IWA" && navaid.name() == "Warszawa ILS" && navaid.icao() == "EPWA" && navaid.runway_id() == "33");
+	verify ("UTF-8 identifier matches", std::strcmp (navaid.utf8_identifier(), "IWA") == 0);
+
+	Navaid copy (navaid);
+	navaid.set_name ("Changed");
+	verify ("copies don't see changes of the original", copy.name() == "Warszawa ILS" && navaid.name() == "Changed");
+	verify ("changed navaid keeps other strings", navaid.identifier() == "IWA" && navaid.runway_id() == "33");
+
+	Navaid::Runway runway ("15", LonLat (21_deg, 52_deg), "33", LonLat (21.1_deg, 52.1_deg));
+	verify ("runway identifiers", runway.identifier_1() == "15" && runway.identifier_2() == "33");
+});
+
+
+static xf::RuntimeTest t2 ("Navaid shared strings block", []{
+	using namespace xf::TestAsserts;
+
+	char const data[] = "\0ABC\0Name\0";
+	Shared<char> block (new char[sizeof (data)], std::default_delete<char[]>());
+	std::memcpy (block.get(), data, sizeof (data));
+	Shared<char const> strings = block;
+
+	Navaid navaid (Navaid::VOR);
+	navaid.set_strings (strings, 1, 5, 0, 0);
+	verify ("strings are read from the block", navaid.identifier() == "ABC" && navaid.name() == "Name" && navaid.icao().isEmpty());
+	verify ("block isn't copied", navaid.utf8_identifier() == block.get() + 1);
+
+	Navaid copy (navaid);
+	strings.reset();
+	block.reset();
+	verify ("copies keep the block alive", copy.identifier() == "ABC" && navaid.name() == "Name");
+});
+
+
+
+static xf::RuntimeTest t3 ("NavaidsBuilder shares strings and runways", []{
+	using namespace xf::TestAsserts;
+
+	NavaidsBuilder builder;
+
+	Navaid vor (Navaid::VOR);
+	vor.set_frequency (113.45_MHz);
+	builder.add (vor, "WAR", "Warszawa VOR");
+
+	builder.add (Navaid (Navaid::ARPT), "EPWA", "Chopin");
+	builder.add_runway ("11", LonLat (20.95_deg, 52.16_deg), "29", LonLat (20.99_deg, 52.17_deg), 60_m);
+	builder.add_runway ("15", LonLat (20.96_deg, 52.18_deg), "33", LonLat (20.97_deg, 52.15_deg), 45_m);
+
+	builder.add (Navaid (Navaid::LOC), "IWA", "Warszawa ILS", "EPWA", "33");
+	builder.add (Navaid (Navaid::FIX), "WAR", "WAR");
+	builder.add (Navaid (Navaid::ARPT), "EPKK", "Balice");
+	builder.add_runway ("07", LonLat (19.77_deg, 50.07_deg), "25", LonLat (19.80_deg, 50.08_deg), 60_m);
+	builder.add (Navaid (Navaid::FIX), "", "");
+
+	std::vector<Navaid> navaids = builder.finish();
+	verify ("builder is empty after finish()", builder.size() == 0);
+	verify ("all navaids are returned", navaids.size() == 6);
+
+	verify ("navaid data is kept", navaids[0].type() == Navaid::VOR && navaids[0].frequency() == 113.45_MHz);
+	verify ("strings are set",
+			navaids[0].identifier() == "WAR" && navaids[0].name() == "Warszawa VOR" &&
+			navaids[2].icao() == "EPWA" && navaids[2].runway_id() == "33" && navaids[4].name() == "Balice");
+	verify ("empty strings are empty", navaids[5].identifier().isEmpty() && navaids[0].icao().isEmpty());
+	verify ("equal strings are stored once", navaids[0].utf8_identifier() == navaids[3].utf8_identifier());
+
+	// Navaid with empty strings points to the beginning of the block:
+	char const* const block_begin = navaids[5].utf8_identifier();
+	bool one_block = true;
+	for (Navaid const& navaid: navaids)
+		one_block = one_block && navaid.utf8_identifier() >= block_begin && navaid.utf8_identifier() < block_begin + 64;
+	verify ("all navaids use one block", one_block);
+
+	verify ("runways are assigned to their airports",
+			navaids[1].runways().size() == 2 && navaids[4].runways().size() == 1 && navaids[0].runways().empty() && navaids[5].runways().empty());
+	verify ("runways data is kept",
+			navaids[1].runways()[1].identifier_1() == "15" && navaids[1].runways()[1].identifier_2() == "33" &&
+			navaids[1].runways()[1].width() == 45_m && navaids[4].runways()[0].identifier_2() == "25");
+	verify ("airports share the runways table", navaids[1].runways().end() == navaids[4].runways().begin());
+	verify ("runways strings are in the same block", navaids[1].runways()[1].identifier_2() == navaids[2].runway_id());
+
+	Navaid copy (navaids[1]);
+	navaids.clear();
+	verify ("copies keep the block and the table alive", copy.identifier() == "EPWA" && copy.runways()[0].identifier_2() == "29");
+
+	builder.add (Navaid (Navaid::NDB), "ZAKŁ", "Zakłęcie");
+	navaids = builder.finish();
+	verify ("builder can be reused", navaids.size() == 1 && navaids[0].identifier() == QString::fromUtf8 ("ZAKŁ") && navaids[0].name() == QString::fromUtf8 ("Zakłęcie"));
+});
+
+} // namespace Test
+} // namespace Xefis
+
@@ -0,0 +1,295 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+// Standard:
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Lib:
+#include <zlib.h>
+
+// Qt:
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/navaid_database.h>
+#include <xefis/core/navaid_storage.h>
+#include <xefis/core/stdexcept.h>
+#include <xefis/test/test.h>
+#include <xefis/utility/geo_tile_grid.h>
+
+
+namespace Xefis {
+namespace Test {
+
+typedef std::vector<std::pair<QString, LonLat>> Fixes;
+
+
+/**
+ * Write gzipped fix.dat file with given fixes, as parsed by NavaidStorage.
+ */
+static void
+write_fix_dat (QString const& path, Fixes const& fixes)
+{
+	gzFile file = gzopen (path.toStdString().c_str(), "wb");
+	// First two lines are file origin and copyrights:
+	gzputs (file, "I\n600 Version - test data\n\n");
+	for (auto const& fix: fixes)
+		gzprintf (file, "%.6f %.6f %s\n", fix.second.lat().quantity<Degree>(), fix.second.lon().quantity<Degree>(), fix.first.toStdString().c_str());
+	gzputs (file, "99\n");
+	gzclose (file);
+}
+
+
+/**
+ * Replace contents of the file at @path with contents modified by @modify.
+ */
+static void
+modify_file (QString const& path, std::function<void (QByteArray&)> modify)
+{
+	QFile file (path);
+	file.open (QFile::ReadOnly);
+	QByteArray data = file.readAll();
+	file.close();
+
+	modify (data);
+
+	file.open (QFile::WriteOnly | QFile::Truncate);
+	file.write (data);
+}
+
+
+/**
+ * Return true if NavaidDatabase refuses to map the file at @path.
+ */
+static bool
+rejected (QString const& path)
+{
+	try {
+		NavaidDatabase database (path);
+	}
+	catch (IOError const&)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+
+/**
+ * Return true if both navaids have the same data.
+ */
+static bool
+equal (Navaid const& a, Navaid const& b)
+{
+	if (a.type() != b.type() || a.identifier() != b.identifier() || a.name() != b.name() ||
+		a.icao() != b.icao() || a.runway_id() != b.runway_id() ||
+		a.position().haversine (b.position()) > 1e-12 || abs (a.range() - b.range()) > 1e-9_nmi ||
+		abs (a.frequency() - b.frequency()) > 1e-9_Hz || abs (a.elevation() - b.elevation()) > 1e-9_ft ||
+		abs (a.true_bearing() - b.true_bearing()) > 1e-9_deg || a.vor_type() != b.vor_type() ||
+		a.runways().size() != b.runways().size())
+	{
+		return false;
+	}
+
+	for (std::size_t r = 0; r < a.runways().size(); ++r)
+	{
+		Navaid::Runway const& ra = a.runways()[r];
+		Navaid::Runway const& rb = b.runways()[r];
+
+		if (ra.identifier_1() != rb.identifier_1() || ra.identifier_2() != rb.identifier_2() ||
+			ra.pos_1().haversine (rb.pos_1()) > 1e-12 || ra.pos_2().haversine (rb.pos_2()) > 1e-12 ||
+			abs (ra.width() - rb.width()) > 1e-9_m)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * Return true if storage loaded from @directory used the compiled database.
+ * Region-streaming mode is used only with the compiled database.
+ */
+static bool
+uses_compiled_database (QString const& directory, QString const& fix_identifier)
+{
+	NavaidStorage storage (directory);
+	storage.set_streaming_radius (100_nmi);
+	storage.load();
+
+	xf::TestAsserts::verify ("navaids are loaded", storage.loaded() && storage.find_by_id (Navaid::FIX, fix_identifier));
+	return storage.streaming();
+}
+
+
+static xf::RuntimeTest t1 ("NavaidDatabase maps written navaids", []{
+	using namespace xf::TestAsserts;
+
+	QTemporaryDir directory;
+	QString const source = directory.path() + "/fix.dat.gz";
+	QString const compiled = directory.path() + "/navaids.navdb";
+	write_fix_dat (source, { { "ABCDE", LonLat (19.9_deg, 50.1_deg) } });
+
+	std::vector<Navaid> navaids;
+
+	Navaid vor (Navaid::VOR, LonLat (21.0_deg, 52.2_deg), "WAR", "Warszawa VOR", 130_nmi);
+	vor.set_frequency (113.45_MHz);
+	vor.set_slaved_variation (5_deg);
+	vor.set_elevation (360_ft);
+	vor.set_vor_type (Navaid::VOR_DME);
+	navaids.push_back (vor);
+
+	Navaid loc (Navaid::LOC, LonLat (20.95_deg, 52.15_deg), "IWA", "Warszawa ILS", 18_nmi);
+	loc.set_frequency (110.3_MHz);
+	loc.set_true_bearing (334_deg);
+	loc.set_icao ("EPWA");
+	loc.set_runway_id ("33");
+	navaids.push_back (loc);
+
+	Navaid arpt (Navaid::ARPT, LonLat (20.97_deg, 52.17_deg), "EPWA", "Chopin", 0_nmi);
+	Navaid::Runway runway ("11", LonLat (20.95_deg, 52.16_deg), "29", LonLat (20.99_deg, 52.17_deg));
+	runway.set_width (60_m);
+	arpt.set_runways ({ runway, Navaid::Runway ("15", LonLat (20.96_deg, 52.18_deg), "33", LonLat (20.97_deg, 52.15_deg)) });
+	navaids.push_back (arpt);
+
+	navaids.push_back (Navaid (Navaid::FIX, LonLat (-179.9_deg, -89.9_deg), "SOUTH", "SOUTH", 0_nmi));
+	navaids.push_back (Navaid (Navaid::NDB, LonLat (179.9_deg, 89.9_deg), "NTH", "North NDB", 25_nmi));
+
+	GeoTileGrid const tile_grid (5_deg);
+	std::stable_sort (navaids.begin(), navaids.end(), [&](Navaid const& a, Navaid const& b) {
+		return tile_grid.tile_of (a.position()) < tile_grid.tile_of (b.position());
+	});
+
+	std::vector<Navaid const*> navaid_ptrs;
+	for (Navaid const& navaid: navaids)
+		navaid_ptrs.push_back (&navaid);
+
+	NavaidDatabase::write (compiled, { source }, tile_grid, navaid_ptrs);
+
+	NavaidDatabase database (compiled);
+	verify ("database is fresh", database.is_fresh ({ source }));
+	verify ("database isn't fresh for different sources", !database.is_fresh ({ source, source }));
+	verify ("navaids count matches", database.navaids_count() == navaids.size());
+
+	bool all_equal = true;
+	for (std::size_t i = 0; i < database.navaids_count(); ++i)
+		all_equal = all_equal && equal (database.navaid (i), navaids[i]);
+	verify ("mapped navaids are equal to written ones", all_equal);
+
+	bool tiles_match = true;
+	for (std::size_t i = 0; i < navaids.size(); ++i)
+	{
+		auto const& tile = database.tile_record (tile_grid.tile_of (navaids[i].position()));
+		tiles_match = tiles_match && tile.navaids_begin <= i && i < tile.navaids_begin + tile.navaids_count;
+	}
+	verify ("navaids are found in their tiles", tiles_match);
+
+	write_fix_dat (source, { { "ABCDE", LonLat (19.9_deg, 50.1_deg) }, { "FGHIJ", LonLat (20.0_deg, 50.0_deg) } });
+	verify ("database isn't fresh after source file changes", !database.is_fresh ({ source }));
+});
+
+
+static xf::RuntimeTest t2 ("NavaidDatabase rejects invalid files", []{
+	using namespace xf::TestAsserts;
+
+	QTemporaryDir directory;
+	QString const source = directory.path() + "/fix.dat.gz";
+	QString const compiled = directory.path() + "/navaids.navdb";
+	QString const copy = directory.path() + "/copy.navdb";
+	write_fix_dat (source, { { "ABCDE", LonLat (19.9_deg, 50.1_deg) } });
+
+	Navaid fix (Navaid::FIX, LonLat (19.9_deg, 50.1_deg), "ABCDE", "ABCDE", 0_nmi);
+	NavaidDatabase::write (compiled, { source }, GeoTileGrid(), { &fix });
+	verify ("valid file is accepted", !rejected (compiled));
+
+	auto corrupted = [&](std::function<void (QByteArray&)> modify) {
+		QFile::remove (copy);
+		QFile::copy (compiled, copy);
+		modify_file (copy, modify);
+		return rejected (copy);
+	};
+
+	auto header_field = [](QByteArray& data, std::size_t offset) {
+		return reinterpret_cast<uint64_t*> (data.data() + offset);
+	};
+
+	verify ("missing file is rejected", rejected (directory.path() + "/missing.navdb"));
+	verify ("empty file is rejected", corrupted ([](QByteArray& data) { data.clear(); }));
+	verify ("truncated header is rejected", corrupted ([](QByteArray& data) { data.truncate (sizeof (NavaidDatabase::Header) / 2); }));
+	verify ("truncated sections are rejected", corrupted ([](QByteArray& data) { data.truncate (data.size() - sizeof (NavaidDatabase::TileRecord)); }));
+	verify ("invalid magic is rejected", corrupted ([](QByteArray& data) { data[0] = data[0] ^ 0xff; }));
+	verify ("invalid version is rejected", corrupted ([](QByteArray& data) {
+		reinterpret_cast<uint32_t*> (data.data() + offsetof (NavaidDatabase::Header, version))[0] += 1;
+	}));
+	verify ("invalid byte order is rejected", corrupted ([](QByteArray& data) {
+		std::reverse (data.data() + offsetof (NavaidDatabase::Header, byte_order_mark), data.data() + offsetof (NavaidDatabase::Header, byte_order_mark) + sizeof (uint32_t));
+	}));
+	verify ("invalid sources count is rejected", corrupted ([](QByteArray& data) {
+		reinterpret_cast<uint32_t*> (data.data() + offsetof (NavaidDatabase::Header, sources_count))[0] = NavaidDatabase::kMaxSources + 1;
+	}));
+	verify ("section offset beyond file is rejected", corrupted ([&](QByteArray& data) {
+		*header_field (data, offsetof (NavaidDatabase::Header, strings_offset)) = data.size() + 8;
+	}));
+	verify ("section size beyond file is rejected", corrupted ([&](QByteArray& data) {
+		*header_field (data, offsetof (NavaidDatabase::Header, navaids_count)) = data.size();
+	}));
+});
+
+
+static xf::RuntimeTest t3 ("NavaidStorage falls back to text files", []{
+	using namespace xf::TestAsserts;
+
+	QTemporaryDir directory;
+	QString const source = directory.path() + "/fix.dat.gz";
+	QString const compiled = directory.path() + "/navaids.navdb";
+	Fixes fixes { { "ABCDE", LonLat (19.9_deg, 50.1_deg) }, { "FGHIJ", LonLat (-70.0_deg, -33.0_deg) } };
+
+	auto compile = [&] {
+		write_fix_dat (source, fixes);
+		NavaidStorage storage (directory.path());
+		storage.load_sources();
+		storage.compile (compiled);
+	};
+
+	write_fix_dat (source, fixes);
+	verify ("text files are used without compiled database", !uses_compiled_database (directory.path(), "ABCDE"));
+
+	compile();
+	verify ("fresh compiled database is used", uses_compiled_database (directory.path(), "FGHIJ"));
+
+	fixes.push_back ({ "KLMNO", LonLat (150.0_deg, 10.0_deg) });
+	write_fix_dat (source, fixes);
+	verify ("text files are used when source stamp changes", !uses_compiled_database (directory.path(), "KLMNO"));
+
+	compile();
+	modify_file (compiled, [](QByteArray& data) { data[0] = data[0] ^ 0xff; });
+	verify ("text files are used when header is corrupt", !uses_compiled_database (directory.path(), "KLMNO"));
+
+	compile();
+	modify_file (compiled, [](QByteArray& data) { data.truncate (data.size() / 2); });
+	verify ("text files are used when database is truncated", !uses_compiled_database (directory.path(), "KLMNO"));
+});
+
+} // namespace Test
+} // namespace Xefis
+
@@ -0,0 +1,53 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+// System:
+#include <locale.h>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/navaid_storage.h>
+
+
+/**
+ * Compile text navigation data files (share/nav/*.dat.gz) into a binary database,
+ * that is memory-mapped by NavaidStorage on startup.
+ * Usage: navdb-compiler [output-file]
+ */
+int main (int argc, char** argv, char**)
+{
+	setenv ("LC_ALL", "POSIX", 1);
+	setlocale (LC_ALL, "POSIX");
+
+	try {
+		xf::NavaidStorage navaid_storage;
+		QString output_file = argc > 1 ? QString (argv[1]) : navaid_storage.compiled_file();
+
+		navaid_storage.load_sources();
+		navaid_storage.compile (output_file);
+	}
+	catch (xf::Exception& e)
+	{
+		std::cerr << "Fatal error: " << e << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,190 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+// Xefis:
+#include <xefis/config/all.h>
+
+// Local:
+#include "magnetic_variation_cache.h"
+
+
+namespace Xefis {
+
+void
+MagneticVariationCache::set_date (int year, int month, int day)
+{
+	std::tuple<int, int, int> date { year, month, day };
+
+	if (date != _date)
+	{
+		_date = date;
+		_cells.clear();
+		_cells_lru.clear();
+		_last_cell = nullptr;
+	}
+}
+
+
+MagneticVariationCache::Field
+MagneticVariationCache::field (LonLat const& position, Length altitude_amsl)
+{
+	double const cell_size_deg = kCellSize.quantity<Degree>();
+	int const max_lat_index = std::lround (90.0 / cell_size_deg) - 1;
+
+	double const x = position.lon().quantity<Degree>() / cell_size_deg;
+	double const y = position.lat().quantity<Degree>() / cell_size_deg;
+	double const z = altitude_amsl / kCellHeight;
+
+	int const lon_index = std::floor (x);
+	int const lat_index = std::max<int> (-max_lat_index - 1, std::min<int> (std::floor (y), max_lat_index));
+	int const alt_index = std::max<int> (kMinAltitudeBand, std::min<int> (std::floor (z), kMaxAltitudeBand - 1));
+	CellKey const key { lat_index, lon_index, alt_index };
+
+	if (!_last_cell || key != _last_key)
+	{
+		_last_cell = &cell (key);
+		_last_key = key;
+	}
+
+	if (_last_cell->direct)
+		return direct_field (position, altitude_amsl);
+
+	double const lon_fraction = x - lon_index;
+	double const lat_fraction = y - lat_index;
+	// May be outside of [0, 1] for altitudes outside of covered range:
+	double const alt_fraction = z - alt_index;
+
+	double const declination = interpolate (_last_cell->declination, lon_fraction, lat_fraction, alt_fraction);
+	double const inclination = interpolate (_last_cell->inclination, lon_fraction, lat_fraction, alt_fraction);
+
+	return { 1_deg * std::remainder (declination, 360.0), 1_deg * inclination };
+}
+
+
+double
+MagneticVariationCache::interpolate (CornerValues const& v, double lon_fraction, double lat_fraction, double alt_fraction)
+{
+	auto bilinear = [&](auto const& w) {
+		double const south = w[0][0] + lon_fraction * (w[0][1] - w[0][0]);
+		double const north = w[1][0] + lon_fraction * (w[1][1] - w[1][0]);
+		return south + lat_fraction * (north - south);
+	};
+
+	double const lower = bilinear (v[0]);
+	double const upper = bilinear (v[1]);
+	return lower + alt_fraction * (upper - lower);
+}
+
+
+MagneticVariationCache::Field
+MagneticVariationCache::direct_field (LonLat const& position, Length altitude_amsl) const
+{
+	MagneticVariation mv;
+	mv.set_position (position);
+	mv.set_altitude_amsl (altitude_amsl);
+	mv.set_date (std::get<0> (_date), std::get<1> (_date), std::get<2> (_date));
+	mv.update();
+
+	return { mv.magnetic_declination(), mv.magnetic_inclination() };
+}
+
+
+MagneticVariationCache::Cell const&
+MagneticVariationCache::cell (CellKey const& key)
+{
+	auto found = _cells.find (key);
+
+	if (found != _cells.end())
+	{
+		// Move to the front of LRU list:
+		_cells_lru.splice (_cells_lru.begin(), _cells_lru, found->second.lru_position);
+		return found->second.cell;
+	}
+
+	Cell computed = compute_cell (key);
+
+	if (_cells.size() >= kMaxCells)
+	{
+		if (_last_cell && _last_key == _cells_lru.back())
+			_last_cell = nullptr;
+
+		_cells.erase (_cells_lru.back());
+		_cells_lru.pop_back();
+	}
+
+	_cells_lru.push_front (key);
+	return _cells.insert ({ key, CellEntry { computed, _cells_lru.begin() } }).first->second.cell;
+}
+
+
+MagneticVariationCache::Cell
+MagneticVariationCache::compute_cell (CellKey const& key) const
+{
+	int const lat_index = std::get<0> (key);
+	int const lon_index = std::get<1> (key);
+	int const alt_index = std::get<2> (key);
+
+	Cell cell;
+	double reference_declination = 0.0;
+
+	for (int k = 0; k < 2; ++k)
+	{
+		for (int i = 0; i < 2; ++i)
+		{
+			for (int j = 0; j < 2; ++j)
+			{
+				LonLat corner (kCellSize * double (lon_index + j), kCellSize * double (lat_index + i));
+				Field f = direct_field (corner, kCellHeight * double (alt_index + k));
+				double const declination = f.declination.quantity<Degree>();
+
+				if (k == 0 && i == 0 && j == 0)
+					reference_declination = declination;
+
+				cell.declination[k][i][j] = reference_declination + std::remainder (declination - reference_declination, 360.0);
+				cell.inclination[k][i][j] = f.inclination.quantity<Degree>();
+			}
+		}
+	}
+
+	// Check interpolation error in the middle of the cell and in the middle of its edges,
+	// on both the lower and the upper altitude faces:
+	double const max_error = kMaxInterpolationError.quantity<Degree>();
+
+	for (int k = 0; k < 2 && !cell.direct; ++k)
+	{
+		for (auto const& fractions: { std::make_pair (0.5, 0.5), { 0.5, 0.0 }, { 0.5, 1.0 }, { 0.0, 0.5 }, { 1.0, 0.5 } })
+		{
+			LonLat point (kCellSize * (lon_index + fractions.first), kCellSize * (lat_index + fractions.second));
+			Field f = direct_field (point, kCellHeight * double (alt_index + k));
+			double const declination_error = std::remainder (interpolate (cell.declination, fractions.first, fractions.second, k) - f.declination.quantity<Degree>(), 360.0);
+			double const inclination_error = interpolate (cell.inclination, fractions.first, fractions.second, k) - f.inclination.quantity<Degree>();
+
+			if (std::abs (declination_error) > max_error || std::abs (inclination_error) > max_error)
+			{
+				cell.direct = true;
+				break;
+			}
+		}
+	}
+
+	return cell;
+}
+
+} // namespace Xefis
+
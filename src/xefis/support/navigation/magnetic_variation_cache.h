@@ -0,0 +1,162 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+#ifndef XEFIS__SUPPORT__NAVIGATION__MAGNETIC_VARIATION_CACHE_H__INCLUDED
+#define XEFIS__SUPPORT__NAVIGATION__MAGNETIC_VARIATION_CACHE_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <array>
+#include <list>
+#include <map>
+#include <tuple>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/support/navigation/magnetic_variation.h>
+
+
+namespace Xefis {
+
+/**
+ * Computes magnetic declination and inclination by interpolating values
+ * of MagneticVariation precomputed on a grid.
+ *
+ * Grid cells are 1° × 1° × 5 km (altitude) and are computed lazily, when position
+ * first enters the cell. Values are interpolated bilinearly over longitude and latitude
+ * and linearly over altitude, with error below 0.1°. Near magnetic poles, where
+ * the field changes too quickly to interpolate, cells fall back to direct computation.
+ * This is detected when cell is created by comparing interpolated and direct values
+ * in the middle of the cell and its edges.
+ *
+ * At most kMaxCells cells are kept, least recently used are dropped first.
+ * All cells are discarded when date changes.
+ */
+class MagneticVariationCache
+{
+	// Maximum error of interpolated values checked when cell is created:
+	static constexpr Angle		kMaxInterpolationError	= 0.05_deg;
+	// Size of cells:
+	static constexpr Angle		kCellSize				= 1_deg;
+	static constexpr Length		kCellHeight				= 5_km;
+	// Altitude range covered by cells, altitudes outside are extrapolated:
+	static constexpr int		kMinAltitudeBand		= -1;
+	static constexpr int		kMaxAltitudeBand		= 8;
+
+  public:
+	// Max number of cached cells (about 1 MB). Least recently used are dropped first:
+	static constexpr std::size_t	kMaxCells	= 4096;
+
+	/**
+	 * Resulting magnetic field angles.
+	 */
+	class Field
+	{
+	  public:
+		Angle	declination;
+		Angle	inclination;
+	};
+
+  private:
+	// Latitude, longitude and altitude indices of the cell:
+	typedef std::tuple<int, int, int> CellKey;
+
+	// Values at cell corners, indexed [altitude][latitude][longitude]:
+	typedef std::array<std::array<std::array<double, 2>, 2>, 2> CornerValues;
+
+	typedef std::list<CellKey> CellsLRU;
+
+	/**
+	 * Field angles (in degrees) at cell corners.
+	 * Declinations are unwrapped relative to the first corner, so that they can be interpolated.
+	 */
+	class Cell
+	{
+	  public:
+		bool			direct		= false;
+		CornerValues	declination;
+		CornerValues	inclination;
+	};
+
+	class CellEntry
+	{
+	  public:
+		Cell				cell;
+		CellsLRU::iterator	lru_position;
+	};
+
+  public:
+	/**
+	 * Set date. Supported years: 1950…2049.
+	 * Clears cache if date is different than the previous one.
+	 */
+	void
+	set_date (int year, int month, int day);
+
+	/**
+	 * Return magnetic declination and inclination at given position and altitude.
+	 */
+	Field
+	field (LonLat const& position, Length altitude_amsl);
+
+	/**
+	 * Return number of cells computed so far.
+	 */
+	std::size_t
+	cells_count() const noexcept;
+
+  private:
+	/**
+	 * Interpolate bilinearly over longitude and latitude and linearly over altitude.
+	 */
+	static double
+	interpolate (CornerValues const&, double lon_fraction, double lat_fraction, double alt_fraction);
+
+	/**
+	 * Compute field with MagneticVariation.
+	 */
+	Field
+	direct_field (LonLat const& position, Length altitude_amsl) const;
+
+	/**
+	 * Find or compute cell. May drop the least recently used cell.
+	 */
+	Cell const&
+	cell (CellKey const&);
+
+	/**
+	 * Compute values for a new cell.
+	 */
+	Cell
+	compute_cell (CellKey const&) const;
+
+  private:
+	std::tuple<int, int, int>	_date			{ 0, 0, 0 };
+	std::map<CellKey, CellEntry>	_cells;
+	CellsLRU					_cells_lru;
+	// Most recently used cell:
+	CellKey						_last_key;
+	Cell const*					_last_cell		= nullptr;
+};
+
+
+inline std::size_t
+MagneticVariationCache::cells_count() const noexcept
+{
+	return _cells.size();
+}
+
+} // namespace Xefis
+
+#endif
+
@@ -0,0 +1,169 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+// Xefis:
+#include <xefis/test/test.h>
+#include <xefis/test/random_positions.h>
+#include <xefis/support/navigation/magnetic_variation.h>
+#include <xefis/support/navigation/magnetic_variation_cache.h>
+
+
+namespace Xefis {
+namespace Test {
+
+static MagneticVariationCache::Field
+direct_field (LonLat const& position, Length altitude_amsl, int year)
+{
+	MagneticVariation mv;
+	mv.set_position (position);
+	mv.set_altitude_amsl (altitude_amsl);
+	mv.set_date (year, 6, 1);
+	mv.update();
+	return { mv.magnetic_declination(), mv.magnetic_inclination() };
+}
+
+
+/**
+ * Check cached field against direct computation at all given positions and altitudes.
+ */
+static void
+verify_accuracy (char const* what, int year, std::vector<LonLat> const& positions, std::vector<Length> const& altitudes)
+{
+	using namespace xf::TestAsserts;
+
+	MagneticVariationCache cache;
+	cache.set_date (year, 6, 1);
+	double max_declination_error_deg = 0.0;
+	double max_inclination_error_deg = 0.0;
+
+	for (std::size_t i = 0; i < positions.size(); ++i)
+	{
+		for (Length altitude: altitudes)
+		{
+			auto cached = cache.field (positions[i], altitude);
+			auto direct = direct_field (positions[i], altitude, year);
+
+			double const declination_error_deg = std::remainder ((cached.declination - direct.declination).quantity<Degree>(), 360.0);
+			double const inclination_error_deg = (cached.inclination - direct.inclination).quantity<Degree>();
+			max_declination_error_deg = std::max (max_declination_error_deg, std::abs (declination_error_deg));
+			max_inclination_error_deg = std::max (max_inclination_error_deg, std::abs (inclination_error_deg));
+		}
+	}
+
+	verify (std::string (what) + ": declination error is below 0.1°", max_declination_error_deg < 0.1);
+	verify (std::string (what) + ": inclination error is below 0.1°", max_inclination_error_deg < 0.1);
+}
+
+
+/**
+ * Return a dense grid of positions around given center, ±2° in both directions.
+ */
+static std::vector<LonLat>
+neighbourhood (LonLat const& center)
+{
+	std::vector<LonLat> positions;
+
+	for (int i = -20; i <= 20; ++i)
+		for (int j = -20; j <= 20; ++j)
+			positions.emplace_back (center.lon() + 0.1_deg * i, center.lat() + 0.1_deg * j);
+
+	return positions;
+}
+
+
+static xf::RuntimeTest t1 ("MagneticVariationCache accuracy", []{
+	std::mt19937 rng (1);
+	auto const sphere = uniform_sphere_positions (5000, rng);
+
+	for (int year: { 2016, 2018 })
+		verify_accuracy ("uniform positions", year, sphere, { -1_km, 0_km, 3.3_km, 11_km });
+});
+
+
+static xf::RuntimeTest t2 ("MagneticVariationCache near magnetic poles", []{
+	for (int year: { 2016, 2018 })
+	{
+		verify_accuracy ("north dip pole", year, neighbourhood (LonLat (-166.0_deg, 86.4_deg)), { 0_km, 10_km });
+		verify_accuracy ("south dip pole", year, neighbourhood (LonLat (136.6_deg, -64.3_deg)), { 0_km, 10_km });
+	}
+});
+
+
+static xf::RuntimeTest t3 ("MagneticVariationCache altitude band edges", []{
+	std::vector<Length> altitudes;
+
+	// Covered limits -5 km and 40 km, every 5 km band boundary and points just below and above them:
+	for (int band = -1; band <= 8; ++band)
+		for (Length offset: { -1_m, 0_m, 1_m })
+			altitudes.push_back (5_km * double (band) + offset);
+
+	std::mt19937 rng (2);
+	auto const sphere = uniform_sphere_positions (500, rng);
+
+	verify_accuracy ("band edges", 2018, sphere, altitudes);
+});
+
+
+static xf::RuntimeTest t4 ("MagneticVariationCache date change", []{
+	using namespace xf::TestAsserts;
+
+	MagneticVariationCache cache;
+	LonLat position (19.9_deg, 50.1_deg);
+
+	cache.set_date (2012, 1, 1);
+	cache.field (position, 1_km);
+	cache.set_date (2012, 1, 1);
+	verify ("cells are kept when date doesn't change", cache.cells_count() == 1);
+
+	cache.set_date (2018, 1, 1);
+	verify ("cells are discarded when date changes", cache.cells_count() == 0);
+
+	auto cached = cache.field (position, 1_km);
+	MagneticVariation mv;
+	mv.set_position (position);
+	mv.set_altitude_amsl (1_km);
+	mv.set_date (2018, 1, 1);
+	mv.update();
+	verify ("field is computed for the new date", abs (cached.declination - mv.magnetic_declination()) < 0.1_deg);
+});
+
+
+static xf::RuntimeTest t5 ("MagneticVariationCache cells limit", []{
+	using namespace xf::TestAsserts;
+
+	MagneticVariationCache cache;
+	cache.set_date (2018, 1, 1);
+	LonLat const first (0.5_deg, 0.5_deg);
+	auto const first_field = cache.field (first, 0_km);
+
+	// Visit twice as many different cells as the cache may keep:
+	for (std::size_t i = 0; i < 2 * MagneticVariationCache::kMaxCells; ++i)
+	{
+		cache.field (LonLat (1_deg * (-179.5 + i % 360), 1_deg * (-60.5 + i / 360)), 0_km);
+		verify ("number of cells is limited", cache.cells_count() <= MagneticVariationCache::kMaxCells);
+	}
+
+	auto const again = cache.field (first, 0_km);
+	verify ("dropped cell is recomputed", abs (again.declination - first_field.declination) < 1e-9_deg);
+});
+
+} // namespace Test
+} // namespace Xefis
+
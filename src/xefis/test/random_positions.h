@@ -0,0 +1,52 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+#ifndef XEFIS__TEST__RANDOM_POSITIONS_H__INCLUDED
+#define XEFIS__TEST__RANDOM_POSITIONS_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Xefis:
+#include <xefis/config/all.h>
+
+
+namespace Xefis {
+namespace Test {
+
+/**
+ * Return @count positions uniformly distributed over the sphere.
+ */
+template<class Generator>
+	inline std::vector<LonLat>
+	uniform_sphere_positions (std::size_t count, Generator& rng)
+	{
+		std::uniform_real_distribution<double> lon_dist (-180.0, 180.0);
+		std::uniform_real_distribution<double> sin_lat_dist (-1.0, 1.0);
+
+		std::vector<LonLat> positions;
+		positions.reserve (count);
+		for (std::size_t i = 0; i < count; ++i)
+			positions.emplace_back (1_deg * lon_dist (rng), 1_rad * std::asin (sin_lat_dist (rng)));
+
+		return positions;
+	}
+
+} // namespace Test
+} // namespace Xefis
+
+#endif
+
@@ -0,0 +1,177 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/stdexcept.h>
+
+// Local:
+#include "airway_graph.h"
+
+
+namespace Xefis {
+
+AirwayGraph::AirwayGraph (std::vector<LonLat> positions, std::vector<Segment> const& segments):
+	_positions (std::move (positions))
+{
+	_vectors.reserve (_positions.size());
+	for (LonLat const& position: _positions)
+		_vectors.push_back (SphericalIndex::to_vector (position));
+
+	// Count edges leaving each node, then turn counts into offsets:
+	_first_edge.assign (_positions.size() + 1, 0);
+	for (Segment const& segment: segments)
+	{
+		if (segment.a >= _positions.size() || segment.b >= _positions.size())
+			throw InvalidCall ("airway segment references nonexistent node");
+
+		++_first_edge[segment.a + 1];
+		++_first_edge[segment.b + 1];
+	}
+
+	for (std::size_t n = 1; n < _first_edge.size(); ++n)
+		_first_edge[n] += _first_edge[n - 1];
+
+	std::vector<uint32_t> next_edge (_first_edge.begin(), _first_edge.end() - 1);
+	_edges.resize (2 * segments.size());
+
+	for (Segment const& segment: segments)
+	{
+		LonLat const& a = _positions[segment.a];
+		LonLat const& b = _positions[segment.b];
+		float const distance = a.haversine (b);
+
+		_edges[next_edge[segment.a]++] = { segment.b, segment.airway, distance, static_cast<float> (a.initial_bearing (b).quantity<Degree>()), segment.classes };
+		_edges[next_edge[segment.b]++] = { segment.a, segment.airway, distance, static_cast<float> (b.initial_bearing (a).quantity<Degree>()), segment.classes };
+	}
+}
+
+
+Optional<AirwayGraph::Route>
+AirwayGraph::shortest_route (std::vector<NodeID> const& sources, std::vector<NodeID> const& targets, uint8_t classes) const
+{
+	struct Entry
+	{
+		// Estimated total distance through the node:
+		float	estimate;
+		float	distance;
+		NodeID	node;
+
+		// Reversed, so that std::priority_queue returns the best entry:
+		bool
+		operator< (Entry const& other) const noexcept
+		{
+			return estimate > other.estimate;
+		}
+	};
+
+	constexpr NodeID kNoNode = std::numeric_limits<NodeID>::max();
+	constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+	std::vector<uint8_t> is_target (nodes_count(), false);
+	std::vector<SphericalIndex::Vector> target_vectors;
+
+	for (NodeID node: targets)
+	{
+		if (node >= nodes_count())
+			throw InvalidCall ("route target node doesn't exist");
+
+		is_target[node] = true;
+		target_vectors.push_back (_vectors[node]);
+	}
+
+	// Chord to the nearest target. It's never longer than the great-circle arc,
+	// so the heuristic is admissible; scale it down a bit to absorb rounding errors:
+	auto heuristic = [&](NodeID node) -> float {
+		SphericalIndex::Vector const& v = _vectors[node];
+		float min_squared_chord = kInfinity;
+		for (SphericalIndex::Vector const& t: target_vectors)
+		{
+			float const dx = v[0] - t[0];
+			float const dy = v[1] - t[1];
+			float const dz = v[2] - t[2];
+			min_squared_chord = std::min (min_squared_chord, dx * dx + dy * dy + dz * dz);
+		}
+		return 0.9999f * std::sqrt (min_squared_chord);
+	};
+
+	std::vector<float> distances (nodes_count(), kInfinity);
+	std::vector<NodeID> previous_nodes (nodes_count(), kNoNode);
+	std::vector<Edge const*> previous_edges (nodes_count(), nullptr);
+	std::priority_queue<Entry> queue;
+
+	for (NodeID node: sources)
+	{
+		if (node >= nodes_count())
+			throw InvalidCall ("route source node doesn't exist");
+
+		distances[node] = 0.0f;
+		queue.push ({ heuristic (node), 0.0f, node });
+	}
+
+	while (!queue.empty())
+	{
+		Entry const entry = queue.top();
+		queue.pop();
+
+		// Skip entries superseded by a shorter path:
+		if (entry.distance > distances[entry.node])
+			continue;
+
+		if (is_target[entry.node])
+		{
+			Route route;
+			route.distance = static_cast<double> (entry.distance) * kEarthMeanRadius;
+
+			for (NodeID node = entry.node; node != kNoNode; node = previous_nodes[node])
+			{
+				route.nodes.push_back (node);
+				if (previous_edges[node])
+					route.edges.push_back (previous_edges[node]);
+			}
+
+			std::reverse (route.nodes.begin(), route.nodes.end());
+			std::reverse (route.edges.begin(), route.edges.end());
+			return route;
+		}
+
+		auto const range = edges (entry.node);
+		for (Edge const* edge = range.first; edge != range.second; ++edge)
+		{
+			if (!(edge->classes & classes))
+				continue;
+
+			float const distance = entry.distance + edge->distance;
+			if (distance < distances[edge->target])
+			{
+				distances[edge->target] = distance;
+				previous_nodes[edge->target] = entry.node;
+				previous_edges[edge->target] = edge;
+				queue.push ({ distance + heuristic (edge->target), distance, edge->target });
+			}
+		}
+	}
+
+	return { };
+}
+
+} // namespace Xefis
+
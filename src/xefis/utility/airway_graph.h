@@ -0,0 +1,167 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+#ifndef XEFIS__UTILITY__AIRWAY_GRAPH_H__INCLUDED
+#define XEFIS__UTILITY__AIRWAY_GRAPH_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/utility/spherical_index.h>
+
+
+namespace Xefis {
+
+/**
+ * Compact graph of airway segments stored as CSR (compressed sparse row) arrays:
+ * edges leaving node n are _edges[_first_edge[n]] … _edges[_first_edge[n + 1] - 1].
+ *
+ * Nodes are waypoints identified by their numbers; mapping them to fixes and navaids
+ * is up to the user. Segment lengths and bearings are computed once, when the graph
+ * is built, so route queries don't do any trigonometry.
+ */
+class AirwayGraph
+{
+  public:
+	typedef uint32_t NodeID;
+	typedef uint32_t AirwayID;
+
+	/**
+	 * Bidirectional airway segment between two nodes.
+	 */
+	struct Segment
+	{
+		NodeID		a;
+		NodeID		b;
+		AirwayID	airway;
+		// Bit mask of airway classes (eg. low/high altitude airways):
+		uint8_t		classes;
+	};
+
+	/**
+	 * Directed edge, one for each direction of a segment.
+	 */
+	struct Edge
+	{
+		NodeID		target;
+		AirwayID	airway;
+		// Great-circle distance in Earth radii:
+		float		distance;
+		// Initial true bearing in degrees, [-180, 180]:
+		float		bearing;
+		uint8_t		classes;
+	};
+
+	/**
+	 * Result of a route query.
+	 */
+	struct Route
+	{
+		// Source node first, target node last:
+		std::vector<NodeID>			nodes;
+		// Legs, edges[i] goes from nodes[i] to nodes[i + 1]:
+		std::vector<Edge const*>	edges;
+		Length						distance;
+	};
+
+  public:
+	// Ctor
+	AirwayGraph() = default;
+
+	/**
+	 * Build graph of nodes at given @positions (node N is at positions[N]),
+	 * connected by @segments.
+	 */
+	AirwayGraph (std::vector<LonLat> positions, std::vector<Segment> const& segments);
+
+	/**
+	 * Number of nodes.
+	 */
+	std::size_t
+	nodes_count() const noexcept;
+
+	/**
+	 * Number of directed edges (twice the number of segments).
+	 */
+	std::size_t
+	edges_count() const noexcept;
+
+	/**
+	 * Return position of a node.
+	 */
+	LonLat const&
+	position (NodeID) const;
+
+	/**
+	 * Return range of edges leaving a node.
+	 */
+	std::pair<Edge const*, Edge const*>
+	edges (NodeID) const;
+
+	/**
+	 * Find the shortest route from any of @sources to any of @targets using A* search
+	 * with great-circle distance heuristic. Only edges having at least one of @classes
+	 * are used. Multiple sources and targets are useful when a waypoint identifier isn't
+	 * unique - the search picks the pair that gives the shortest route.
+	 * Return empty Optional if targets aren't reachable.
+	 */
+	Optional<Route>
+	shortest_route (std::vector<NodeID> const& sources, std::vector<NodeID> const& targets, uint8_t classes = 0xff) const;
+
+  private:
+	std::vector<LonLat>					_positions;
+	// Unit vectors of node positions, for the A* heuristic:
+	std::vector<SphericalIndex::Vector>	_vectors;
+	// Size is nodes_count() + 1:
+	std::vector<uint32_t>				_first_edge;
+	std::vector<Edge>					_edges;
+};
+
+
+inline std::size_t
+AirwayGraph::nodes_count() const noexcept
+{
+	return _positions.size();
+}
+
+
+inline std::size_t
+AirwayGraph::edges_count() const noexcept
+{
+	return _edges.size();
+}
+
+
+inline LonLat const&
+AirwayGraph::position (NodeID node) const
+{
+	return _positions[node];
+}
+
+
+inline std::pair<AirwayGraph::Edge const*, AirwayGraph::Edge const*>
+AirwayGraph::edges (NodeID node) const
+{
+	return { _edges.data() + _first_edge[node], _edges.data() + _first_edge[node + 1] };
+}
+
+} // namespace Xefis
+
+#endif
+
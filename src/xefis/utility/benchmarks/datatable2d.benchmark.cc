@@ -0,0 +1,104 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+// Standard:
+#include <cstddef>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/benchmark/benchmark.h>
+#include <xefis/utility/datatable2d.h>
+
+
+namespace Xefis {
+namespace Benchmarks {
+
+/**
+ * Measure Datatable2D lookups for tables shaped like airfoil and viscosity tables:
+ * points on a uniform grid, points resampled onto a finer grid and irregular points.
+ * Each iteration does 100 lookups, either one by one or with a batch call ("-b" variants).
+ */
+static xf::Benchmark datatable2d ("utility/datatable2d", [](Benchmark& benchmark) {
+	std::vector<int> const sizes { 16, 64, 256 };
+	std::mt19937 rng (1);
+	std::uniform_real_distribution<double> noise (-1.0, 1.0);
+	double volatile sink = 0.0;
+
+	for (int size: sizes)
+	{
+		std::map<double, double> uniform;
+		std::map<double, double> resampled;
+		std::map<double, double> irregular;
+
+		for (int i = 0; i < size; ++i)
+		{
+			uniform[0.5 * i] = noise (rng);
+			// Every 4th grid node is missing:
+			resampled[0.5 * (i + i / 3)] = noise (rng);
+			irregular[0.5 * i + 0.1 * noise (rng)] = noise (rng);
+		}
+
+		std::string const suffix = "-" + std::to_string (size);
+		unsigned int const iterations = 20000;
+
+		for (auto const* map: { &uniform, &resampled, &irregular })
+		{
+			Datatable2D<double, double> table (*map);
+			std::string const variant = map == &uniform ? "uniform"
+				: map == &resampled ? "resampled"
+				: "irregular";
+			double const min = table.domain().min();
+			double const span = table.domain().max() - min;
+
+			benchmark.measure (variant + suffix, iterations, [&](unsigned int i) {
+				for (unsigned int k = 0; k < 100; ++k)
+					sink = *table.value (min + span * (((i + k) % 997) / 997.0));
+			});
+
+			// Sorted sweep, like the AOA sweep in performance computations:
+			std::vector<double> arguments (100);
+			std::vector<double> values (100);
+			for (std::size_t k = 0; k < arguments.size(); ++k)
+				arguments[k] = min + span * k / arguments.size();
+
+			benchmark.measure (variant + "-b" + suffix, iterations, [&](unsigned int) {
+				table.extrapolated_values (arguments.data(), values.data(), arguments.size());
+				sink = values[0];
+			});
+		}
+
+		Datatable2D<double, double> table (irregular);
+		double const min = table.domain().min();
+		double const span = table.domain().max() - min;
+
+		benchmark.measure ("arguments" + suffix, iterations, [&](unsigned int i) {
+			for (unsigned int k = 0; k < 100; ++k)
+				sink = table.arguments (((i + k) % 997) / 997.0 - 0.5).size();
+		});
+
+		benchmark.measure ("average" + suffix, iterations, [&](unsigned int i) {
+			for (unsigned int k = 0; k < 100; ++k)
+				sink = table.average ({ min, min + span * (1 + (i + k) % 996) / 997.0 });
+		});
+	}
+
+	static_cast<void> (sink);
+});
+
+} // namespace Benchmarks
+} // namespace Xefis
+
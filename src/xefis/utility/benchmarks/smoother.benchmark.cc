@@ -0,0 +1,117 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+// Standard:
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/benchmark/benchmark.h>
+#include <xefis/utility/dot_product.h>
+#include <xefis/utility/smoother.h>
+#include <xefis/utility/smoother_bank.h>
+
+
+namespace Xefis {
+namespace Benchmarks {
+
+/**
+ * Compare the portable and vectorized FIR kernels, the Smoother engines,
+ * and 4 separate Smoothers against a SmootherBank with 4 channels,
+ * for window sizes used by modules (25 ms … 5 s at 1 ms precision).
+ */
+static xf::Benchmark smoother ("utility/smoother", [](Benchmark& benchmark) {
+	std::vector<int> const window_sizes { 25, 100, 500, 2000, 5000 };
+	std::mt19937 rng (1);
+	std::uniform_real_distribution<double> noise (-1.0, 1.0);
+	double volatile sink = 0.0;
+
+	for (int size: window_sizes)
+	{
+		std::vector<double> a (size);
+		std::vector<double> b (size);
+		std::vector<double> w (size);
+		for (int i = 0; i < size; ++i)
+		{
+			a[i] = noise (rng);
+			b[i] = noise (rng);
+			w[i] = noise (rng);
+		}
+
+		std::string const suffix = "-" + std::to_string (size);
+		unsigned int const iterations = 20000000 / size;
+
+		benchmark.measure ("scalar" + suffix, iterations, [&](unsigned int) {
+			sink = detail::scalar_dot_product (a.data(), w.data(), a.size());
+		});
+
+		benchmark.measure ("simd" + suffix, iterations, [&](unsigned int) {
+			sink = dot_product (a.data(), w.data(), a.size());
+		});
+
+		benchmark.measure ("simd-pair" + suffix, iterations, [&](unsigned int) {
+			double x, y;
+			dot_products (a.data(), b.data(), w.data(), a.size(), x, y);
+			sink = x + y;
+		});
+
+		// Each process() call pushes 10 samples and computes the output once:
+		for (auto engine: { SmootherBase::Engine::FIR, SmootherBase::Engine::Recursive, SmootherBase::Engine::MultiResolution })
+		{
+			for (bool winding: { false, true })
+			{
+				Smoother<double> smoother (1_ms * size);
+				smoother.set_engine (engine);
+				if (winding)
+					smoother.set_winding ({ 0.0, 360.0 });
+
+				std::string variant = engine == SmootherBase::Engine::FIR ? "fir"
+					: engine == SmootherBase::Engine::Recursive ? "rec"
+					: "mr";
+				if (winding)
+					variant += "-wind";
+
+				benchmark.measure (variant + suffix, iterations, [&](unsigned int i) {
+					sink = smoother.process (180.0 + 90.0 * ((i % 7) / 7.0), 10_ms);
+				});
+			}
+		}
+
+		std::vector<Smoother<double>> separate (4, Smoother<double> (1_ms * size));
+
+		benchmark.measure ("separate-4" + suffix, iterations, [&](unsigned int i) {
+			for (auto& smoother: separate)
+				sink = smoother.process (180.0 + 90.0 * ((i % 7) / 7.0), 10_ms);
+		});
+
+		SmootherBank bank (1_ms * size);
+		for (std::size_t c = 0; c < separate.size(); ++c)
+			bank.add_channel();
+
+		benchmark.measure ("bank-4" + suffix, iterations, [&](unsigned int i) {
+			for (std::size_t c = 0; c < bank.channels_count(); ++c)
+				bank.set_sample (c, 180.0 + 90.0 * ((i % 7) / 7.0));
+			bank.process (10_ms);
+			sink = bank.value (0);
+		});
+	}
+
+	static_cast<void> (sink);
+});
+
+} // namespace Benchmarks
+} // namespace Xefis
+
@@ -16,19 +16,43 @@
 
 // Standard:
 #include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <map>
 #include <vector>
 
 // Xefis:
 #include <xefis/config/all.h>
 #include <xefis/utility/numeric.h>
-#include <xefis/utility/sequence.h>
 
 
 namespace Xefis {
 
+/**
+ * Piecewise-linear function defined by a set of argument-value points.
+ *
+ * Points are kept in flat arrays sorted by argument. If all arguments lie on
+ * a uniform grid, possibly finer than the spacing of the points themselves
+ * (eg. points at 0°, 2°, 5°, 6° lie on a 1° grid), the function is also resampled
+ * onto that grid at construction, so that lookups compute the grid index directly
+ * in O(1). Since all original points are grid nodes, resampling doesn't change
+ * the function. Otherwise lookups use binary search.
+ *
+ * Minimum and maximum values and the average over the whole domain are computed
+ * at construction. Monotonic runs of values are also precomputed, so that arguments()
+ * does a binary search in each run instead of scanning all points.
+ */
 template<class pArgument, class pValue>
 	class Datatable2D
 	{
+		// Maximum number of grid nodes relative to the number of points:
+		static constexpr std::size_t	kMaxGridNodesPerPoint	= 64;
+		// Maximum number of grid nodes:
+		static constexpr std::size_t	kMaxGridNodes			= 4096;
+		// Grid steps tried are the smallest argument spacing divided by 1…kMaxGridDivisor:
+		static constexpr std::size_t	kMaxGridDivisor			= 16;
+
 	  public:
 		typedef pArgument					Argument;
 		typedef pValue						Value;
@@ -62,6 +86,17 @@ template<class pArgument, class pValue>
 			{ }
 		};
 
+	  private:
+		/**
+		 * Range of point indices [first, last] where values are monotonic.
+		 */
+		struct MonotonicRun
+		{
+			std::size_t	first;
+			std::size_t	last;
+			bool		increasing;
+		};
+
 	  public:
 		/**
 		 * Create a data-table from argument-value points given in the map.
@@ -89,6 +124,15 @@ template<class pArgument, class pValue>
 		Value
 		extrapolated_value (Argument const&) const noexcept;
 
+		/**
+		 * Compute extrapolated_value() for @count arguments and store results in @values.
+		 * On a uniform grid the loop is branch-free, so that the compiler can vectorize it.
+		 * Otherwise the segment found for previous argument is tried first, so sweeps
+		 * over sorted arguments don't need binary search.
+		 */
+		void
+		extrapolated_values (Argument const* arguments, Value* values, std::size_t count) const noexcept;
+
 		/**
 		 * Return the point of minimum known argument.
 		 */
@@ -150,7 +194,31 @@ template<class pArgument, class pValue>
 		Value
 		average (Range<Argument> domain) const;
 
+		/**
+		 * Return true if lookups use a uniform grid.
+		 */
+		bool
+		uniform() const noexcept;
+
 	  private:
+		/**
+		 * Precompute lookup structures and statistics.
+		 */
+		void
+		initialize();
+
+		/**
+		 * Find uniform grid containing all arguments and resample the function onto it.
+		 */
+		void
+		initialize_grid();
+
+		/**
+		 * Find monotonic runs of values.
+		 */
+		void
+		initialize_runs();
+
 		/**
 		 * Return interpolated value.
 		 * Argument must be inside data-table domain.
@@ -158,31 +226,58 @@ template<class pArgument, class pValue>
 		Value
 		in_domain_value (Argument const&) const noexcept;
 
+		/**
+		 * Return interpolated value found with binary search.
+		 * Argument must be inside data-table domain.
+		 */
+		Value
+		searched_value (Argument const&) const noexcept;
+
+		/**
+		 * Return point at given index.
+		 */
+		Point
+		point (std::size_t index) const noexcept;
+
 	  private:
-		DataMap					_data_map;
-		mutable Optional<Point>	_cached_min_value;
-		mutable Optional<Point>	_cached_max_value;
+		std::vector<Argument>		_arguments;
+		std::vector<Value>			_values;
+		// Uniform grid, empty if not used:
+		std::vector<Value>			_grid_values;
+		Argument					_grid_min;
+		Argument					_grid_step;
+		std::vector<MonotonicRun>	_runs;
+		std::size_t					_min_value_index	= 0;
+		std::size_t					_max_value_index	= 0;
+		Value						_average;
 	};
 
 
 template<class A, class V>
 	inline
-	Datatable2D<A, V>::Datatable2D (DataMap const& map):
-		_data_map (map)
+	Datatable2D<A, V>::Datatable2D (DataMap const& map)
 	{
-		if (_data_map.empty())
+		if (map.empty())
 			throw EmptyDomainException();
+
+		_arguments.reserve (map.size());
+		_values.reserve (map.size());
+
+		for (auto const& pair: map)
+		{
+			_arguments.push_back (pair.first);
+			_values.push_back (pair.second);
+		}
+
+		initialize();
 	}
 
 
 template<class A, class V>
 	inline
 	Datatable2D<A, V>::Datatable2D (DataMap&& map):
-		_data_map (std::move (map))
-	{
-		if (_data_map.empty())
-			throw EmptyDomainException();
-	}
+		Datatable2D (static_cast<DataMap const&> (map))
+	{ }
 
 
 template<class A, class V>
@@ -190,8 +285,8 @@ template<class A, class V>
 	Datatable2D<A, V>::value (Argument const& argument) const noexcept
 	{
 		// Outside of domain?
-		if (argument < _data_map.begin()->first ||
-			argument > _data_map.rbegin()->first)
+		if (argument < _arguments.front() ||
+			argument > _arguments.back())
 		{
 			return { };
 		}
@@ -204,24 +299,63 @@ template<class A, class V>
 	inline typename Datatable2D<A, V>::Value
 	Datatable2D<A, V>::extrapolated_value (Argument const& argument) const noexcept
 	{
-		if (_data_map.size() == 1)
-			return _data_map.begin()->second;
-		else if (argument < domain().min())
+		std::size_t const n = _arguments.size();
+
+		if (n == 1)
+			return _values[0];
+		else if (argument < _arguments[0])
+			return xf::renormalize (argument, _arguments[0], _arguments[1], _values[0], _values[1]);
+		else if (argument > _arguments[n - 1])
+			return xf::renormalize (argument, _arguments[n - 1], _arguments[n - 2], _values[n - 1], _values[n - 2]);
+		else
+			return in_domain_value (argument);
+	}
+
+
+template<class A, class V>
+	inline void
+	Datatable2D<A, V>::extrapolated_values (Argument const* arguments, Value* values, std::size_t count) const noexcept
+	{
+		std::size_t const n = _arguments.size();
+
+		if (n == 1)
+			std::fill (values, values + count, _values[0]);
+		else if (!_grid_values.empty())
 		{
-			auto p0 = *_data_map.begin();
-			auto p1 = *(++_data_map.begin());
+			// Extrapolation uses the first and last grid intervals, which lie on the first and last segments:
+			double const last_interval = _grid_values.size() - 2;
+			Value const* grid = _grid_values.data();
+
+			for (std::size_t k = 0; k < count; ++k)
+			{
+				double const position = (arguments[k] - _grid_min) / _grid_step;
+				std::size_t const i = static_cast<std::size_t> (std::min (std::max (0.0, position), last_interval));
+				double const fraction = position - i;
 
-			return xf::renormalize (argument, p0.first, p1.first, p0.second, p1.second);
+				values[k] = grid[i] + fraction * (grid[i + 1] - grid[i]);
+			}
 		}
-		else if (argument > domain().max())
+		else
 		{
-			auto p0 = *_data_map.rbegin();
-			auto p1 = *(++_data_map.rbegin());
+			std::size_t b = 1;
+
+			for (std::size_t k = 0; k < count; ++k)
+			{
+				Argument const& argument = arguments[k];
+
+				if (!(_arguments[b - 1] <= argument && argument <= _arguments[b]))
+				{
+					if (argument < _arguments[0])
+						b = 1;
+					else if (argument > _arguments[n - 1])
+						b = n - 1;
+					else
+						b = std::lower_bound (_arguments.begin() + 1, _arguments.end() - 1, argument) - _arguments.begin();
+				}
 
-			return xf::renormalize (argument, p0.first, p1.first, p0.second, p1.second);
+				values[k] = renormalize (argument, _arguments[b - 1], _arguments[b], _values[b - 1], _values[b]);
+			}
 		}
-		else
-			return in_domain_value (argument);
 	}
 
 
@@ -229,7 +363,7 @@ template<class A, class V>
 	inline typename Datatable2D<A, V>::Point
 	Datatable2D<A, V>::min_argument() const noexcept
 	{
-		return { _data_map.begin()->first, _data_map.begin()->second };
+		return point (0);
 	}
 
 
@@ -237,7 +371,7 @@ template<class A, class V>
 	inline typename Datatable2D<A, V>::Point
 	Datatable2D<A, V>::max_argument() const noexcept
 	{
-		return { _data_map.rbegin()->first, _data_map.rbegin()->second };
+		return point (_arguments.size() - 1);
 	}
 
 
@@ -245,16 +379,7 @@ template<class A, class V>
 	inline typename Datatable2D<A, V>::Point
 	Datatable2D<A, V>::min_value() const noexcept
 	{
-		if (!_cached_min_value)
-		{
-			auto min = _data_map.begin();
-			for (auto i = min; i != _data_map.end(); ++i)
-				if (i->second < min->second)
-					min = i;
-			_cached_min_value = Point { min->first, min->second };
-		}
-
-		return *_cached_min_value;
+		return point (_min_value_index);
 	}
 
 
@@ -262,16 +387,7 @@ template<class A, class V>
 	inline typename Datatable2D<A, V>::Point
 	Datatable2D<A, V>::max_value() const noexcept
 	{
-		if (!_cached_max_value)
-		{
-			auto max = _data_map.begin();
-			for (auto i = max; i != _data_map.end(); ++i)
-				if (i->second > max->second)
-					max = i;
-			_cached_max_value = Point { max->first, max->second };
-		}
-
-		return *_cached_max_value;
+		return point (_max_value_index);
 	}
 
 
@@ -279,7 +395,7 @@ template<class A, class V>
 	inline Range<typename Datatable2D<A, V>::Argument>
 	Datatable2D<A, V>::domain() const noexcept
 	{
-		return { min_argument().argument, max_argument().argument };
+		return { _arguments.front(), _arguments.back() };
 	}
 
 
@@ -287,7 +403,7 @@ template<class A, class V>
 	inline Range<typename Datatable2D<A, V>::Value>
 	Datatable2D<A, V>::codomain() const noexcept
 	{
-		return { min_value().value, max_value().value };
+		return { _values[_min_value_index], _values[_max_value_index] };
 	}
 
 
@@ -303,49 +419,43 @@ template<class A, class V>
 	inline std::vector<typename Datatable2D<A, V>::Point>
 	Datatable2D<A, V>::arguments (Value const& value, Range<Argument> search_domain) const
 	{
-		if (_data_map.size() >= 2)
-		{
-			std::vector<Point> result;
-			auto a = std::begin (_data_map);
-			auto b = a;
-			++b;
-
-			// Handle the smallest argument in the domain:
-			if (value == a->second && search_domain.includes (a->first))
-				result.emplace_back (a->first, a->second);
-
-			// Find range [a, b] such that @value fits into it.
-			// Linearly interpolate the argument.
-			for (; b != std::end (_data_map); ++a, ++b)
-			{
-				auto const val_a = a->second;
-				auto const val_b = b->second;
+		std::vector<Point> result;
 
-				if ((val_a < value && value <= val_b) || (val_b <= value && value < val_a))
-				{
-					auto const arg_a = a->first;
-					auto const arg_b = b->first;
+		// Handle the smallest argument in the domain:
+		if (value == _values[0] && search_domain.includes (_arguments[0]))
+			result.emplace_back (_arguments[0], _values[0]);
 
-					auto const arg = xf::renormalize (value, val_a, val_b, arg_a, arg_b);
+		// In each run find segment [a, b] such that @value fits into it
+		// (val_a < value <= val_b for increasing values, val_b <= value < val_a for decreasing).
+		// Linearly interpolate the argument.
+		for (auto const& run: _runs)
+		{
+			auto const first = _values.begin() + run.first;
+			auto const last = _values.begin() + run.last + 1;
+			std::size_t b;
 
-					if (search_domain.includes (arg))
-						result.emplace_back (arg, value);
-				}
+			if (run.increasing)
+			{
+				if (!(_values[run.first] < value && value <= _values[run.last]))
+					continue;
+				b = std::lower_bound (first, last, value) - _values.begin();
+			}
+			else
+			{
+				if (!(_values[run.last] <= value && value < _values[run.first]))
+					continue;
+				// First val_b <= value:
+				b = std::lower_bound (first, last, value, std::greater<Value>()) - _values.begin();
 			}
 
-			return result;
-		}
-		else if (_data_map.size() == 1)
-		{
-			auto item = *_data_map.begin();
+			std::size_t const a = b - 1;
+			auto const arg = xf::renormalize (value, _values[a], _values[b], _arguments[a], _arguments[b]);
 
-			if (item.second == value && search_domain.includes (item.first))
-				return { Point { item.first, item.second } };
-			else
-				return { };
+			if (search_domain.includes (arg))
+				result.emplace_back (arg, value);
 		}
-		else
-			return { };
+
+		return result;
 	}
 
 
@@ -353,7 +463,7 @@ template<class A, class V>
 	inline typename Datatable2D<A, V>::Value
 	Datatable2D<A, V>::average() const
 	{
-		return average (domain());
+		return _average;
 	}
 
 
@@ -361,18 +471,18 @@ template<class A, class V>
 	inline typename Datatable2D<A, V>::Value
 	Datatable2D<A, V>::average (Range<Argument> search_domain) const
 	{
-		if (_data_map.size() > 1)
+		std::size_t const n = _arguments.size();
+
+		if (n > 1)
 		{
-			Range<std::pair<Argument, Value>> search_domain_2 {
-				std::make_pair (search_domain.min(), Value()),
-				std::make_pair (search_domain.max(), Value()),
-			};
-			auto it_range = find_range_exclusive (_data_map.begin(), _data_map.end(), search_domain_2,
-												  [](auto const& a, auto const& b) { return a.first < b.first; });
-
-			// If there's at least one iterator in range:
-			if (it_range.first != _data_map.end())
+			// First argument greater than search_domain.min() and first argument not less than search_domain.max():
+			std::size_t first = std::upper_bound (_arguments.begin(), _arguments.end(), search_domain.min()) - _arguments.begin();
+
+			// If there's at least one point in range:
+			if (first != n)
 			{
+				std::size_t last = std::lower_bound (_arguments.begin() + first, _arguments.end(), search_domain.max()) - _arguments.begin();
+
 				typedef decltype (std::declval<Argument>() / std::declval<Argument>()) WeightType;
 				Value total_avg = Value (0);
 				WeightType total_weight = 0;
@@ -386,29 +496,15 @@ template<class A, class V>
 					total_weight += weight;
 				};
 
-				// Compute average value from domain.min() to first iterator:
-				{
-					auto iterator = it_range.first;
-					update_average (search_domain.min(), iterator->first, extrapolated_value (search_domain.min()), iterator->second);
-				}
+				// Compute average value from domain.min() to first point:
+				update_average (search_domain.min(), _arguments[first], extrapolated_value (search_domain.min()), _values[first]);
 
-				// Compute average values between iterators:
-				{
-					auto a = it_range.first;
-					auto b = a;
-					++b;
+				// Compute average values between points:
+				for (std::size_t b = first + 1; b < last; ++b)
+					update_average (_arguments[b - 1], _arguments[b], _values[b - 1], _values[b]);
 
-					for (; b != it_range.second; ++a, ++b)
-						update_average (a->first, b->first, a->second, b->second);
-				}
-
-				// Compute average value from (last iterator - 1) to search_domain.max():
-				{
-					auto iterator = it_range.second;
-					--iterator;
-
-					update_average (iterator->first, search_domain.max(), iterator->second, extrapolated_value (search_domain.max()));
-				}
+				// Compute average value from (last point - 1) to search_domain.max():
+				update_average (_arguments[last - 1], search_domain.max(), _values[last - 1], extrapolated_value (search_domain.max()));
 
 				return total_avg / total_weight;
 			}
@@ -419,7 +515,104 @@ template<class A, class V>
 			}
 		}
 		else
-			return _data_map.begin()->second;
+			return _values[0];
+	}
+
+
+template<class A, class V>
+	inline bool
+	Datatable2D<A, V>::uniform() const noexcept
+	{
+		return !_grid_values.empty();
+	}
+
+
+template<class A, class V>
+	inline void
+	Datatable2D<A, V>::initialize()
+	{
+		for (std::size_t i = 1; i < _values.size(); ++i)
+		{
+			if (_values[i] < _values[_min_value_index])
+				_min_value_index = i;
+			if (_values[i] > _values[_max_value_index])
+				_max_value_index = i;
+		}
+
+		initialize_grid();
+		initialize_runs();
+		_average = average (domain());
+	}
+
+
+template<class A, class V>
+	inline void
+	Datatable2D<A, V>::initialize_grid()
+	{
+		std::size_t const n = _arguments.size();
+
+		if (n < 2)
+			return;
+
+		Argument min_spacing = _arguments[1] - _arguments[0];
+		for (std::size_t i = 2; i < n; ++i)
+			min_spacing = std::min (min_spacing, _arguments[i] - _arguments[i - 1]);
+
+		Argument const span = _arguments[n - 1] - _arguments[0];
+		std::size_t const max_nodes = std::min (kMaxGridNodes, kMaxGridNodesPerPoint * n);
+
+		for (std::size_t divisor = 1; divisor <= kMaxGridDivisor; ++divisor)
+		{
+			Argument const step = min_spacing / static_cast<double> (divisor);
+			double const intervals = std::round (span / step);
+
+			if (!(intervals + 1 <= max_nodes))
+				break;
+
+			bool on_grid = true;
+			for (std::size_t i = 1; i < n && on_grid; ++i)
+			{
+				double const position = (_arguments[i] - _arguments[0]) / step;
+				on_grid = std::abs (position - std::round (position)) < 1e-6;
+			}
+
+			if (on_grid)
+			{
+				std::size_t const nodes = static_cast<std::size_t> (intervals) + 1;
+				_grid_min = _arguments[0];
+				// Make the last node match the last argument exactly:
+				_grid_step = span / intervals;
+				_grid_values.resize (nodes);
+
+				for (std::size_t k = 0; k < nodes; ++k)
+					_grid_values[k] = searched_value (std::min (_grid_min + _grid_step * static_cast<double> (k), _arguments[n - 1]));
+
+				return;
+			}
+		}
+	}
+
+
+template<class A, class V>
+	inline void
+	Datatable2D<A, V>::initialize_runs()
+	{
+		std::size_t const n = _values.size();
+
+		for (std::size_t b = 1; b < n; ++b)
+		{
+			Value const val_a = _values[b - 1];
+			Value const val_b = _values[b];
+
+			// Flat segments never match in arguments(), attach them to the current run:
+			if (!_runs.empty() && _runs.back().last == b - 1 &&
+				(val_a == val_b || _runs.back().increasing == (val_a < val_b)))
+			{
+				_runs.back().last = b;
+			}
+			else
+				_runs.push_back ({ b - 1, b, val_a < val_b });
+		}
 	}
 
 
@@ -427,13 +620,38 @@ template<class A, class V>
 	inline typename Datatable2D<A, V>::Value
 	Datatable2D<A, V>::in_domain_value (Argument const& argument) const noexcept
 	{
-		auto range = extended_adjacent_find (_data_map.begin(), _data_map.end(), argument,
-											 [](auto pair) { return pair.first; });
+		if (_grid_values.empty())
+			return searched_value (argument);
 
-		Range<Argument> from { range.first->first, range.second->first };
-		Range<Value> to { range.first->second, range.second->second };
+		double const position = (argument - _grid_min) / _grid_step;
+		std::size_t const last_interval = _grid_values.size() - 2;
+		std::size_t const i = position > 0.0 ? std::min (static_cast<std::size_t> (position), last_interval) : 0;
+		double const fraction = position - i;
 
-		return renormalize (argument, from, to);
+		return _grid_values[i] + fraction * (_grid_values[i + 1] - _grid_values[i]);
+	}
+
+
+template<class A, class V>
+	inline typename Datatable2D<A, V>::Value
+	Datatable2D<A, V>::searched_value (Argument const& argument) const noexcept
+	{
+		if (_arguments.size() == 1)
+			return _values[0];
+
+		// First argument not less than @argument, but at least the second one:
+		std::size_t b = std::lower_bound (_arguments.begin() + 1, _arguments.end() - 1, argument) - _arguments.begin();
+		std::size_t a = b - 1;
+
+		return renormalize (argument, _arguments[a], _arguments[b], _values[a], _values[b]);
+	}
+
+
+template<class A, class V>
+	inline typename Datatable2D<A, V>::Point
+	Datatable2D<A, V>::point (std::size_t index) const noexcept
+	{
+		return { _arguments[index], _values[index] };
 	}
 
 } // namespace Xefis
@@ -0,0 +1,391 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+// Standard:
+#include <cstddef>
+
+// System:
+#if defined(__AVX__)
+# include <immintrin.h>
+#elif defined(__SSE2__)
+# include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+# include <arm_neon.h>
+#endif
+
+// Xefis:
+#include <xefis/config/all.h>
+
+// Local:
+#include "dot_product.h"
+
+
+namespace Xefis {
+
+#if defined(__AVX__)
+
+namespace {
+
+inline __m256d
+multiply_add (__m256d a, __m256d b, __m256d sum) noexcept
+{
+# if defined(__FMA__)
+	return _mm256_fmadd_pd (a, b, sum);
+# else
+	return _mm256_add_pd (sum, _mm256_mul_pd (a, b));
+# endif
+}
+
+
+inline double
+horizontal_sum (__m256d v) noexcept
+{
+	__m128d s = _mm_add_pd (_mm256_castpd256_pd128 (v), _mm256_extractf128_pd (v, 1));
+	return _mm_cvtsd_f64 (_mm_add_sd (s, _mm_unpackhi_pd (s, s)));
+}
+
+} // namespace
+
+
+double
+dot_product (double const* a, double const* b, std::size_t n) noexcept
+{
+	__m256d s0 = _mm256_setzero_pd();
+	__m256d s1 = _mm256_setzero_pd();
+	std::size_t i = 0;
+
+	for (; i + 8 <= n; i += 8)
+	{
+		s0 = multiply_add (_mm256_loadu_pd (a + i), _mm256_loadu_pd (b + i), s0);
+		s1 = multiply_add (_mm256_loadu_pd (a + i + 4), _mm256_loadu_pd (b + i + 4), s1);
+	}
+
+	double result = horizontal_sum (_mm256_add_pd (s0, s1));
+	return result + detail::scalar_dot_product (a + i, b + i, n - i);
+}
+
+
+void
+dot_products (double const* a, double const* b, double const* w, std::size_t n, double& aw, double& bw) noexcept
+{
+	__m256d sa = _mm256_setzero_pd();
+	__m256d sb = _mm256_setzero_pd();
+	std::size_t i = 0;
+
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d vw = _mm256_loadu_pd (w + i);
+		sa = multiply_add (_mm256_loadu_pd (a + i), vw, sa);
+		sb = multiply_add (_mm256_loadu_pd (b + i), vw, sb);
+	}
+
+	detail::scalar_dot_products (a + i, b + i, w + i, n - i, aw, bw);
+	aw += horizontal_sum (sa);
+	bw += horizontal_sum (sb);
+}
+
+
+void
+column_dot_products (double const* rows, double const* w, std::size_t n, std::size_t columns, double* result) noexcept
+{
+	std::size_t c = 0;
+
+	// Blocks of 8 columns, two rows at a time, to keep 4 independent accumulators:
+	for (; c + 8 <= columns; c += 8)
+	{
+		__m256d s0 = _mm256_setzero_pd();
+		__m256d s1 = _mm256_setzero_pd();
+		__m256d s2 = _mm256_setzero_pd();
+		__m256d s3 = _mm256_setzero_pd();
+		std::size_t i = 0;
+
+		for (; i + 2 <= n; i += 2)
+		{
+			double const* r0 = rows + i * columns + c;
+			double const* r1 = r0 + columns;
+			__m256d w0 = _mm256_set1_pd (w[i]);
+			__m256d w1 = _mm256_set1_pd (w[i + 1]);
+			s0 = multiply_add (_mm256_loadu_pd (r0), w0, s0);
+			s1 = multiply_add (_mm256_loadu_pd (r0 + 4), w0, s1);
+			s2 = multiply_add (_mm256_loadu_pd (r1), w1, s2);
+			s3 = multiply_add (_mm256_loadu_pd (r1 + 4), w1, s3);
+		}
+
+		if (i < n)
+		{
+			double const* r0 = rows + i * columns + c;
+			__m256d w0 = _mm256_set1_pd (w[i]);
+			s0 = multiply_add (_mm256_loadu_pd (r0), w0, s0);
+			s1 = multiply_add (_mm256_loadu_pd (r0 + 4), w0, s1);
+		}
+
+		_mm256_storeu_pd (result + c, _mm256_add_pd (s0, s2));
+		_mm256_storeu_pd (result + c + 4, _mm256_add_pd (s1, s3));
+	}
+
+	for (; c + 4 <= columns; c += 4)
+	{
+		__m256d s0 = _mm256_setzero_pd();
+		__m256d s1 = _mm256_setzero_pd();
+		std::size_t i = 0;
+
+		for (; i + 2 <= n; i += 2)
+		{
+			s0 = multiply_add (_mm256_loadu_pd (rows + i * columns + c), _mm256_set1_pd (w[i]), s0);
+			s1 = multiply_add (_mm256_loadu_pd (rows + (i + 1) * columns + c), _mm256_set1_pd (w[i + 1]), s1);
+		}
+
+		if (i < n)
+			s0 = multiply_add (_mm256_loadu_pd (rows + i * columns + c), _mm256_set1_pd (w[i]), s0);
+
+		_mm256_storeu_pd (result + c, _mm256_add_pd (s0, s1));
+	}
+
+	detail::scalar_column_dot_products (rows + c, w, n, columns, columns - c, result + c);
+}
+
+#elif defined(__SSE2__)
+
+namespace {
+
+inline double
+horizontal_sum (__m128d v) noexcept
+{
+	return _mm_cvtsd_f64 (_mm_add_sd (v, _mm_unpackhi_pd (v, v)));
+}
+
+} // namespace
+
+
+double
+dot_product (double const* a, double const* b, std::size_t n) noexcept
+{
+	__m128d s0 = _mm_setzero_pd();
+	__m128d s1 = _mm_setzero_pd();
+	std::size_t i = 0;
+
+	for (; i + 4 <= n; i += 4)
+	{
+		s0 = _mm_add_pd (s0, _mm_mul_pd (_mm_loadu_pd (a + i), _mm_loadu_pd (b + i)));
+		s1 = _mm_add_pd (s1, _mm_mul_pd (_mm_loadu_pd (a + i + 2), _mm_loadu_pd (b + i + 2)));
+	}
+
+	double result = horizontal_sum (_mm_add_pd (s0, s1));
+	return result + detail::scalar_dot_product (a + i, b + i, n - i);
+}
+
+
+void
+dot_products (double const* a, double const* b, double const* w, std::size_t n, double& aw, double& bw) noexcept
+{
+	__m128d sa = _mm_setzero_pd();
+	__m128d sb = _mm_setzero_pd();
+	std::size_t i = 0;
+
+	for (; i + 2 <= n; i += 2)
+	{
+		__m128d vw = _mm_loadu_pd (w + i);
+		sa = _mm_add_pd (sa, _mm_mul_pd (_mm_loadu_pd (a + i), vw));
+		sb = _mm_add_pd (sb, _mm_mul_pd (_mm_loadu_pd (b + i), vw));
+	}
+
+	detail::scalar_dot_products (a + i, b + i, w + i, n - i, aw, bw);
+	aw += horizontal_sum (sa);
+	bw += horizontal_sum (sb);
+}
+
+
+void
+column_dot_products (double const* rows, double const* w, std::size_t n, std::size_t columns, double* result) noexcept
+{
+	std::size_t c = 0;
+
+	// Blocks of 4 columns, two rows at a time, to keep 4 independent accumulators:
+	for (; c + 4 <= columns; c += 4)
+	{
+		__m128d s0 = _mm_setzero_pd();
+		__m128d s1 = _mm_setzero_pd();
+		__m128d s2 = _mm_setzero_pd();
+		__m128d s3 = _mm_setzero_pd();
+		std::size_t i = 0;
+
+		for (; i + 2 <= n; i += 2)
+		{
+			double const* r0 = rows + i * columns + c;
+			double const* r1 = r0 + columns;
+			__m128d w0 = _mm_set1_pd (w[i]);
+			__m128d w1 = _mm_set1_pd (w[i + 1]);
+			s0 = _mm_add_pd (s0, _mm_mul_pd (_mm_loadu_pd (r0), w0));
+			s1 = _mm_add_pd (s1, _mm_mul_pd (_mm_loadu_pd (r0 + 2), w0));
+			s2 = _mm_add_pd (s2, _mm_mul_pd (_mm_loadu_pd (r1), w1));
+			s3 = _mm_add_pd (s3, _mm_mul_pd (_mm_loadu_pd (r1 + 2), w1));
+		}
+
+		if (i < n)
+		{
+			double const* r0 = rows + i * columns + c;
+			__m128d w0 = _mm_set1_pd (w[i]);
+			s0 = _mm_add_pd (s0, _mm_mul_pd (_mm_loadu_pd (r0), w0));
+			s1 = _mm_add_pd (s1, _mm_mul_pd (_mm_loadu_pd (r0 + 2), w0));
+		}
+
+		_mm_storeu_pd (result + c, _mm_add_pd (s0, s2));
+		_mm_storeu_pd (result + c + 2, _mm_add_pd (s1, s3));
+	}
+
+	for (; c + 2 <= columns; c += 2)
+	{
+		__m128d s0 = _mm_setzero_pd();
+		__m128d s1 = _mm_setzero_pd();
+		std::size_t i = 0;
+
+		for (; i + 2 <= n; i += 2)
+		{
+			s0 = _mm_add_pd (s0, _mm_mul_pd (_mm_loadu_pd (rows + i * columns + c), _mm_set1_pd (w[i])));
+			s1 = _mm_add_pd (s1, _mm_mul_pd (_mm_loadu_pd (rows + (i + 1) * columns + c), _mm_set1_pd (w[i + 1])));
+		}
+
+		if (i < n)
+			s0 = _mm_add_pd (s0, _mm_mul_pd (_mm_loadu_pd (rows + i * columns + c), _mm_set1_pd (w[i])));
+
+		_mm_storeu_pd (result + c, _mm_add_pd (s0, s1));
+	}
+
+	detail::scalar_column_dot_products (rows + c, w, n, columns, columns - c, result + c);
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+double
+dot_product (double const* a, double const* b, std::size_t n) noexcept
+{
+	float64x2_t s0 = vdupq_n_f64 (0.0);
+	float64x2_t s1 = vdupq_n_f64 (0.0);
+	std::size_t i = 0;
+
+	for (; i + 4 <= n; i += 4)
+	{
+		s0 = vfmaq_f64 (s0, vld1q_f64 (a + i), vld1q_f64 (b + i));
+		s1 = vfmaq_f64 (s1, vld1q_f64 (a + i + 2), vld1q_f64 (b + i + 2));
+	}
+
+	double result = vaddvq_f64 (vaddq_f64 (s0, s1));
+	return result + detail::scalar_dot_product (a + i, b + i, n - i);
+}
+
+
+void
+dot_products (double const* a, double const* b, double const* w, std::size_t n, double& aw, double& bw) noexcept
+{
+	float64x2_t sa = vdupq_n_f64 (0.0);
+	float64x2_t sb = vdupq_n_f64 (0.0);
+	std::size_t i = 0;
+
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t vw = vld1q_f64 (w + i);
+		sa = vfmaq_f64 (sa, vld1q_f64 (a + i), vw);
+		sb = vfmaq_f64 (sb, vld1q_f64 (b + i), vw);
+	}
+
+	detail::scalar_dot_products (a + i, b + i, w + i, n - i, aw, bw);
+	aw += vaddvq_f64 (sa);
+	bw += vaddvq_f64 (sb);
+}
+
+
+void
+column_dot_products (double const* rows, double const* w, std::size_t n, std::size_t columns, double* result) noexcept
+{
+	std::size_t c = 0;
+
+	// Blocks of 4 columns, two rows at a time, to keep 4 independent accumulators:
+	for (; c + 4 <= columns; c += 4)
+	{
+		float64x2_t s0 = vdupq_n_f64 (0.0);
+		float64x2_t s1 = vdupq_n_f64 (0.0);
+		float64x2_t s2 = vdupq_n_f64 (0.0);
+		float64x2_t s3 = vdupq_n_f64 (0.0);
+		std::size_t i = 0;
+
+		for (; i + 2 <= n; i += 2)
+		{
+			double const* r0 = rows + i * columns + c;
+			double const* r1 = r0 + columns;
+			s0 = vfmaq_n_f64 (s0, vld1q_f64 (r0), w[i]);
+			s1 = vfmaq_n_f64 (s1, vld1q_f64 (r0 + 2), w[i]);
+			s2 = vfmaq_n_f64 (s2, vld1q_f64 (r1), w[i + 1]);
+			s3 = vfmaq_n_f64 (s3, vld1q_f64 (r1 + 2), w[i + 1]);
+		}
+
+		if (i < n)
+		{
+			double const* r0 = rows + i * columns + c;
+			s0 = vfmaq_n_f64 (s0, vld1q_f64 (r0), w[i]);
+			s1 = vfmaq_n_f64 (s1, vld1q_f64 (r0 + 2), w[i]);
+		}
+
+		vst1q_f64 (result + c, vaddq_f64 (s0, s2));
+		vst1q_f64 (result + c + 2, vaddq_f64 (s1, s3));
+	}
+
+	for (; c + 2 <= columns; c += 2)
+	{
+		float64x2_t s0 = vdupq_n_f64 (0.0);
+		float64x2_t s1 = vdupq_n_f64 (0.0);
+		std::size_t i = 0;
+
+		for (; i + 2 <= n; i += 2)
+		{
+			s0 = vfmaq_n_f64 (s0, vld1q_f64 (rows + i * columns + c), w[i]);
+			s1 = vfmaq_n_f64 (s1, vld1q_f64 (rows + (i + 1) * columns + c), w[i + 1]);
+		}
+
+		if (i < n)
+			s0 = vfmaq_n_f64 (s0, vld1q_f64 (rows + i * columns + c), w[i]);
+
+		vst1q_f64 (result + c, vaddq_f64 (s0, s1));
+	}
+
+	detail::scalar_column_dot_products (rows + c, w, n, columns, columns - c, result + c);
+}
+
+#else
+
+// 32-bit ARM NEON has no double-precision vector operations, so ARMv6/ARMv7 targets
+// end up here too:
+
+double
+dot_product (double const* a, double const* b, std::size_t n) noexcept
+{
+	return detail::scalar_dot_product (a, b, n);
+}
+
+
+void
+dot_products (double const* a, double const* b, double const* w, std::size_t n, double& aw, double& bw) noexcept
+{
+	detail::scalar_dot_products (a, b, w, n, aw, bw);
+}
+
+
+void
+column_dot_products (double const* rows, double const* w, std::size_t n, std::size_t columns, double* result) noexcept
+{
+	detail::scalar_column_dot_products (rows, w, n, columns, columns, result);
+}
+
+#endif
+
+} // namespace Xefis
+
@@ -0,0 +1,190 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+#ifndef XEFIS__UTILITY__DOT_PRODUCT_H__INCLUDED
+#define XEFIS__UTILITY__DOT_PRODUCT_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+
+// Xefis:
+#include <xefis/config/all.h>
+
+
+namespace Xefis {
+
+namespace detail {
+
+/**
+ * Portable implementation of dot_product().
+ * Uses several accumulators to break the dependency chain between additions.
+ */
+template<class Value>
+	inline Value
+	scalar_dot_product (Value const* a, Value const* b, std::size_t n) noexcept
+	{
+		Value s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+		std::size_t i = 0;
+
+		for (; i + 4 <= n; i += 4)
+		{
+			s0 += a[i + 0] * b[i + 0];
+			s1 += a[i + 1] * b[i + 1];
+			s2 += a[i + 2] * b[i + 2];
+			s3 += a[i + 3] * b[i + 3];
+		}
+
+		for (; i < n; ++i)
+			s0 += a[i] * b[i];
+
+		return (s0 + s1) + (s2 + s3);
+	}
+
+
+/**
+ * Portable implementation of dot_products().
+ */
+template<class Value>
+	inline void
+	scalar_dot_products (Value const* a, Value const* b, Value const* w, std::size_t n, Value& aw, Value& bw) noexcept
+	{
+		Value a0 = 0.0, a1 = 0.0, b0 = 0.0, b1 = 0.0;
+		std::size_t i = 0;
+
+		for (; i + 2 <= n; i += 2)
+		{
+			a0 += a[i + 0] * w[i + 0];
+			a1 += a[i + 1] * w[i + 1];
+			b0 += b[i + 0] * w[i + 0];
+			b1 += b[i + 1] * w[i + 1];
+		}
+
+		for (; i < n; ++i)
+		{
+			a0 += a[i] * w[i];
+			b0 += b[i] * w[i];
+		}
+
+		aw = a0 + a1;
+		bw = b0 + b1;
+	}
+
+
+/**
+ * Portable implementation of column_dot_products().
+ * Computes results for first @columns columns of a matrix with @stride elements per row.
+ */
+template<class Value>
+	inline void
+	scalar_column_dot_products (Value const* rows, Value const* w, std::size_t n, std::size_t stride, std::size_t columns, Value* result) noexcept
+	{
+		for (std::size_t c = 0; c < columns; ++c)
+			result[c] = 0.0;
+
+		for (std::size_t i = 0; i < n; ++i)
+			for (std::size_t c = 0; c < columns; ++c)
+				result[c] += rows[i * stride + c] * w[i];
+	}
+
+} // namespace detail
+
+
+/**
+ * Return sum of a[i] for i in [0, n).
+ * Like dot_product(), uses several accumulators, so the order of additions is unspecified.
+ */
+template<class Value>
+	inline Value
+	vector_sum (Value const* a, std::size_t n) noexcept
+	{
+		Value s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+		std::size_t i = 0;
+
+		for (; i + 4 <= n; i += 4)
+		{
+			s0 += a[i + 0];
+			s1 += a[i + 1];
+			s2 += a[i + 2];
+			s3 += a[i + 3];
+		}
+
+		for (; i < n; ++i)
+			s0 += a[i];
+
+		return (s0 + s1) + (s2 + s3);
+	}
+
+
+/**
+ * Return sum of a[i] * b[i] for i in [0, n).
+ * Order of additions is unspecified, so results may differ from a sequential sum
+ * in the last bits.
+ */
+template<class Value>
+	inline Value
+	dot_product (Value const* a, Value const* b, std::size_t n) noexcept
+	{
+		return detail::scalar_dot_product (a, b, n);
+	}
+
+
+/**
+ * Vectorized version for doubles (AVX, SSE2 or AArch64 NEON, depending on
+ * target architecture).
+ */
+double
+dot_product (double const* a, double const* b, std::size_t n) noexcept;
+
+
+/**
+ * Compute dot products of @a and @b with the same vector @w in one pass,
+ * so that @w is loaded only once. Results are stored in @aw and @bw.
+ */
+template<class Value>
+	inline void
+	dot_products (Value const* a, Value const* b, Value const* w, std::size_t n, Value& aw, Value& bw) noexcept
+	{
+		detail::scalar_dot_products (a, b, w, n, aw, bw);
+	}
+
+
+/**
+ * Vectorized version for doubles.
+ */
+void
+dot_products (double const* a, double const* b, double const* w, std::size_t n, double& aw, double& bw) noexcept;
+
+
+/**
+ * Compute dot products of each column of row-major matrix @rows (@n rows, @columns
+ * columns) with vector @w, so that result[c] = Σ rows[i · columns + c] · w[i].
+ * Used to compute many windowed sums over histories stored as structure of arrays.
+ */
+template<class Value>
+	inline void
+	column_dot_products (Value const* rows, Value const* w, std::size_t n, std::size_t columns, Value* result) noexcept
+	{
+		detail::scalar_column_dot_products (rows, w, n, columns, columns, result);
+	}
+
+
+/**
+ * Vectorized version for doubles.
+ */
+void
+column_dot_products (double const* rows, double const* w, std::size_t n, std::size_t columns, double* result) noexcept;
+
+} // namespace Xefis
+
+#endif
+
@@ -0,0 +1,104 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+// Standard:
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/core/stdexcept.h>
+#include <xefis/utility/numeric.h>
+
+// Local:
+#include "geo_tile_grid.h"
+
+
+namespace Xefis {
+
+GeoTileGrid::GeoTileGrid (Angle tile_size):
+	_tile_size_deg (tile_size.quantity<Degree>())
+{
+	double const rows = 180.0 / _tile_size_deg;
+
+	if (!(_tile_size_deg > 0.0) || std::abs (rows - std::round (rows)) > 1e-9)
+		throw InvalidCall ("tile size must divide 180°");
+
+	_rows = std::round (rows);
+	_columns = 2 * _rows;
+}
+
+
+std::vector<GeoTileGrid::TileID>
+GeoTileGrid::tiles_within (LonLat const& center, Angle radius) const
+{
+	// Small margin for rounding errors, so that tiles touching the cap are never missed:
+	double const margin_deg = 1e-6;
+	double const radius_deg = std::abs (radius.quantity<Degree>()) + margin_deg;
+	double const lat_deg = center.lat().quantity<Degree>();
+	double const lon_deg = center.lon().quantity<Degree>();
+
+	std::vector<TileID> result;
+
+	unsigned int const row_0 = row_of (lat_deg - radius_deg);
+	unsigned int const row_1 = row_of (lat_deg + radius_deg);
+	unsigned int column_0 = 0;
+	unsigned int columns = _columns;
+
+	// If the cap contains a pole, it spans all longitudes. Otherwise its
+	// longitude half-width is asin (sin radius / cos lat):
+	if (lat_deg + radius_deg < 90.0 && lat_deg - radius_deg > -90.0)
+	{
+		double const sin_radius = std::sin ((1_deg * radius_deg).quantity<Radian>());
+		double const cos_lat = std::cos ((1_deg * lat_deg).quantity<Radian>());
+		double const half_width_deg = (1_rad * std::asin (sin_radius / cos_lat)).quantity<Degree>() + margin_deg;
+
+		if (half_width_deg < 180.0)
+		{
+			double const west_deg = lon_deg - half_width_deg;
+			double const east_deg = lon_deg + half_width_deg;
+			column_0 = column_of (west_deg);
+			// Count columns from the western one, possibly wrapping around the antimeridian:
+			double const first_column_west_deg = std::floor ((west_deg + 180.0) / _tile_size_deg) * _tile_size_deg - 180.0;
+			columns = std::min<unsigned int> (_columns, std::floor ((east_deg - first_column_west_deg) / _tile_size_deg) + 1);
+		}
+	}
+
+	result.reserve ((row_1 - row_0 + 1) * columns);
+
+	for (unsigned int row = row_0; row <= row_1; ++row)
+		for (unsigned int c = 0; c < columns; ++c)
+			result.push_back (row * _columns + (column_0 + c) % _columns);
+
+	return result;
+}
+
+
+unsigned int
+GeoTileGrid::row_of (double lat_deg) const noexcept
+{
+	double const row = std::floor ((lat_deg + 90.0) / _tile_size_deg);
+	return limit<double> (row, 0.0, _rows - 1);
+}
+
+
+unsigned int
+GeoTileGrid::column_of (double lon_deg) const noexcept
+{
+	double const column = std::floor (floored_mod (lon_deg + 180.0, 360.0) / _tile_size_deg);
+	return std::min<unsigned int> (column, _columns - 1);
+}
+
+} // namespace Xefis
+
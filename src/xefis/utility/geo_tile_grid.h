@@ -0,0 +1,108 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+#ifndef XEFIS__UTILITY__GEO_TILE_GRID_H__INCLUDED
+#define XEFIS__UTILITY__GEO_TILE_GRID_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Xefis:
+#include <xefis/config/all.h>
+
+
+namespace Xefis {
+
+/**
+ * Divides the Earth into square lon/lat tiles of equal angular size.
+ *
+ * Tiles are numbered row by row, starting from the south-west corner
+ * (lon -180°, lat -90°). Tile size must divide 180° evenly.
+ */
+class GeoTileGrid
+{
+  public:
+	typedef uint32_t TileID;
+
+  public:
+	// Ctor
+	explicit
+	GeoTileGrid (Angle tile_size = 2_deg);
+
+	/**
+	 * Angular size of a tile.
+	 */
+	Angle
+	tile_size() const noexcept;
+
+	/**
+	 * Total number of tiles.
+	 */
+	std::size_t
+	tiles_count() const noexcept;
+
+	/**
+	 * Return tile containing the @position.
+	 */
+	TileID
+	tile_of (LonLat const& position) const noexcept;
+
+	/**
+	 * Return all tiles having common points with a spherical cap
+	 * of angular @radius around @center. Result may contain some tiles
+	 * that are close to the cap, but don't intersect it.
+	 */
+	std::vector<TileID>
+	tiles_within (LonLat const& center, Angle radius) const;
+
+  private:
+	unsigned int
+	row_of (double lat_deg) const noexcept;
+
+	unsigned int
+	column_of (double lon_deg) const noexcept;
+
+  private:
+	double			_tile_size_deg;
+	unsigned int	_rows;
+	unsigned int	_columns;
+};
+
+
+inline Angle
+GeoTileGrid::tile_size() const noexcept
+{
+	return 1_deg * _tile_size_deg;
+}
+
+
+inline std::size_t
+GeoTileGrid::tiles_count() const noexcept
+{
+	return static_cast<std::size_t> (_rows) * _columns;
+}
+
+
+inline GeoTileGrid::TileID
+GeoTileGrid::tile_of (LonLat const& position) const noexcept
+{
+	return row_of (position.lat().quantity<Degree>()) * _columns + column_of (position.lon().quantity<Degree>());
+}
+
+} // namespace Xefis
+
+#endif
+
@@ -0,0 +1,187 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+#ifndef XEFIS__UTILITY__MIRRORED_RING_H__INCLUDED
+#define XEFIS__UTILITY__MIRRORED_RING_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+// Xefis:
+#include <xefis/config/all.h>
+
+
+namespace Xefis {
+
+/**
+ * Fixed-size ring buffer which always exposes its contents as one contiguous span,
+ * ordered from the oldest to the newest element.
+ *
+ * Each element is stored twice, in two consecutive copies of the ring, so the span
+ * starting at the oldest element never wraps around. That makes push_back() write two
+ * elements, but lets readers iterate the contents with plain pointers, which compilers
+ * can vectorize.
+ */
+template<class tValueType>
+	class MirroredRing
+	{
+	  public:
+		typedef tValueType	ValueType;
+		typedef std::size_t	size_type;
+
+	  public:
+		// Ctor
+		explicit
+		MirroredRing (size_type size = 0, ValueType value = ValueType());
+
+		/**
+		 * Number of elements in the ring.
+		 */
+		size_type
+		size() const noexcept;
+
+		/**
+		 * Change size of the ring and set all elements to @value.
+		 */
+		void
+		resize (size_type size, ValueType value = ValueType());
+
+		/**
+		 * Set all elements to @value.
+		 */
+		void
+		fill (ValueType value) noexcept;
+
+		/**
+		 * Replace the oldest element with a new one.
+		 * Ring must not be empty.
+		 */
+		void
+		push_back (ValueType value) noexcept;
+
+		/**
+		 * Return the oldest element.
+		 */
+		ValueType const&
+		front() const noexcept;
+
+		/**
+		 * Return the newest element.
+		 */
+		ValueType const&
+		back() const noexcept;
+
+		/**
+		 * Return element at index @i, where 0 is the oldest one.
+		 */
+		ValueType const&
+		operator[] (size_type i) const noexcept;
+
+		/**
+		 * Return pointer to size() contiguous elements, from the oldest to the newest.
+		 * Invalidated by push_back() and resize().
+		 */
+		ValueType const*
+		data() const noexcept;
+
+	  private:
+		std::vector<ValueType>	_storage;
+		size_type				_size	= 0;
+		// Index of the oldest element:
+		size_type				_head	= 0;
+	};
+
+
+template<class V>
+	inline
+	MirroredRing<V>::MirroredRing (size_type size, ValueType value)
+	{
+		resize (size, value);
+	}
+
+
+template<class V>
+	inline typename MirroredRing<V>::size_type
+	MirroredRing<V>::size() const noexcept
+	{
+		return _size;
+	}
+
+
+template<class V>
+	inline void
+	MirroredRing<V>::resize (size_type size, ValueType value)
+	{
+		_storage.assign (2 * size, value);
+		_size = size;
+		_head = 0;
+	}
+
+
+template<class V>
+	inline void
+	MirroredRing<V>::fill (ValueType value) noexcept
+	{
+		std::fill (_storage.begin(), _storage.end(), value);
+	}
+
+
+template<class V>
+	inline void
+	MirroredRing<V>::push_back (ValueType value) noexcept
+	{
+		_storage[_head] = value;
+		_storage[_head + _size] = value;
+
+		if (++_head == _size)
+			_head = 0;
+	}
+
+
+template<class V>
+	inline typename MirroredRing<V>::ValueType const&
+	MirroredRing<V>::front() const noexcept
+	{
+		return _storage[_head];
+	}
+
+
+template<class V>
+	inline typename MirroredRing<V>::ValueType const&
+	MirroredRing<V>::back() const noexcept
+	{
+		return _storage[_head + _size - 1];
+	}
+
+
+template<class V>
+	inline typename MirroredRing<V>::ValueType const&
+	MirroredRing<V>::operator[] (size_type i) const noexcept
+	{
+		return _storage[_head + i];
+	}
+
+
+template<class V>
+	inline typename MirroredRing<V>::ValueType const*
+	MirroredRing<V>::data() const noexcept
+	{
+		return _storage.data() + _head;
+	}
+
+} // namespace Xefis
+
+#endif
+
@@ -0,0 +1,280 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+#ifndef XEFIS__UTILITY__MULTI_RESOLUTION_HISTORY_H__INCLUDED
+#define XEFIS__UTILITY__MULTI_RESOLUTION_HISTORY_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/utility/dot_product.h>
+#include <xefis/utility/mirrored_ring.h>
+
+
+namespace Xefis {
+
+/**
+ * History of the last N samples used to compute Hann-windowed sums (see Smoother),
+ * which keeps only the most recent samples at full resolution. Older samples are
+ * decimated: each D consecutive samples are replaced by their average.
+ *
+ * The window is applied exactly: each decimated block is multiplied by the exact sum
+ * of Hann coefficients it covers (computed in closed form), so the only error comes
+ * from replacing samples with the block average:
+ *
+ *   |Σ (h[i] - h̄)·(w[i] - w̄)| ≤ D · V · (D - 1)·π/(N - 1)   for each block,
+ *
+ * where V is the variation (max - min) of samples within the block, and π/(N - 1)
+ * bounds the slope of the Hann window. For the normalized output 2/(N - 1)·Σ h·w
+ * it gives:
+ *
+ *   |error| ≤ 2π·D·(D - 1) / (N - 1)² · TV,
+ *
+ * where TV is the total variation of the decimated part of the signal. For D = N/128
+ * this is less than 4e-4·TV, independent of the window size. Constant signals
+ * are reproduced exactly. Changes within the full-resolution part aren't affected at all.
+ *
+ * Memory use and cost of windowed_sum() are proportional to M + D + N/D instead of N.
+ */
+template<class tValueType>
+	class MultiResolutionHistory
+	{
+	  public:
+		typedef tValueType ValueType;
+
+	  public:
+		// Ctor
+		MultiResolutionHistory() = default;
+
+		/**
+		 * \param	window_size
+		 * 			Number of samples in the window (N), at least 3.
+		 * \param	decimation
+		 * 			Number of samples averaged into one block (D).
+		 * \param	full_resolution
+		 * 			Minimum number of most recent samples kept at full resolution (M), at least 1.
+		 *
+		 * M is reduced to N - 1 and then D to N - M if needed, since the full resolution
+		 * part with a pending block must fit in the window (M + D ≤ N).
+		 */
+		explicit
+		MultiResolutionHistory (std::size_t window_size, std::size_t decimation, std::size_t full_resolution);
+
+		/**
+		 * Return true if history has been configured.
+		 */
+		bool
+		configured() const noexcept;
+
+		/**
+		 * Set all samples to @value.
+		 */
+		void
+		fill (ValueType value) noexcept;
+
+		/**
+		 * Push new sample, dropping the oldest one.
+		 */
+		void
+		push_back (ValueType value) noexcept;
+
+		/**
+		 * Return sum of samples multiplied by the Hann window of size N.
+		 */
+		ValueType
+		windowed_sum() const noexcept;
+
+		/**
+		 * Return number of stored values, including tables.
+		 */
+		std::size_t
+		stored_values() const noexcept;
+
+	  private:
+		std::size_t					_window_size		= 0;
+		std::size_t					_decimation			= 1;
+		std::size_t					_full_resolution	= 0;
+		// Most recent samples, of which the newest _full_resolution + _pending are not decimated yet:
+		MirroredRing<ValueType>		_recent;
+		// Averages of decimated blocks, oldest first:
+		MirroredRing<ValueType>		_blocks;
+		std::size_t					_pending			= 0;
+		// Window coefficients for the samples in _recent:
+		std::vector<ValueType>		_recent_window;
+		// cos/sin (θ·D·k) for block k, where θ = 2π / (N - 1):
+		std::vector<ValueType>		_block_cos;
+		std::vector<ValueType>		_block_sin;
+		// Σ exp (i·θ·m) for m in [0, D), multiplied by exp (i·θ·s) where s is the window
+		// position of the oldest block, for each value of _pending:
+		std::vector<ValueType>		_phase_re;
+		std::vector<ValueType>		_phase_im;
+		// Sums of the first r window coefficients, for the block partially covered by the window:
+		std::vector<ValueType>		_partial_weights;
+	};
+
+
+template<class V>
+	inline
+	MultiResolutionHistory<V>::MultiResolutionHistory (std::size_t window_size, std::size_t decimation, std::size_t full_resolution):
+		_window_size (window_size),
+		_decimation (std::max<std::size_t> (decimation, 1)),
+		_full_resolution (std::max<std::size_t> (full_resolution, 1))
+	{
+		std::size_t const N = _window_size;
+		std::size_t const M = std::min (_full_resolution, N - 1);
+		std::size_t const D = std::min (_decimation, N - M);
+		_full_resolution = M;
+		_decimation = D;
+
+		ValueType const theta = 2.0 * M_PI / (N - 1);
+		auto window = [&](long n) -> ValueType {
+			return 0.5 * (1.0 - std::cos (theta * n));
+		};
+
+		std::size_t const blocks = (N - M + D - 1) / D + 1;
+
+		_recent.resize (M + D);
+		_blocks.resize (blocks);
+
+		_recent_window.resize (M + D);
+		for (std::size_t i = 0; i < M + D; ++i)
+		{
+			long n = static_cast<long> (N) - static_cast<long> (M + D) + static_cast<long> (i);
+			_recent_window[i] = n >= 0 ? window (n) : 0.0;
+		}
+
+		_block_cos.resize (blocks);
+		_block_sin.resize (blocks);
+		for (std::size_t k = 0; k < blocks; ++k)
+		{
+			_block_cos[k] = std::cos (theta * D * k);
+			_block_sin[k] = std::sin (theta * D * k);
+		}
+
+		ValueType g_re = 0.0;
+		ValueType g_im = 0.0;
+		for (std::size_t m = 0; m < D; ++m)
+		{
+			g_re += std::cos (theta * m);
+			g_im += std::sin (theta * m);
+		}
+
+		_phase_re.resize (D);
+		_phase_im.resize (D);
+		for (std::size_t p = 0; p < D; ++p)
+		{
+			// Window position of block 0 (which may be negative):
+			long s = static_cast<long> (N - M - p) - static_cast<long> (blocks * D);
+			ValueType c = std::cos (theta * s);
+			ValueType d = std::sin (theta * s);
+			_phase_re[p] = g_re * c - g_im * d;
+			_phase_im[p] = g_re * d + g_im * c;
+		}
+
+		_partial_weights.resize (D);
+		ValueType partial = 0.0;
+		for (std::size_t r = 0; r < D; ++r)
+		{
+			_partial_weights[r] = partial;
+			partial += window (r);
+		}
+	}
+
+
+template<class V>
+	inline bool
+	MultiResolutionHistory<V>::configured() const noexcept
+	{
+		return _window_size > 0;
+	}
+
+
+template<class V>
+	inline void
+	MultiResolutionHistory<V>::fill (ValueType value) noexcept
+	{
+		_recent.fill (value);
+		_blocks.fill (value);
+		_pending = 0;
+	}
+
+
+template<class V>
+	inline void
+	MultiResolutionHistory<V>::push_back (ValueType value) noexcept
+	{
+		_recent.push_back (value);
+
+		if (++_pending == _decimation)
+		{
+			// All of _recent is now pending; the oldest D samples form a new block:
+			ValueType const* oldest = _recent.data();
+			_blocks.push_back (std::accumulate (oldest, oldest + _decimation, ValueType (0.0)) / _decimation);
+			_pending = 0;
+		}
+	}
+
+
+template<class V>
+	inline typename MultiResolutionHistory<V>::ValueType
+	MultiResolutionHistory<V>::windowed_sum() const noexcept
+	{
+		std::size_t const N = _window_size;
+		std::size_t const D = _decimation;
+		std::size_t const M = _full_resolution;
+		std::size_t const p = _pending;
+
+		// Full resolution part covers window positions [N - M - p, N):
+		std::size_t const skip = D - p;
+		ValueType result = dot_product (_recent.data() + skip, _recent_window.data() + skip, M + p);
+
+		// Blocks cover positions [0, N - M - p). Block k covers [s + k·D, s + (k + 1)·D),
+		// its window coefficients sum to D/2 - Re (G·exp (i·θ·(s + k·D))) / 2:
+		std::size_t const covered = N - M - p;
+		std::size_t const full_blocks = covered / D;
+		std::size_t const remainder = covered % D;
+		std::size_t const first = _blocks.size() - full_blocks;
+		ValueType const* blocks = _blocks.data();
+
+		ValueType a;
+		ValueType b;
+		dot_products (_block_cos.data() + first, _block_sin.data() + first, blocks + first, full_blocks, a, b);
+		ValueType sum = vector_sum (blocks + first, full_blocks);
+		result += 0.5 * D * sum - 0.5 * (_phase_re[p] * a - _phase_im[p] * b);
+
+		// Block partially covered by the window:
+		if (remainder > 0)
+			result += blocks[first - 1] * _partial_weights[remainder];
+
+		return result;
+	}
+
+
+template<class V>
+	inline std::size_t
+	MultiResolutionHistory<V>::stored_values() const noexcept
+	{
+		return 2 * _recent.size() + 2 * _blocks.size() + _recent_window.size()
+			+ _block_cos.size() + _block_sin.size() + _phase_re.size() + _phase_im.size() + _partial_weights.size();
+	}
+
+} // namespace Xefis
+
+#endif
+
@@ -53,5 +53,75 @@ Painter::draw_outlined_polygon (QPolygonF const& polygon)
 	drawPolygon (polygon);
 }
 
+
+void
+Painter::paint_sprite (QString const& key, QRectF const& bounds, std::function<void (Painter&)> paint_function, bool shadow)
+{
+	QTransform const painter_transform = transform();
+
+	// Sprites can't handle perspective transforms:
+	if (!painter_transform.isAffine())
+	{
+		if (shadow)
+			add_shadow ([&] { paint_function (*this); });
+		else
+			paint_function (*this);
+		return;
+	}
+
+	QTransform const linear (painter_transform.m11(), painter_transform.m12(), painter_transform.m21(), painter_transform.m22(), 0.0, 0.0);
+	qreal const tx = painter_transform.dx();
+	qreal const ty = painter_transform.dy();
+	int const dx = limit<int> (floored_mod<qreal> (tx, 1.0) * SpriteRank, 0, SpriteRank - 1);
+	int const dy = limit<int> (floored_mod<qreal> (ty, 1.0) * SpriteRank, 0, SpriteRank - 1);
+	QPen const p = pen();
+	QBrush const b = brush();
+
+	SpriteKey sprite_key {
+		key, shadow,
+		{ bounds.left(), bounds.top(), bounds.width(), bounds.height() },
+		{ linear.m11(), linear.m12(), linear.m21(), linear.m22() },
+		p.color().rgba(), p.widthF(), p.style(), p.capStyle(), p.joinStyle(), p.isCosmetic(),
+		b.color().rgba(), b.style(), _shadow_color.rgba(), _shadow_width, dx, dy,
+	};
+
+	auto sprite = _sprites.find (sprite_key);
+	if (sprite == _sprites.end())
+	{
+		if (_sprites.size() >= MaxSprites)
+			_sprites.clear();
+
+		// Margin for pen width, shadow and antialiasing, in device pixels:
+		qreal const scale = std::max (std::hypot (linear.m11(), linear.m12()), std::hypot (linear.m21(), linear.m22()));
+		qreal const pen_width = std::max<qreal> (p.widthF(), 1.0) + (shadow ? _shadow_width : 0.f);
+		qreal const margin = (p.isCosmetic() ? pen_width : pen_width * scale) + 2.0;
+		QRect const image_rect = linear.mapRect (bounds).adjusted (-margin, -margin, +margin, +margin).toAlignedRect();
+
+		QImage image (image_rect.size(), QImage::Format_ARGB32_Premultiplied);
+		image.fill (Qt::transparent);
+
+		Painter sprite_painter (&image, cache());
+		sprite_painter.setRenderHints (renderHints());
+		sprite_painter.setPen (p);
+		sprite_painter.setBrush (b);
+		sprite_painter.setFont (font());
+		sprite_painter._shadow_color = _shadow_color;
+		sprite_painter._shadow_width = _shadow_width;
+		sprite_painter.setTransform (linear * QTransform::fromTranslate (-image_rect.left() + 1.0 * dx / SpriteRank,
+																		 -image_rect.top() + 1.0 * dy / SpriteRank));
+		if (shadow)
+			sprite_painter.add_shadow ([&] { paint_function (sprite_painter); });
+		else
+			paint_function (sprite_painter);
+		sprite_painter.end();
+
+		sprite = _sprites.insert ({ sprite_key, Sprite { image, image_rect.topLeft() } }).first;
+	}
+
+	resetTransform();
+	drawImage (QPoint (std::floor (tx), std::floor (ty)) + sprite->second.offset, sprite->second.image);
+	setTransform (painter_transform);
+}
+
 } // namespace Xefis
 
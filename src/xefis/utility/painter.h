@@ -19,6 +19,7 @@
 #include <tuple>
 #include <map>
 #include <memory>
+#include <functional>
 
 // Qt:
 #include <QtGui/QPainter>
@@ -35,6 +36,48 @@ class Painter: public TextPainter
 {
 	constexpr static float DefaultShadowWidth = 1.2f;
 
+	// Number of sub-pixel positions in each axis for which sprites are rendered:
+	constexpr static int SpriteRank = 4;
+
+	// Max number of cached sprites, whole cache is dropped when exceeded:
+	constexpr static std::size_t MaxSprites = 512;
+
+	/**
+	 * Pre-rasterized shape, possibly with shadow.
+	 */
+	struct Sprite
+	{
+		QImage	image;
+		QPoint	offset;
+	};
+
+	/**
+	 * Identifies rasterized sprite. Contains user-provided key and bounds,
+	 * painter settings that affect the result and the linear part of transform.
+	 */
+	struct SpriteKey
+	{
+		QString	key;
+		bool	shadow;
+		qreal	bounds[4];
+		qreal	transform[4];
+		QRgb	pen_color;
+		qreal	pen_width;
+		int		pen_style;
+		int		pen_cap;
+		int		pen_join;
+		bool	pen_cosmetic;
+		QRgb	brush_color;
+		int		brush_style;
+		QRgb	shadow_color;
+		float	shadow_width;
+		int		dx;
+		int		dy;
+
+		bool
+		operator< (SpriteKey const& other) const;
+	};
+
   public:
 	// Ctor
 	Painter (TextPainter::Cache* cache);
@@ -78,14 +121,63 @@ class Painter: public TextPainter
 	void
 	add_shadow (QColor color, std::function<void()> paint_function);
 
+	/**
+	 * Paint a recurring shape from pre-rasterized sprite, so that it's only rasterized once.
+	 * Sprite is identified by the key, bounds, current pen, brush and linear part of the painter transform.
+	 * The translation is applied when blitting the sprite, so the same sprite can be drawn at many places.
+	 *
+	 * \param	key
+	 *			Must identify the shape painted by the paint function. Use it only for plain shapes,
+	 *			things like font or pen dash pattern are not taken into account.
+	 * \param	bounds
+	 *			Bounding rectangle of the shape in current painter coordinates, without pen width.
+	 * \param	paint_function
+	 *			Function that paints the shape using given Painter object.
+	 */
+	void
+	paint_sprite (QString const& key, QRectF const& bounds, std::function<void (Painter&)> paint_function);
+
+	/**
+	 * Like paint_sprite(), but paints the shape with a shadow, like add_shadow() does.
+	 * Shadow and the shape itself are composed in a single sprite, so that it takes one blit to paint them.
+	 */
+	void
+	add_shadow_sprite (QString const& key, QRectF const& bounds, std::function<void (Painter&)> paint_function);
+
+	/**
+	 * Drop all cached sprites.
+	 */
+	void
+	clear_sprites();
+
+  private:
+	void
+	paint_sprite (QString const& key, QRectF const& bounds, std::function<void (Painter&)> paint_function, bool shadow);
+
   private:
 	float	_shadow_width			= DefaultShadowWidth;
 	QColor	_shadow_color			= { 0x10, 0x20, 0x30, 127 };
 	QPen	_saved_pen;
 	bool	_painting_shadow		= false;
+	std::map<SpriteKey, Sprite>
+			_sprites;
 };
 
 
+inline bool
+Painter::SpriteKey::operator< (SpriteKey const& other) const
+{
+	auto tie = [](SpriteKey const& k) {
+		return std::tie (k.key, k.shadow, k.bounds[0], k.bounds[1], k.bounds[2], k.bounds[3],
+						 k.transform[0], k.transform[1], k.transform[2], k.transform[3],
+						 k.pen_color, k.pen_width, k.pen_style, k.pen_cap, k.pen_join, k.pen_cosmetic,
+						 k.brush_color, k.brush_style, k.shadow_color, k.shadow_width, k.dx, k.dy);
+	};
+
+	return tie (*this) < tie (other);
+}
+
+
 inline bool
 Painter::painting_shadow() const
 {
@@ -172,6 +264,27 @@ Painter::add_shadow (QColor color, std::function<void()> paint_function)
 	_shadow_color = s;
 }
 
+
+inline void
+Painter::paint_sprite (QString const& key, QRectF const& bounds, std::function<void (Painter&)> paint_function)
+{
+	paint_sprite (key, bounds, paint_function, false);
+}
+
+
+inline void
+Painter::add_shadow_sprite (QString const& key, QRectF const& bounds, std::function<void (Painter&)> paint_function)
+{
+	paint_sprite (key, bounds, paint_function, true);
+}
+
+
+inline void
+Painter::clear_sprites()
+{
+	_sprites.clear();
+}
+
 } // namespace Xefis
 
 #endif
@@ -32,6 +32,25 @@ namespace Xefis {
  */
 class Semaphore: private Noncopyable
 {
+  public:
+	/**
+	 * RAII-way locking. Waits on the semaphore when constructed
+	 * and posts it when destructed, also when exception is thrown.
+	 */
+	class Lock: public Noncopyable
+	{
+	  public:
+		// Ctor. Wait on the semaphore.
+		explicit
+		Lock (Semaphore const& semaphore);
+
+		// Dtor. Post the semaphore.
+		~Lock();
+
+	  private:
+		Semaphore const&	_semaphore;
+	};
+
   public:
 	explicit
 	Semaphore (int value = 0) noexcept;
@@ -78,6 +97,21 @@ class Semaphore: private Noncopyable
 	int				_initial_value;
 };
 
+
+inline
+Semaphore::Lock::Lock (Semaphore const& semaphore):
+	_semaphore (semaphore)
+{
+	_semaphore.wait();
+}
+
+
+inline
+Semaphore::Lock::~Lock()
+{
+	_semaphore.post();
+}
+
 } // namespace Xefis
 
 #endif
@@ -18,12 +18,13 @@
 #include <cstddef>
 #include <cmath>
 #include <algorithm>
-
-// Boost:
-#include <boost/circular_buffer.hpp>
+#include <vector>
 
 // Xefis:
 #include <xefis/config/all.h>
+#include <xefis/utility/dot_product.h>
+#include <xefis/utility/mirrored_ring.h>
+#include <xefis/utility/multi_resolution_history.h>
 #include <xefis/utility/numeric.h>
 #include <xefis/utility/range.h>
 
@@ -35,6 +36,27 @@ namespace Xefis {
  */
 class SmootherBase
 {
+  public:
+	/**
+	 * Algorithm used to compute the Hann-windowed average.
+	 * FIR and Recursive have the same frequency response, MultiResolution approximates it.
+	 */
+	enum class Engine
+	{
+		// Direct FIR convolution over the whole history on each update. Cost is proportional
+		// to the smoothing time.
+		FIR,
+		// Sliding sum and sliding cosine terms updated on each sample, with constant cost per sample.
+		// Sums are recomputed from history once per window length to discard accumulated rounding errors.
+		Recursive,
+		// FIR convolution over a history (see MultiResolutionHistory) which keeps about N/64 most
+		// recent samples at full resolution and averages older samples in blocks of N/128
+		// samples, where N is the window size in samples. Memory use and cost drop about
+		// 10 times for long windows. Error of the output is less than 4e-4 of the total variation
+		// of the input over the decimated part of the window.
+		MultiResolution,
+	};
+
   public:
 	// Dtor
 	virtual ~SmootherBase() {}
@@ -64,6 +86,18 @@ class SmootherBase
 	void
 	set_precision (Time precision) noexcept;
 
+	/**
+	 * Return smoothing engine.
+	 */
+	Engine
+	engine() const noexcept;
+
+	/**
+	 * Select smoothing engine. Default is Engine::FIR.
+	 */
+	void
+	set_engine (Engine engine) noexcept;
+
 	/**
 	 * Resets the smoother when the next process() is called,
 	 * to the value given in process() call.
@@ -81,7 +115,8 @@ class SmootherBase
   protected:
 	Time	_smoothing_time;
 	Time	_precision;
-	bool	_invalidate = false;
+	Engine	_engine		= Engine::FIR;
+	bool	_invalidate	= false;
 };
 
 
@@ -134,6 +169,76 @@ template<class tValueType>
 		set_smoothing_time_impl (int milliseconds) noexcept override;
 
 	  private:
+		typedef MirroredRing<ValueType> History;
+
+		// Number of decimated blocks in the window for the MultiResolution engine:
+		static constexpr std::size_t kMultiResolutionBlocks = 128;
+
+		/**
+		 * State of the Recursive engine for one history buffer:
+		 * sum of samples and the complex sum of samples multiplied by exp (i·2π·n / (N - 1)).
+		 */
+		struct SlidingSums
+		{
+			ValueType	sum	= 0.0;
+			ValueType	re	= 0.0;
+			ValueType	im	= 0.0;
+		};
+
+		/**
+		 * History of samples and state of the selected engine.
+		 */
+		struct Track
+		{
+			// Full history for FIR and Recursive engines, only the last sample for MultiResolution:
+			History								history;
+			SlidingSums							sums;
+			MultiResolutionHistory<ValueType>	decimated;
+		};
+
+	  private:
+		/**
+		 * Resize track history for the current engine and window size.
+		 */
+		void
+		resize (Track&, bool used) noexcept;
+
+		/**
+		 * Set all samples in the track to @value.
+		 */
+		void
+		fill (Track&, ValueType value) noexcept;
+
+		/**
+		 * Push sample to the track, updating the selected engine's state.
+		 */
+		void
+		push (Track&, ValueType sample) noexcept;
+
+		/**
+		 * Return sum of history samples multiplied by the Hann window.
+		 */
+		ValueType
+		windowed_sum (Track const&) const noexcept;
+
+		/**
+		 * Compute windowed sums of two tracks at once.
+		 */
+		void
+		windowed_sums (Track const& track_a, Track const& track_b, ValueType& result_a, ValueType& result_b) const noexcept;
+
+		/**
+		 * Recompute sliding sums directly from the history.
+		 */
+		void
+		anchor (Track&) const noexcept;
+
+		/**
+		 * Re-anchor sliding sums of histories in use.
+		 */
+		void
+		anchor() noexcept;
+
 		ValueType
 		encircle (ValueType s) const noexcept;
 
@@ -148,10 +253,16 @@ template<class tValueType>
 		ValueType							_z;
 		Range<ValueType>					_winding;
 		bool								_winding_enabled	= false;
-		boost::circular_buffer<ValueType>	_history;
-		boost::circular_buffer<ValueType>	_history_cos;
-		boost::circular_buffer<ValueType>	_history_sin;
+		std::size_t							_window_size		= 0;
+		Track								_track;
+		Track								_track_cos;
+		Track								_track_sin;
 		std::vector<ValueType>				_window;
+		// Recursive engine:
+		std::vector<ValueType>				_window_sin;
+		ValueType							_rotation_cos		= 1.0;
+		ValueType							_rotation_sin		= 0.0;
+		std::size_t							_pushes_since_anchor	= 0;
 	};
 
 
@@ -190,6 +301,22 @@ SmootherBase::set_precision (Time precision) noexcept
 }
 
 
+inline SmootherBase::Engine
+SmootherBase::engine() const noexcept
+{
+	return _engine;
+}
+
+
+inline void
+SmootherBase::set_engine (Engine engine) noexcept
+{
+	_engine = engine;
+	// Recompute window and restart:
+	set_smoothing_time (_smoothing_time);
+}
+
+
 inline void
 SmootherBase::invalidate() noexcept
 {
@@ -211,10 +338,11 @@ template<class V>
 	inline void
 	Smoother<V>::set_smoothing_time_impl (int millis) noexcept
 	{
-		_history.resize (millis);
-		_history_cos.resize (millis);
-		_history_sin.resize (millis);
-		_window.resize (millis);
+		_window_size = millis;
+		// Only the last raw sample is needed in winding mode:
+		resize (_track, !_winding_enabled);
+		resize (_track_cos, _winding_enabled);
+		resize (_track_sin, _winding_enabled);
 		recompute_window();
 		invalidate();
 	}
@@ -224,15 +352,17 @@ template<class V>
 	inline void
 	Smoother<V>::reset (ValueType value) noexcept
 	{
-		std::fill (_history.begin(), _history.end(), value);
+		fill (_track, value);
 		if (_winding_enabled)
 		{
-			std::fill (_history_cos.begin(), _history_cos.end(), std::cos (encircle (value)));
-			std::fill (_history_sin.begin(), _history_sin.end(), std::sin (encircle (value)));
+			fill (_track_cos, std::cos (encircle (value)));
+			fill (_track_sin, std::sin (encircle (value)));
 			_z = floored_mod<ValueType> (_z, _winding.min(), _winding.max());
 		}
 		else
 			_z = value;
+
+		anchor();
 	}
 
 
@@ -242,6 +372,7 @@ template<class V>
 	{
 		_winding = range;
 		_winding_enabled = true;
+		set_smoothing_time_impl (_window_size);
 		reset (range.min());
 	}
 
@@ -270,9 +401,9 @@ template<class V>
 		{
 			if (_winding_enabled)
 			{
-				ValueType p = _history.back();
-				ValueType cos_p = _history_cos.back();
-				ValueType sin_p = _history_sin.back();
+				ValueType p = _track.history.back();
+				ValueType cos_p = _track_cos.history.back();
+				ValueType sin_p = _track_sin.history.back();
 				ValueType rad_s = encircle (s);
 				ValueType cos_s = std::cos (rad_s);
 				ValueType sin_s = std::sin (rad_s);
@@ -280,39 +411,40 @@ template<class V>
 				for (int i = 0; i < iterations; ++i)
 				{
 					ValueType d = static_cast<ValueType> (i + 1) / iterations;
-					_history.push_back (p + d * (s - p));
-					_history_cos.push_back (cos_p + d * (cos_s - cos_p));
-					_history_sin.push_back (sin_p + d * (sin_s - sin_p));
+					_track.history.push_back (p + d * (s - p));
+					push (_track_cos, cos_p + d * (cos_s - cos_p));
+					push (_track_sin, sin_p + d * (sin_s - sin_p));
 				}
 
-				ValueType x = 0.0;
-				ValueType y = 0.0;
-				for (typename boost::circular_buffer<ValueType>::size_type i = 0; i < _history.size(); ++i)
-				{
-					x += _history_cos[i] * _window[i];
-					y += _history_sin[i] * _window[i];
-				}
-				x /= _history.size() - 1;
-				y /= _history.size() - 1;
+				ValueType x;
+				ValueType y;
+				windowed_sums (_track_cos, _track_sin, x, y);
+				x /= _window_size - 1;
+				y /= _window_size - 1;
 				x *= 2.0;
 				y *= 2.0; // Window energy correction.
 				_z = floored_mod<ValueType> (decircle (std::atan2 (y, x)), _winding.min(), _winding.max());
 			}
 			else
 			{
-				ValueType p = _history.back();
+				ValueType p = _track.history.back();
 				// Linear interpolation:
 				for (int i = 0; i < iterations; ++i)
-					_history.push_back (p + (static_cast<ValueType> (i + 1) / iterations) * (s - p));
+					push (_track, p + (static_cast<ValueType> (i + 1) / iterations) * (s - p));
 
-				_z = 0.0;
-				for (std::size_t i = 0; i < _history.size(); ++i)
-					_z += _history[i] * _window[i];
-				_z /= _history.size() - 1; // Some coeffs are 0 in the window.
+				_z = windowed_sum (_track);
+				_z /= _window_size - 1; // Some coeffs are 0 in the window.
 				_z *= 2.0; // Window energy correction.
 			}
 
 			_accumulated_dt = 0_s;
+
+			if (_engine == Engine::Recursive)
+			{
+				_pushes_since_anchor += iterations;
+				if (_pushes_since_anchor >= _window_size)
+					anchor();
+			}
 		}
 
 		return _z;
@@ -331,7 +463,138 @@ template<class V>
 	inline typename Smoother<V>::ValueType
 	Smoother<V>::last_sample() const noexcept
 	{
-		return _history.back();
+		return _track.history.back();
+	}
+
+
+template<class V>
+	inline void
+	Smoother<V>::resize (Track& track, bool used) noexcept
+	{
+		if (used && _engine == Engine::MultiResolution)
+		{
+			std::size_t decimation = std::max<std::size_t> (1, _window_size / kMultiResolutionBlocks);
+			track.history.resize (1);
+			track.decimated = MultiResolutionHistory<ValueType> (_window_size, decimation, 2 * decimation);
+		}
+		else
+		{
+			track.history.resize (used ? _window_size : 1);
+			track.decimated = MultiResolutionHistory<ValueType>();
+		}
+	}
+
+
+template<class V>
+	inline void
+	Smoother<V>::fill (Track& track, ValueType value) noexcept
+	{
+		track.history.fill (value);
+		if (track.decimated.configured())
+			track.decimated.fill (value);
+	}
+
+
+template<class V>
+	inline void
+	Smoother<V>::push (Track& track, ValueType sample) noexcept
+	{
+		switch (_engine)
+		{
+			case Engine::FIR:
+				break;
+
+			case Engine::Recursive:
+			{
+				// The oldest sample drops out, remaining ones move one step towards the beginning
+				// of the window, so the cosine terms rotate by -2π / (N - 1). The new sample lands
+				// at n = N - 1, where the phase is 2π.
+				SlidingSums& sums = track.sums;
+				ValueType dropped = track.history.front();
+				ValueType re = sums.re - dropped;
+				ValueType im = sums.im;
+				sums.sum += sample - dropped;
+				sums.re = re * _rotation_cos + im * _rotation_sin + sample;
+				sums.im = im * _rotation_cos - re * _rotation_sin;
+				break;
+			}
+
+			case Engine::MultiResolution:
+				track.decimated.push_back (sample);
+				break;
+		}
+
+		track.history.push_back (sample);
+	}
+
+
+template<class V>
+	inline typename Smoother<V>::ValueType
+	Smoother<V>::windowed_sum (Track const& track) const noexcept
+	{
+		switch (_engine)
+		{
+			case Engine::Recursive:
+				return 0.5 * (track.sums.sum - track.sums.re);
+
+			case Engine::MultiResolution:
+				return track.decimated.windowed_sum();
+
+			default:
+				return dot_product (track.history.data(), _window.data(), _window_size);
+		}
+	}
+
+
+template<class V>
+	inline void
+	Smoother<V>::windowed_sums (Track const& track_a, Track const& track_b, ValueType& result_a, ValueType& result_b) const noexcept
+	{
+		if (_engine == Engine::FIR)
+			dot_products (track_a.history.data(), track_b.history.data(), _window.data(), _window_size, result_a, result_b);
+		else
+		{
+			result_a = windowed_sum (track_a);
+			result_b = windowed_sum (track_b);
+		}
+	}
+
+
+template<class V>
+	inline void
+	Smoother<V>::anchor (Track& track) const noexcept
+	{
+		History const& history = track.history;
+		SlidingSums& sums = track.sums;
+
+		sums = SlidingSums();
+
+		for (typename History::size_type i = 0; i < history.size(); ++i)
+		{
+			sums.sum += history[i];
+			// cos (2π·n / (N - 1)) = 1 - 2·window[n]:
+			sums.re += history[i] * (1.0 - 2.0 * _window[i]);
+			sums.im += history[i] * _window_sin[i];
+		}
+	}
+
+
+template<class V>
+	inline void
+	Smoother<V>::anchor() noexcept
+	{
+		if (_engine != Engine::Recursive)
+			return;
+
+		if (_winding_enabled)
+		{
+			anchor (_track_cos);
+			anchor (_track_sin);
+		}
+		else
+			anchor (_track);
+
+		_pushes_since_anchor = 0;
 	}
 
 
@@ -355,9 +618,23 @@ template<class V>
 	inline void
 	Smoother<V>::recompute_window() noexcept
 	{
-		std::size_t N = _window.size();
+		// MultiResolutionHistory has its own window tables:
+		std::size_t N = _engine == Engine::MultiResolution ? 0 : _window_size;
+		_window.resize (N);
 		for (std::size_t n = 0; n < N; ++n)
 			_window[n] = 0.5 * (1.0 - std::cos (2.0 * M_PI * n / (N - 1)));
+
+		if (_engine == Engine::Recursive)
+		{
+			_window_sin.resize (N);
+			for (std::size_t n = 0; n < N; ++n)
+				_window_sin[n] = std::sin (2.0 * M_PI * n / (N - 1));
+
+			_rotation_cos = std::cos (2.0 * M_PI / (N - 1));
+			_rotation_sin = std::sin (2.0 * M_PI / (N - 1));
+		}
+		else
+			_window_sin.clear();
 	}
 
 } // namespace Xefis
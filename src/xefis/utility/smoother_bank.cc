@@ -0,0 +1,311 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/utility/dot_product.h>
+#include <xefis/utility/numeric.h>
+
+// Local:
+#include "smoother_bank.h"
+
+
+namespace Xefis {
+
+SmootherBank::SmootherBank (Time smoothing_time, Time precision)
+{
+	set_smoothing_time (smoothing_time);
+	set_precision (precision);
+	invalidate();
+}
+
+
+SmootherBank::Channel
+SmootherBank::add_channel()
+{
+	ChannelInfo info;
+	info.lane = _lanes;
+	_lanes += 1;
+	_channels.push_back (info);
+	reallocate();
+	return _channels.size() - 1;
+}
+
+
+SmootherBank::Channel
+SmootherBank::add_channel (Range<double> winding)
+{
+	ChannelInfo info;
+	info.lane = _lanes;
+	info.winding_enabled = true;
+	info.winding = winding;
+	// Cos and sin components:
+	_lanes += 2;
+	_channels.push_back (info);
+	reallocate();
+	return _channels.size() - 1;
+}
+
+
+void
+SmootherBank::process (Time dt) noexcept
+{
+	_accumulated_dt += dt;
+
+	if (_invalidate)
+	{
+		_invalidate = false;
+		for (auto& channel: _channels)
+			channel.invalidate = true;
+	}
+
+	for (Channel c = 0; c < _channels.size(); ++c)
+	{
+		ChannelInfo& channel = _channels[c];
+		if (channel.invalidate && std::isfinite (channel.sample))
+			reset (c, channel.sample);
+	}
+
+	if (_accumulated_dt > 10 * _smoothing_time)
+		_accumulated_dt = 10 * _smoothing_time;
+
+	int iterations = _accumulated_dt / _precision;
+
+	if (iterations > 1 && !_channels.empty())
+	{
+		// Interpolate linearly from the newest row to the new samples.
+		// Channels without a valid sample repeat their newest samples.
+		double const* newest = window_rows() + (_window_size - 1) * _stride;
+		std::copy (newest, newest + _stride, _previous.begin());
+		std::copy (newest, newest + _stride, _next.begin());
+
+		for (auto& channel: _channels)
+		{
+			if (std::isfinite (channel.sample))
+			{
+				if (channel.winding_enabled)
+				{
+					double rad_s = encircle (channel, channel.sample);
+					_next[channel.lane] = std::cos (rad_s);
+					_next[channel.lane + 1] = std::sin (rad_s);
+				}
+				else
+					_next[channel.lane] = channel.sample;
+
+				channel.last_sample = channel.sample;
+			}
+		}
+
+		for (int i = 0; i < iterations; ++i)
+		{
+			double d = static_cast<double> (i + 1) / iterations;
+			for (std::size_t l = 0; l < _stride; ++l)
+				_row[l] = _previous[l] + d * (_next[l] - _previous[l]);
+			push_row();
+		}
+
+		if (_engine == Engine::Recursive)
+		{
+			for (std::size_t l = 0; l < _stride; ++l)
+				_results[l] = 0.5 * (_sums.sum[l] - _sums.re[l]);
+		}
+		else
+			column_dot_products (window_rows(), _window.data(), _window_size, _stride, _results.data());
+
+		for (auto& channel: _channels)
+		{
+			if (!std::isfinite (channel.sample))
+				continue;
+
+			if (channel.winding_enabled)
+			{
+				double x = _results[channel.lane];
+				double y = _results[channel.lane + 1];
+				x /= _window_size - 1;
+				y /= _window_size - 1;
+				x *= 2.0;
+				y *= 2.0; // Window energy correction.
+				channel.value = floored_mod<double> (decircle (channel, std::atan2 (y, x)), channel.winding.min(), channel.winding.max());
+			}
+			else
+			{
+				channel.value = _results[channel.lane];
+				channel.value /= _window_size - 1; // Some coeffs are 0 in the window.
+				channel.value *= 2.0; // Window energy correction.
+			}
+		}
+
+		_accumulated_dt = 0_s;
+
+		if (_engine == Engine::Recursive)
+		{
+			_pushes_since_anchor += iterations;
+			if (_pushes_since_anchor >= _window_size)
+				anchor();
+		}
+	}
+
+	for (auto& channel: _channels)
+		channel.sample = std::numeric_limits<double>::quiet_NaN();
+}
+
+
+void
+SmootherBank::reset (Channel c, double value) noexcept
+{
+	ChannelInfo& channel = _channels[c];
+	channel.invalidate = false;
+	channel.last_sample = value;
+
+	if (channel.winding_enabled)
+	{
+		fill_lane (channel.lane, std::cos (encircle (channel, value)));
+		fill_lane (channel.lane + 1, std::sin (encircle (channel, value)));
+		channel.value = floored_mod<double> (value, channel.winding.min(), channel.winding.max());
+	}
+	else
+	{
+		fill_lane (channel.lane, value);
+		channel.value = value;
+	}
+
+	anchor();
+}
+
+
+void
+SmootherBank::set_smoothing_time_impl (int millis) noexcept
+{
+	std::size_t const N = millis;
+
+	_window.resize (N);
+	_window_cos.resize (N);
+	_window_sin.resize (N);
+
+	for (std::size_t n = 0; n < N; ++n)
+	{
+		_window[n] = 0.5 * (1.0 - std::cos (2.0 * M_PI * n / (N - 1)));
+		_window_cos[n] = std::cos (2.0 * M_PI * n / (N - 1));
+		_window_sin[n] = std::sin (2.0 * M_PI * n / (N - 1));
+	}
+
+	_rotation_cos = std::cos (2.0 * M_PI / (N - 1));
+	_rotation_sin = std::sin (2.0 * M_PI / (N - 1));
+	_window_size = N;
+
+	reallocate();
+	invalidate();
+}
+
+
+void
+SmootherBank::reallocate()
+{
+	_stride = (_lanes + kLanesAlignment - 1) / kLanesAlignment * kLanesAlignment;
+	_history.assign (2 * _window_size * _stride, 0.0);
+	_head = 0;
+
+	for (auto* v: { &_previous, &_next, &_row, &_results, &_sums.sum, &_sums.re, &_sums.im })
+		v->assign (_stride, 0.0);
+
+	_pushes_since_anchor = 0;
+
+	for (auto& channel: _channels)
+		channel.invalidate = true;
+}
+
+
+void
+SmootherBank::fill_lane (std::size_t lane, double value) noexcept
+{
+	for (std::size_t r = 0; r < 2 * _window_size; ++r)
+		_history[r * _stride + lane] = value;
+}
+
+
+void
+SmootherBank::push_row() noexcept
+{
+	double* oldest = &_history[_head * _stride];
+	double* mirror = &_history[(_head + _window_size) * _stride];
+
+	if (_engine == Engine::Recursive)
+	{
+		// See Smoother<>::push():
+		for (std::size_t l = 0; l < _stride; ++l)
+		{
+			double dropped = oldest[l];
+			double re = _sums.re[l] - dropped;
+			double im = _sums.im[l];
+			_sums.sum[l] += _row[l] - dropped;
+			_sums.re[l] = re * _rotation_cos + im * _rotation_sin + _row[l];
+			_sums.im[l] = im * _rotation_cos - re * _rotation_sin;
+		}
+	}
+
+	std::copy (_row.begin(), _row.end(), oldest);
+	std::copy (_row.begin(), _row.end(), mirror);
+
+	if (++_head == _window_size)
+		_head = 0;
+}
+
+
+double const*
+SmootherBank::window_rows() const noexcept
+{
+	return &_history[_head * _stride];
+}
+
+
+void
+SmootherBank::anchor() noexcept
+{
+	if (_engine != Engine::Recursive)
+		return;
+
+	double const* rows = window_rows();
+
+	std::fill (_sums.sum.begin(), _sums.sum.end(), 0.0);
+	for (std::size_t i = 0; i < _window_size; ++i)
+		for (std::size_t l = 0; l < _stride; ++l)
+			_sums.sum[l] += rows[i * _stride + l];
+
+	column_dot_products (rows, _window_cos.data(), _window_size, _stride, _sums.re.data());
+	column_dot_products (rows, _window_sin.data(), _window_size, _stride, _sums.im.data());
+
+	_pushes_since_anchor = 0;
+}
+
+
+double
+SmootherBank::encircle (ChannelInfo const& channel, double s) const noexcept
+{
+	return renormalize (s, channel.winding, Range<double> (0.0, 2.0 * M_PI));
+}
+
+
+double
+SmootherBank::decircle (ChannelInfo const& channel, double s) const noexcept
+{
+	return renormalize (s, Range<double> (0.0, 2.0 * M_PI), channel.winding);
+}
+
+} // namespace Xefis
+
@@ -0,0 +1,244 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+#ifndef XEFIS__UTILITY__SMOOTHER_BANK_H__INCLUDED
+#define XEFIS__UTILITY__SMOOTHER_BANK_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// Xefis:
+#include <xefis/config/all.h>
+#include <xefis/utility/range.h>
+#include <xefis/utility/smoother.h>
+
+
+namespace Xefis {
+
+/**
+ * Set of smoothers with common smoothing time, precision and engine, updated together
+ * with the same dt. Computes the same values as separate Smoother<double> instances.
+ *
+ * Histories of all channels are stored as a structure of arrays: each history row
+ * contains one sample for each lane, where a lane is one channel, or one of cos/sin
+ * components of a winding channel. Rows live in a mirrored ring (see MirroredRing),
+ * so the whole window is one contiguous matrix and each process() computes windowed
+ * sums for all lanes in one pass with column_dot_products().
+ *
+ * Usage: add channels, then for each update set samples with set_sample() and call process().
+ * Channels whose sample is not set or is not finite keep their history extended with
+ * their last sample and keep their output value. New and invalidated channels are reset
+ * to their first valid sample, like Smoother.
+ *
+ * Engine::MultiResolution is not supported, the bank uses Engine::FIR instead.
+ */
+class SmootherBank: public SmootherBase
+{
+	// Number of lanes is rounded up to a multiple of this, to fill whole vector registers:
+	static constexpr std::size_t kLanesAlignment = 4;
+
+  public:
+	typedef std::size_t Channel;
+
+  private:
+	struct ChannelInfo
+	{
+		std::size_t			lane;
+		bool				winding_enabled	= false;
+		Range<double>		winding;
+		bool				invalidate		= true;
+		// NaN if not set, so that channels get seeded with their first real sample:
+		double				sample			= std::numeric_limits<double>::quiet_NaN();
+		double				last_sample		= 0.0;
+		double				value			= 0.0;
+	};
+
+	struct SlidingSums
+	{
+		std::vector<double>	sum;
+		std::vector<double>	re;
+		std::vector<double>	im;
+	};
+
+  public:
+	// Ctor
+	SmootherBank (Time smoothing_time = 1_ms, Time precision = 1_ms);
+
+	/**
+	 * Add new channel. Invalidates all channels.
+	 */
+	Channel
+	add_channel();
+
+	/**
+	 * Add new channel with winding enabled, with given values range.
+	 * Invalidates all channels.
+	 */
+	Channel
+	add_channel (Range<double> winding);
+
+	/**
+	 * Return number of channels.
+	 */
+	std::size_t
+	channels_count() const noexcept;
+
+	/**
+	 * Set sample to be pushed to channel by next process() call.
+	 */
+	void
+	set_sample (Channel, double sample) noexcept;
+
+	/**
+	 * Push samples set with set_sample() to all channels and compute new values.
+	 * Samples are cleared afterwards.
+	 */
+	void
+	process (Time dt) noexcept;
+
+	/**
+	 * Return last computed value for given channel.
+	 */
+	double
+	value (Channel) const noexcept;
+
+	/**
+	 * Return most recently pushed sample for given channel.
+	 */
+	double
+	last_sample (Channel) const noexcept;
+
+	/**
+	 * Reset given channel to @value.
+	 */
+	void
+	reset (Channel, double value = 0.0) noexcept;
+
+	/**
+	 * Reset given channel to the value given in the next process() call.
+	 */
+	void
+	invalidate (Channel) noexcept;
+
+	/**
+	 * Invalidate all channels.
+	 */
+	using SmootherBase::invalidate;
+
+  protected:
+	void
+	set_smoothing_time_impl (int milliseconds) noexcept override;
+
+  private:
+	/**
+	 * Reallocate storage after changing window size or number of lanes.
+	 */
+	void
+	reallocate();
+
+	/**
+	 * Set all history samples of a lane to @value.
+	 */
+	void
+	fill_lane (std::size_t lane, double value) noexcept;
+
+	/**
+	 * Push row of samples (_row) to the history.
+	 */
+	void
+	push_row() noexcept;
+
+	/**
+	 * Return pointer to the oldest row of the window.
+	 */
+	double const*
+	window_rows() const noexcept;
+
+	/**
+	 * Recompute sliding sums of the Recursive engine from history.
+	 */
+	void
+	anchor() noexcept;
+
+	double
+	encircle (ChannelInfo const&, double s) const noexcept;
+
+	double
+	decircle (ChannelInfo const&, double s) const noexcept;
+
+  private:
+	std::vector<ChannelInfo>	_channels;
+	std::size_t					_lanes					= 0;
+	std::size_t					_stride					= 0;
+	std::size_t					_window_size			= 0;
+	Time						_accumulated_dt			= 0_s;
+	// Rows of the mirrored ring, each with _stride samples:
+	std::vector<double>			_history;
+	// Index of the oldest row:
+	std::size_t					_head					= 0;
+	std::vector<double>			_window;
+	std::vector<double>			_window_cos;
+	std::vector<double>			_window_sin;
+	// Scratch rows:
+	std::vector<double>			_previous;
+	std::vector<double>			_next;
+	std::vector<double>			_row;
+	std::vector<double>			_results;
+	// Recursive engine:
+	double						_rotation_cos			= 1.0;
+	double						_rotation_sin			= 0.0;
+	SlidingSums					_sums;
+	std::size_t					_pushes_since_anchor	= 0;
+};
+
+
+inline std::size_t
+SmootherBank::channels_count() const noexcept
+{
+	return _channels.size();
+}
+
+
+inline void
+SmootherBank::set_sample (Channel channel, double sample) noexcept
+{
+	_channels[channel].sample = sample;
+}
+
+
+inline double
+SmootherBank::value (Channel channel) const noexcept
+{
+	return _channels[channel].value;
+}
+
+
+inline double
+SmootherBank::last_sample (Channel channel) const noexcept
+{
+	return _channels[channel].last_sample;
+}
+
+
+inline void
+SmootherBank::invalidate (Channel channel) noexcept
+{
+	_channels[channel].invalidate = true;
+}
+
+} // namespace Xefis
+
+#endif
+
@@ -0,0 +1,110 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <algorithm>
+#include <numeric>
+
+// Xefis:
+#include <xefis/config/all.h>
+
+// Local:
+#include "spherical_index.h"
+
+
+namespace Xefis {
+
+std::vector<std::size_t>
+SphericalIndex::build (std::vector<LonLat> const& positions)
+{
+	std::vector<Vector> points;
+	points.reserve (positions.size());
+	for (LonLat const& position: positions)
+		points.push_back (to_vector (position));
+
+	std::vector<std::size_t> order (positions.size());
+	std::iota (order.begin(), order.end(), 0);
+	build_subtree (order, points, 0, order.size(), 0);
+
+	_points.clear();
+	_points.reserve (order.size());
+	for (std::size_t i: order)
+		_points.push_back (points[i]);
+
+	_boxes.resize (_points.size());
+	if (!_points.empty())
+		build_boxes (0, _points.size());
+
+	return order;
+}
+
+
+void
+SphericalIndex::adopt (std::vector<LonLat> const& ordered_positions)
+{
+	_points.clear();
+	_points.reserve (ordered_positions.size());
+	for (LonLat const& position: ordered_positions)
+		_points.push_back (to_vector (position));
+
+	_boxes.resize (_points.size());
+	if (!_points.empty())
+		build_boxes (0, _points.size());
+}
+
+
+SphericalIndex::Box
+SphericalIndex::build_boxes (std::size_t begin, std::size_t end)
+{
+	std::size_t const mid = begin + (end - begin) / 2;
+	Box box { _points[mid], _points[mid] };
+
+	for (auto const& range: { std::make_pair (begin, mid), std::make_pair (mid + 1, end) })
+	{
+		if (range.first < range.second)
+		{
+			Box const sub_box = build_boxes (range.first, range.second);
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				box.min[i] = std::min (box.min[i], sub_box.min[i]);
+				box.max[i] = std::max (box.max[i], sub_box.max[i]);
+			}
+		}
+	}
+
+	return _boxes[mid] = box;
+}
+
+
+void
+SphericalIndex::build_subtree (std::vector<std::size_t>& order, std::vector<Vector> const& points, std::size_t begin, std::size_t end, unsigned int dimension)
+{
+	while (end - begin > 1)
+	{
+		std::size_t const mid = begin + (end - begin) / 2;
+
+		std::nth_element (order.begin() + begin, order.begin() + mid, order.begin() + end, [&](std::size_t a, std::size_t b) {
+			return points[a][dimension] < points[b][dimension];
+		});
+
+		unsigned int const next_dimension = (dimension + 1) % 3;
+		build_subtree (order, points, begin, mid, next_dimension);
+		begin = mid + 1;
+		dimension = next_dimension;
+	}
+}
+
+} // namespace Xefis
+
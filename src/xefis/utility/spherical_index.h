@@ -0,0 +1,490 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+#ifndef XEFIS__UTILITY__SPHERICAL_INDEX_H__INCLUDED
+#define XEFIS__UTILITY__SPHERICAL_INDEX_H__INCLUDED
+
+// Standard:
+#include <cstddef>
+#include <array>
+#include <cmath>
+#include <queue>
+#include <vector>
+
+// Xefis:
+#include <xefis/config/all.h>
+
+
+namespace Xefis {
+
+/**
+ * Immutable spatial index of points on a sphere.
+ *
+ * Points are stored as 3D unit vectors in a flat array laid out as an implicit, balanced k-d tree:
+ * the root of the range [begin, end) is at (begin + end) / 2, and split dimension cycles x, y, z
+ * with depth. Since it works on unit vectors, there are no special cases near the poles or the antimeridian.
+ * Each subtree also has a tight bounding box stored at its root position, used by difference
+ * and nearest-first queries.
+ *
+ * The index doesn't store user data. build() returns a permutation, that should be applied
+ * to user data, so that query results (positions in the index) can be used to access it directly.
+ */
+class SphericalIndex
+{
+  public:
+	// Single precision gives sub-meter resolution on Earth and halves memory traffic:
+	typedef std::array<float, 3> Vector;
+
+	/**
+	 * Iterates over points of the index ordered by distance from a center point, nearest first.
+	 * Points are found lazily (best-first search), so taking first K points costs roughly
+	 * O(K log N), and there's no need to know K in advance.
+	 *
+	 * The index must not be modified while iterator is in use.
+	 */
+	class NearestIterator
+	{
+		struct Entry
+		{
+			float		squared_chord;
+			std::size_t	begin;
+			std::size_t	end;
+			bool		point;
+
+			// Reversed, so that std::priority_queue returns the nearest entry:
+			bool
+			operator< (Entry const& other) const noexcept;
+		};
+
+	  public:
+		// Ctor
+		NearestIterator (SphericalIndex const&, LonLat const& center);
+
+		/**
+		 * Return true if iterator points to a point (is not at the end).
+		 */
+		explicit
+		operator bool() const noexcept;
+
+		/**
+		 * Return position of the current point in the index.
+		 */
+		std::size_t
+		operator*() const noexcept;
+
+		/**
+		 * Go to the next nearest point.
+		 */
+		NearestIterator&
+		operator++();
+
+		/**
+		 * Squared chord length between the center and the current point.
+		 * It's monotonic with the great-circle distance.
+		 */
+		float
+		squared_chord() const noexcept;
+
+	  private:
+		/**
+		 * Expand subtrees until the nearest entry is a point.
+		 */
+		void
+		find_next_point();
+
+		/**
+		 * Enqueue subtree [begin, end), if it's not empty.
+		 */
+		void
+		push_subtree (std::size_t begin, std::size_t end);
+
+	  private:
+		SphericalIndex const*		_index;
+		Vector						_center;
+		std::priority_queue<Entry>	_queue;
+	};
+
+  public:
+	/**
+	 * Build index from points.
+	 * Return permutation: point at index position i is positions[result[i]].
+	 */
+	std::vector<std::size_t>
+	build (std::vector<LonLat> const& positions);
+
+	/**
+	 * Use points, that are already in index order (for example previously permuted
+	 * with the result of build() and stored in a file).
+	 */
+	void
+	adopt (std::vector<LonLat> const& ordered_positions);
+
+	/**
+	 * Number of points.
+	 */
+	std::size_t
+	size() const noexcept;
+
+	/**
+	 * Call callback (std::size_t index) for each point within great-circle
+	 * angular distance @radius from @center.
+	 */
+	template<class Callback>
+		void
+		for_each_within (LonLat const& center, Angle radius, Callback&& callback) const;
+
+	/**
+	 * Call callback (std::size_t index) for each point within @radius from @center,
+	 * that is not within @excluded_radius from @excluded_center. Used for incremental
+	 * updates of query results when the query circle moves: subtrees lying entirely
+	 * in the excluded circle are skipped, so the cost depends mostly on the area
+	 * of the difference, not of the whole circle.
+	 *
+	 * A point is reported by for_each_within_difference (a, b) if and only if it's
+	 * reported by for_each_within (a) and not by for_each_within (b).
+	 */
+	template<class Callback>
+		void
+		for_each_within_difference (LonLat const& center, Angle radius, LonLat const& excluded_center, Angle excluded_radius, Callback&& callback) const;
+
+	/**
+	 * Return iterator over points ordered by distance from @center, nearest first.
+	 */
+	NearestIterator
+	nearest (LonLat const& center) const;
+
+	/**
+	 * Convert LonLat to a 3D unit vector.
+	 */
+	static Vector
+	to_vector (LonLat const& position) noexcept;
+
+	/**
+	 * Return squared chord length corresponding to given great-circle angle.
+	 */
+	static float
+	squared_chord (Angle angle) noexcept;
+
+	/**
+	 * Return great-circle angle corresponding to given distance on Earth.
+	 */
+	static Angle
+	earth_angle (Length distance) noexcept;
+
+  private:
+	struct Box
+	{
+		Vector	min;
+		Vector	max;
+	};
+
+	struct DifferenceQuery
+	{
+		Vector	center;
+		float	max_squared_chord;
+		Vector	excluded_center;
+		float	excluded_squared_chord;
+	};
+
+	/**
+	 * Compute bounding boxes of subtrees in range [begin, end) and return box of the whole range.
+	 */
+	Box
+	build_boxes (std::size_t begin, std::size_t end);
+
+	/**
+	 * Reorder order[begin, end) so that it forms implicit k-d tree.
+	 */
+	void
+	build_subtree (std::vector<std::size_t>& order, std::vector<Vector> const& points, std::size_t begin, std::size_t end, unsigned int dimension);
+
+	template<class Callback>
+		void
+		query_subtree (std::size_t begin, std::size_t end, unsigned int dimension, Vector const& center, float max_squared_chord, float max_chord, Callback& callback) const;
+
+	template<class Callback>
+		void
+		query_difference_subtree (std::size_t begin, std::size_t end, DifferenceQuery const& query, Callback& callback) const;
+
+	static float
+	squared_distance (Vector const& a, Vector const& b) noexcept;
+
+	/**
+	 * Lower bound of squared_distance() between @center and any point in the @box.
+	 */
+	static float
+	min_squared_distance (Box const& box, Vector const& center) noexcept;
+
+	/**
+	 * Upper bound of squared_distance() between @center and any point in the @box.
+	 */
+	static float
+	max_squared_distance (Box const& box, Vector const& center) noexcept;
+
+  private:
+	std::vector<Vector>	_points;
+	// Bounding box of the subtree rooted at given position:
+	std::vector<Box>	_boxes;
+};
+
+
+inline bool
+SphericalIndex::NearestIterator::Entry::operator< (Entry const& other) const noexcept
+{
+	return squared_chord > other.squared_chord;
+}
+
+
+inline
+SphericalIndex::NearestIterator::NearestIterator (SphericalIndex const& index, LonLat const& center):
+	_index (&index),
+	_center (to_vector (center))
+{
+	push_subtree (0, _index->_points.size());
+	find_next_point();
+}
+
+
+inline
+SphericalIndex::NearestIterator::operator bool() const noexcept
+{
+	return !_queue.empty();
+}
+
+
+inline std::size_t
+SphericalIndex::NearestIterator::operator*() const noexcept
+{
+	return _queue.top().begin;
+}
+
+
+inline SphericalIndex::NearestIterator&
+SphericalIndex::NearestIterator::operator++()
+{
+	_queue.pop();
+	find_next_point();
+	return *this;
+}
+
+
+inline float
+SphericalIndex::NearestIterator::squared_chord() const noexcept
+{
+	return _queue.top().squared_chord;
+}
+
+
+inline void
+SphericalIndex::NearestIterator::find_next_point()
+{
+	// Box distances are lower bounds of distances of points in boxes,
+	// so when a point is on top, no other point can be nearer:
+	while (!_queue.empty() && !_queue.top().point)
+	{
+		Entry const subtree = _queue.top();
+		_queue.pop();
+
+		std::size_t const mid = subtree.begin + (subtree.end - subtree.begin) / 2;
+		_queue.push ({ squared_distance (_index->_points[mid], _center), mid, mid + 1, true });
+		push_subtree (subtree.begin, mid);
+		push_subtree (mid + 1, subtree.end);
+	}
+}
+
+
+inline void
+SphericalIndex::NearestIterator::push_subtree (std::size_t begin, std::size_t end)
+{
+	if (begin < end)
+	{
+		std::size_t const mid = begin + (end - begin) / 2;
+		_queue.push ({ min_squared_distance (_index->_boxes[mid], _center), begin, end, false });
+	}
+}
+
+
+inline std::size_t
+SphericalIndex::size() const noexcept
+{
+	return _points.size();
+}
+
+
+inline SphericalIndex::NearestIterator
+SphericalIndex::nearest (LonLat const& center) const
+{
+	return NearestIterator (*this, center);
+}
+
+
+template<class Callback>
+	inline void
+	SphericalIndex::for_each_within (LonLat const& center, Angle radius, Callback&& callback) const
+	{
+		float const max_squared_chord = squared_chord (radius);
+		query_subtree (0, _points.size(), 0, to_vector (center), max_squared_chord, std::sqrt (max_squared_chord), callback);
+	}
+
+
+template<class Callback>
+	inline void
+	SphericalIndex::for_each_within_difference (LonLat const& center, Angle radius, LonLat const& excluded_center, Angle excluded_radius, Callback&& callback) const
+	{
+		DifferenceQuery const query {
+			to_vector (center),
+			squared_chord (radius),
+			to_vector (excluded_center),
+			squared_chord (excluded_radius),
+		};
+		query_difference_subtree (0, _points.size(), query, callback);
+	}
+
+
+inline SphericalIndex::Vector
+SphericalIndex::to_vector (LonLat const& position) noexcept
+{
+	double const lon = position.lon().quantity<Radian>();
+	double const lat = position.lat().quantity<Radian>();
+	double const cos_lat = std::cos (lat);
+
+	return { static_cast<float> (cos_lat * std::cos (lon)),
+			 static_cast<float> (cos_lat * std::sin (lon)),
+			 static_cast<float> (std::sin (lat)) };
+}
+
+
+inline float
+SphericalIndex::squared_chord (Angle angle) noexcept
+{
+	// Chord length is 2 sin (angle / 2); limit to antipodal point:
+	double const half = 0.5 * std::min (std::abs (angle.quantity<Radian>()), M_PI);
+	double const chord = 2.0 * std::sin (half);
+	return chord * chord;
+}
+
+
+inline Angle
+SphericalIndex::earth_angle (Length distance) noexcept
+{
+	return 1_rad * (distance / kEarthMeanRadius);
+}
+
+
+template<class Callback>
+	inline void
+	SphericalIndex::query_subtree (std::size_t begin, std::size_t end, unsigned int dimension, Vector const& center,
+								   float max_squared_chord, float max_chord, Callback& callback) const
+	{
+		while (begin < end)
+		{
+			std::size_t const mid = begin + (end - begin) / 2;
+			Vector const& point = _points[mid];
+
+			if (squared_distance (point, center) <= max_squared_chord)
+				callback (mid);
+
+			// Left subtree has coordinates <= point's, right one >= point's:
+			float const delta = center[dimension] - point[dimension];
+			unsigned int const next_dimension = (dimension + 1) % 3;
+			bool const go_left = delta <= max_chord;
+			bool const go_right = delta >= -max_chord;
+
+			if (go_left && go_right)
+			{
+				query_subtree (begin, mid, next_dimension, center, max_squared_chord, max_chord, callback);
+				begin = mid + 1;
+			}
+			else if (go_left)
+				end = mid;
+			else
+				begin = mid + 1;
+
+			dimension = next_dimension;
+		}
+	}
+
+
+template<class Callback>
+	inline void
+	SphericalIndex::query_difference_subtree (std::size_t begin, std::size_t end, DifferenceQuery const& query, Callback& callback) const
+	{
+		while (begin < end)
+		{
+			std::size_t const mid = begin + (end - begin) / 2;
+			Box const& box = _boxes[mid];
+
+			// Skip subtrees that are out of the query circle or entirely in the excluded one:
+			if (min_squared_distance (box, query.center) > query.max_squared_chord ||
+				max_squared_distance (box, query.excluded_center) <= query.excluded_squared_chord)
+			{
+				return;
+			}
+
+			Vector const& point = _points[mid];
+
+			if (squared_distance (point, query.center) <= query.max_squared_chord &&
+				squared_distance (point, query.excluded_center) > query.excluded_squared_chord)
+			{
+				callback (mid);
+			}
+
+			query_difference_subtree (begin, mid, query, callback);
+			begin = mid + 1;
+		}
+	}
+
+
+inline float
+SphericalIndex::squared_distance (Vector const& a, Vector const& b) noexcept
+{
+	float const dx = a[0] - b[0];
+	float const dy = a[1] - b[1];
+	float const dz = a[2] - b[2];
+	return dx * dx + dy * dy + dz * dz;
+}
+
+
+inline float
+SphericalIndex::min_squared_distance (Box const& box, Vector const& center) noexcept
+{
+	// Computed the same way as squared_distance(), and rounding is monotonic, so the result
+	// is never greater than squared_distance() for any point in the box:
+	float d[3];
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		if (center[i] < box.min[i])
+			d[i] = box.min[i] - center[i];
+		else if (center[i] > box.max[i])
+			d[i] = center[i] - box.max[i];
+		else
+			d[i] = 0.f;
+	}
+	return d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+}
+
+
+inline float
+SphericalIndex::max_squared_distance (Box const& box, Vector const& center) noexcept
+{
+	float d[3];
+	for (unsigned int i = 0; i < 3; ++i)
+		d[i] = std::max (std::abs (box.min[i] - center[i]), std::abs (box.max[i] - center[i]));
+	return d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+}
+
+} // namespace Xefis
+
+#endif
+
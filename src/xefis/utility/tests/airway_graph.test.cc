@@ -0,0 +1,141 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+// Xefis:
+#include <xefis/test/test.h>
+#include <xefis/utility/airway_graph.h>
+
+
+namespace Xefis {
+namespace Test {
+
+/**
+ * Reference implementation: Dijkstra's algorithm with a linear search for the nearest node.
+ */
+static double
+reference_distance (std::vector<LonLat> const& positions, std::vector<AirwayGraph::Segment> const& segments,
+					std::vector<AirwayGraph::NodeID> const& sources, std::vector<AirwayGraph::NodeID> const& targets, uint8_t classes)
+{
+	double const kInfinity = std::numeric_limits<double>::infinity();
+	std::vector<double> distances (positions.size(), kInfinity);
+	std::vector<bool> done (positions.size(), false);
+
+	for (auto node: sources)
+		distances[node] = 0.0;
+
+	while (true)
+	{
+		std::size_t best = positions.size();
+		for (std::size_t n = 0; n < positions.size(); ++n)
+			if (!done[n] && distances[n] < kInfinity && (best == positions.size() || distances[n] < distances[best]))
+				best = n;
+
+		if (best == positions.size())
+			return kInfinity;
+
+		for (auto node: targets)
+			if (node == best)
+				return distances[best];
+
+		done[best] = true;
+
+		for (auto const& segment: segments)
+		{
+			if (!(segment.classes & classes))
+				continue;
+
+			double const length = positions[segment.a].haversine (positions[segment.b]);
+			if (segment.a == best)
+				distances[segment.b] = std::min (distances[segment.b], distances[best] + length);
+			else if (segment.b == best)
+				distances[segment.a] = std::min (distances[segment.a], distances[best] + length);
+		}
+	}
+}
+
+
+static xf::RuntimeTest t1 ("AirwayGraph shortest routes", []{
+	using namespace xf::TestAsserts;
+
+	std::mt19937 rng (1);
+	std::uniform_real_distribution<double> lon_dist (-10.0, 30.0);
+	std::uniform_real_distribution<double> lat_dist (35.0, 60.0);
+	std::uniform_int_distribution<int> class_dist (1, 2);
+
+	std::vector<LonLat> positions;
+	for (int i = 0; i < 300; ++i)
+		positions.emplace_back (1_deg * lon_dist (rng), 1_deg * lat_dist (rng));
+
+	// Connect each node with its three nearest neighbours:
+	std::vector<AirwayGraph::Segment> segments;
+	for (AirwayGraph::NodeID a = 0; a < positions.size(); ++a)
+	{
+		std::vector<std::pair<double, AirwayGraph::NodeID>> neighbours;
+		for (AirwayGraph::NodeID b = 0; b < positions.size(); ++b)
+			if (b != a)
+				neighbours.emplace_back (positions[a].haversine (positions[b]), b);
+		std::partial_sort (neighbours.begin(), neighbours.begin() + 3, neighbours.end());
+
+		for (int k = 0; k < 3; ++k)
+			segments.push_back ({ a, neighbours[k].second, a, static_cast<uint8_t> (class_dist (rng)) });
+	}
+
+	AirwayGraph graph (positions, segments);
+	verify ("graph has two edges per segment", graph.edges_count() == 2 * segments.size());
+
+	std::uniform_int_distribution<AirwayGraph::NodeID> node_dist (0, positions.size() - 1);
+
+	for (int q = 0; q < 100; ++q)
+	{
+		std::vector<AirwayGraph::NodeID> sources { node_dist (rng) };
+		std::vector<AirwayGraph::NodeID> targets { node_dist (rng) };
+		if (q % 3 == 0)
+			targets.push_back (node_dist (rng));
+		uint8_t const classes = q % 4 == 0 ? 1 : 0xff;
+
+		double const expected = reference_distance (positions, segments, sources, targets, classes);
+		auto route = graph.shortest_route (sources, targets, classes);
+
+		if (std::isinf (expected))
+			verify ("no route to unreachable target", !route);
+		else
+		{
+			verify ("route is found", !!route);
+			verify ("route distance is the shortest one", std::abs (route->distance / kEarthMeanRadius - expected) < 1e-5);
+			verify ("route starts at a source", route->nodes.front() == sources[0]);
+			verify ("route ends at a target", std::find (targets.begin(), targets.end(), route->nodes.back()) != targets.end());
+			verify ("route has a leg between each pair of nodes", route->edges.size() + 1 == route->nodes.size());
+
+			double legs_distance = 0.0;
+			for (std::size_t i = 0; i < route->edges.size(); ++i)
+			{
+				verify ("leg leads to the next node", route->edges[i]->target == route->nodes[i + 1]);
+				verify ("leg has allowed class", route->edges[i]->classes & classes);
+				legs_distance += route->edges[i]->distance;
+			}
+			verify ("route distance is a sum of legs", std::abs (legs_distance - expected) < 1e-5);
+		}
+	}
+});
+
+} // namespace Test
+} // namespace Xefis
+
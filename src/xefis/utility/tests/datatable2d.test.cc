@@ -13,6 +13,7 @@
 
 // Standard:
 #include <cstddef>
+#include <cmath>
 
 // Xefis:
 #include <xefis/test/test.h>
@@ -43,6 +44,75 @@ static xf::RuntimeTest t1 ("Datatable2D<>", []{
 	verify_equal_with_epsilon ("average ({ -2.0, 2.0 }) is correct", d.average ({ -2.0, 2.0 }), 0.0, 0.001);
 });
 
+
+static xf::RuntimeTest t2 ("Datatable2D<> lookups", []{
+	using namespace xf::TestAsserts;
+
+	// Reference piecewise-linear interpolation:
+	auto reference_value = [](std::map<double, double> const& m, double x) {
+		auto b = m.lower_bound (x);
+		if (b == m.begin())
+			return b->second;
+		auto a = std::prev (b);
+		return a->second + (x - a->first) / (b->first - a->first) * (b->second - a->second);
+	};
+
+	auto reference_arguments = [](std::map<double, double> const& m, double v) {
+		std::vector<double> result;
+		if (m.begin()->second == v)
+			result.push_back (m.begin()->first);
+		for (auto a = m.begin(), b = std::next (a); b != m.end(); ++a, ++b)
+			if ((a->second < v && v <= b->second) || (b->second <= v && v < a->second))
+				result.push_back (a->first + (v - a->second) / (b->second - a->second) * (b->first - a->first));
+		return result;
+	};
+
+	auto check = [&](std::string const& name, std::map<double, double> const& m, bool uniform) {
+		Datatable2D<double, double> d (m);
+		bool values_ok = true;
+		bool arguments_ok = true;
+
+		for (double x = d.domain().min(); x <= d.domain().max(); x += 0.0137)
+			values_ok = values_ok && std::abs (*d.value (x) - reference_value (m, x)) < 1e-9;
+
+		for (auto const& p: m)
+			values_ok = values_ok && std::abs (*d.value (p.first) - p.second) < 1e-9;
+
+		for (double v = d.codomain().min() - 1.0; v <= d.codomain().max() + 1.0; v += 0.25)
+		{
+			auto points = d.arguments (v);
+			auto expected = reference_arguments (m, v);
+			arguments_ok = arguments_ok && points.size() == expected.size();
+			for (std::size_t i = 0; arguments_ok && i < points.size(); ++i)
+				arguments_ok = std::abs (points[i].argument - expected[i]) < 1e-9;
+		}
+
+		// Sorted sweep with extrapolation on both sides, followed by unsorted arguments:
+		std::vector<double> batch_arguments;
+		for (double x = d.domain().min() - 2.0; x <= d.domain().max() + 2.0; x += 0.0137)
+			batch_arguments.push_back (x);
+		for (double x: { 3.3, -5.0, 0.1, 8.8, 1.0 })
+			batch_arguments.push_back (x);
+
+		std::vector<double> batch_values (batch_arguments.size());
+		d.extrapolated_values (batch_arguments.data(), batch_values.data(), batch_arguments.size());
+		bool batch_ok = true;
+
+		for (std::size_t i = 0; i < batch_arguments.size(); ++i)
+			batch_ok = batch_ok && std::abs (batch_values[i] - d.extrapolated_value (batch_arguments[i])) < 1e-9;
+
+		verify (name + ": uniform() is correct", d.uniform() == uniform);
+		verify (name + ": extrapolated_values() matches extrapolated_value()", batch_ok);
+		verify (name + ": value() matches interpolation", values_ok);
+		verify (name + ": arguments() matches interpolation", arguments_ok);
+		verify ("value() outside of domain is empty", !d.value (d.domain().max() + 0.1));
+	};
+
+	check ("uniform", { { -2.0, 1.0 }, { -1.0, 3.0 }, { 0.0, 3.0 }, { 1.0, 2.0 }, { 2.0, 5.0 }, { 3.0, -1.0 } }, true);
+	check ("resampled", { { 0.0, 0.0 }, { 2.0, 4.0 }, { 5.0, 1.0 }, { 6.0, 1.0 }, { 6.5, 3.0 }, { 9.0, 0.0 } }, true);
+	check ("irregular", { { 0.0, 0.0 }, { 1.0, 4.0 }, { 1.0 + M_PI, 1.0 }, { 7.0, 2.0 }, { 7.1, 3.0 } }, false);
+});
+
 } // namespace Test
 } // namespace Xefis
 
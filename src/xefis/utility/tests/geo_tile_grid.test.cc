@@ -0,0 +1,110 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+// Xefis:
+#include <xefis/test/random_positions.h>
+#include <xefis/test/test.h>
+#include <xefis/utility/geo_tile_grid.h>
+
+
+namespace Xefis {
+namespace Test {
+
+/**
+ * Return positions on tile seams and corners near @center, and just off them on both sides.
+ */
+static std::vector<LonLat>
+seam_positions (LonLat const& center, Angle tile_size)
+{
+	double const size_deg = tile_size.quantity<Degree>();
+	double const lon_seam_deg = std::round (center.lon().quantity<Degree>() / size_deg) * size_deg;
+	double const lat_seam_deg = std::round (center.lat().quantity<Degree>() / size_deg) * size_deg;
+
+	std::vector<LonLat> positions;
+	for (int i = -2; i <= 2; ++i)
+	{
+		for (int j = -2; j <= 2; ++j)
+		{
+			for (double offset_deg: { -1e-7, 0.0, 1e-7 })
+			{
+				double lon_deg = lon_seam_deg + i * size_deg + offset_deg;
+				double lat_deg = lat_seam_deg + j * size_deg + offset_deg;
+				// Wrap longitude into [-180, 180], keep latitude within [-90, 90]:
+				lon_deg = std::remainder (lon_deg, 360.0);
+				if (std::abs (lat_deg) <= 90.0)
+					positions.emplace_back (1_deg * lon_deg, 1_deg * lat_deg);
+			}
+		}
+	}
+
+	return positions;
+}
+
+
+static xf::RuntimeTest t1 ("GeoTileGrid tiles within radius", []{
+	using namespace xf::TestAsserts;
+
+	std::mt19937 rng (1);
+	std::vector<LonLat> const random_positions = uniform_sphere_positions (20000, rng);
+
+	// Centers on tile corners, on the antimeridian from both sides, on the poles,
+	// and on latitudes where the cap just touches a pole:
+	LonLat const centers[] = {
+		{ 0_deg, 0_deg },
+		{ 30_deg, 45_deg },
+		{ 180_deg, 0_deg },
+		{ -180_deg, -30_deg },
+		{ 0_deg, 90_deg },
+		{ 45_deg, -90_deg },
+		{ 10_deg, 80_deg },
+		{ -120_deg, -70_deg },
+	};
+
+	for (Angle tile_size: { 1_deg, 2_deg, 15_deg })
+	{
+		GeoTileGrid grid (tile_size);
+
+		for (LonLat const& center: centers)
+		{
+			std::vector<LonLat> positions = seam_positions (center, tile_size);
+			positions.insert (positions.end(), random_positions.begin(), random_positions.end());
+
+			for (LonLat const& position: positions)
+				verify ("tile of each position is valid", grid.tile_of (position) < grid.tiles_count());
+
+			for (Angle radius: { 0.5_deg, 3_deg, 10_deg, 20_deg, 100_deg })
+			{
+				std::vector<GeoTileGrid::TileID> tiles = grid.tiles_within (center, radius);
+				std::set<GeoTileGrid::TileID> tiles_set (tiles.begin(), tiles.end());
+
+				verify ("tiles aren't repeated", tiles_set.size() == tiles.size());
+
+				for (LonLat const& position: positions)
+					if (center.haversine (position) <= radius.quantity<Radian>())
+						verify ("tile of each point within radius is returned", tiles_set.count (grid.tile_of (position)) > 0);
+			}
+		}
+	}
+});
+
+} // namespace Test
+} // namespace Xefis
+
@@ -0,0 +1,304 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+#include <deque>
+#include <random>
+#include <vector>
+
+// Xefis:
+#include <xefis/test/test.h>
+#include <xefis/utility/dot_product.h>
+#include <xefis/utility/mirrored_ring.h>
+#include <xefis/utility/multi_resolution_history.h>
+#include <xefis/utility/smoother.h>
+
+
+namespace Xefis {
+namespace Test {
+
+/**
+ * Feed the same random signal to FIR and Recursive smoothers and return
+ * the largest difference between their outputs.
+ */
+template<class Input>
+	static double
+	max_engine_difference (Time smoothing_time, Range<double> const* winding, int updates, Input input)
+	{
+		Smoother<double> fir (smoothing_time);
+		Smoother<double> recursive (smoothing_time);
+		recursive.set_engine (SmootherBase::Engine::Recursive);
+
+		if (winding)
+		{
+			fir.set_winding (*winding);
+			recursive.set_winding (*winding);
+		}
+
+		std::mt19937 rng (1);
+		std::uniform_real_distribution<double> dt_ms (0.0, 50.0);
+		double max_difference = 0.0;
+
+		for (int i = 0; i < updates; ++i)
+		{
+			double sample = input (rng);
+			Time dt = dt_ms (rng) * 1_ms;
+			double a = fir.process (sample, dt);
+			double b = recursive.process (sample, dt);
+			double difference = std::abs (a - b);
+
+			if (winding)
+				difference = std::min (difference, winding->extent() - difference);
+
+			max_difference = std::max (max_difference, difference);
+
+			// Exercise reset, as done by modules when input becomes invalid:
+			if (i % 997 == 0)
+			{
+				fir.invalidate();
+				recursive.invalidate();
+			}
+		}
+
+		return max_difference;
+	}
+
+
+static xf::RuntimeTest t1 ("Smoother<> Recursive engine is equivalent to FIR", []{
+	using namespace xf::TestAsserts;
+
+	std::uniform_real_distribution<double> noise (-100.0, 100.0);
+	auto signal = [&](std::mt19937& rng) { return 1000.0 + noise (rng); };
+
+	verify ("outputs match for short window", max_engine_difference (3_ms, nullptr, 20000, signal) < 1e-9);
+	verify ("outputs match for 100 ms window", max_engine_difference (100_ms, nullptr, 20000, signal) < 1e-9);
+	verify ("outputs match for 2 s window", max_engine_difference (2_s, nullptr, 5000, signal) < 1e-9);
+	verify ("outputs match for 5 s window", max_engine_difference (5_s, nullptr, 2000, signal) < 1e-9);
+});
+
+
+static xf::RuntimeTest t2 ("Smoother<> Recursive engine is equivalent to FIR in winding mode", []{
+	using namespace xf::TestAsserts;
+
+	Range<double> const winding (0.0, 360.0);
+	std::uniform_real_distribution<double> noise (-30.0, 30.0);
+	// Signal oscillating around the 0°/360° boundary:
+	auto signal = [&](std::mt19937& rng) { return floored_mod (noise (rng), 0.0, 360.0); };
+
+	verify ("outputs match for 200 ms window", max_engine_difference (200_ms, &winding, 20000, signal) < 1e-9);
+	verify ("outputs match for 5 s window", max_engine_difference (5_s, &winding, 2000, signal) < 1e-9);
+});
+
+
+static xf::RuntimeTest t3 ("Smoother<> Recursive engine step response", []{
+	using namespace xf::TestAsserts;
+
+	Smoother<double> smoother (1_s);
+	smoother.set_engine (SmootherBase::Engine::Recursive);
+	smoother.process (0.0, 10_ms);
+
+	for (int i = 0; i < 50; ++i)
+		smoother.process (1.0, 10_ms);
+
+	verify ("output is halfway after half the smoothing time", std::abs (smoother.value() - 0.5) < 0.02);
+
+	for (int i = 0; i < 60; ++i)
+		smoother.process (1.0, 10_ms);
+
+	verify ("output reaches target after smoothing time", std::abs (smoother.value() - 1.0) < 1e-9);
+});
+
+
+static xf::RuntimeTest t4 ("Smoother<> FIR kernel on mirrored ring", []{
+	using namespace xf::TestAsserts;
+
+	std::mt19937 rng (1);
+	std::uniform_real_distribution<double> noise (-1.0, 1.0);
+
+	bool products_match = true;
+	bool ring_ordered = true;
+
+	// Cover all remainders of the vectorized loops:
+	for (std::size_t n = 1; n < 40; ++n)
+	{
+		MirroredRing<double> ring (n);
+		std::vector<double> a;
+		std::vector<double> b (n);
+		std::vector<double> w (n);
+
+		for (std::size_t i = 0; i < 3 * n + 1; ++i)
+		{
+			a.push_back (noise (rng));
+			ring.push_back (a.back());
+		}
+
+		a.erase (a.begin(), a.end() - n);
+
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			ring_ordered = ring_ordered && ring.data()[i] == a[i] && ring[i] == a[i];
+			b[i] = noise (rng);
+			w[i] = noise (rng);
+		}
+
+		double expected_a = 0.0;
+		double expected_b = 0.0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			expected_a += a[i] * w[i];
+			expected_b += b[i] * w[i];
+		}
+
+		double aw, bw;
+		dot_products (ring.data(), b.data(), w.data(), n, aw, bw);
+
+		products_match = products_match
+			&& std::abs (dot_product (ring.data(), w.data(), n) - expected_a) < 1e-12
+			&& std::abs (aw - expected_a) < 1e-12
+			&& std::abs (bw - expected_b) < 1e-12;
+	}
+
+	bool columns_match = true;
+
+	for (std::size_t columns = 1; columns < 12; ++columns)
+	{
+		for (std::size_t n = 1; n < 6; ++n)
+		{
+			std::vector<double> rows (n * columns);
+			std::vector<double> w (n);
+			std::vector<double> result (columns);
+
+			for (auto& v: rows)
+				v = noise (rng);
+			for (auto& v: w)
+				v = noise (rng);
+
+			column_dot_products (rows.data(), w.data(), n, columns, result.data());
+
+			for (std::size_t c = 0; c < columns; ++c)
+			{
+				double expected = 0.0;
+				for (std::size_t i = 0; i < n; ++i)
+					expected += rows[i * columns + c] * w[i];
+				columns_match = columns_match && std::abs (result[c] - expected) < 1e-12;
+			}
+		}
+	}
+
+	verify ("ring exposes samples from oldest to newest", ring_ordered);
+	verify ("dot products match sequential sums", products_match);
+	verify ("column dot products match sequential sums", columns_match);
+});
+
+
+static xf::RuntimeTest t5 ("Smoother<> MultiResolutionHistory error bounds", []{
+	using namespace xf::TestAsserts;
+
+	std::mt19937 rng (1);
+	std::normal_distribution<double> step (0.0, 1.0);
+
+	struct Config
+	{
+		std::size_t	window_size;
+		std::size_t	decimation;
+		std::size_t	full_resolution;
+	};
+
+	bool exact_without_decimation = true;
+	bool within_bounds = true;
+	bool constant_exact = true;
+
+	// Last configs have M + D > N and get clamped:
+	for (Config config: { Config { 3, 1, 1 }, Config { 100, 1, 5 }, Config { 100, 7, 5 }, Config { 37, 5, 1 }, Config { 1000, 7, 14 },
+						  Config { 3, 3, 2 }, Config { 10, 3, 20 }, Config { 10, 7, 5 }, Config { 5, 50, 1 } })
+	{
+		std::size_t const N = config.window_size;
+		double const D = config.decimation;
+
+		MultiResolutionHistory<double> decimated (N, config.decimation, config.full_resolution);
+		std::deque<double> history (N, 3.0);
+		decimated.fill (3.0);
+
+		constant_exact = constant_exact && std::abs (decimated.windowed_sum() - 3.0 * (N - 1) / 2.0) < 1e-9;
+
+		double x = 3.0;
+		for (int i = 0; i < 3000; ++i)
+		{
+			// Random walk with occasional steps:
+			x += step (rng) + (i % 500 == 0 ? 50.0 : 0.0);
+			history.pop_front();
+			history.push_back (x);
+			decimated.push_back (x);
+
+			double sum = 0.0;
+			double total_variation = 0.0;
+			for (std::size_t n = 0; n < N; ++n)
+			{
+				sum += history[n] * 0.5 * (1.0 - std::cos (2.0 * M_PI * n / (N - 1)));
+				if (n > 0)
+					total_variation += std::abs (history[n] - history[n - 1]);
+			}
+
+			double error = std::abs (decimated.windowed_sum() - sum) * 2.0 / (N - 1);
+			double bound = 2.0 * M_PI * D * (D - 1) / ((N - 1.0) * (N - 1.0)) * total_variation;
+
+			if (config.decimation == 1)
+				exact_without_decimation = exact_without_decimation && error < 1e-9;
+			else
+				within_bounds = within_bounds && error <= bound + 1e-9;
+		}
+	}
+
+	verify ("constant signal is reproduced exactly", constant_exact);
+	verify ("result is exact when decimation is 1", exact_without_decimation);
+	verify ("error is within documented bounds", within_bounds);
+});
+
+
+static xf::RuntimeTest t6 ("Smoother<> MultiResolution engine tracks FIR", []{
+	using namespace xf::TestAsserts;
+
+	for (bool winding: { false, true })
+	{
+		Smoother<double> fir (2_s);
+		Smoother<double> multi_resolution (2_s);
+		multi_resolution.set_engine (SmootherBase::Engine::MultiResolution);
+
+		if (winding)
+		{
+			fir.set_winding ({ 0.0, 360.0 });
+			multi_resolution.set_winding ({ 0.0, 360.0 });
+		}
+
+		double max_difference = 0.0;
+
+		// Steps of 90 every second, with 10 ms updates:
+		for (int i = 0; i < 1000; ++i)
+		{
+			double sample = 90.0 * ((i / 100) % 4) + 10.0;
+			double a = fir.process (sample, 10_ms);
+			double b = multi_resolution.process (sample, 10_ms);
+			max_difference = std::max (max_difference, std::abs (a - b));
+		}
+
+		// 2 steps of 90 in the window, D = 15, N = 2000: bound is 2π·15·14/1999²·180 ≈ 0.06.
+		verify (winding ? "winding output follows FIR engine" : "output follows FIR engine", max_difference < 0.06);
+	}
+});
+
+} // namespace Test
+} // namespace Xefis
+
@@ -0,0 +1,155 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+// Standard:
+#include <cstddef>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Xefis:
+#include <xefis/test/test.h>
+#include <xefis/utility/smoother.h>
+#include <xefis/utility/smoother_bank.h>
+
+
+namespace Xefis {
+namespace Test {
+
+/**
+ * Feed random signals to a SmootherBank and to separate Smoothers and return
+ * the largest difference between their outputs.
+ */
+static double
+max_bank_difference (Time smoothing_time, SmootherBase::Engine engine, int updates)
+{
+	Range<double> const winding (-180.0, 180.0);
+	std::size_t const channels = 7;
+
+	SmootherBank bank (smoothing_time);
+	bank.set_engine (engine);
+	std::vector<Smoother<double>> smoothers (channels, Smoother<double> (smoothing_time));
+
+	for (std::size_t c = 0; c < channels; ++c)
+	{
+		smoothers[c].set_engine (engine);
+		// Mix winding and linear channels:
+		if (c % 3 == 0)
+		{
+			bank.add_channel (winding);
+			smoothers[c].set_winding (winding);
+		}
+		else
+			bank.add_channel();
+	}
+
+	std::mt19937 rng (1);
+	std::uniform_real_distribution<double> dt_ms (0.0, 50.0);
+	std::uniform_real_distribution<double> noise (-179.0, 179.0);
+	double max_difference = 0.0;
+
+	for (int i = 0; i < updates; ++i)
+	{
+		Time dt = dt_ms (rng) * 1_ms;
+
+		for (std::size_t c = 0; c < channels; ++c)
+		{
+			// Channels are invalidated independently:
+			if ((i + 37 * c) % 1009 == 0)
+			{
+				bank.invalidate (c);
+				smoothers[c].invalidate();
+			}
+
+			double sample = 10.0 * c + noise (rng);
+			bank.set_sample (c, sample);
+			smoothers[c].process (sample, dt);
+		}
+
+		bank.process (dt);
+
+		for (std::size_t c = 0; c < channels; ++c)
+		{
+			double difference = std::abs (bank.value (c) - smoothers[c].value());
+			if (c % 3 == 0)
+				difference = std::min (difference, winding.extent() - difference);
+			max_difference = std::max (max_difference, difference);
+		}
+	}
+
+	return max_difference;
+}
+
+
+static xf::RuntimeTest t1 ("SmootherBank is equivalent to separate Smoothers", []{
+	using namespace xf::TestAsserts;
+
+	verify ("FIR engine, short window", max_bank_difference (25_ms, SmootherBase::Engine::FIR, 10000) < 1e-9);
+	verify ("FIR engine, long window", max_bank_difference (2_s, SmootherBase::Engine::FIR, 2000) < 1e-9);
+	verify ("Recursive engine, short window", max_bank_difference (25_ms, SmootherBase::Engine::Recursive, 10000) < 1e-9);
+	verify ("Recursive engine, long window", max_bank_difference (2_s, SmootherBase::Engine::Recursive, 2000) < 1e-9);
+});
+
+
+static xf::RuntimeTest t2 ("SmootherBank holds channels without samples", []{
+	using namespace xf::TestAsserts;
+
+	SmootherBank bank (100_ms);
+	SmootherBank::Channel a = bank.add_channel();
+	SmootherBank::Channel b = bank.add_channel();
+
+	bank.set_sample (a, 1.0);
+	bank.set_sample (b, 2.0);
+	bank.process (10_ms);
+
+	for (int i = 0; i < 20; ++i)
+	{
+		bank.set_sample (a, 5.0);
+		bank.process (10_ms);
+	}
+
+	verify ("channel with samples reaches target", std::abs (bank.value (a) - 5.0) < 1e-9);
+	verify ("channel without samples keeps its value", bank.value (b) == 2.0);
+	verify ("last sample is kept", bank.last_sample (b) == 2.0);
+});
+
+
+static xf::RuntimeTest t3 ("SmootherBank seeds channels with their first sample", []{
+	using namespace xf::TestAsserts;
+
+	SmootherBank bank (100_ms);
+	SmootherBank::Channel a = bank.add_channel();
+	SmootherBank::Channel b = bank.add_channel();
+
+	// Channel b gets no samples in the first updates:
+	for (int i = 0; i < 5; ++i)
+	{
+		bank.set_sample (a, 1.0);
+		bank.process (10_ms);
+	}
+
+	bank.set_sample (a, 1.0);
+	bank.set_sample (b, 7.0);
+	bank.process (10_ms);
+
+	verify ("first sample resets the channel", std::abs (bank.value (b) - 7.0) < 1e-9);
+
+	bank.set_sample (b, 7.0);
+	bank.process (10_ms);
+
+	verify ("history is seeded with the first sample", std::abs (bank.value (b) - 7.0) < 1e-9);
+});
+
+} // namespace Test
+} // namespace Xefis
+
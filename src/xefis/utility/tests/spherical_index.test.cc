@@ -0,0 +1,167 @@
+/* vim:ts=4
+ *
+ * Copyleft 2012…2016  Michał Gawron
+ * Marduk Unix Labs, http://mulabs.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Visit http://www.gnu.org/licenses/gpl-3.0.html for more information on licensing.
+ */
+
+
+// Standard:
+#include <cstddef>
+#include <algorithm>
+#include <random>
+#include <set>
+
+// Xefis:
+#include <xefis/test/random_positions.h>
+#include <xefis/test/test.h>
+#include <xefis/utility/spherical_index.h>
+
+
+namespace Xefis {
+namespace Test {
+
+static xf::RuntimeTest t1 ("SphericalIndex radius queries", []{
+	using namespace xf::TestAsserts;
+
+	std::mt19937 rng (1);
+	std::uniform_real_distribution<double> lon_dist (-180.0, 180.0);
+	std::uniform_real_distribution<double> near_dist (-1.5, 1.5);
+
+	std::vector<LonLat> positions = uniform_sphere_positions (4000, rng);
+	// Clusters around the antimeridian and the north pole:
+	for (int i = 0; i < 1000; ++i)
+	{
+		double lon = 180.0 + near_dist (rng);
+		if (lon > 180.0)
+			lon -= 360.0;
+		positions.emplace_back (1_deg * lon, 1_deg * near_dist (rng));
+		positions.emplace_back (1_deg * lon_dist (rng), 90_deg - 1_deg * std::abs (near_dist (rng)));
+	}
+
+	SphericalIndex index;
+	std::vector<std::size_t> order = index.build (positions);
+
+	verify ("index contains all points", index.size() == positions.size());
+
+	LonLat const centers[] = {
+		{ 179.9_deg, 0.5_deg },
+		{ -179.9_deg, -0.5_deg },
+		{ 0_deg, 89.9_deg },
+		{ 120_deg, -89.5_deg },
+		{ 19_deg, 50_deg },
+	};
+
+	for (LonLat const& center: centers)
+	{
+		for (Length radius: { 10_nmi, 80_nmi, 160_nmi, 1000_nmi })
+		{
+			std::set<std::size_t> found;
+			index.for_each_within (center, SphericalIndex::earth_angle (radius), [&](std::size_t i) {
+				found.insert (order[i]);
+			});
+
+			Angle::Value const angle = SphericalIndex::earth_angle (radius).quantity<Radian>();
+
+			for (std::size_t i = 0; i < positions.size(); ++i)
+			{
+				Angle::Value const distance = center.haversine (positions[i]);
+				// Ignore points lying on the boundary, where single precision vectors may disagree:
+				if (std::abs (distance - angle) < 1e-5)
+					continue;
+				verify ("query result matches brute force search", (distance <= angle) == (found.count (i) > 0));
+			}
+		}
+	}
+});
+
+
+static xf::RuntimeTest t2 ("SphericalIndex difference queries", []{
+	using namespace xf::TestAsserts;
+
+	std::mt19937 rng (2);
+	std::uniform_real_distribution<double> near_dist (-3.0, 3.0);
+
+	std::vector<LonLat> positions = uniform_sphere_positions (4000, rng);
+	for (int i = 0; i < 4000; ++i)
+		positions.emplace_back (1_deg * (19.0 + near_dist (rng)), 1_deg * (50.0 + near_dist (rng)));
+
+	SphericalIndex index;
+	index.build (positions);
+
+	auto within = [&](LonLat const& center, Angle radius) {
+		std::set<std::size_t> result;
+		index.for_each_within (center, radius, [&](std::size_t i) { result.insert (i); });
+		return result;
+	};
+
+	// Moving query circle, including change of radius and a jump over the antimeridian:
+	std::vector<std::pair<LonLat, Angle>> const steps = {
+		{ { 19_deg, 50_deg }, 1_deg },
+		{ { 19.01_deg, 50_deg }, 1_deg },
+		{ { 19.2_deg, 50.1_deg }, 1_deg },
+		{ { 19.2_deg, 50.1_deg }, 2_deg },
+		{ { 21_deg, 49_deg }, 0.5_deg },
+		{ { 179.5_deg, 10_deg }, 5_deg },
+		{ { -179.5_deg, 10_deg }, 5_deg },
+	};
+
+	for (std::size_t s = 1; s < steps.size(); ++s)
+	{
+		auto const& a = steps[s - 1];
+		auto const& b = steps[s];
+		std::set<std::size_t> const in_a = within (a.first, a.second);
+		std::set<std::size_t> const in_b = within (b.first, b.second);
+
+		std::set<std::size_t> entered;
+		index.for_each_within_difference (b.first, b.second, a.first, a.second, [&](std::size_t i) { entered.insert (i); });
+		std::set<std::size_t> left;
+		index.for_each_within_difference (a.first, a.second, b.first, b.second, [&](std::size_t i) { left.insert (i); });
+
+		std::set<std::size_t> updated = in_a;
+		for (std::size_t i: left)
+			updated.erase (i);
+		updated.insert (entered.begin(), entered.end());
+
+		verify ("entered points are not in the previous result", std::none_of (entered.begin(), entered.end(), [&](std::size_t i) { return in_a.count (i); }));
+		verify ("left points are in the previous result", std::all_of (left.begin(), left.end(), [&](std::size_t i) { return in_a.count (i); }));
+		verify ("updated result equals new result", updated == in_b);
+	}
+});
+
+
+static xf::RuntimeTest t3 ("SphericalIndex nearest-first iteration", []{
+	using namespace xf::TestAsserts;
+
+	std::mt19937 rng (3);
+	std::vector<LonLat> const positions = uniform_sphere_positions (3000, rng);
+
+	SphericalIndex index;
+	std::vector<std::size_t> order = index.build (positions);
+
+	for (LonLat const& center: { LonLat (179.9_deg, 0.5_deg), LonLat (0_deg, 89.9_deg), LonLat (19_deg, 50_deg) })
+	{
+		std::vector<float> distances;
+		std::set<std::size_t> visited;
+		for (auto point = index.nearest (center); point; ++point)
+		{
+			distances.push_back (point.squared_chord());
+			visited.insert (*point);
+			float const expected = SphericalIndex::squared_chord (1_rad * center.haversine (positions[order[*point]]));
+			verify ("reported distance is the distance of the point", std::abs (point.squared_chord() - expected) < 1e-5f);
+		}
+
+		verify ("all points are visited once", visited.size() == positions.size() && distances.size() == positions.size());
+		verify ("points are ordered by distance", std::is_sorted (distances.begin(), distances.end()));
+	}
+});
+
+} // namespace Test
+} // namespace Xefis
+
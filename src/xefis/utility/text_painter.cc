@@ -14,6 +14,9 @@
 // Standard:
 #include <cstddef>
 #include <cmath>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 // Xefis:
 #include <xefis/utility/numeric.h>
@@ -30,7 +33,9 @@ TextPainter::Cache::Glyph::Glyph (QFont const& font, QColor color, QChar charact
 	QFontMetricsF metrics (font);
 	position_correction.setX (position_correction.x() * metrics.width("0"));
 	position_correction.setY (position_correction.y() * metrics.height());
-	QSize size (std::ceil (metrics.width (character)) + 1, std::ceil (metrics.height()) + 1);
+	// Glyph may extend past its advance (eg. italic or overhanging glyphs):
+	qreal width = std::max (metrics.width (character), metrics.boundingRect (character).right());
+	QSize size (std::ceil (width) + 1, std::ceil (metrics.height()) + 1);
 	QImage image (size, QImage::Format_ARGB32_Premultiplied);
 	QColor alpha = color;
 	alpha.setAlpha (0);
@@ -75,6 +80,24 @@ TextPainter::Cache::Glyph::Glyph (QFont const& font, QColor color, QChar charact
 }
 
 
+TextPainter::Cache::Glyphs&
+TextPainter::Cache::glyphs_for (QFont const& font, QColor color)
+{
+	if (last_glyphs && last_font && last_font->color == color && last_font->font == font)
+		return *last_glyphs;
+
+	Font key { font, color };
+
+	Fonts::iterator glyphs_cache_it = fonts.find (key);
+	if (glyphs_cache_it == fonts.end())
+		glyphs_cache_it = fonts.insert ({ key, Glyphs() }).first;
+
+	last_font = key;
+	last_glyphs = &glyphs_cache_it->second;
+	return *last_glyphs;
+}
+
+
 TextPainter::TextPainter (Cache* cache):
 	_cache (cache)
 {
@@ -176,27 +199,15 @@ TextPainter::fast_draw_text (QRectF const& target, Qt::Alignment flags, QString
 		saved_transform = true;
 	}
 
-	QColor color = pen().color();
+	float fx = floored_mod<float> (offset.x(), 1.f);
+	float fy = floored_mod<float> (offset.y(), 1.f);
+	int dx = limit<int> (fx * Cache::Glyph::Rank, 0, Cache::Glyph::Rank - 1);
+	int dy = limit<int> (fy * Cache::Glyph::Rank, 0, Cache::Glyph::Rank - 1);
 
-	// TODO cache previous painting info { font, color }, and if the same, use cached glyphs_cache iterator.
-	// Find font cache:
-	Cache::Fonts::iterator glyphs_cache_it = _cache->fonts.find (Cache::Font { font(), color });
-	if (glyphs_cache_it == _cache->fonts.end())
-		glyphs_cache_it = _cache->fonts.insert ({ Cache::Font { font(), color }, Cache::Glyphs() }).first;
-	Cache::Glyphs* glyphs_cache = &glyphs_cache_it->second;
-
-	for (QString::ConstIterator c = text.begin(); c != text.end(); ++c)
-	{
-		auto glyph = glyphs_cache->find (*c);
-		if (glyph == glyphs_cache->end())
-			glyph = glyphs_cache->insert ({ *c, Cache::Glyph (font(), color, *c, _position_correction) }).first;
-		float fx = floored_mod<float> (offset.x(), 1.f);
-		float fy = floored_mod<float> (offset.y(), 1.f);
-		int dx = limit<int> (fx * Cache::Glyph::Rank, 0, Cache::Glyph::Rank - 1);
-		int dy = limit<int> (fy * Cache::Glyph::Rank, 0, Cache::Glyph::Rank - 1);
-		drawImage (QPoint (offset.x(), offset.y()), glyph->second.data->positions[dx][dy]);
-		offset.rx() += metrics.width (*c);
-	}
+	if (text.size() == 1)
+		drawImage (QPoint (offset.x(), offset.y()), glyph_image (_cache->glyphs_for (font(), pen().color()), text[0], dx, dy));
+	else if (!text.isEmpty())
+		drawImage (QPoint (offset.x(), offset.y()), run_image (metrics, text, dx, dy));
 
 	if (saved_transform)
 		setTransform (painter_transform);
@@ -217,6 +228,74 @@ TextPainter::fast_draw_vertical_text (QPointF const& position, Qt::Alignment fla
 }
 
 
+QImage const&
+TextPainter::glyph_image (Cache::Glyphs& glyphs_cache, QChar character, int dx, int dy)
+{
+	auto glyph = glyphs_cache.find (character);
+	if (glyph == glyphs_cache.end())
+		glyph = glyphs_cache.insert ({ character, Cache::Glyph (font(), pen().color(), character, _position_correction) }).first;
+	return glyph->second.data->positions[dx][dy];
+}
+
+
+QImage const&
+TextPainter::run_image (QFontMetricsF const& metrics, QString const& text, int dx, int dy)
+{
+	QColor color = pen().color();
+	Cache::RunKey key { Cache::Font { font(), color }, text, dx, dy };
+
+	auto run = _cache->runs.find (key);
+	if (run != _cache->runs.end())
+	{
+		// Move to the front of LRU list:
+		_cache->runs_lru.splice (_cache->runs_lru.begin(), _cache->runs_lru, run->second.lru_position);
+		return run->second.run.image;
+	}
+
+	Cache::Glyphs& glyphs_cache = _cache->glyphs_for (font(), color);
+
+	// Compose glyphs the same way they would be drawn one by one on the target,
+	// starting from the sub-pixel position represented by dx/dy:
+	QPointF const start (1.f * dx / Cache::Glyph::Rank, 1.f * dy / Cache::Glyph::Rank);
+	std::vector<std::pair<QPoint, QImage const*>> glyphs;
+	glyphs.reserve (text.size());
+	QPointF offset = start;
+	// Size the run from glyph images, since glyphs may extend past their advance:
+	QSize size (std::ceil (start.x() + metrics.width (text)) + 1, std::ceil (start.y() + metrics.height()) + 1);
+
+	for (QChar c: text)
+	{
+		float fx = floored_mod<float> (offset.x(), 1.f);
+		int gdx = limit<int> (fx * Cache::Glyph::Rank, 0, Cache::Glyph::Rank - 1);
+		QImage const& glyph = glyph_image (glyphs_cache, c, gdx, dy);
+		QPoint position (std::floor (offset.x()), std::floor (offset.y()));
+		glyphs.emplace_back (position, &glyph);
+		size = size.expandedTo (QSize (position.x() + glyph.width(), position.y() + glyph.height()));
+		offset.rx() += metrics.width (c);
+	}
+
+	QImage image (size, QImage::Format_ARGB32_Premultiplied);
+	image.fill (Qt::transparent);
+
+	QPainter painter (&image);
+
+	for (auto const& glyph: glyphs)
+		painter.drawImage (glyph.first, *glyph.second);
+
+	painter.end();
+
+	if (_cache->runs.size() >= Cache::MaxRuns)
+	{
+		_cache->runs.erase (_cache->runs_lru.back());
+		_cache->runs_lru.pop_back();
+	}
+
+	_cache->runs_lru.push_front (key);
+	auto inserted = _cache->runs.insert ({ key, Cache::RunEntry { Cache::Run { image }, _cache->runs_lru.begin() } }).first;
+	return inserted->second.run.image;
+}
+
+
 void
 TextPainter::apply_alignment (QRectF& rect, Qt::Alignment flags)
 {
@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <tuple>
 #include <map>
+#include <list>
 #include <memory>
 
 // Qt:
@@ -79,10 +80,66 @@ class TextPainter: public QPainter
 			operator< (Font const& other) const;
 		};
 
+		/**
+		 * Whole pre-composited string, ready to be drawn with a single blit.
+		 */
+		struct Run
+		{
+			QImage	image;
+		};
+
+		struct RunKey
+		{
+			Font	font;
+			QString	text;
+			int		dx;
+			int		dy;
+
+			bool
+			operator< (RunKey const& other) const;
+		};
+
 		typedef std::map<QChar, Glyph>	Glyphs;
 		typedef std::map<Font, Glyphs>	Fonts;
+		typedef std::list<RunKey>		RunsLRU;
 
-		Fonts fonts;
+		struct RunEntry
+		{
+			Run					run;
+			RunsLRU::iterator	lru_position;
+		};
+
+		typedef std::map<RunKey, RunEntry>	Runs;
+
+		// Max number of cached strings. Least recently used are dropped first.
+		static constexpr std::size_t MaxRuns = 1024;
+
+	  public:
+		/**
+		 * Return number of cached glyph images.
+		 */
+		std::size_t
+		glyphs_count() const;
+
+		/**
+		 * Return number of cached strings.
+		 */
+		std::size_t
+		runs_count() const;
+
+	  private:
+		/**
+		 * Return glyphs cache for given font and color.
+		 * Remembers last used font, so that consecutive calls with the same font are cheap.
+		 */
+		Glyphs&
+		glyphs_for (QFont const&, QColor);
+
+		Fonts				fonts;
+		Runs				runs;
+		RunsLRU				runs_lru;
+		Optional<Font>		last_font;
+		Glyphs*				last_glyphs = nullptr;
 	};
 
   public:
@@ -116,7 +173,27 @@ class TextPainter: public QPainter
 	void
 	fast_draw_vertical_text (QPointF const& position, Qt::Alignment flags, QString const& text);
 
+  protected:
+	/**
+	 * Return glyphs cache used by this painter.
+	 */
+	Cache*
+	cache() const;
+
   private:
+	/**
+	 * Return cached glyph image for given character and sub-pixel offset.
+	 */
+	QImage const&
+	glyph_image (Cache::Glyphs&, QChar, int dx, int dy);
+
+	/**
+	 * Return pre-composited image of the whole string, rendering it if not cached.
+	 * Image's top-left corner corresponds to the floored position of the first glyph.
+	 */
+	QImage const&
+	run_image (QFontMetricsF const&, QString const& text, int dx, int dy);
+
 	/**
 	 * Apply alignment flags to given rectangle.
 	 */
@@ -143,12 +220,43 @@ TextPainter::Cache::Glyph::operator= (Glyph const& other)
 }
 
 
+inline TextPainter::Cache*
+TextPainter::cache() const
+{
+	return _cache;
+}
+
+
 inline bool
 TextPainter::Cache::Font::operator< (Font const& other) const
 {
 	return std::make_pair (font, color.rgba()) < std::make_pair (other.font, other.color.rgba());
 }
 
+
+inline bool
+TextPainter::Cache::RunKey::operator< (RunKey const& other) const
+{
+	return std::tie (dx, dy, text, font) < std::tie (other.dx, other.dy, other.text, other.font);
+}
+
+
+inline std::size_t
+TextPainter::Cache::glyphs_count() const
+{
+	std::size_t result = 0;
+	for (auto const& f: fonts)
+		result += f.second.size();
+	return result;
+}
+
+
+inline std::size_t
+TextPainter::Cache::runs_count() const
+{
+	return runs.size();
+}
+
 } // namespace Xefis
 
 #endif